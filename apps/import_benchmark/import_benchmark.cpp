@@ -0,0 +1,532 @@
+#include "import_benchmark.hpp"
+
+#include <base/hsk_framerenderinfo.hpp>
+#include <gltfconvert/hsk_modelconverter.hpp>
+#include <gltfconvert/hsk_multimodelload.hpp>
+#include <gltfconvert/hsk_scenegenerator.hpp>
+#include <hsk_vkHelpers.hpp>
+#include <scenegraph/hsk_scene.hpp>
+#include <utility/hsk_deviceresource.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#endif
+
+namespace {
+    /// @brief Starts a new peak resident set size measurement. Linux resets the process high water mark, Windows can't reset it.
+    void ResetPeakRss()
+    {
+#ifdef __linux__
+        std::ofstream clearRefs("/proc/self/clear_refs");
+        clearRefs << "5";
+#endif
+    }
+
+    /// @brief Peak resident set size in bytes since the last ResetPeakRss() call (Windows: since process start). 0 if unknown.
+    uint64_t GetPeakRss()
+    {
+#if defined(__linux__)
+        std::ifstream status("/proc/self/status");
+        std::string   line;
+        while(std::getline(status, line))
+        {
+            if(line.rfind("VmHWM:", 0) == 0)
+            {
+                return std::stoull(line.substr(6)) * 1024;
+            }
+        }
+        return 0;
+#elif defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters{};
+        if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return counters.PeakWorkingSetSize;
+        }
+        return 0;
+#else
+        return 0;
+#endif
+    }
+
+    /// @brief Scene updates averaged per synthetic scene
+    const uint32_t SYNTHETIC_UPDATE_FRAMES = 16;
+
+    template <typename TFunc>
+    double MeasureMs(TFunc&& func)
+    {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /// @brief Parses a comma separated list of numbers
+    std::vector<uint32_t> ParseCounts(const char* list, int minimum)
+    {
+        std::vector<uint32_t> result;
+        std::stringstream     counts(list);
+        std::string           count;
+        while(std::getline(counts, count, ','))
+        {
+            if(count.size())
+            {
+                result.push_back((uint32_t)std::max(std::atoi(count.c_str()), minimum));
+            }
+        }
+        return result;
+    }
+
+    void PrintUsage()
+    {
+        std::cerr << "Usage: importbenchmark [asset directory] [options]\n"
+                     "  --out <file>             JSON output path (default import_benchmark.json)\n"
+                     "  --repeat <n>             Loads per file (default 1)\n"
+                     "  --software               Prefer a CPU Vulkan implementation (lavapipe, SwiftShader)\n"
+                     "  --import-cache <dir>     Enable the import cache (ModelConverter::Config::ImportCacheDirectory)\n"
+                     "  --texture-cache <dir>    Enable texture cooking (ModelConverter::Config::TextureCacheDirectory)\n"
+                     "  --compact                Use EVertexLayout::Compact\n"
+                     "  --synthetic <n,n,...>    Benchmark synthetic scenes of these node counts (e.g. 1000,10000,100000,1000000)\n"
+                     "  --write-synthetic <dir>  Also write the synthetic scenes to dir as .glb files\n"
+                     "  --concurrent <n,n,...>   Also load all files at once with these thread counts (0: hardware concurrency)\n";
+    }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    ImportBenchmark::Options options;
+    if(!ImportBenchmark::ParseArguments(argc, argv, options))
+    {
+        return 2;
+    }
+    try
+    {
+        ImportBenchmark benchmark(std::move(options));
+        return benchmark.Run();
+    }
+    catch(const hsk::Exception& ex)
+    {
+        hsk::logger()->error("Import benchmark: {}", ex.what());
+        return 1;
+    }
+    catch(const std::exception& ex)
+    {
+        hsk::logger()->error("Import benchmark: {}", ex.what());
+        return 1;
+    }
+}
+
+bool ImportBenchmark::ParseArguments(int argc, char** argv, Options& outoptions)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        std::string_view argument = argv[i];
+        bool             hasValue = i + 1 < argc;
+        if(argument == "--out" && hasValue)
+        {
+            outoptions.OutputPath = argv[++i];
+        }
+        else if(argument == "--repeat" && hasValue)
+        {
+            outoptions.Repetitions = (uint32_t)std::max(std::atoi(argv[++i]), 1);
+        }
+        else if(argument == "--software")
+        {
+            outoptions.PreferSoftwareDevice = true;
+        }
+        else if(argument == "--import-cache" && hasValue)
+        {
+            outoptions.ImportCacheDirectory = argv[++i];
+        }
+        else if(argument == "--texture-cache" && hasValue)
+        {
+            outoptions.TextureCacheDirectory = argv[++i];
+        }
+        else if(argument == "--compact")
+        {
+            outoptions.VertexLayout = hsk::EVertexLayout::Compact;
+        }
+        else if(argument == "--synthetic" && hasValue)
+        {
+            outoptions.SyntheticNodeCounts = ParseCounts(argv[++i], 1);
+        }
+        else if(argument == "--concurrent" && hasValue)
+        {
+            outoptions.ConcurrentThreadCounts = ParseCounts(argv[++i], 0);
+        }
+        else if(argument == "--write-synthetic" && hasValue)
+        {
+            outoptions.SyntheticOutputDirectory = argv[++i];
+        }
+        else if(outoptions.AssetDirectory.empty() && argument.size() && argument[0] != '-')
+        {
+            outoptions.AssetDirectory = argument;
+        }
+        else
+        {
+            PrintUsage();
+            return false;
+        }
+    }
+    bool hasAssets = !outoptions.AssetDirectory.empty();
+    if((!hasAssets && (outoptions.SyntheticNodeCounts.empty() || outoptions.ConcurrentThreadCounts.size()))
+       || (hasAssets && !std::filesystem::is_directory(outoptions.AssetDirectory)))
+    {
+        PrintUsage();
+        return false;
+    }
+    return true;
+}
+
+ImportBenchmark::ImportBenchmark(Options options) : mOptions(std::move(options)) {}
+
+void ImportBenchmark::CreateContext()
+{
+    vkb::InstanceBuilder instanceBuilder;
+    instanceBuilder.set_app_name("importbenchmark").set_headless(true).require_api_version(1, 2);
+    auto instanceReturn = instanceBuilder.build();
+    HSK_ASSERTFMT(instanceReturn, "Instance creation: {}", instanceReturn.error().message())
+    mContext.Instance = instanceReturn.value();
+
+    vkb::PhysicalDeviceSelector pds(mContext.Instance);
+    pds.defer_surface_initialization();
+    pds.set_minimum_version(1, 2);
+    if(mOptions.PreferSoftwareDevice)
+    {
+        pds.prefer_gpu_device_type(vkb::PreferredDeviceType::cpu);
+    }
+    VkPhysicalDeviceFeatures deviceFeatures{};
+    deviceFeatures.samplerAnisotropy = VK_TRUE;
+    pds.set_required_features(deviceFeatures);
+    auto physicalDeviceReturn = pds.select();
+    HSK_ASSERTFMT(physicalDeviceReturn, "Physical device selection: {}", physicalDeviceReturn.error().message())
+    mContext.PhysicalDevice = physicalDeviceReturn.value();
+    mDeviceName             = mContext.PhysicalDevice.properties.deviceName;
+
+    vkb::DeviceBuilder deviceBuilder{mContext.PhysicalDevice};
+    auto               deviceReturn = deviceBuilder.build();
+    HSK_ASSERTFMT(deviceReturn, "Device creation: {}", deviceReturn.error().message())
+    mContext.Device        = deviceReturn.value();
+    mContext.DispatchTable = mContext.Device.make_table();
+
+    auto queueReturn = mContext.Device.get_queue(vkb::QueueType::graphics);
+    HSK_ASSERTFMT(queueReturn, "Failed to get graphics queue. Error: {} ", queueReturn.error().message())
+    mContext.QueueGraphics = hsk::Queue{.Queue = queueReturn.value(), .QueueFamilyIndex = mContext.Device.get_queue_index(vkb::QueueType::graphics).value()};
+    mContext.TransferQueue = mContext.QueueGraphics;
+    mContext.PresentQueue  = mContext.QueueGraphics;
+
+    VkCommandPoolCreateInfo poolInfo{.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                                     .flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+                                     .queueFamilyIndex = mContext.QueueGraphics.QueueFamilyIndex};
+    hsk::AssertVkResult(vkCreateCommandPool(mContext.Device, &poolInfo, nullptr, &mCommandPool));
+    mContext.CommandPool         = mCommandPool;
+    mContext.TransferCommandPool = mCommandPool;
+
+    VmaVulkanFunctions vulkanFunctions    = {};
+    vulkanFunctions.vkGetInstanceProcAddr = &vkGetInstanceProcAddr;
+    vulkanFunctions.vkGetDeviceProcAddr   = &vkGetDeviceProcAddr;
+
+    VmaAllocatorCreateInfo allocatorCreateInfo = {};
+    allocatorCreateInfo.vulkanApiVersion       = VK_API_VERSION_1_2;
+    allocatorCreateInfo.physicalDevice         = mContext.PhysicalDevice;
+    allocatorCreateInfo.device                 = mContext.Device;
+    allocatorCreateInfo.instance               = mContext.Instance;
+    allocatorCreateInfo.pVulkanFunctions       = &vulkanFunctions;
+    hsk::AssertVkResult(vmaCreateAllocator(&allocatorCreateInfo, &mContext.Allocator));
+
+    mContext.DebugEnabled = false;
+}
+
+void ImportBenchmark::DestroyContext()
+{
+    hsk::AssertVkResult(vkDeviceWaitIdle(mContext.Device));
+    for(auto deviceResource : *hsk::DeviceResourceBase::GetTotalAllocatedResources())
+    {
+        if(deviceResource->Exists())
+        {
+            hsk::logger()->error("Resource with name \"{}\" has not been cleaned up!", deviceResource->GetName());
+        }
+    }
+    vmaDestroyAllocator(mContext.Allocator);
+    vkDestroyCommandPool(mContext.Device, mCommandPool, nullptr);
+    vkb::destroy_device(mContext.Device);
+    vkb::destroy_instance(mContext.Instance);
+    mContext = {};
+}
+
+std::vector<std::filesystem::path> ImportBenchmark::FindAssets() const
+{
+    std::vector<std::filesystem::path> result;
+    for(const auto& entry : std::filesystem::recursive_directory_iterator(mOptions.AssetDirectory))
+    {
+        std::string extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)std::tolower(c); });
+        if(entry.is_regular_file() && (extension == ".gltf" || extension == ".glb"))
+        {
+            result.push_back(entry.path());
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+nlohmann::ordered_json ImportBenchmark::BenchmarkAsset(const std::filesystem::path& asset, uint32_t repetition)
+{
+    nlohmann::ordered_json result;
+    result["file"]       = asset.string();
+    result["repetition"] = repetition;
+
+    hsk::Scene scene(&mContext);
+    {
+        hsk::ModelConverter converter(&scene);
+        hsk::ModelConverter::Config& config = converter.GetConfig();
+        config.VertexLayout                 = mOptions.VertexLayout;
+        config.ImportCacheDirectory         = mOptions.ImportCacheDirectory;
+        config.TextureCacheDirectory        = mOptions.TextureCacheDirectory;
+
+        ResetPeakRss();
+        try
+        {
+            converter.LoadGltfModel(asset.string(), &mContext);
+            result["success"] = true;
+        }
+        catch(const hsk::Exception& ex)
+        {
+            result["success"] = false;
+            result["error"]   = ex.what();
+        }
+        catch(const std::exception& ex)
+        {
+            result["success"] = false;
+            result["error"]   = ex.what();
+        }
+        result["peakRssBytes"] = GetPeakRss();
+
+        const hsk::ModelConverter::LoadStats& stats = converter.GetLoadStats();
+        result["importCacheHit"]                    = stats.ImportCacheHit;
+        result["phasesMs"]                          = {{"readImportCache", stats.ReadImportCacheMs},
+                                                       {"parse", stats.ParseMs},
+                                                       {"buildGeometry", stats.BuildGeometryMs},
+                                                       {"decodeImages", stats.DecodeImagesMs},
+                                                       {"translateScene", stats.TranslateSceneMs},
+                                                       {"writeImportCache", stats.WriteImportCacheMs},
+                                                       {"uploadGeometry", stats.UploadGeometryMs},
+                                                       {"uploadTextures", stats.UploadTexturesMs},
+                                                       {"submit", stats.SubmitMs},
+                                                       {"attachToScene", stats.AttachToSceneMs},
+                                                       {"total", stats.TotalMs}};
+        result["bytes"]                             = {{"source", stats.SourceBytes},
+                                                       {"encodedImages", stats.EncodedImageBytes},
+                                                       {"uploaded", stats.UploadedBytes}};
+        result["vertexCount"]                       = stats.VertexCount;
+        result["indexCount"]                        = stats.IndexCount;
+        result["submitCount"]                       = stats.SubmitCount;
+    }
+    hsk::AssertVkResult(vkDeviceWaitIdle(mContext.Device));
+    scene.Cleanup(false);
+
+    std::cout << asset.filename().string() << " #" << repetition << ": " << result["phasesMs"]["total"].get<double>() << " ms" << std::endl;
+    return result;
+}
+
+nlohmann::ordered_json ImportBenchmark::BenchmarkConcurrentLoad(const std::vector<std::filesystem::path>& assets, uint32_t threadCount, uint32_t repetition)
+{
+    nlohmann::ordered_json result;
+    result["concurrent"] = threadCount;
+    result["repetition"] = repetition;
+
+    std::vector<std::string> paths;
+    for(const std::filesystem::path& asset : assets)
+    {
+        paths.push_back(asset.string());
+    }
+
+    hsk::Scene scene(&mContext);
+    {
+        hsk::MultiModelLoad          load(&scene);
+        hsk::ModelConverter::Config& config = load.GetConfig();
+        config.VertexLayout                 = mOptions.VertexLayout;
+        config.ImportCacheDirectory         = mOptions.ImportCacheDirectory;
+        config.TextureCacheDirectory        = mOptions.TextureCacheDirectory;
+        load.SetMaxConcurrentModels(threadCount);
+
+        ResetPeakRss();
+        size_t loadedCount = 0;
+        try
+        {
+            loadedCount = load.Load(paths, &mContext);
+        }
+        catch(const hsk::Exception& ex)
+        {
+            result["error"] = ex.what();
+        }
+        catch(const std::exception& ex)
+        {
+            result["error"] = ex.what();
+        }
+        result["success"]      = loadedCount == paths.size();
+        result["peakRssBytes"] = GetPeakRss();
+        result["loadedCount"]  = loadedCount;
+        result["phasesMs"]     = {{"submit", load.GetSubmitMs()}, {"total", load.GetTotalMs()}};
+
+        // Sum of the per model times, compared to the total this shows how well the load scales
+        double summedModelMs = 0.0;
+        for(const hsk::MultiModelLoad::Result& model : load.GetResults())
+        {
+            summedModelMs += model.Stats.TotalMs;
+        }
+        result["summedModelMs"] = summedModelMs;
+    }
+    hsk::AssertVkResult(vkDeviceWaitIdle(mContext.Device));
+    scene.Cleanup(false);
+
+    std::cout << "concurrent " << threadCount << " threads #" << repetition << ": " << result["phasesMs"]["total"].get<double>() << " ms" << std::endl;
+    return result;
+}
+
+nlohmann::ordered_json ImportBenchmark::BenchmarkSyntheticScene(uint32_t nodeCount, uint32_t repetition)
+{
+    nlohmann::ordered_json result;
+    result["synthetic"]  = nodeCount;
+    result["repetition"] = repetition;
+
+    hsk::SceneGenerator          generator;
+    hsk::SceneGenerator::Config& config = generator.GetConfig();
+    config.NodeCount                    = nodeCount;
+    config.VertexLayout                 = mOptions.VertexLayout;
+
+    hsk::Scene scene(&mContext);
+    double     generateMs = 0.0;
+    double     buildMs    = 0.0;
+    double     updateMs   = 0.0;
+    ResetPeakRss();
+    try
+    {
+        generateMs = MeasureMs([&]() { generator.Generate(); });
+        buildMs    = MeasureMs([&]() { generator.BuildScene(&scene, &mContext); });
+
+        // Transform propagation and animation playback
+        hsk::FrameUpdateInfo updateInfo;
+        updateInfo.SetFrameTime(1.0 / 60.0);
+        updateMs = MeasureMs([&]() {
+                       for(uint32_t frame = 0; frame < SYNTHETIC_UPDATE_FRAMES; frame++)
+                       {
+                           updateInfo.SetFrameNumber(frame);
+                           scene.Update(updateInfo);
+                       }
+                   }) /
+                   SYNTHETIC_UPDATE_FRAMES;
+
+        if(!mOptions.SyntheticOutputDirectory.empty() && repetition == 0)
+        {
+            std::filesystem::create_directories(mOptions.SyntheticOutputDirectory);
+            generator.WriteGlb((mOptions.SyntheticOutputDirectory / ("synthetic_" + std::to_string(nodeCount) + ".glb")).string());
+        }
+        result["success"] = true;
+    }
+    catch(const hsk::Exception& ex)
+    {
+        result["success"] = false;
+        result["error"]   = ex.what();
+    }
+    catch(const std::exception& ex)
+    {
+        result["success"] = false;
+        result["error"]   = ex.what();
+    }
+    result["peakRssBytes"] = GetPeakRss();
+
+    const hsk::SceneGenerator::Stats& stats = generator.GetStats();
+    result["phasesMs"]                      = {{"generate", generateMs}, {"buildScene", buildMs}, {"update", updateMs}};
+    result["rootNodeCount"]                 = stats.RootNodeCount;
+    result["depth"]                         = stats.Depth;
+    result["meshInstanceCount"]             = stats.MeshInstanceCount;
+    result["animatedNodeCount"]             = stats.AnimatedNodeCount;
+    result["vertexCount"]                   = stats.VertexCount;
+    result["triangleCount"]                 = stats.TriangleCount;
+    result["instancedTriangleCount"]        = stats.InstancedTriangleCount;
+
+    hsk::AssertVkResult(vkDeviceWaitIdle(mContext.Device));
+    scene.Cleanup(false);
+
+    std::cout << "synthetic " << nodeCount << " nodes #" << repetition << ": build " << buildMs << " ms, update " << updateMs << " ms" << std::endl;
+    return result;
+}
+
+int ImportBenchmark::Run()
+{
+    std::vector<std::filesystem::path> assets;
+    if(!mOptions.AssetDirectory.empty())
+    {
+        assets = FindAssets();
+        if(assets.empty())
+        {
+            hsk::logger()->error("Import benchmark: No .gltf or .glb files in \"{}\"", mOptions.AssetDirectory.string());
+            return 1;
+        }
+    }
+
+    CreateContext();
+    hsk::logger()->info("Import benchmark: {} files, {} synthetic scenes on \"{}\"", assets.size(), mOptions.SyntheticNodeCounts.size(), mDeviceName);
+
+    // Import logging would dominate the measured time of small models
+    spdlog::level::level_enum logLevel = hsk::logger()->level();
+    hsk::logger()->set_level(spdlog::level::warn);
+
+    nlohmann::ordered_json results  = nlohmann::ordered_json::array();
+    int                    exitCode = 0;
+    auto                   lAdd     = [&](nlohmann::ordered_json&& result) {
+        if(!result["success"].get<bool>())
+        {
+            exitCode = 1;
+        }
+        results.push_back(std::move(result));
+    };
+    for(const std::filesystem::path& asset : assets)
+    {
+        for(uint32_t repetition = 0; repetition < mOptions.Repetitions; repetition++)
+        {
+            lAdd(BenchmarkAsset(asset, repetition));
+        }
+    }
+    for(uint32_t threadCount : mOptions.ConcurrentThreadCounts)
+    {
+        for(uint32_t repetition = 0; repetition < mOptions.Repetitions; repetition++)
+        {
+            lAdd(BenchmarkConcurrentLoad(assets, threadCount, repetition));
+        }
+    }
+    for(uint32_t nodeCount : mOptions.SyntheticNodeCounts)
+    {
+        for(uint32_t repetition = 0; repetition < mOptions.Repetitions; repetition++)
+        {
+            lAdd(BenchmarkSyntheticScene(nodeCount, repetition));
+        }
+    }
+
+    hsk::logger()->set_level(logLevel);
+
+    nlohmann::ordered_json document = {{"device", mDeviceName}, {"assetDirectory", mOptions.AssetDirectory.string()}, {"results", std::move(results)}};
+    std::ofstream          output(mOptions.OutputPath);
+    output << document.dump(4) << std::endl;
+    if(!output)
+    {
+        hsk::logger()->error("Import benchmark: Unable to write \"{}\"", mOptions.OutputPath.string());
+        exitCode = 1;
+    }
+    else
+    {
+        hsk::logger()->info("Import benchmark: Results written to \"{}\"", mOptions.OutputPath.string());
+    }
+
+    DestroyContext();
+    return exitCode;
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <base/hsk_vkcontext.hpp>
+#include <scenegraph/hsk_geo.hpp>
+#include <tinygltf/json.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+/// @brief Headless benchmark of the model import path. Loads every glTF file of a directory with ModelConverter::LoadGltfModel() and writes the phase timings,
+/// data volume, peak memory and submit count of every load as JSON. Optionally loads all files at once with varying thread counts, and benchmarks synthetic scenes of given node counts (see hsk::SceneGenerator),
+/// built directly into a scene, measuring generation, build and scene update times.
+/// @remark Creates its own Vulkan device without window or swapchain, so it runs on software implementations (e.g. lavapipe selected via VK_ICD_FILENAMES).
+class ImportBenchmark
+{
+  public:
+    struct Options
+    {
+        std::filesystem::path AssetDirectory = {};
+        std::filesystem::path OutputPath     = "import_benchmark.json";
+        /// @brief Loads per file. Later repetitions hit the import and texture caches, if enabled.
+        uint32_t Repetitions = 1;
+        /// @brief Prefers CPU implementations (lavapipe, SwiftShader) over GPUs
+        bool               PreferSoftwareDevice  = false;
+        std::string        ImportCacheDirectory  = {};
+        std::string        TextureCacheDirectory = {};
+        hsk::EVertexLayout VertexLayout          = hsk::EVertexLayout::Full;
+        /// @brief Node counts of the synthetic scenes to benchmark
+        std::vector<uint32_t> SyntheticNodeCounts = {};
+        /// @brief If set, every synthetic scene is also written to this directory as .glb, so its import can be benchmarked with the same tool
+        std::filesystem::path SyntheticOutputDirectory = {};
+        /// @brief Thread counts to load all assets at once with (see hsk::MultiModelLoad), 0 selects the hardware concurrency
+        std::vector<uint32_t> ConcurrentThreadCounts = {};
+    };
+
+    /// @return False if the command line is invalid (usage has been printed)
+    static bool ParseArguments(int argc, char** argv, Options& outoptions);
+
+    explicit ImportBenchmark(Options options);
+
+    /// @return Process exit code
+    int Run();
+
+  protected:
+    Options        mOptions;
+    hsk::VkContext mContext     = {};
+    VkCommandPool  mCommandPool = VK_NULL_HANDLE;
+    std::string    mDeviceName;
+
+    void CreateContext();
+    void DestroyContext();
+
+    /// @brief All .gltf and .glb files below the asset directory, sorted by path
+    std::vector<std::filesystem::path> FindAssets() const;
+
+    /// @brief Loads asset with ModelConverter::LoadGltfModel()
+    /// @return Result entry, "success" is false if the load failed
+    nlohmann::ordered_json BenchmarkAsset(const std::filesystem::path& asset, uint32_t repetition);
+    /// @brief Loads all assets into one scene with hsk::MultiModelLoad
+    nlohmann::ordered_json BenchmarkConcurrentLoad(const std::vector<std::filesystem::path>& assets, uint32_t threadCount, uint32_t repetition);
+    /// @brief Generates a synthetic scene and builds it into a scene, then measures the average time of a scene update
+    nlohmann::ordered_json BenchmarkSyntheticScene(uint32_t nodeCount, uint32_t repetition);
+};
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "skinning_demo.hpp"
+
+#include <gltfconvert/hsk_modelconverter.hpp>
+#include <hsk_env.hpp>
+#include <hsk_vkHelpers.hpp>
+#include <scenegraph/components/hsk_freecameracontroller.hpp>
+#include <scenegraph/components/hsk_skinnedmeshinstance.hpp>
+#include <scenegraph/globalcomponents/hsk_geometrystore.hpp>
+#include <scenegraph/hsk_geo.hpp>
+#include <scenegraph/hsk_node.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    /// @brief Frame of the first smoke check read back. Not the very first frame, so the animation has advanced by the second one.
+    const uint64_t SMOKE_FIRST_FRAME = 2;
+    /// @brief Displacement (in model units) below which the mesh is considered undeformed
+    const float SMOKE_MIN_DISPLACEMENT = 1e-4f;
+
+    void PrintUsage()
+    {
+        std::cerr << "Usage: skinningdemo [model file] [options]\n"
+                     "  --smoke <frames>  Check that the first skinned mesh deforms until the given frame, then exit (exit code 1 on failure)\n";
+    }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    SkinningDemo::Options options;
+    if(!SkinningDemo::ParseArguments(argc, argv, options))
+    {
+        return 2;
+    }
+    SkinningDemo demo(std::move(options));
+    int result = demo.Run();
+    return result ? result : demo.GetSmokeResult();
+}
+
+bool SkinningDemo::ParseArguments(int argc, char** argv, Options& outoptions)
+{
+    bool hasModel = false;
+    for(int i = 1; i < argc; i++)
+    {
+        std::string_view argument = argv[i];
+        if(argument == "--smoke" && i + 1 < argc)
+        {
+            outoptions.SmokeFrames = (uint64_t)std::max(std::atoi(argv[++i]), (int)SMOKE_FIRST_FRAME + 1);
+        }
+        else if(!hasModel && argument.size() && argument[0] != '-')
+        {
+            outoptions.ModelPath = argument;
+            hasModel             = true;
+        }
+        else
+        {
+            PrintUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+SkinningDemo::SkinningDemo(Options options) : mOptions(std::move(options)) {}
+
+void SkinningDemo::Init()
+{
+    mScene = std::make_unique<hsk::Scene>(&mContext);
+
+    hsk::ModelConverter converter(mScene.get());
+    converter.LoadGltfModel(hsk::MakeRelativePath(mOptions.ModelPath));
+
+    hsk::Node* cameraNode        = mScene->MakeNode();
+    mCamera                      = cameraNode->MakeComponent<hsk::Camera>();
+    mCamera->GetEyePosition()    = glm::vec3(0.f, 1.f, 3.f);
+    mCamera->GetLookatPosition() = glm::vec3(0.f, 0.75f, 0.f);
+    mCamera->GetUpDirection()    = glm::vec3(0.f, 1.f, 0.f);
+    mCamera->InitDefault();
+    cameraNode->MakeComponent<hsk::FreeCameraController>();
+
+    // Skinning has to be recorded before every stage drawing the scene
+    mSkinningStage.Init(&mContext, mScene.get());
+    mGBufferStage.SetVertexLayout(converter.GetConfig().VertexLayout);
+    mGBufferStage.Init(&mContext, mScene.get());
+    mImageToSwapchainStage.Init(&mContext, mGBufferStage.GetColorAttachmentByName(hsk::GBufferStage::Albedo));
+
+    hsk::logger()->info("Skinning demo: {} skinned and {} morphed mesh instances", mSkinningStage.GetSkinnedInstances().size(), mSkinningStage.GetMorphedInstances().size());
+}
+
+void SkinningDemo::Update(float delta)
+{
+    if(mOptions.SmokeFrames && mRenderedFrameCount > mOptions.SmokeFrames)
+    {
+        EvaluateSmokeCheck();
+        return;
+    }
+
+    hsk::FrameUpdateInfo updateInfo;
+    updateInfo.SetFrameTime(delta).SetFrameNumber(mRenderedFrameCount);
+    mScene->Update(updateInfo);
+}
+
+void SkinningDemo::OnEvent(std::shared_ptr<hsk::Event> event)
+{
+    if(mScene)
+    {
+        mScene->HandleEvent(event);
+    }
+}
+
+void SkinningDemo::RecordCommandBuffer(hsk::FrameRenderInfo& renderInfo)
+{
+    mSkinningStage.RecordFrame(renderInfo);
+
+    uint64_t frame = renderInfo.GetFrameNumber();
+    if(mOptions.SmokeFrames && (frame == SMOKE_FIRST_FRAME || frame == mOptions.SmokeFrames))
+    {
+        CmdReadBackSkinnedVertices(renderInfo.GetCommandBuffer(), frame == SMOKE_FIRST_FRAME ? 0 : 1);
+    }
+
+    mGBufferStage.RecordFrame(renderInfo);
+    mImageToSwapchainStage.RecordFrame(renderInfo);
+}
+
+void SkinningDemo::OnResized(VkExtent2D size)
+{
+    mCamera->OnResized(size);
+    mGBufferStage.OnResized(size);
+    mImageToSwapchainStage.OnResized(size, mGBufferStage.GetColorAttachmentByName(hsk::GBufferStage::Albedo));
+}
+
+void SkinningDemo::CmdReadBackSkinnedVertices(VkCommandBuffer commandBuffer, size_t index)
+{
+    if(mSkinningStage.GetSkinnedInstances().empty())
+    {
+        return;
+    }
+    hsk::SkinnedMeshInstance* instance        = mSkinningStage.GetSkinnedInstances().front();
+    const hsk::ManagedBuffer& skinnedVertices = instance->GetSkinnedVertices();
+    VkDeviceSize              size            = (VkDeviceSize)instance->GetMesh()->GetVertexCount() * hsk::GetVertexStride(instance->GetMesh()->GetBuffer()->GetVertexLayout());
+    if(!mSmokeReadbacks[index].Exists())
+    {
+        mSmokeReadbacks[index].SetName(index ? "Smoke Readback Last" : "Smoke Readback First");
+        mSmokeReadbacks[index].Create(&mContext, VK_BUFFER_USAGE_TRANSFER_DST_BIT, size, VMA_MEMORY_USAGE_AUTO_PREFER_HOST, VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT);
+    }
+
+    VkMemoryBarrier barrier{.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER, .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT, .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT};
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    VkBufferCopy copy{.srcOffset = 0, .dstOffset = 0, .size = size};
+    vkCmdCopyBuffer(commandBuffer, skinnedVertices.GetBuffer(), mSmokeReadbacks[index].GetBuffer(), 1, &copy);
+}
+
+void SkinningDemo::EvaluateSmokeCheck()
+{
+    State(EState::StopRequested);
+    hsk::AssertVkResult(vkDeviceWaitIdle(mContext.Device));
+
+    if(mSkinningStage.GetSkinnedInstances().empty() || !mSmokeReadbacks[0].Exists() || !mSmokeReadbacks[1].Exists())
+    {
+        hsk::logger()->error("Skinning smoke check: \"{}\" has no skinned mesh instance", mOptions.ModelPath);
+        mSmokeResult = 1;
+        return;
+    }
+
+    hsk::SkinnedMeshInstance* instance    = mSkinningStage.GetSkinnedInstances().front();
+    size_t                    stride      = hsk::GetVertexStride(instance->GetMesh()->GetBuffer()->GetVertexLayout());
+    size_t                    vertexCount = instance->GetMesh()->GetVertexCount();
+
+    // Both layouts start with the position
+    void* first = nullptr;
+    void* last  = nullptr;
+    mSmokeReadbacks[0].Map(first);
+    mSmokeReadbacks[1].Map(last);
+    float maxDisplacement = 0.f;
+    for(size_t i = 0; i < vertexCount; i++)
+    {
+        glm::vec3 firstPos;
+        glm::vec3 lastPos;
+        memcpy(&firstPos, reinterpret_cast<const uint8_t*>(first) + i * stride, sizeof(glm::vec3));
+        memcpy(&lastPos, reinterpret_cast<const uint8_t*>(last) + i * stride, sizeof(glm::vec3));
+        maxDisplacement = std::max(maxDisplacement, glm::distance(firstPos, lastPos));
+    }
+    mSmokeReadbacks[0].Unmap();
+    mSmokeReadbacks[1].Unmap();
+
+    bool deformed = maxDisplacement > SMOKE_MIN_DISPLACEMENT;
+    mSmokeResult  = deformed ? 0 : 1;
+    if(deformed)
+    {
+        hsk::logger()->info("Skinning smoke check passed: {} vertices moved up to {} between frames {} and {}", vertexCount, maxDisplacement, SMOKE_FIRST_FRAME, mOptions.SmokeFrames);
+    }
+    else
+    {
+        hsk::logger()->error("Skinning smoke check failed: skinned vertices did not change between frames {} and {}", SMOKE_FIRST_FRAME, mOptions.SmokeFrames);
+    }
+}
+
+void SkinningDemo::Cleanup()
+{
+    hsk::AssertVkResult(vkDeviceWaitIdle(mContext.Device));
+    mImageToSwapchainStage.Destroy();
+    mGBufferStage.Destroy();
+    mSkinningStage.Destroy();
+    for(hsk::ManagedBuffer& readback : mSmokeReadbacks)
+    {
+        readback.Cleanup();
+    }
+    if(mScene)
+    {
+        mScene->Cleanup();
+        mScene = nullptr;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <hsk_rtrpf.hpp>
+#include <memory/hsk_managedbuffer.hpp>
+#include <scenegraph/components/hsk_camera.hpp>
+#include <scenegraph/hsk_scene.hpp>
+#include <stages/hsk_gbuffer.hpp>
+#include <stages/hsk_imagetoswapchain.hpp>
+#include <stages/hsk_skinningstage.hpp>
+
+#include <memory>
+#include <string>
+
+/// @brief Renders an animated glTF model through the frame chain SkinningStage -> GBufferStage -> ImageToSwapchainStage, presenting the albedo attachment.
+/// @remark With --smoke <frames>, the skinned vertices of the first skinned instance are read back after the skinning pass of an early frame and of the given frame.
+/// The demo then exits, with exit code 1 if they are identical, i.e. the mesh did not deform.
+class SkinningDemo : public hsk::DefaultAppBase
+{
+  public:
+    struct Options
+    {
+        /// @brief glTF file to load, relative paths are resolved with hsk::MakeRelativePath()
+        std::string ModelPath = "models/glTF-Sample-Models/CesiumMan/glTF/CesiumMan.gltf";
+        /// @brief If not 0, the frame the smoke check completes at
+        uint64_t SmokeFrames = 0;
+    };
+
+    /// @return False if the command line is invalid (usage has been printed)
+    static bool ParseArguments(int argc, char** argv, Options& outoptions);
+
+    explicit SkinningDemo(Options options);
+
+    /// @brief 0 if the smoke check passed or was not requested
+    inline int GetSmokeResult() const { return mSmokeResult; }
+
+  protected:
+    virtual void Init() override;
+    virtual void Update(float delta) override;
+    virtual void OnEvent(std::shared_ptr<hsk::Event> event) override;
+    virtual void RecordCommandBuffer(hsk::FrameRenderInfo& renderInfo) override;
+    virtual void OnResized(VkExtent2D size) override;
+    virtual void Cleanup() override;
+
+    Options                     mOptions;
+    std::unique_ptr<hsk::Scene> mScene;
+    hsk::Camera*                mCamera = nullptr;
+
+    hsk::SkinningStage         mSkinningStage;
+    hsk::GBufferStage          mGBufferStage;
+    hsk::ImageToSwapchainStage mImageToSwapchainStage;
+
+    /// @brief Skinned vertices of the first skinned instance, read back at the two smoke check frames
+    hsk::ManagedBuffer mSmokeReadbacks[2];
+    int                mSmokeResult = 0;
+
+    /// @brief Records copying the skinned vertices of the first skinned instance into mSmokeReadbacks[index]
+    void CmdReadBackSkinnedVertices(VkCommandBuffer commandBuffer, size_t index);
+    /// @brief Compares both read backs and stops the application
+    void EvaluateSmokeCheck();
+};
\ No newline at end of file
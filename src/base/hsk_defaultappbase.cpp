@@ -41,6 +41,7 @@ namespace hsk {
         BaseInitGetVkQueues();
         BaseInitCommandPool();
         BaseInitCreateVma();
+        BaseInitStagingRing();
         BaseInitSyncObjects();
     }
 
@@ -228,6 +229,12 @@ namespace hsk {
         vmaCreateAllocator(&allocatorCreateInfo, &mContext.Allocator);
     }
 
+    void DefaultAppBase::BaseInitStagingRing()
+    {
+        mStagingRing.Create(&mContext);
+        mContext.StagingRing = &mStagingRing;
+    }
+
     void DefaultAppBase::BaseInitCompileShaders()
     {
         if(!mShaderCompilerConfig.EnableShaderCompiler)
@@ -282,12 +289,17 @@ namespace hsk {
 
             mFrames.push_back(std::move(target));
         }
+        mContext.FrameProgress = &mFrameProgress;
     }
 
     void DefaultAppBase::BaseCleanupVulkan()
     {
         AssertVkResult(vkDeviceWaitIdle(mContext.Device));
 
+        mStagingRing.Cleanup();
+        mContext.StagingRing   = nullptr;
+        mContext.FrameProgress = nullptr;
+
         vkDestroyCommandPool(mContext.Device, mCommandPoolDefault, nullptr);
         for(auto& target : mFrames)
         {
@@ -349,6 +361,13 @@ namespace hsk {
         // Make sure that the command buffer we want to use has been presented to the GPU
         vkWaitForFences(mContext.Device, 1, &currentFrame.CommandBufferExecutedFence, VK_TRUE, UINT64_MAX);
 
+        // Reclaim staging memory of uploads that have executed meanwhile
+        mStagingRing.Retire();
+
+        // Fences signal in submission order, so every frame up to the one last recorded into this slot has completed
+        mFrameProgress.FrameNumber         = mRenderedFrameCount;
+        mFrameProgress.CompletedFrameCount = mRenderedFrameCount >= mFrames.size() ? mRenderedFrameCount - mFrames.size() + 1 : 0;
+
         VkImage primaryOutput    = nullptr;
         VkImage comparisonOutput = nullptr;
 
@@ -438,6 +457,9 @@ namespace hsk {
         submitInfo.commandBufferCount = 1;
         submitInfo.pCommandBuffers    = commandbuffers;
 
+        // Device local writes of this frame are submitted at once, ahead of the frame reading them
+        mStagingRing.Flush();
+
         // Submit all work to the default queue
         AssertVkResult(vkQueueSubmit(mContext.QueueGraphics, 1, &submitInfo, currentFrame.CommandBufferExecutedFence));
 
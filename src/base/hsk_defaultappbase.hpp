@@ -1,5 +1,6 @@
 #pragma once
 #include "../memory/hsk_managedimage.hpp"
+#include "../memory/hsk_stagingring.hpp"
 #include "../osi/hsk_window.hpp"
 #include "hsk_framerenderinfo.hpp"
 #include "hsk_minimalappbase.hpp"
@@ -43,6 +44,7 @@ namespace hsk {
         virtual void BaseInitGetVkQueues();
         virtual void BaseInitCommandPool();
         virtual void BaseInitCreateVma();
+        virtual void BaseInitStagingRing();
         virtual void BaseInitCompileShaders();
         virtual void BaseInitSyncObjects();
 
@@ -103,6 +105,11 @@ namespace hsk {
         /// @brief Commandpool for the default queue.
         VkCommandPool mCommandPoolDefault{};
 
+        /// @brief Staging memory for device local writes during runtime, see VkContext::StagingRing
+        StagingRing mStagingRing;
+        /// @brief Frame numbers of recorded and completed frames, see VkContext::FrameProgress
+        FrameProgress mFrameProgress;
+
 #pragma endregion
     };
 }  // namespace hsk
\ No newline at end of file
@@ -2,9 +2,20 @@
 #include "../osi/hsk_window.hpp"
 #include <vkbootstrap/VkBootstrap.h>
 #include <vma/vk_mem_alloc.h>
+#include <atomic>
 #include <vulkan/vulkan.h>
 
 namespace hsk {
+    class StagingRing;
+
+    /// @brief Progress of the render loop. Resources frames in flight may still read are released once their frame has completed (see GeometryArena::Free()).
+    struct FrameProgress
+    {
+        /// @brief Number of the frame currently being recorded
+        std::atomic<uint64_t> FrameNumber{};
+        /// @brief Frames numbered below have finished executing. A resource released while FrameNumber was N may be destroyed once CompletedFrameCount > N.
+        std::atomic<uint64_t> CompletedFrameCount{};
+    };
 
     /// @brief Used for easy queue access.
     struct Queue
@@ -46,5 +57,10 @@ namespace hsk {
         Queue               TransferQueue{};
         bool                DebugEnabled;  // global flag indicating debug is enabled
         vkb::DispatchTable  DispatchTable;
+        /// @brief Ring used for small device local writes (ManagedBuffer::WriteDataDeviceLocal, ManagedImage::WriteDeviceLocalData). Optional.
+        /// The writes are only recorded, the owner of the ring flushes it before submitting work depending on them (see StagingRing).
+        hsk::StagingRing* StagingRing{};
+        /// @brief Set by render loops recording frames ahead of the GPU (DefaultAppBase). Without it, nothing is in flight between calls and resources are released immediately.
+        hsk::FrameProgress* FrameProgress{};
     };
 }  // namespace hsk
\ No newline at end of file
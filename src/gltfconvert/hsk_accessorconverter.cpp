@@ -0,0 +1,252 @@
+#include "hsk_accessorconverter.hpp"
+#include "../hsk_exception.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <tinygltf/tiny_gltf.h>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define HSK_ACCESSOR_SSE
+#include <emmintrin.h>
+#endif
+
+namespace hsk {
+    namespace {
+        using ConvertFunc = void (*)(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride, size_t count, bool normalized);
+
+        template <typename TIn, typename TOut, uint32_t N>
+        void ConvertElements(const uint8_t* src, size_t srcStride, uint8_t* dst, size_t dstStride, size_t count, bool normalized)
+        {
+            if constexpr(std::is_same_v<TIn, TOut>)
+            {
+                // Plain copy (float -> float, uint32 -> uint32)
+                for(size_t i = 0; i < count; i++)
+                {
+                    memcpy(dst + i * dstStride, src + i * srcStride, N * sizeof(TIn));
+                }
+                return;
+            }
+            else
+            {
+                if constexpr(std::is_same_v<TOut, float> && std::is_integral_v<TIn>)
+                {
+                    if(normalized)
+                    {
+                        // glTF normalized integers: f = max(c / MAX, -1)
+                        constexpr float scale = 1.f / (float)std::numeric_limits<TIn>::max();
+                        size_t          first = 0;
+#ifdef HSK_ACCESSOR_SSE
+                        if constexpr(sizeof(TIn) == 2 && N >= 3)
+                        {
+                            if(srcStride >= 4 * sizeof(TIn))
+                            {
+                                // Convert all components of an element at once. For N == 3 the fourth lane is read from the element's padding and discarded,
+                                // so the last element (whose padding may lie past the end of the buffer) is left to the scalar loop.
+                                const __m128 scale4    = _mm_set1_ps(scale);
+                                const __m128 minusOne4 = _mm_set1_ps(-1.f);
+                                size_t       simdCount = N == 4 ? count : (count ? count - 1 : 0);
+                                for(size_t i = 0; i < simdCount; i++)
+                                {
+                                    __m128i raw = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i * srcStride));
+                                    __m128i wide;
+                                    if constexpr(std::is_signed_v<TIn>)
+                                    {
+                                        wide = _mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16);
+                                    }
+                                    else
+                                    {
+                                        wide = _mm_unpacklo_epi16(raw, _mm_setzero_si128());
+                                    }
+                                    __m128 value = _mm_mul_ps(_mm_cvtepi32_ps(wide), scale4);
+                                    if constexpr(std::is_signed_v<TIn>)
+                                    {
+                                        value = _mm_max_ps(value, minusOne4);
+                                    }
+                                    float* out = reinterpret_cast<float*>(dst + i * dstStride);
+                                    if constexpr(N == 4)
+                                    {
+                                        _mm_storeu_ps(out, value);
+                                    }
+                                    else
+                                    {
+                                        _mm_storel_pi(reinterpret_cast<__m64*>(out), value);
+                                        _mm_store_ss(out + 2, _mm_movehl_ps(value, value));
+                                    }
+                                }
+                                first = simdCount;
+                            }
+                        }
+#endif
+                        for(size_t i = first; i < count; i++)
+                        {
+                            float* out = reinterpret_cast<float*>(dst + i * dstStride);
+                            for(uint32_t c = 0; c < N; c++)
+                            {
+                                TIn value;
+                                memcpy(&value, src + i * srcStride + c * sizeof(TIn), sizeof(TIn));
+                                out[c] = std::max((float)value * scale, -1.f);
+                            }
+                        }
+                        return;
+                    }
+                }
+                for(size_t i = 0; i < count; i++)
+                {
+                    TOut* out = reinterpret_cast<TOut*>(dst + i * dstStride);
+                    for(uint32_t c = 0; c < N; c++)
+                    {
+                        TIn value;
+                        memcpy(&value, src + i * srcStride + c * sizeof(TIn), sizeof(TIn));
+                        out[c] = (TOut)value;
+                    }
+                }
+            }
+        }
+
+        template <typename TIn, typename TOut>
+        ConvertFunc SelectComponentCount(uint32_t components)
+        {
+            switch(components)
+            {
+                case 1:
+                    return &ConvertElements<TIn, TOut, 1>;
+                case 2:
+                    return &ConvertElements<TIn, TOut, 2>;
+                case 3:
+                    return &ConvertElements<TIn, TOut, 3>;
+                case 4:
+                    return &ConvertElements<TIn, TOut, 4>;
+                default:
+                    HSK_THROWFMT("Accessor conversion of {} components not supported!", components);
+            }
+        }
+
+        template <typename TOut>
+        ConvertFunc SelectConverter(int32_t componentType, uint32_t components)
+        {
+            switch(componentType)
+            {
+                case TINYGLTF_COMPONENT_TYPE_BYTE:
+                    return SelectComponentCount<int8_t, TOut>(components);
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+                    return SelectComponentCount<uint8_t, TOut>(components);
+                case TINYGLTF_COMPONENT_TYPE_SHORT:
+                    return SelectComponentCount<int16_t, TOut>(components);
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+                    return SelectComponentCount<uint16_t, TOut>(components);
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+                    return SelectComponentCount<uint32_t, TOut>(components);
+                case TINYGLTF_COMPONENT_TYPE_FLOAT:
+                    return SelectComponentCount<float, TOut>(components);
+                default:
+                    HSK_THROWFMT("Accessor component type {} not supported!", componentType);
+            }
+        }
+
+        /// @brief Returns a pointer to the first byte of a range within a buffer view, checking that count elements of elementSize spaced by stride fit
+        const uint8_t* GetBufferViewData(const tinygltf::Model&              model,
+                                         const std::vector<GltfBufferData>& buffers,
+                                         int32_t                            bufferViewIndex,
+                                         size_t                             byteOffset,
+                                         size_t                             count,
+                                         size_t                             stride,
+                                         size_t                             elementSize)
+        {
+            HSK_ASSERTFMT(bufferViewIndex >= 0 && bufferViewIndex < (int32_t)model.bufferViews.size(), "Buffer view index {} out of range!", bufferViewIndex)
+            const tinygltf::BufferView& bufferView = model.bufferViews[bufferViewIndex];
+            HSK_ASSERTFMT(bufferView.buffer >= 0 && (size_t)bufferView.buffer < buffers.size(), "Buffer view #{}: Buffer index {} out of range!", bufferViewIndex, bufferView.buffer)
+            const GltfBufferData& buffer = buffers[bufferView.buffer];
+            size_t                start  = bufferView.byteOffset + byteOffset;
+            size_t                end    = count ? start + (count - 1) * stride + elementSize : start;
+            HSK_ASSERTFMT(end <= bufferView.byteOffset + bufferView.byteLength && end <= buffer.Size, "Buffer view #{}: Accessed range [{}, {}) out of bounds!",
+                          bufferViewIndex, start, end)
+            return buffer.Data + start;
+        }
+
+        template <typename TOut>
+        size_t Convert(const tinygltf::Model&             model,
+                       const std::vector<GltfBufferData>& buffers,
+                       int32_t                            accessorIndex,
+                       uint32_t                           components,
+                       TOut*                              out,
+                       size_t                             outStride,
+                       size_t                             maxCount)
+        {
+            HSK_ASSERTFMT(accessorIndex >= 0 && accessorIndex < (int32_t)model.accessors.size(), "Accessor index {} out of range!", accessorIndex)
+            const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
+
+            int32_t componentSize  = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(accessor.componentType));
+            int32_t componentCount = tinygltf::GetNumComponentsInType(static_cast<uint32_t>(accessor.type));
+            HSK_ASSERTFMT(componentSize > 0 && componentCount > 0, "Accessor #{}: Invalid type {} / component type {}!", accessorIndex, accessor.type, accessor.componentType)
+            HSK_ASSERTFMT(components <= (uint32_t)componentCount, "Accessor #{}: Requested {} components, accessor has {}!", accessorIndex, components, componentCount)
+            HSK_ASSERTFMT(accessor.count <= maxCount, "Accessor #{}: {} elements exceed output capacity of {}!", accessorIndex, accessor.count, maxCount)
+
+            ConvertFunc convert     = SelectConverter<TOut>(accessor.componentType, components);
+            size_t      elementSize = (size_t)componentSize * componentCount;
+            uint8_t*    dst         = reinterpret_cast<uint8_t*>(out);
+
+            if(accessor.bufferView >= 0)
+            {
+                const tinygltf::BufferView& bufferView = model.bufferViews[accessor.bufferView];
+                int32_t                     stride     = accessor.ByteStride(bufferView);
+                HSK_ASSERTFMT(stride > 0, "Accessor #{}: Invalid byte stride!", accessorIndex)
+
+                const uint8_t* src = GetBufferViewData(model, buffers, accessor.bufferView, accessor.byteOffset, accessor.count, stride, elementSize);
+                convert(src, stride, dst, outStride, accessor.count, accessor.normalized);
+            }
+            else
+            {
+                // Without a buffer view all values are initialized to zero
+                for(size_t i = 0; i < accessor.count; i++)
+                {
+                    memset(dst + i * outStride, 0, components * sizeof(TOut));
+                }
+            }
+
+            if(accessor.sparse.isSparse)
+            {
+                // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#sparse-accessors
+                auto&    sparse       = accessor.sparse;
+                int32_t  indexSize    = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(sparse.indices.componentType));
+                HSK_ASSERTFMT(indexSize > 0, "Accessor #{}: Sparse index component type {} not supported!", accessorIndex, sparse.indices.componentType)
+                const uint8_t* indices = GetBufferViewData(model, buffers, sparse.indices.bufferView, sparse.indices.byteOffset, sparse.count, indexSize, indexSize);
+                const uint8_t* values  = GetBufferViewData(model, buffers, sparse.values.bufferView, sparse.values.byteOffset, sparse.count, elementSize, elementSize);
+
+                std::vector<uint32_t> sparseIndices(sparse.count);
+                SelectConverter<uint32_t>(sparse.indices.componentType, 1)(indices, indexSize, reinterpret_cast<uint8_t*>(sparseIndices.data()), sizeof(uint32_t), sparse.count, false);
+                for(int32_t i = 0; i < sparse.count; i++)
+                {
+                    uint32_t index = sparseIndices[i];
+                    HSK_ASSERTFMT(index < accessor.count, "Accessor #{}: Sparse index {} out of bounds!", accessorIndex, index)
+                    convert(values + i * elementSize, elementSize, dst + index * outStride, outStride, 1, accessor.normalized);
+                }
+            }
+
+            return accessor.count;
+        }
+    }  // namespace
+
+    size_t AccessorConverter::ToFloat(const tinygltf::Model&             model,
+                                      const std::vector<GltfBufferData>& buffers,
+                                      int32_t                            accessorIndex,
+                                      uint32_t                           components,
+                                      float*                             out,
+                                      size_t                             outStride,
+                                      size_t                             maxCount)
+    {
+        return Convert<float>(model, buffers, accessorIndex, components, out, outStride, maxCount);
+    }
+
+    size_t AccessorConverter::ToUint(const tinygltf::Model&             model,
+                                     const std::vector<GltfBufferData>& buffers,
+                                     int32_t                            accessorIndex,
+                                     uint32_t                           components,
+                                     uint32_t*                          out,
+                                     size_t                             outStride,
+                                     size_t                             maxCount)
+    {
+        return Convert<uint32_t>(model, buffers, accessorIndex, components, out, outStride, maxCount);
+    }
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tinygltf {
+    class Model;
+}
+
+namespace hsk {
+
+    /// @brief Contents of a glTF buffer: Either the data owned by the tinygltf::Buffer, or a view into a memory mapped .glb file
+    struct GltfBufferData
+    {
+        const uint8_t* Data = nullptr;
+        size_t         Size = 0;
+    };
+
+    /// @brief Bulk conversion of glTF accessors into strided output (e.g. a member of an array of vertices)
+    /// @remark Handles all accessor component types, normalized integers (KHR_mesh_quantization), byte strides, accessors without buffer view (all zero) and sparse accessors.
+    /// Reads are bounds checked against the buffer once per accessor, not per element.
+    class AccessorConverter
+    {
+      public:
+        /// @brief Converts all elements of an accessor to float vectors. Normalized integers are mapped to [0, 1] / [-1, 1], other integers are converted by value.
+        /// @param buffers Contents of every buffer of the model, indexed by buffer index
+        /// @param components Number of components written per element. Must not exceed the component count of the accessor type (e.g. 3 reads xyz of a VEC4 tangent).
+        /// @param out First component of the first output element
+        /// @param outStride Distance between output elements in bytes
+        /// @param maxCount Number of output elements available. Throws if the accessor has more elements.
+        /// @return Number of elements written (the accessor count)
+        static size_t ToFloat(const tinygltf::Model&             model,
+                              const std::vector<GltfBufferData>& buffers,
+                              int32_t                            accessorIndex,
+                              uint32_t                           components,
+                              float*                             out,
+                              size_t                             outStride,
+                              size_t                             maxCount);
+
+        /// @brief Converts all elements of an accessor to unsigned integers (indices, joints). Float components are truncated, normalization is ignored.
+        /// @copydetails ToFloat
+        static size_t ToUint(const tinygltf::Model&             model,
+                             const std::vector<GltfBufferData>& buffers,
+                             int32_t                            accessorIndex,
+                             uint32_t                           components,
+                             uint32_t*                          out,
+                             size_t                             outStride,
+                             size_t                             maxCount);
+    };
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "hsk_asyncmodelload.hpp"
+#include "../base/hsk_vkcontext.hpp"
+#include <chrono>
+#include <limits>
+
+namespace hsk {
+    AsyncModelLoad::AsyncModelLoad(Scene* scene) : mConverter(scene) {}
+
+    AsyncModelLoad::~AsyncModelLoad()
+    {
+        if(mWorker.joinable())
+        {
+            mWorker.join();
+        }
+        // Drops all resources of an unfinished load
+        mConverter.Reset();
+    }
+
+    void AsyncModelLoad::Start(std::string utf8Path, const VkContext* context, std::function<int32_t(const tinygltf::Model&)> sceneSelect)
+    {
+        HSK_ASSERTFMT(!mWorker.joinable() && (GetState() == EState::Done || GetState() == EState::Failed), "Async model load of \"{}\" started while another load is in progress!", utf8Path)
+
+        mConverter.Reset();
+        mConverter.mContext = context ? context : mConverter.GetScene()->GetContext();
+        mConverter.mUploads.Create(mConverter.mContext);
+        mError.clear();
+        mLoadProgress     = 0.f;
+        mImageCount       = 0;
+        mGeometryUploaded = false;
+        mNextTexture      = 0;
+        mState            = EState::Loading;
+
+        mWorker = std::thread(&AsyncModelLoad::RunWorker, this, std::move(utf8Path), std::move(sceneSelect));
+    }
+
+    void AsyncModelLoad::RunWorker(std::string utf8Path, std::function<int32_t(const tinygltf::Model&)> sceneSelect)
+    {
+        try
+        {
+            bool useImportCache = mConverter.UseImportCache(sceneSelect);
+            if(!useImportCache || !mConverter.ReadImportCache(utf8Path))
+            {
+                mConverter.ParseFile(utf8Path, sceneSelect);
+                mImageCount   = (uint32_t)mConverter.mGltfModel.images.size();
+                mLoadProgress = 0.2f;
+
+                logger()->info("Model Load: Building vertex and index buffers ...");
+
+                mConverter.BuildGeometry();
+                mLoadProgress = 0.3f;
+
+                logger()->info("Model Load: Decoding images ...");
+
+                mConverter.DecodeImages();
+                mConverter.TranslateScene();
+
+                if(useImportCache)
+                {
+                    mConverter.WriteImportCache(utf8Path);
+                }
+            }
+            mLoadProgress = 1.f;
+            mState        = EState::Uploading;
+        }
+        catch(const Exception& ex)
+        {
+            Fail(ex.what());
+        }
+        catch(const std::exception& ex)
+        {
+            Fail(ex.what());
+        }
+    }
+
+    bool AsyncModelLoad::Update(double budgetMs)
+    {
+        EState state = GetState();
+        if(state == EState::Loading)
+        {
+            return false;
+        }
+        if(mWorker.joinable())
+        {
+            mWorker.join();
+        }
+        if(state != EState::Uploading)
+        {
+            return true;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            // One step (recording the geometry upload, a single texture upload or attaching to the scene) is always performed
+            do
+            {
+                if(!mGeometryUploaded)
+                {
+                    mConverter.UploadGeometry();
+                    mGeometryUploaded = true;
+                }
+                else if(mNextTexture < (int32_t)mConverter.GetTextureCount())
+                {
+                    mConverter.UploadTexture(mNextTexture);
+                    mNextTexture++;
+                }
+                else
+                {
+                    mConverter.mUploads.Submit();
+                    mConverter.AttachToScene();
+                    mConverter.InitialUpdate();
+                    mConverter.Reset();
+                    mState = EState::Done;
+
+                    logger()->info("Model Load: Done");
+                    return true;
+                }
+            } while(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() < budgetMs
+                    && mConverter.mUploads.GetRecordedSize() < mUploadBytesPerUpdate);
+
+            // Everything recorded during this update is submitted at once. The GPU processes it while the frame continues, the next update waits for completion.
+            mConverter.mUploads.Submit(false);
+        }
+        catch(const Exception& ex)
+        {
+            Fail(ex.what());
+            mConverter.Reset();
+            return true;
+        }
+        catch(const std::exception& ex)
+        {
+            Fail(ex.what());
+            mConverter.Reset();
+            return true;
+        }
+        return false;
+    }
+
+    void AsyncModelLoad::Wait()
+    {
+        while(!Update(std::numeric_limits<double>::infinity()))
+        {
+            if(GetState() == EState::Loading)
+            {
+                mWorker.join();
+            }
+        }
+    }
+
+    float AsyncModelLoad::GetProgress() const
+    {
+        // Background loading accounts for the first half, uploads for the second half
+        switch(GetState())
+        {
+            case EState::Loading: {
+                float    progress   = mLoadProgress.load();
+                uint32_t imageCount = mImageCount.load();
+                if(progress >= 0.3f && progress < 1.f && imageCount > 0)
+                {
+                    progress += 0.7f * (float)mConverter.GetDecodedImageCount() / (float)imageCount;
+                }
+                return 0.5f * std::min(progress, 1.f);
+            }
+            case EState::Uploading: {
+                // Geometry upload, texture uploads and attaching to the scene
+                float stepCount = (float)mConverter.GetTextureCount() + 2.f;
+                float stepsDone = (mGeometryUploaded ? 1.f : 0.f) + (float)mNextTexture;
+                return 0.5f + 0.5f * stepsDone / stepCount;
+            }
+            case EState::Done:
+                return 1.f;
+            default:
+                return 0.f;
+        }
+    }
+
+    void AsyncModelLoad::Fail(std::string_view reason)
+    {
+        logger()->error("Model Load: Async load failed: {}", reason);
+        mError = reason;
+        mState = EState::Failed;
+    }
+}  // namespace hsk
\ No newline at end of file
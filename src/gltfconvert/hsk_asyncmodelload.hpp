@@ -0,0 +1,70 @@
+#pragma once
+#include "hsk_modelconverter.hpp"
+#include <atomic>
+#include <thread>
+
+namespace hsk {
+
+    /// @brief Handle of a model load running in the background
+    /// @remark Parsing, geometry building and image decoding (or reading the import cache) run on a worker thread. Device uploads are time sliced by calling Update() once per frame from the thread owning the scene.
+    /// Nodes, meshes, textures and materials of the model are attached to the scene in a single Update() call once all of its resources are resident.
+    class AsyncModelLoad : public NoMoveDefaults
+    {
+      public:
+        enum class EState
+        {
+            /// @brief Worker thread is parsing the file, building geometry and decoding images
+            Loading,
+            /// @brief Resources are uploaded in Update() calls
+            Uploading,
+            /// @brief The model is attached to the scene
+            Done,
+            /// @brief Loading failed, see GetError()
+            Failed
+        };
+
+        explicit AsyncModelLoad(Scene* scene);
+        virtual ~AsyncModelLoad();
+
+        /// @brief Starts loading the model in the background
+        /// @param sceneSelect Called on the worker thread
+        void Start(std::string utf8Path, const VkContext* context = nullptr, std::function<int32_t(const tinygltf::Model&)> sceneSelect = nullptr);
+
+        /// @brief Advances uploads. Call once per frame from the thread owning the scene.
+        /// @param budgetMs Time after which no further uploads are recorded. At least one upload is recorded per call.
+        /// @remark Recorded uploads are submitted without waiting, the submit is waited on by the next Update() call.
+        /// @return True, if the load has finished (successfully or not)
+        bool Update(double budgetMs = 2.0);
+
+        /// @brief Blocks until the load has finished
+        void Wait();
+
+        EState GetState() const { return mState.load(); }
+        /// @brief Approximate progress in [0, 1]
+        float GetProgress() const;
+        bool  IsFinished() const { return GetState() == EState::Done || GetState() == EState::Failed; }
+
+        HSK_PROPERTY_CGET(Error)
+        /// @brief Converter used for loading. Configure before calling Start()
+        HSK_PROPERTY_GET(Converter)
+        /// @brief Update() stops recording uploads once this many bytes have been recorded in the current call
+        HSK_PROPERTY_ALL(UploadBytesPerUpdate)
+
+      protected:
+        ModelConverter        mConverter;
+        std::thread           mWorker;
+        std::atomic<EState>   mState = EState::Done;
+        /// @brief Progress of the worker thread stages in [0, 1]
+        std::atomic<float>    mLoadProgress = 0.f;
+        /// @brief Number of images of the model, known after parsing
+        std::atomic<uint32_t> mImageCount = 0;
+        std::string           mError;
+
+        VkDeviceSize mUploadBytesPerUpdate = 32 * 1024 * 1024;
+        bool         mGeometryUploaded     = false;
+        int32_t      mNextTexture          = 0;
+
+        void RunWorker(std::string utf8Path, std::function<int32_t(const tinygltf::Model&)> sceneSelect);
+        void Fail(std::string_view reason);
+    };
+}  // namespace hsk
\ No newline at end of file
@@ -1,11 +1,19 @@
 #include "hsk_modelconverter.hpp"
 #include "../base/hsk_vkcontext.hpp"
 #include "../hsk_glm.hpp"
+#include "../scenegraph/components/hsk_instancedmeshinstance.hpp"
 #include "../scenegraph/components/hsk_meshinstance.hpp"
+#include "../scenegraph/components/hsk_morphedmeshinstance.hpp"
+#include "../scenegraph/components/hsk_skinnedmeshinstance.hpp"
 #include "../scenegraph/components/hsk_transform.hpp"
 #include "../scenegraph/globalcomponents/hsk_geometrystore.hpp"
+#include "../scenegraph/globalcomponents/hsk_instancebuffer.hpp"
 #include "../scenegraph/globalcomponents/hsk_materialbuffer.hpp"
 #include "../scenegraph/globalcomponents/hsk_texturestore.hpp"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <limits>
 
 namespace hsk {
     ModelConverter::ModelConverter(Scene* scene)
@@ -16,9 +24,69 @@ namespace hsk {
     {
     }
 
-    void ModelConverter::LoadGltfModel(std::string utf8Path, const VkContext* context, std::function<int32_t(tinygltf::Model)> sceneSelect)
+    void ModelConverter::LoadGltfModel(std::string utf8Path, const VkContext* context, std::function<int32_t(const tinygltf::Model&)> sceneSelect)
     {
         mContext = context ? context : mScene->GetContext();
+        mUploads.Create(mContext);
+
+        mLoadStats                  = {};
+        uint32_t submitCountAtStart = mUploads.GetSubmitCount();
+        auto     loadStart          = std::chrono::steady_clock::now();
+
+        ConvertAndRecordUploads(utf8Path, sceneSelect);
+
+        // Geometry and all textures are uploaded with a single submit
+        MeasurePhase(mLoadStats.SubmitMs, [&]() { mUploads.Submit(); });
+        mLoadStats.SubmitCount = mUploads.GetSubmitCount() - submitCountAtStart;
+
+        MeasurePhase(mLoadStats.AttachToSceneMs, [&]() {
+            AttachToScene();
+            InitialUpdate();
+        });
+
+        Reset();
+
+        mLoadStats.TotalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+        logger()->info("Model Load: Done ({:.1f} ms)", mLoadStats.TotalMs);
+    }
+
+    void ModelConverter::ConvertAndRecordUploads(const std::string& utf8Path, const std::function<int32_t(const tinygltf::Model&)>& sceneSelect)
+    {
+        bool cacheHit = false;
+        if(UseImportCache(sceneSelect))
+        {
+            MeasurePhase(mLoadStats.ReadImportCacheMs, [&]() { cacheHit = ReadImportCache(utf8Path); });
+        }
+        mLoadStats.ImportCacheHit = cacheHit;
+        if(!cacheHit)
+        {
+            MeasurePhase(mLoadStats.ParseMs, [&]() { ParseFile(utf8Path, sceneSelect); });
+
+            logger()->info("Model Load: Building vertex and index buffers ...");
+
+            MeasurePhase(mLoadStats.BuildGeometryMs, [&]() { BuildGeometry(); });
+
+            logger()->info("Model Load: Decoding images ...");
+
+            MeasurePhase(mLoadStats.DecodeImagesMs, [&]() { DecodeImages(); });
+            MeasurePhase(mLoadStats.TranslateSceneMs, [&]() { TranslateScene(); });
+
+            if(UseImportCache(sceneSelect))
+            {
+                MeasurePhase(mLoadStats.WriteImportCacheMs, [&]() { WriteImportCache(utf8Path); });
+            }
+        }
+
+        MeasurePhase(mLoadStats.UploadGeometryMs, [&]() { UploadGeometry(); });
+
+        logger()->info("Model Load: Uploading textures ...");
+
+        MeasurePhase(mLoadStats.UploadTexturesMs, [&]() { LoadTextures(); });
+        mLoadStats.UploadedBytes = mUploads.GetRecordedSize();
+    }
+
+    void ModelConverter::ParseFile(const std::string& utf8Path, const std::function<int32_t(const tinygltf::Model&)>& sceneSelect)
+    {
         tinygltf::TinyGLTF gltfContext;
         std::string        error;
         std::string        warning;
@@ -30,11 +98,72 @@ namespace hsk {
             binary = (utf8Path.substr(extpos + 1, utf8Path.length() - extpos) == "glb");
         }
 
+        // KTX2 images are always kept encoded, stb can't read them
+        gltfContext.SetImageLoader(&ModelConverter::DeferImageDecoding, this);
+
         logger()->info("Model Load: Loading tinygltf model ...");
 
+        // Parsed from a mapping instead of a copy of the whole file read by tinygltf
+        if(!mSourceFile.Open(utf8Path))
+        {
+            HSK_THROWFMT("Model Load: Unable to open file \"{}\"", utf8Path);
+        }
+        HSK_ASSERTFMT(mSourceFile.GetSize() <= std::numeric_limits<uint32_t>::max(), "Model Load: File \"{}\" exceeds the size limit of 4GB", utf8Path)
+
+        const uint8_t* data    = mSourceFile.GetData();
+        size_t         size    = mSourceFile.GetSize();
+        std::string    baseDir = std::filesystem::path(utf8Path).parent_path().string();
+        mLoadStats.SourceBytes = size;
+
+        bool fileLoaded = false;
+        if(binary)
+        {
+            // https://registry.khronos.org/glTF/specs/2.0/glTF-2.0.html#glb-file-format-specification: 12 byte header, JSON chunk, optional binary chunk
+            uint32_t jsonLength = 0;
+            if(size >= 20)
+            {
+                memcpy(&jsonLength, data + 12, sizeof(uint32_t));
+                jsonLength          = (uint32_t)std::min<size_t>(jsonLength, size - 20);
+                size_t binaryHeader = 20 + (size_t)jsonLength;
+                if(binaryHeader + 8 <= size)
+                {
+                    uint32_t binaryLength = 0;
+                    memcpy(&binaryLength, data + binaryHeader, sizeof(uint32_t));
+                    mGlbBinaryChunk = GltfBufferData{.Data = data + binaryHeader + 8, .Size = std::min<size_t>(binaryLength, size - binaryHeader - 8)};
+                }
+            }
 
-        bool fileLoaded = binary ? gltfContext.LoadBinaryFromFile(&mGltfModel, &error, &warning, utf8Path.c_str()) :
-                                   gltfContext.LoadASCIIFromFile(&mGltfModel, &error, &warning, utf8Path.c_str());
+            std::string patchedJson;
+            if(size >= 20 && PatchCompressionFallbacks(std::string_view(reinterpret_cast<const char*>(data) + 20, jsonLength), patchedJson))
+            {
+                // The JSON chunk changed size, so the file is reassembled around it. Buffers still reference the binary chunk of the mapping after ResolveBuffers().
+                patchedJson.resize((patchedJson.size() + 3) / 4 * 4, ' ');
+                size_t               binarySize = size - 20 - jsonLength;
+                std::vector<uint8_t> patched(20 + patchedJson.size() + binarySize);
+                uint32_t             totalLength = (uint32_t)patched.size();
+                uint32_t             chunkLength = (uint32_t)patchedJson.size();
+                memcpy(patched.data(), data, 20);
+                memcpy(patched.data() + 8, &totalLength, sizeof(uint32_t));
+                memcpy(patched.data() + 12, &chunkLength, sizeof(uint32_t));
+                memcpy(patched.data() + 20, patchedJson.data(), patchedJson.size());
+                memcpy(patched.data() + 20 + patchedJson.size(), data + 20 + jsonLength, binarySize);
+                fileLoaded = gltfContext.LoadBinaryFromMemory(&mGltfModel, &error, &warning, patched.data(), totalLength, baseDir);
+            }
+            else
+            {
+                fileLoaded = gltfContext.LoadBinaryFromMemory(&mGltfModel, &error, &warning, data, (unsigned int)size, baseDir);
+            }
+        }
+        else
+        {
+            std::string_view json(reinterpret_cast<const char*>(data), size);
+            std::string      patchedJson;
+            if(PatchCompressionFallbacks(json, patchedJson))
+            {
+                json = patchedJson;
+            }
+            fileLoaded = gltfContext.LoadASCIIFromString(&mGltfModel, &error, &warning, json.data(), (unsigned int)json.size(), baseDir);
+        }
 
         if(warning.size())
         {
@@ -50,19 +179,115 @@ namespace hsk {
             Exception::Throw("Failed to load file");
         }
 
+        if(sceneSelect)
+        {
+            mGltfScene = &(mGltfModel.scenes[sceneSelect(mGltfModel)]);
+        }
+        else
+        {
+            mGltfScene = &(mGltfModel.scenes[mGltfModel.defaultScene]);
+        }
+
+        ResolveBuffers();
+        DecompressBufferViews();
+    }
+
+    void ModelConverter::ResolveBuffers()
+    {
+        mGltfBuffers.resize(mGltfModel.buffers.size());
+        size_t releasedSize = 0;
+        for(size_t i = 0; i < mGltfModel.buffers.size(); i++)
+        {
+            tinygltf::Buffer& buffer = mGltfModel.buffers[i];
+            if(mGlbBinaryChunk.Data && buffer.uri.empty() && buffer.data.size() <= mGlbBinaryChunk.Size)
+            {
+                // tinygltf always copies the binary chunk. The mapping holds the same bytes, so the copy is released right away.
+                mGltfBuffers[i] = GltfBufferData{.Data = mGlbBinaryChunk.Data, .Size = buffer.data.size()};
+                releasedSize += buffer.data.size();
+                std::vector<unsigned char>().swap(buffer.data);
+            }
+            else
+            {
+                mGltfBuffers[i] = GltfBufferData{.Data = buffer.data.data(), .Size = buffer.data.size()};
+                if(buffer.uri.size() && !tinygltf::IsDataURI(buffer.uri))
+                {
+                    mLoadStats.SourceBytes += buffer.data.size();
+                }
+            }
+        }
+        if(releasedSize)
+        {
+            logger()->debug("Model Load: Reading {} bytes of buffer data from the mapped file", releasedSize);
+        }
+    }
+
+    void ModelConverter::ReleaseSourceData()
+    {
+        for(tinygltf::Buffer& buffer : mGltfModel.buffers)
+        {
+            std::vector<unsigned char>().swap(buffer.data);
+        }
+        for(DecodedImage& decoded : mDecodedImages)
+        {
+            // References the encoded image (only left set for KTX2 images not usable on this device)
+            decoded.Ktx2 = Ktx2Texture{};
+        }
+        mGltfBuffers.clear();
+        mDecompressedBuffers.clear();
+        mMappedImages.clear();
+        mGlbBinaryChunk = {};
+        mSourceFile.Close();
+    }
+
+    void ModelConverter::TranslateScene()
+    {
+        TranslateMaterials();
+        TranslateTextures();
+
+        std::vector<int32_t> gltfToRecord(mGltfModel.nodes.size(), -1);
+        mRecords.Nodes.reserve(mGltfModel.nodes.size());
+        for(int32_t nodeIndex : mGltfScene->nodes)
+        {
+            RecursivelyTranslateNodes(nodeIndex, -1, gltfToRecord);
+        }
+
+        TranslateSkins(gltfToRecord);
+        TranslateAnimations(gltfToRecord);
+
+        ReleaseSourceData();
+    }
+
+    void ModelConverter::AttachToScene()
+    {
         logger()->info("Model Load: Preparing scene buffers ...");
 
-        mScene->GetNodeBuffer().reserve(mGltfModel.nodes.size());
-        mIndexBindings.Nodes.resize(mGltfModel.nodes.size());
+        mScene->GetNodeBuffer().reserve(mScene->GetNodeBuffer().size() + mRecords.Nodes.size());
 
-        mIndexBindings.MaterialBufferOffset = mMaterialBuffer.GetVector().size();
-        mMaterialBuffer.GetVector().resize(mIndexBindings.MaterialBufferOffset + mGltfModel.materials.size());
+        mIndexBindings.Textures.resize(mLoadedTextures.size());
+        for(size_t i = 0; i < mLoadedTextures.size(); i++)
+        {
+            mIndexBindings.Textures[i] = mTextures.AddTexture(std::move(mLoadedTextures[i].Image), mLoadedTextures[i].Sampler, mLoadedTextureHashes[i]);
+        }
+        mAttachedTextures = mIndexBindings.Textures;
+        if(mDeduplicatedImageCount)
+        {
+            logger()->info("Model Load: {} of {} textures share an identical image", mDeduplicatedImageCount, mLoadedTextures.size());
+        }
+        mLoadedTextures.clear();
+        mLoadedTextureHashes.clear();
+        mLoadedImages.clear();
 
-        mIndexBindings.TextureBufferOffset = mTextures.GetTextures().size();
-        mTextures.GetTextures().reserve(mGltfModel.textures.size());
+        mGeo.GetMeshes().reserve(mGeo.GetMeshes().size() + mMeshes.size());
+        for(auto& mesh : mMeshes)
+        {
+            mGeo.GetMeshes().push_back(std::move(mesh));
+        }
+        mMeshes.clear();
+        if(mGeometryBufferSet)
+        {
+            mGeo.GetBufferSets().push_back(std::move(mGeometryBufferSet));
+        }
 
-        mGeo.GetMeshes().reserve(mGltfModel.meshes.size());
-        mIndexBindings.Meshes.resize(mGltfModel.meshes.size());
         std::vector<Node*> nodesWithMeshInstances{};
         mScene->FindNodesWithComponent<MeshInstance>(nodesWithMeshInstances);
         mNextMeshInstanceIndex = 0;
@@ -75,81 +300,123 @@ namespace hsk {
             mNextMeshInstanceIndex++;
         }
 
-
-        if(sceneSelect)
-        {
-            mGltfScene = &(mGltfModel.scenes[sceneSelect(mGltfModel)]);
-        }
-        else
-        {
-            mGltfScene = &(mGltfModel.scenes[mGltfModel.defaultScene]);
-        }
-
-        logger()->info("Model Load: Building vertex and index buffers ...");
-
-        BuildGeometryBuffer();
-
-        logger()->info("Model Load: Uploading textures ...");
-
-        LoadTextures();
-
         logger()->info("Model Load: Uploading materials ...");
 
         LoadMaterials();
 
         logger()->info("Model Load: Initialising scene state ...");
 
-        for(int32_t nodeIndex : mGltfScene->nodes)
-        {
-            RecursivelyTranslateNodes(nodeIndex, nullptr);
-        }
-
-        logger()->info("Model Load: Loading Animations ...");
+        PrepareSkins();
+        AttachNodes();
 
-        LoadAnimations();
+        logger()->info("Model Load: Loading Skins ...");
 
-        InitialUpdate();
+        LoadSkins();
 
-        Reset();
+        logger()->info("Model Load: Loading Animations ...");
 
-        logger()->info("Model Load: Done");
+        LoadAnimations();
     }
 
-    void ModelConverter::RecursivelyTranslateNodes(int32_t currentIndex, Node* parent)
+    void ModelConverter::RecursivelyTranslateNodes(int32_t gltfIndex, int32_t parentRecord, std::vector<int32_t>& gltfToRecord)
     {
-        Node*& node = mIndexBindings.Nodes[currentIndex];
-
-        if(node)
+        if(gltfToRecord[gltfIndex] >= 0)
         {
             return;
         }
 
-        auto& gltfNode = mGltfModel.nodes[currentIndex];
-        node           = mScene->MakeNode(parent);
+        auto&   gltfNode    = mGltfModel.nodes[gltfIndex];
+        int32_t recordIndex = (int32_t)mRecords.Nodes.size();
 
-        if(!parent)
-        {
-            mScene->GetRootNodes().push_back(node);
-        }
+        gltfToRecord[gltfIndex] = recordIndex;
 
-        InitTransformFromGltf(node->GetTransform(), gltfNode.matrix, gltfNode.translation, gltfNode.rotation, gltfNode.scale);
+        NodeRecord node{.Parent = parentRecord, .Mesh = gltfNode.mesh, .Skin = gltfNode.skin};
+        InitTransformFromGltf(node, gltfNode.matrix, gltfNode.translation, gltfNode.rotation, gltfNode.scale);
+        node.Weights.assign(gltfNode.weights.begin(), gltfNode.weights.end());
+        TranslateGpuInstances(gltfIndex, node);
+        mRecords.Nodes.push_back(std::move(node));
 
-        if(gltfNode.mesh >= 0)
+        for(int32_t childIndex : gltfNode.children)
         {
-            auto meshInstance = node->MakeComponent<MeshInstance>();
-            meshInstance->SetMesh(mIndexBindings.Meshes[gltfNode.mesh]);
-            meshInstance->SetInstanceIndex(mNextMeshInstanceIndex);
-            mNextMeshInstanceIndex++;
+            RecursivelyTranslateNodes(childIndex, recordIndex, gltfToRecord);
         }
+    }
 
-        for(int32_t childIndex : gltfNode.children)
+    void ModelConverter::AttachNodes()
+    {
+        InstanceBuffer* instanceBuffer = mScene->GetComponent<InstanceBuffer>();
+        mIndexBindings.Nodes.resize(mRecords.Nodes.size());
+        for(size_t i = 0; i < mRecords.Nodes.size(); i++)
         {
-            RecursivelyTranslateNodes(childIndex, node);
+            const NodeRecord& record = mRecords.Nodes[i];
+            Node*             parent = record.Parent >= 0 ? mIndexBindings.Nodes[record.Parent] : nullptr;
+            Node*             node   = mScene->MakeNode(parent);
+            mIndexBindings.Nodes[i]  = node;
+
+            if(!parent)
+            {
+                mScene->GetRootNodes().push_back(node);
+            }
+
+            Transform* transform = node->GetTransform();
+            transform->SetTranslation(record.Translation);
+            transform->SetRotation(record.Rotation);
+            transform->SetScale(record.Scale);
+            transform->SetLocalMatrix(record.LocalMatrix);
+            transform->SetStatic(record.Static);
+
+            if(record.Mesh >= 0)
+            {
+                Mesh*         mesh         = mIndexBindings.Meshes[record.Mesh];
+                MeshInstance* meshInstance = nullptr;
+                bool          deformed     = (record.Skin >= 0 && mesh->GetBuffer()->GetSkinData().Exists()) || mesh->GetMorphTargets();
+                if(record.Instances.size() && deformed)
+                {
+                    // Deformation is applied per node, so these are drawn once at the node's transform (the fallback of a viewer not supporting the extension)
+                    logger()->warn("Model Load: Node record #{} is instanced, but its mesh is skinned or morphed. Drawing a single instance.", i);
+                }
+                // Device resources of skinned and morphed instances are created by SkinningStage, which picks up new components in its next RecordFrame()
+                if(record.Skin >= 0 && mesh->GetBuffer()->GetSkinData().Exists())
+                {
+                    auto skinnedMeshInstance = node->MakeComponent<SkinnedMeshInstance>();
+                    skinnedMeshInstance->SetSkin(mIndexBindings.Skins[record.Skin]);
+                    meshInstance = skinnedMeshInstance;
+                }
+                else if(mesh->GetMorphTargets())
+                {
+                    meshInstance = node->MakeComponent<MorphedMeshInstance>();
+                }
+                else if(record.Instances.size())
+                {
+                    auto instancedMeshInstance = node->MakeComponent<InstancedMeshInstance>();
+                    instancedMeshInstance->SetFirstInstance(instanceBuffer->AddInstances(record.Instances.data(), record.Instances.size()));
+                    instancedMeshInstance->SetInstanceCount((uint32_t)record.Instances.size());
+                    meshInstance = instancedMeshInstance;
+                }
+                else
+                {
+                    meshInstance = node->MakeComponent<MeshInstance>();
+                }
+                meshInstance->SetMesh(mesh);
+                meshInstance->SetInstanceIndex(mNextMeshInstanceIndex);
+                mNextMeshInstanceIndex++;
+
+                if(mesh->GetMorphTargets())
+                {
+                    // Node weights override mesh weights (https://www.khronos.org/registry/glTF/specs/2.0/glTF-2.0.html#morph-targets)
+                    auto& weights = meshInstance->GetMorphWeights();
+                    weights       = mesh->GetMorphTargets()->GetDefaultWeights();
+                    for(size_t j = 0; j < std::min(weights.size(), record.Weights.size()); j++)
+                    {
+                        weights[j] = record.Weights[j];
+                    }
+                }
+            }
         }
     }
 
     void ModelConverter::InitTransformFromGltf(
-        Transform* transform, const std::vector<double>& matrix, const std::vector<double>& translation, const std::vector<double>& rotation, const std::vector<double>& scale)
+        NodeRecord& node, const std::vector<double>& matrix, const std::vector<double>& translation, const std::vector<double>& rotation, const std::vector<double>& scale)
     {
         if(matrix.size() > 0)
         {
@@ -164,10 +431,9 @@ namespace hsk {
             // GLM and gltf::node.matrix both are column major, so this is valid:
             // https://www.khronos.org/registry/glTF/specs/2.0/glTF-2.0.html#_node_matrix
 
-            auto& transformMatrix = transform->GetLocalMatrix();
             for(int32_t i = 0; i < 16; i++)
             {
-                transformMatrix[i / 4][i % 4] = (float)matrix[i];
+                node.LocalMatrix[i / 4][i % 4] = (float)matrix[i];
             }
         }
         if(translation.size() > 0)
@@ -176,10 +442,9 @@ namespace hsk {
 
             // https://www.khronos.org/registry/glTF/specs/2.0/glTF-2.0.html#_node_translation
 
-            auto& transformTranslation = transform->GetTranslation();
             for(int32_t i = 0; i < 3; i++)
             {
-                transformTranslation[i] = (float)translation[i];
+                node.Translation[i] = (float)translation[i];
             }
         }
         if(rotation.size() > 0)
@@ -188,10 +453,9 @@ namespace hsk {
 
             // https://www.khronos.org/registry/glTF/specs/2.0/glTF-2.0.html#_node_rotation
 
-            auto& transformRotation = transform->GetRotation();
             for(int32_t i = 0; i < 4; i++)
             {
-                transformRotation[i] = (float)rotation[i];
+                node.Rotation[i] = (float)rotation[i];
             }
         }
         if(scale.size() > 0)
@@ -200,16 +464,15 @@ namespace hsk {
 
             // https://www.khronos.org/registry/glTF/specs/2.0/glTF-2.0.html#_node_scale
 
-            auto& transformScale = transform->GetScale();
             for(int32_t i = 0; i < 3; i++)
             {
-                transformScale[i] = (float)scale[i];
+                node.Scale[i] = (float)scale[i];
             }
         }
         if(!translation.size() && !scale.size() && !rotation.size())
         {
             // Set it static so that the local transform never is updated
-            transform->SetStatic(true);
+            node.Static = true;
         }
     }
 
@@ -221,15 +484,30 @@ namespace hsk {
         }
 
         mMaterialBuffer.UpdateDeviceLocal();
+        mScene->GetComponent<InstanceBuffer>()->UpdateDeviceLocal();
     }
 
     void ModelConverter::Reset()
     {
+        // Submits commands still pending (e.g. after a failed load) before their resources are released
+        mUploads.Cleanup();
+        ReleaseSourceData();
         mGltfScene             = nullptr;
         mGltfModel             = tinygltf::Model();
         mIndexBindings         = {};
         mNextMeshInstanceIndex = 0;
         mVertexBuffer.clear();
         mIndexBuffer.clear();
+        mSkinDataBuffer.clear();
+        mMeshletBuffer.Clear();
+        mDecodedImages.clear();
+        mDecodedImageCount = 0;
+        mMeshes.clear();
+        mGeometryBufferSet = nullptr;
+        mLoadedTextures.clear();
+        mLoadedTextureHashes.clear();
+        mLoadedImages.clear();
+        mDeduplicatedImageCount = 0;
+        mRecords                = {};
     }
 }  // namespace hsk
\ No newline at end of file
@@ -3,44 +3,282 @@
 #include "../scenegraph/hsk_scene.hpp"
 #include "../scenegraph/hsk_scenegraph_declares.hpp"
 #include "../scenegraph/hsk_animation.hpp"
+#include "../scenegraph/hsk_material.hpp"
+#include "../memory/hsk_managedbuffer.hpp"
+#include "../imageprocessing/hsk_ktx2.hpp"
+#include "../imageprocessing/hsk_texturecooker.hpp"
+#include "../memory/hsk_uploadbatch.hpp"
+#include "../meshprocessing/hsk_meshoptimizer.hpp"
+#include "../scenegraph/globalcomponents/hsk_geometrystore.hpp"
+#include "../scenegraph/globalcomponents/hsk_instancebuffer.hpp"
+#include "../scenegraph/globalcomponents/hsk_texturestore.hpp"
+#include "../utility/hsk_mappedfile.hpp"
+#include "hsk_accessorconverter.hpp"
+#include <atomic>
+#include <chrono>
 #include <map>
+#include <mutex>
 #include <set>
+#include <string_view>
+#include <unordered_map>
 #include <tinygltf/tiny_gltf.h>
 
 namespace hsk {
+    class ThreadPool;
+    class AsyncModelLoad;
+    class MultiModelLoad;
+
     class ModelConverter : public NoMoveDefaults
     {
       public:
+        /// @brief Import options
+        struct Config
+        {
+            /// @brief If set, tinygltf only loads the encoded images. All images are decoded afterwards in parallel, straight into per image staging buffers.
+            bool ParallelImageDecoding = true;
+            /// @brief Pool used for parallel import work. nullptr selects ThreadPool::Default()
+            ThreadPool* Workers = nullptr;
+            /// @brief Reorders the triangles of indexed triangle list primitives for post-transform vertex cache efficiency
+            bool OptimizeVertexCache = true;
+            /// @brief Additionally reorders triangle clusters to reduce overdraw, trading at most OverdrawThreshold of vertex cache efficiency
+            bool  OptimizeOverdraw  = false;
+            float OverdrawThreshold = 1.05f;
+            /// @brief Stores the vertices of indexed triangle list primitives in order of first use
+            bool OptimizeVertexFetch = true;
+            /// @brief Merges bytewise identical vertices of non-indexed primitives (without morph targets), turning them into indexed primitives
+            bool WeldVertices = true;
+            /// @brief Layout of the vertex buffer. Stages drawing the scene must be configured with the same layout (e.g. GBufferStage::SetVertexLayout())
+            EVertexLayout VertexLayout = EVertexLayout::Full;
+            /// @brief Sub-allocates vertices and indices from the GeometryStore's shared arena instead of creating buffers per model, so consecutive meshes
+            /// of different models draw without rebinding. Models with skinned geometry always get dedicated buffers.
+            bool UseGeometryArena = true;
+            /// @brief Splits indexed triangle list primitives into meshlets with bounds and normal cones (see GeometryBufferSet::GetMeshlets())
+            bool     BuildMeshlets       = false;
+            uint32_t MeshletMaxVertices  = 64;
+            uint32_t MeshletMaxTriangles = 124;
+            /// @brief If set, PNG / JPEG images are cooked on the worker pool to block compressed formats with a complete mip chain (normal maps to BC5)
+            /// and cached as KTX2 files in this directory. Later loads of the same image read the cache instead of decoding. Requires ParallelImageDecoding.
+            std::string TextureCacheDirectory = {};
+            /// @brief Cook color and data textures to BC7. Otherwise (or if BC7 is unsupported) BC1 is used for opaque images, BC3 for images with alpha.
+            bool CookToBC7 = true;
+            /// @brief If set, the converted model (geometry, materials, nodes, skins, animations and decoded textures) is cached in this directory, keyed by the
+            /// content of the source files and the import options. Later loads map the cache file instead of parsing and converting. Requires ParallelImageDecoding.
+            /// @remark Not used for loads with a scene selection callback, the callback requires the parsed model.
+            std::string ImportCacheDirectory = {};
+        };
+
+        /// @brief Wall time and data volume of the phases of the last LoadGltfModel() call
+        struct LoadStats
+        {
+            /// @brief Phase wall times in milliseconds. Phases skipped by an import cache hit stay 0.
+            double ReadImportCacheMs  = 0.0;
+            double ParseMs            = 0.0;
+            double BuildGeometryMs    = 0.0;
+            double DecodeImagesMs     = 0.0;
+            double TranslateSceneMs   = 0.0;
+            double WriteImportCacheMs = 0.0;
+            double UploadGeometryMs   = 0.0;
+            /// @brief Recording texture uploads, including the mip map generation commands
+            double UploadTexturesMs = 0.0;
+            /// @brief Submitting the upload batch and waiting for the GPU to finish all copies and mip map blits
+            double SubmitMs         = 0.0;
+            double AttachToSceneMs  = 0.0;
+            double TotalMs          = 0.0;
+            bool   ImportCacheHit   = false;
+            /// @brief Size of the model file and all external buffers it references (size of the cache file on an import cache hit)
+            uint64_t SourceBytes = 0;
+            /// @brief Size of all encoded images (PNG, JPEG, KTX2) handled by DecodeImages()
+            uint64_t EncodedImageBytes = 0;
+            uint64_t VertexCount       = 0;
+            uint64_t IndexCount        = 0;
+            /// @brief Bytes copied from staging to device memory
+            uint64_t UploadedBytes = 0;
+            /// @brief Number of queue submits of the upload batch
+            uint32_t SubmitCount = 0;
+        };
+
+        /// @brief Part of every import cache key. Increment whenever the converted result or the cache file layout changes.
+        static const uint32_t IMPORT_CACHE_VERSION = 3;
+
         explicit ModelConverter(Scene* scene);
 
-        void LoadGltfModel(std::string utf8Path, const VkContext* context = nullptr, std::function<int32_t(tinygltf::Model)> sceneSelect = nullptr);
+        void LoadGltfModel(std::string utf8Path, const VkContext* context = nullptr, std::function<int32_t(const tinygltf::Model&)> sceneSelect = nullptr);
+
+        /// @brief Number of textures of the model currently loaded (valid after TranslateScene() or reading the import cache)
+        size_t GetTextureCount() const { return mRecords.Textures.size(); }
+        /// @brief Number of images of the model currently loaded (valid after parsing or reading the import cache)
+        size_t GetImageCount() const { return mDecodedImages.size(); }
+        /// @brief Number of images decoded by DecodeImages() so far. Safe to read from any thread.
+        uint32_t GetDecodedImageCount() const { return mDecodedImageCount.load(); }
 
         HSK_PROPERTY_ALL(Scene)
+        HSK_PROPERTY_ALL(Config)
+        /// @brief Vertex cache statistics of all optimized primitives of the last load, before optimization
+        HSK_PROPERTY_CGET(VertexCacheStatsBefore)
+        /// @brief Vertex cache statistics of all optimized primitives of the last load, after optimization
+        HSK_PROPERTY_CGET(VertexCacheStatsAfter)
+        /// @brief Phase timings and data volume of the last LoadGltfModel() call
+        HSK_PROPERTY_CGET(LoadStats)
+        /// @brief TextureStore indices of the textures of the model attached last. Each holds a reference, pass them to TextureStore::ReleaseTextures()
+        /// when the model is unloaded.
+        HSK_PROPERTY_CGET(AttachedTextures)
+
+        friend AsyncModelLoad;
+        friend MultiModelLoad;
 
       protected:
         const VkContext* mContext = nullptr;
+        Config           mConfig  = {};
 
         // Tinygltf stuff
 
         tinygltf::Model  mGltfModel = {};
         tinygltf::Scene* mGltfScene = nullptr;
+        /// @brief Mapping of the source file (.glb files only). Kept until TranslateScene() is done.
+        MappedFile mSourceFile;
+        /// @brief Binary chunk of the mapped .glb file
+        GltfBufferData mGlbBinaryChunk = {};
+        /// @brief Contents of every gltf buffer, indexed by buffer index. Buffers stored in the binary chunk of a .glb file reference the mapping.
+        std::vector<GltfBufferData> mGltfBuffers = {};
+        /// @brief Contents of buffer views compressed with EXT_meshopt_compression, referenced by the entries of mGltfBuffers following the gltf buffers
+        std::vector<std::vector<uint8_t>> mDecompressedBuffers = {};
+        /// @brief Encoded images referencing the mapping instead of tinygltf::Image::image, indexed by gltf image index (Data is nullptr for other images)
+        std::vector<GltfBufferData> mMappedImages = {};
 
         // Temporary structures
 
         std::vector<Vertex>   mVertexBuffer = {};
         std::vector<uint32_t> mIndexBuffer  = {};
+        /// @brief Parallel to mVertexBuffer. Stays empty unless any primitive has JOINTS_0 and WEIGHTS_0 attributes
+        std::vector<VertexSkinData> mSkinDataBuffer = {};
+        /// @brief Per primitive of the mesh currently processed: Vertex order applied by OptimizePrimitive() (remap[gltf vertex index] = primitive local vertex index). Empty if unchanged.
+        std::vector<std::vector<uint32_t>> mPrimitiveVertexRemaps = {};
+        /// @brief Per primitive of the mesh currently processed: First vertex in mVertexBuffer
+        std::vector<uint32_t> mPrimitiveVertexStarts = {};
+        /// @brief Meshlets of all primitives, moved to the buffer set by UploadGeometry()
+        MeshletBuffer mMeshletBuffer = {};
+
+        VertexCacheStats mVertexCacheStatsBefore = {};
+        VertexCacheStats mVertexCacheStatsAfter  = {};
+        LoadStats        mLoadStats              = {};
+
+        /// @brief All device uploads of a model load are recorded into this batch
+        UploadBatch mUploads;
+
+        /// @brief Pixels of an image decoded by DecodeImages(): RGBA8 for PNG/JPEG, the file's or the transcoded format for KTX2
+        struct DecodedImage
+        {
+            /// @brief Staging memory allocated from mUploads. Staging.Mapped is nullptr if the image was not decoded
+            UploadBatch::StagingRange Staging = {};
+            int32_t                   Width   = 0;
+            int32_t                   Height  = 0;
+            VkFormat                  Format  = VK_FORMAT_R8G8B8A8_UNORM;
+            /// @brief One copy per mip level present in staging memory, bufferOffset relative to the staging range
+            std::vector<VkBufferImageCopy> Levels = {};
+            /// @brief If set, the mip chain below the first level is generated by blits after upload
+            bool GenerateMips = true;
+            /// @brief If set, the image is cooked (or read from the texture cache) instead of being decoded to RGBA8
+            bool          Cook  = false;
+            ETextureUsage Usage = ETextureUsage::Color;
+            /// @brief Valid for KTX2 images only
+            Ktx2Texture Ktx2 = {};
+            /// @brief Hash of the uploaded content (see ComputeImageHashSeed()), set once decoded
+            uint64_t ContentHash = 0;
+        };
+        /// @brief Indexed by gltf image index. Holds all images kept encoded by tinygltf (KTX2 images, and all images if decoding in parallel)
+        std::vector<DecodedImage> mDecodedImages     = {};
+        std::atomic<uint32_t>     mDecodedImageCount = 0;
+
+        // Resources created before the model is attached to the scene
+
+        /// @brief Meshes built by BuildGeometry(), moved to the GeometryStore by AttachToScene()
+        std::vector<std::unique_ptr<Mesh>> mMeshes = {};
+        /// @brief Buffer set created by UploadGeometry(), moved to the GeometryStore by AttachToScene()
+        std::unique_ptr<GeometryBufferSet> mGeometryBufferSet = {};
+        /// @brief Textures created by UploadTexture(), indexed by gltf texture index. Added to the TextureStore by AttachToScene()
+        std::vector<SampledTexture> mLoadedTextures = {};
+        /// @brief Content hash of every texture in mLoadedTextures
+        std::vector<uint64_t> mLoadedTextureHashes = {};
+        /// @brief Images created by UploadTexture() by content hash, so textures with identical images of this model share one upload
+        std::unordered_map<uint64_t, std::shared_ptr<ManagedImage>> mLoadedImages = {};
+        /// @brief Number of textures which reused an image of this model or the TextureStore instead of uploading their own
+        uint32_t mDeduplicatedImageCount = 0;
+
+        /// @brief Images uploaded by a group of converters loading concurrently, by content hash. Images are registered once their upload has been recorded.
+        struct SharedImageRegistry
+        {
+            std::mutex                                                  Mutex;
+            std::unordered_map<uint64_t, std::shared_ptr<ManagedImage>> Images;
+        };
+        /// @brief If set, UploadTexture() also reuses images of the other converters of the group. Set by MultiModelLoad, which completes all uploads
+        /// of the group before attaching any model.
+        SharedImageRegistry* mSharedImages = nullptr;
+
+        /// @brief Texture of the model: Image (gltf image index) and sampler
+        struct TextureRecord
+        {
+            std::string         Name       = {};
+            int32_t             ImageIndex = -1;
+            VkSamplerCreateInfo SamplerCI  = {};
+        };
+        /// @brief Node of the selected scene. Parents precede their children.
+        struct NodeRecord
+        {
+            /// @brief Record index of the parent node, -1 for root nodes
+            int32_t   Parent      = -1;
+            glm::vec3 Translation = {};
+            glm::quat Rotation    = {};
+            glm::vec3 Scale       = glm::vec3(1.f);
+            glm::mat4 LocalMatrix = glm::mat4(1.f);
+            bool      Static      = false;
+            /// @brief gltf mesh index, -1 if the node has no mesh
+            int32_t Mesh = -1;
+            /// @brief gltf skin index, -1 if the node is not skinned
+            int32_t Skin = -1;
+            /// @brief Morph target weights overriding the mesh's default weights
+            std::vector<float> Weights = {};
+            /// @brief Transforms of the copies of the mesh drawn relative to the node (EXT_mesh_gpu_instancing), empty if the node is not instanced
+            std::vector<InstanceTransform> Instances = {};
+        };
+        struct SkinRecord
+        {
+            std::string Name = {};
+            /// @brief Record index of every joint node, -1 for joints not part of the selected scene
+            std::vector<int32_t>   Joints              = {};
+            int32_t                SkeletonRoot        = -1;
+            std::vector<glm::mat4> InverseBindMatrices = {};
+        };
+        struct AnimationRecord
+        {
+            /// @brief Channel targets are not set
+            hsk::Animation Animation = {};
+            /// @brief Record index of the target node of every channel, -1 for nodes not part of the selected scene
+            std::vector<int32_t> ChannelTargets = {};
+        };
+        /// @brief Scene independent description of the model, created from the parsed model by TranslateScene() or read from the import cache, attached by AttachToScene()
+        struct Records
+        {
+            /// @brief Texture indices refer to Textures
+            std::vector<MaterialBufferEntry> Materials  = {};
+            std::vector<TextureRecord>       Textures   = {};
+            std::vector<NodeRecord>          Nodes      = {};
+            std::vector<SkinRecord>          Skins      = {};
+            std::vector<AnimationRecord>     Animations = {};
+        } mRecords = {};
 
         /// @brief Variables which determine how to map gltf-model indices to scene indices/pointers
         struct IndexBindings
         {
-            /// @brief Offset for translating gltfModel node index -> scene node buffer index
+            /// @brief Vector mapping node record index -> scene node
             std::vector<Node*> Nodes;
             /// @brief Offset for translating gltfModel material index -> scene material buffer index
             int32_t MaterialBufferOffset;
             /// @brief Vector mapping gltfModel mesh index to Mesh*
             std::vector<Mesh*> Meshes;
-            /// @brief Vector mapping gltfModel texture index to ManagedImage*
-            int32_t TextureBufferOffset;
+            /// @brief Vector mapping gltfModel texture index to TextureStore texture index
+            std::vector<int32_t> Textures;
+            /// @brief Vector mapping gltfModel skin index to Skin*
+            std::vector<Skin*> Skins;
         } mIndexBindings = {};
 
 
@@ -48,25 +286,109 @@ namespace hsk {
 
         // Result structures
 
+        /// @brief TextureStore indices of the model attached last, indexed by gltf texture index. Kept after Reset().
+        std::vector<int32_t> mAttachedTextures = {};
+
         Scene* mScene = nullptr;
 
         MaterialBuffer& mMaterialBuffer;
         GeometryStore&  mGeo;
         TextureStore&   mTextures;
 
-        void RecursivelyTranslateNodes(int32_t currentIndex, Node* parent = nullptr);
+        // Load phases. ParseFile(), BuildGeometry() and DecodeImages() don't touch the scene and may run on a worker thread. UploadGeometry() and
+        // LoadTextures() only use the thread safe reservation functions of the scene's stores. All other phases must be run on the thread owning the scene.
 
-        // void LoadMesh
+        void ParseFile(const std::string& utf8Path, const std::function<int32_t(const tinygltf::Model&)>& sceneSelect);
+        /// @brief Replaces tinygltf's copy of the .glb binary chunk by views into the mapping and fills mGltfBuffers
+        void ResolveBuffers();
+        /// @brief Replaces fallback buffers of EXT_meshopt_compression in the gltf JSON by a placeholder, tinygltf refuses to load them
+        /// @param outpatched Receives the modified JSON
+        /// @return False if json has no fallback buffers (outpatched unchanged)
+        static bool PatchCompressionFallbacks(std::string_view json, std::string& outpatched);
+        /// @brief Decodes all buffer views compressed with EXT_meshopt_compression on the worker pool and redirects them to the decoded data
+        /// @remark Meshes compressed with KHR_draco_mesh_compression are read from their uncompressed fallback attributes. Throws if Draco is required.
+        void DecompressBufferViews();
+        /// @brief Translates materials, textures, nodes, skins and animations of the parsed model into mRecords, then releases the source data
+        void TranslateScene();
+        /// @brief Frees buffer contents and unmaps the source file. Everything needed for upload and scene creation has been converted at this point.
+        void ReleaseSourceData();
+        void UploadGeometry();
+        /// @brief Runs all phases up to recording the uploads of geometry and textures into mUploads, timing them in mLoadStats
+        /// @remark Only touches the scene's stores through their thread safe reservation functions, so converters of the same scene may run this concurrently
+        /// (with dedicated command pools, see UploadBatch::Create())
+        void ConvertAndRecordUploads(const std::string& utf8Path, const std::function<int32_t(const tinygltf::Model&)>& sceneSelect);
+        /// @brief Moves all resources into the scene's stores and creates nodes, skins and animations. Follow up with InitialUpdate().
+        void AttachToScene();
+
+        /// @param gltfToRecord Maps gltf node index to node record index, -1 for nodes not translated yet
+        void RecursivelyTranslateNodes(int32_t gltfIndex, int32_t parentRecord, std::vector<int32_t>& gltfToRecord);
+        /// @brief Creates the scene nodes of all node records
+        void AttachNodes();
+        /// @brief Reads the per instance transforms of a node using EXT_mesh_gpu_instancing into node.Instances
+        void TranslateGpuInstances(int32_t gltfIndex, NodeRecord& node);
 
         void InitTransformFromGltf(
-            Transform* transform, const std::vector<double>& matrix, const std::vector<double>& translation, const std::vector<double>& rotation, const std::vector<double>& scale);
+            NodeRecord& node, const std::vector<double>& matrix, const std::vector<double>& translation, const std::vector<double>& rotation, const std::vector<double>& scale);
 
-        void BuildGeometryBuffer();
+        void BuildGeometry();
         void PushGltfMeshToBuffers(const tinygltf::Mesh& mesh, std::vector<Primitive>& outprimitives);
+        void PushGltfSkinDataToBuffer(const tinygltf::Primitive& gltfPrimitive, uint32_t vertexStart, int32_t vertexCount);
+        /// @brief Applies the configured index and vertex order optimizations to a triangle list primitive
+        /// @param indices Primitive local indices
+        /// @param outremap Receives the applied vertex order (empty if unchanged)
+        void OptimizePrimitive(std::vector<uint32_t>& indices, uint32_t vertexStart, uint32_t vertexCount, std::vector<uint32_t>& outremap);
+        /// @brief Merges identical vertices (including skin data) of the primitive starting at vertexStart, which must be the last primitive pushed
+        /// @param vertexCount Updated to the number of unique vertices
+        /// @param outindices Receives one primitive local index per original vertex
+        /// @return False if all vertices are unique (buffers and outindices unchanged)
+        bool WeldPrimitive(uint32_t vertexStart, int32_t& vertexCount, std::vector<uint32_t>& outindices);
+
+        void LoadMorphTargets(const tinygltf::Mesh& gltfMesh, Mesh* mesh);
+        /// @brief Reads a float vec3 accessor, resolving sparse storage
+        void ReadAccessorVec3(int32_t accessorIndex, std::vector<glm::vec3>& out);
 
+        void TranslateSkins(const std::vector<int32_t>& gltfToRecord);
+        void PrepareSkins();
+        void LoadSkins();
+
+        /// @brief tinygltf image loader callback storing the encoded image instead of decoding it (always for KTX2 images, for all images with ParallelImageDecoding)
+        /// @param userData The ModelConverter
+        static bool DeferImageDecoding(tinygltf::Image*     image,
+                                       const int            imageIndex,
+                                       std::string*         error,
+                                       std::string*         warning,
+                                       int                  requestedWidth,
+                                       int                  requestedHeight,
+                                       const unsigned char* bytes,
+                                       int                  size,
+                                       void*                userData);
+        /// @brief Encoded data of an image kept by DeferImageDecoding()
+        GltfBufferData GetEncodedImage(int32_t imageIndex) const;
+        /// @brief Decodes / transcodes all images kept encoded by tinygltf into staging memory on the worker pool
+        void DecodeImages();
+        /// @brief Chooses the upload format of a KTX2 image
+        /// @return False if the image can not be used on this device (unsupported format, missing transcoder)
+        bool SelectKtx2Format(int32_t imageIndex, DecodedImage& decoded);
+        /// @brief Format PNG / JPEG images are cooked to. VK_FORMAT_UNDEFINED if the device supports none of the candidates.
+        VkFormat SelectCookedFormat(ETextureUsage usage, bool hasAlpha) const;
+        /// @brief Derives the usage of every image from the material slots referencing it
+        void GetImageUsages(std::vector<ETextureUsage>& outusages) const;
+        /// @brief Checks the optimal tiling features of a format
+        bool HasFormatFeatures(VkFormat format, VkFormatFeatureFlags features) const;
+        /// @brief Image used for a texture: The KHR_texture_basisu source if it could be decoded, the regular source otherwise
+        int32_t GetTextureImageIndex(int32_t textureIndex) const;
         void LoadTextures();
+        void UploadTexture(int32_t textureIndex);
+        /// @brief Creates an image and records its upload (and mip map generation) into mUploads
+        /// @param decoded Staging memory holding the image, or nullptr to upload from buffer
+        void UploadImage(ManagedImage& image, const std::string& name, const DecodedImage* decoded, const unsigned char* buffer, VkDeviceSize bufferSize, VkExtent2D extent);
+        /// @brief Seed for content hashes of images, so identical bytes of different format or size never compare equal
+        static uint64_t ComputeImageHashSeed(VkFormat format, uint32_t width, uint32_t height, uint32_t levelCount);
+        void TranslateTextures();
         void TranslateSampler(const tinygltf::Sampler& tinygltfSampler, VkSamplerCreateInfo& outsamplerCI);
+        void TranslateMaterials();
         void LoadMaterials();
+        void TranslateAnimations(const std::vector<int32_t>& gltfToRecord);
         void LoadAnimations();
         void TranslateAnimationSampler(Animation&                                                 animation,
                                        const tinygltf::Animation&                                 gltfAnimation,
@@ -74,8 +396,31 @@ namespace hsk {
                                        const std::map<std::string_view, EAnimationInterpolation>& interpolationMap,
                                        std::map<int, int>&                                        samplerIndexMap);
 
+        /// @brief Updates the global matrices of all root nodes and the device local material and instance buffers. Once suffices after attaching several models.
         void InitialUpdate();
 
+        /// @brief Runs phase and stores its wall time in milliseconds in outms
+        template <typename TPhase>
+        static void MeasurePhase(double& outms, TPhase&& phase);
+
+        /// @brief Checks if the import cache may be used for a load
+        bool UseImportCache(const std::function<int32_t(const tinygltf::Model&)>& sceneSelect) const;
+        /// @brief Replaces ParseFile(), BuildGeometry(), DecodeImages() and TranslateScene() by reading the import cache
+        /// @return False if there is no valid cache entry for the file (the converter state is reset)
+        bool ReadImportCache(const std::string& utf8Path);
+        /// @brief Writes the import cache entry of the model converted by ParseFile(), BuildGeometry(), DecodeImages() and TranslateScene(). Failures are logged only.
+        void WriteImportCache(const std::string& utf8Path);
+        /// @brief Hash of the import options changing the converted result
+        uint64_t ComputeImportSettingsHash() const;
+
         void Reset();
     };
+
+    template <typename TPhase>
+    void ModelConverter::MeasurePhase(double& outms, TPhase&& phase)
+    {
+        auto start = std::chrono::steady_clock::now();
+        phase();
+        outms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
 }  // namespace hsk
\ No newline at end of file
@@ -4,28 +4,24 @@
 #include <spdlog/fmt/fmt.h>
 
 namespace hsk {
-    void ModelConverter::LoadAnimations()
+    void ModelConverter::TranslateAnimations(const std::vector<int32_t>& gltfToRecord)
     {
-        AnimationDirector* animDirector = mScene->GetComponent<AnimationDirector>();
-
         std::map<std::string_view, EAnimationInterpolation> interpolationMap = {
             {"LINEAR", EAnimationInterpolation::Linear}, {"STEP", EAnimationInterpolation::Step}, {"CUBICSPLINE", EAnimationInterpolation::Cubicspline}};
 
 
         std::map<std::string_view, EAnimationTargetPath> targetMap = {
-            {"translation", EAnimationTargetPath::Translation}, {"rotation", EAnimationTargetPath::Rotation}, {"scale", EAnimationTargetPath::Scale}};
+            {"translation", EAnimationTargetPath::Translation}, {"rotation", EAnimationTargetPath::Rotation}, {"scale", EAnimationTargetPath::Scale},
+            {"weights", EAnimationTargetPath::Weights}};
 
         auto interpolationNoMatch = interpolationMap.end();
         auto targetNoMatch        = targetMap.end();
 
-        if(mGltfModel.animations.size() && !animDirector)
-        {
-            animDirector = mScene->MakeComponent<AnimationDirector>();
-        }
         for(int32_t i = 0; i < mGltfModel.animations.size(); i++)
         {
-            Animation animation;
-            auto&     gltfAnimation = mGltfModel.animations[i];
+            AnimationRecord record;
+            Animation&      animation     = record.Animation;
+            auto&           gltfAnimation = mGltfModel.animations[i];
             animation.SetName(gltfAnimation.name);
             if(!animation.GetName().length())
             {
@@ -62,9 +58,11 @@ namespace hsk {
                     continue;
                 }
 
-                if(gltfChannel.target_node >= 0 || gltfChannel.target_node < mIndexBindings.Nodes.size())
+                int32_t target = -1;
+                if(gltfChannel.target_node >= 0 && gltfChannel.target_node < gltfToRecord.size())
                 {
-                    channel.Target = mIndexBindings.Nodes[gltfChannel.target_node];
+                    // Nodes outside of the selected scene are not created, channels targeting them have no effect
+                    target = gltfToRecord[gltfChannel.target_node];
                 }
                 else
                 {
@@ -87,6 +85,7 @@ namespace hsk {
                 }
 
                 animation.GetChannels().push_back(std::move(channel));
+                record.ChannelTargets.push_back(target);
             }
 
             if(!animation.GetChannels().size() || !animation.GetSamplers().size())
@@ -94,7 +93,26 @@ namespace hsk {
                 logger()->warn("Model Load: Animation \"{}\" without samplers or channels, skipping!", animation.GetName());
                 continue;
             }
-            animDirector->GetAnimations().push_back(animation);
+            mRecords.Animations.push_back(std::move(record));
+        }
+    }
+
+    void ModelConverter::LoadAnimations()
+    {
+        AnimationDirector* animDirector = mScene->GetComponent<AnimationDirector>();
+        if(mRecords.Animations.size() && !animDirector)
+        {
+            animDirector = mScene->MakeComponent<AnimationDirector>();
+        }
+        for(const AnimationRecord& record : mRecords.Animations)
+        {
+            Animation animation = record.Animation;
+            for(size_t i = 0; i < animation.GetChannels().size(); i++)
+            {
+                int32_t target                    = record.ChannelTargets[i];
+                animation.GetChannels()[i].Target = target >= 0 ? mIndexBindings.Nodes[target] : nullptr;
+            }
+            animDirector->GetAnimations().push_back(std::move(animation));
         }
     }
 
@@ -132,7 +150,7 @@ namespace hsk {
 
             const tinygltf::Accessor&   accessor   = mGltfModel.accessors[gltfSampler.input];
             const tinygltf::BufferView& bufferView = mGltfModel.bufferViews[accessor.bufferView];
-            const tinygltf::Buffer&     buffer     = mGltfModel.buffers[bufferView.buffer];
+            const GltfBufferData&       buffer     = mGltfBuffers[bufferView.buffer];
 
             if(accessor.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT)
             {
@@ -141,7 +159,7 @@ namespace hsk {
                 return;
             }
 
-            const float* buf = reinterpret_cast<const float*>(buffer.data.data() + (accessor.byteOffset + bufferView.byteOffset));
+            const float* buf = reinterpret_cast<const float*>(buffer.Data + (accessor.byteOffset + bufferView.byteOffset));
             for(size_t index = 0; index < accessor.count; index++)
             {
                 float time = buf[index];
@@ -153,6 +171,8 @@ namespace hsk {
 
         // Keyframe output values
         std::vector<glm::vec4> values;
+        // Keyframe output values of morph target weight samplers
+        std::vector<float> scalars;
 
         {  // Read keyframe property values
             if(gltfSampler.input < 0)
@@ -163,7 +183,7 @@ namespace hsk {
 
             const tinygltf::Accessor&   accessor   = mGltfModel.accessors[gltfSampler.output];
             const tinygltf::BufferView& bufferView = mGltfModel.bufferViews[accessor.bufferView];
-            const tinygltf::Buffer&     buffer     = mGltfModel.buffers[bufferView.buffer];
+            const GltfBufferData&       buffer     = mGltfBuffers[bufferView.buffer];
 
             if(accessor.componentType != TINYGLTF_COMPONENT_TYPE_FLOAT)
             {
@@ -175,7 +195,7 @@ namespace hsk {
             switch(accessor.type)
             {
                 case TINYGLTF_TYPE_VEC3: {
-                    const glm::vec3* buf = reinterpret_cast<const glm::vec3*>(buffer.data.data() + (accessor.byteOffset + bufferView.byteOffset));
+                    const glm::vec3* buf = reinterpret_cast<const glm::vec3*>(buffer.Data + (accessor.byteOffset + bufferView.byteOffset));
                     for(size_t index = 0; index < accessor.count; index++)
                     {
                         glm::vec3 value = buf[index];
@@ -184,7 +204,7 @@ namespace hsk {
                     break;
                 }
                 case TINYGLTF_TYPE_VEC4: {
-                    const glm::vec4* buf = reinterpret_cast<const glm::vec4*>(buffer.data.data() + (accessor.byteOffset + bufferView.byteOffset));
+                    const glm::vec4* buf = reinterpret_cast<const glm::vec4*>(buffer.Data + (accessor.byteOffset + bufferView.byteOffset));
                     for(size_t index = 0; index < accessor.count; index++)
                     {
                         glm::vec4 value = buf[index];
@@ -192,6 +212,11 @@ namespace hsk {
                     }
                     break;
                 }
+                case TINYGLTF_TYPE_SCALAR: {
+                    const float* buf = reinterpret_cast<const float*>(buffer.Data + (accessor.byteOffset + bufferView.byteOffset));
+                    scalars.assign(buf, buf + accessor.count);
+                    break;
+                }
                 default: {
                     logger()->warn("Model Load: In animation \"{}\", sampler #{}: Output Accessor of unrecognised type {}! Skipping sampler!", animation.GetName(), samplerIndex,
                                    accessor.type);
@@ -203,7 +228,24 @@ namespace hsk {
         { // Build Keyframes
             sampler.Keyframes.reserve(times.size());
 
-            if(interpolation->second == EAnimationInterpolation::Cubicspline)
+            if(scalars.size())
+            {
+                // Morph target weights: Output holds (x3 for cubic splines) one value per target per keyframe
+                size_t valuesPerKeyframe = sampler.Interpolation == EAnimationInterpolation::Cubicspline ? 3 : 1;
+                if(!times.size() || scalars.size() % (times.size() * valuesPerKeyframe) != 0)
+                {
+                    logger()->warn("Model Load: In animation \"{}\", sampler #{}: Output Accessor count is not a multiple of input count! Skipping sampler!", animation.GetName(),
+                                   samplerIndex);
+                    return;
+                }
+                sampler.WeightCount = static_cast<uint32_t>(scalars.size() / (times.size() * valuesPerKeyframe));
+                sampler.Weights     = std::move(scalars);
+                for(int32_t i = 0; i < times.size(); i++)
+                {
+                    sampler.Keyframes.push_back(AnimationKeyframe(times[i], glm::vec4()));
+                }
+            }
+            else if(interpolation->second == EAnimationInterpolation::Cubicspline)
             {
                 if(times.size() * 3 != values.size())
                 {
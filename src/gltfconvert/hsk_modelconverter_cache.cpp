@@ -0,0 +1,627 @@
+#include "../scenegraph/hsk_morphtargets.hpp"
+#include "../utility/hsk_hash.hpp"
+#include "../utility/hsk_mappedfile.hpp"
+#include "../utility/hsk_threadpool.hpp"
+#include "hsk_modelconverter.hpp"
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <spdlog/fmt/fmt.h>
+#include <thread>
+#include <type_traits>
+
+namespace hsk {
+    namespace {
+        const char CACHE_MAGIC[8] = {'H', 'S', 'K', 'M', 'O', 'D', 'E', 'L'};
+
+        /// @brief Sequential binary output. All values are written in host byte order, the cache is not meant to be shared between machines.
+        class CacheWriter
+        {
+          public:
+            explicit CacheWriter(std::ostream& out) : mOut(out) {}
+
+            void WriteBytes(const void* data, size_t size)
+            {
+                mOut.write(reinterpret_cast<const char*>(data), (std::streamsize)size);
+                mOffset += size;
+            }
+            template <typename T>
+            void Write(const T& value)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                WriteBytes(&value, sizeof(T));
+            }
+            template <typename T>
+            void WriteVector(const std::vector<T>& values)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                Write<uint64_t>(values.size());
+                WriteBytes(values.data(), values.size() * sizeof(T));
+            }
+            void WriteString(const std::string& value)
+            {
+                Write<uint64_t>(value.size());
+                WriteBytes(value.data(), value.size());
+            }
+            void Align(size_t alignment)
+            {
+                const uint8_t padding[16] = {};
+                WriteBytes(padding, (alignment - mOffset % alignment) % alignment);
+            }
+
+          protected:
+            std::ostream& mOut;
+            uint64_t      mOffset = 0;
+        };
+
+        /// @brief Bounds checked sequential reading of a mapped cache file. Throws on truncated or malformed data.
+        class CacheReader
+        {
+          public:
+            CacheReader(const uint8_t* data, size_t size) : mData(data), mSize(size) {}
+
+            const uint8_t* ReadBytes(size_t size)
+            {
+                if(size > mSize - mOffset)
+                {
+                    HSK_THROWFMT("Unexpected end of file reading {} bytes at offset {}", size, mOffset);
+                }
+                const uint8_t* result = mData + mOffset;
+                mOffset += size;
+                return result;
+            }
+            template <typename T>
+            T Read()
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                T value;
+                memcpy(&value, ReadBytes(sizeof(T)), sizeof(T));
+                return value;
+            }
+            template <typename T>
+            void ReadVector(std::vector<T>& outvalues)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                uint64_t count = ReadCount(sizeof(T));
+                outvalues.resize(count);
+                memcpy(outvalues.data(), ReadBytes(count * sizeof(T)), count * sizeof(T));
+            }
+            std::string ReadString()
+            {
+                uint64_t count = ReadCount(1);
+                return std::string(reinterpret_cast<const char*>(ReadBytes(count)), count);
+            }
+            /// @brief Reads an element count, validated against the remaining size so corrupt counts never cause huge allocations
+            uint64_t ReadCount(size_t elementSize)
+            {
+                uint64_t count = Read<uint64_t>();
+                if(count > (mSize - mOffset) / std::max<size_t>(elementSize, 1))
+                {
+                    HSK_THROWFMT("Element count {} at offset {} exceeds the file size", count, mOffset);
+                }
+                return count;
+            }
+            void Align(size_t alignment) { ReadBytes((alignment - mOffset % alignment) % alignment); }
+
+            inline const uint8_t* GetData() const { return mData; }
+            inline size_t         GetSize() const { return mSize; }
+            inline size_t         GetOffset() const { return mOffset; }
+
+          protected:
+            const uint8_t* mData   = nullptr;
+            size_t         mSize   = 0;
+            size_t         mOffset = 0;
+        };
+
+        /// @brief Resolves percent encoded characters of a relative uri
+        std::string DecodeUri(const std::string& uri)
+        {
+            auto lHexValue = [](char c) -> int32_t {
+                if(c >= '0' && c <= '9')
+                {
+                    return c - '0';
+                }
+                if(c >= 'a' && c <= 'f')
+                {
+                    return c - 'a' + 10;
+                }
+                if(c >= 'A' && c <= 'F')
+                {
+                    return c - 'A' + 10;
+                }
+                return -1;
+            };
+
+            std::string result;
+            result.reserve(uri.size());
+            for(size_t i = 0; i < uri.size(); i++)
+            {
+                if(uri[i] == '%' && i + 2 < uri.size() && lHexValue(uri[i + 1]) >= 0 && lHexValue(uri[i + 2]) >= 0)
+                {
+                    result.push_back((char)(lHexValue(uri[i + 1]) * 16 + lHexValue(uri[i + 2])));
+                    i += 2;
+                }
+                else
+                {
+                    result.push_back(uri[i]);
+                }
+            }
+            return result;
+        }
+
+        /// @brief External file the model was loaded from (buffers and images referenced by uri)
+        struct Dependency
+        {
+            std::string Uri  = {};
+            uint64_t    Size = 0;
+            uint64_t    Hash = 0;
+        };
+
+        /// @brief Hashes the contents of a file
+        /// @return False if the file can not be read
+        bool HashFile(const std::filesystem::path& path, uint64_t seed, uint64_t& outsize, uint64_t& outhash)
+        {
+            MappedFile file;
+            if(!file.Open(path))
+            {
+                return false;
+            }
+            outsize = file.GetSize();
+            outhash = HashBytes(file.GetData(), file.GetSize(), seed);
+            return true;
+        }
+    }  // namespace
+
+    bool ModelConverter::UseImportCache(const std::function<int32_t(const tinygltf::Model&)>& sceneSelect) const
+    {
+        return mConfig.ImportCacheDirectory.size() && mConfig.ParallelImageDecoding && !sceneSelect;
+    }
+
+    uint64_t ModelConverter::ComputeImportSettingsHash() const
+    {
+        const uint32_t settings[] = {IMPORT_CACHE_VERSION,
+                                     TextureCooker::VERSION,
+                                     (uint32_t)mConfig.OptimizeVertexCache,
+                                     (uint32_t)mConfig.OptimizeOverdraw,
+                                     std::bit_cast<uint32_t>(mConfig.OverdrawThreshold),
+                                     (uint32_t)mConfig.OptimizeVertexFetch,
+                                     (uint32_t)mConfig.WeldVertices,
+                                     (uint32_t)mConfig.BuildMeshlets,
+                                     mConfig.MeshletMaxVertices,
+                                     mConfig.MeshletMaxTriangles,
+                                     (uint32_t)!mConfig.TextureCacheDirectory.empty(),
+                                     (uint32_t)mConfig.CookToBC7};
+        return HashBytes(settings, sizeof(settings));
+    }
+
+    bool ModelConverter::ReadImportCache(const std::string& utf8Path)
+    {
+        std::filesystem::path sourcePath = utf8Path;
+        uint64_t              sourceSize = 0;
+        uint64_t              key        = 0;
+        if(!HashFile(sourcePath, ComputeImportSettingsHash(), sourceSize, key))
+        {
+            return false;
+        }
+        std::filesystem::path cachePath = std::filesystem::path(mConfig.ImportCacheDirectory) / fmt::format("{:016x}.hskmodel", key);
+
+        MappedFile cache;
+        if(!cache.Open(cachePath))
+        {
+            logger()->info("Model Load: No import cache entry for \"{}\"", utf8Path);
+            return false;
+        }
+        mLoadStats.SourceBytes = cache.GetSize();
+
+        // Undoes a partial read. Staging memory is only allocated once the file has been validated completely.
+        auto lClearState = [this]() {
+            mIndexBindings = {};
+            mMeshes.clear();
+            mVertexBuffer.clear();
+            mIndexBuffer.clear();
+            mSkinDataBuffer.clear();
+            mMeshletBuffer.Clear();
+            mRecords = {};
+            mDecodedImages.clear();
+            mDecodedImageCount = 0;
+        };
+
+        try
+        {
+            CacheReader reader(cache.GetData(), cache.GetSize());
+
+            if(memcmp(reader.ReadBytes(sizeof(CACHE_MAGIC)), CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || reader.Read<uint32_t>() != IMPORT_CACHE_VERSION
+               || reader.Read<uint64_t>() != key)
+            {
+                HSK_THROWFMT("Header mismatch in {}", cachePath.string());
+            }
+
+            // External buffers and images are part of the source content
+            uint64_t dependencyCount = reader.ReadCount(sizeof(uint64_t));
+            for(uint64_t i = 0; i < dependencyCount; i++)
+            {
+                Dependency dependency{.Uri = reader.ReadString(), .Size = reader.Read<uint64_t>(), .Hash = reader.Read<uint64_t>()};
+                uint64_t   size = 0;
+                uint64_t   hash = 0;
+                if(!HashFile(sourcePath.parent_path() / DecodeUri(dependency.Uri), 0, size, hash) || size != dependency.Size || hash != dependency.Hash)
+                {
+                    logger()->info("Model Load: Import cache entry for \"{}\" is outdated (\"{}\" changed)", utf8Path, dependency.Uri);
+                    return false;
+                }
+            }
+
+            // Meshes
+            uint64_t meshCount = reader.ReadCount(sizeof(uint32_t));
+            mMeshes.reserve(meshCount);
+            mIndexBindings.Meshes.resize(meshCount);
+            for(uint64_t i = 0; i < meshCount; i++)
+            {
+                auto mesh = std::make_unique<Mesh>();
+                mesh->SetFirstVertex(reader.Read<uint32_t>());
+                mesh->SetVertexCount(reader.Read<uint32_t>());
+                reader.ReadVector(mesh->GetPrimitives());
+                if(reader.Read<uint8_t>())
+                {
+                    auto morphTargets = std::make_unique<MorphTargetSet>();
+                    reader.ReadVector(morphTargets->GetDefaultWeights());
+                    morphTargets->GetTargets().resize(reader.ReadCount(sizeof(uint64_t)));
+                    for(MorphTarget& target : morphTargets->GetTargets())
+                    {
+                        reader.ReadVector(target.Deltas);
+                    }
+                    reader.ReadVector(morphTargets->GetBaseVertices());
+                    mesh->GetMorphTargets() = std::move(morphTargets);
+                }
+                mIndexBindings.Meshes[i] = mesh.get();
+                mMeshes.push_back(std::move(mesh));
+            }
+
+            // Geometry
+            reader.ReadVector(mVertexBuffer);
+            reader.ReadVector(mIndexBuffer);
+            reader.ReadVector(mSkinDataBuffer);
+            reader.ReadVector(mMeshletBuffer.Meshlets);
+            reader.ReadVector(mMeshletBuffer.Bounds);
+            reader.ReadVector(mMeshletBuffer.Vertices);
+            reader.ReadVector(mMeshletBuffer.Triangles);
+
+            // Scene records
+            reader.ReadVector(mRecords.Materials);
+            mRecords.Textures.resize(reader.ReadCount(sizeof(uint64_t)));
+            for(TextureRecord& texture : mRecords.Textures)
+            {
+                texture.Name            = reader.ReadString();
+                texture.ImageIndex      = reader.Read<int32_t>();
+                texture.SamplerCI       = reader.Read<VkSamplerCreateInfo>();
+                texture.SamplerCI.pNext = nullptr;
+            }
+            mRecords.Nodes.resize(reader.ReadCount(sizeof(int32_t)));
+            for(NodeRecord& node : mRecords.Nodes)
+            {
+                node.Parent      = reader.Read<int32_t>();
+                node.Translation = reader.Read<glm::vec3>();
+                node.Rotation    = reader.Read<glm::quat>();
+                node.Scale       = reader.Read<glm::vec3>();
+                node.LocalMatrix = reader.Read<glm::mat4>();
+                node.Static      = reader.Read<uint8_t>() != 0;
+                node.Mesh        = reader.Read<int32_t>();
+                node.Skin        = reader.Read<int32_t>();
+                reader.ReadVector(node.Weights);
+                reader.ReadVector(node.Instances);
+            }
+            mRecords.Skins.resize(reader.ReadCount(sizeof(uint64_t)));
+            for(SkinRecord& skin : mRecords.Skins)
+            {
+                skin.Name = reader.ReadString();
+                reader.ReadVector(skin.Joints);
+                skin.SkeletonRoot = reader.Read<int32_t>();
+                reader.ReadVector(skin.InverseBindMatrices);
+            }
+            mRecords.Animations.resize(reader.ReadCount(sizeof(uint64_t)));
+            for(AnimationRecord& record : mRecords.Animations)
+            {
+                Animation& animation = record.Animation;
+                animation.SetName(reader.ReadString());
+                animation.SetStart(reader.Read<float>());
+                animation.SetEnd(reader.Read<float>());
+                animation.GetSamplers().resize(reader.ReadCount(sizeof(uint32_t)));
+                for(AnimationSampler& sampler : animation.GetSamplers())
+                {
+                    sampler.Interpolation = (EAnimationInterpolation)reader.Read<uint32_t>();
+                    reader.ReadVector(sampler.Keyframes);
+                    sampler.WeightCount = reader.Read<uint32_t>();
+                    reader.ReadVector(sampler.Weights);
+                }
+                animation.GetChannels().resize(reader.ReadCount(sizeof(int32_t)));
+                record.ChannelTargets.resize(animation.GetChannels().size());
+                for(size_t i = 0; i < animation.GetChannels().size(); i++)
+                {
+                    AnimationChannel& channel = animation.GetChannels()[i];
+                    channel.SamplerIndex      = reader.Read<int32_t>();
+                    channel.TargetPath        = (EAnimationTargetPath)reader.Read<uint32_t>();
+                    record.ChannelTargets[i]  = reader.Read<int32_t>();
+                }
+            }
+
+            // Image descriptions. Pixel data follows all other contents.
+            struct PayloadCopy
+            {
+                uint64_t Offset = 0;
+                uint64_t Size   = 0;
+            };
+            std::vector<PayloadCopy> payloads;
+            mDecodedImages.resize(reader.ReadCount(1));
+            payloads.resize(mDecodedImages.size());
+            for(size_t i = 0; i < mDecodedImages.size(); i++)
+            {
+                DecodedImage& decoded = mDecodedImages[i];
+                if(!reader.Read<uint8_t>())
+                {
+                    continue;
+                }
+                decoded.Width        = reader.Read<int32_t>();
+                decoded.Height       = reader.Read<int32_t>();
+                decoded.Format       = (VkFormat)reader.Read<uint32_t>();
+                decoded.GenerateMips = reader.Read<uint8_t>() != 0;
+                reader.ReadVector(decoded.Levels);
+                decoded.ContentHash = reader.Read<uint64_t>();
+                payloads[i]         = PayloadCopy{.Offset = reader.Read<uint64_t>(), .Size = reader.Read<uint64_t>()};
+
+                // Formats are chosen by device support when converting, the cache may have been written on a different device
+                VkFormatFeatureFlags features = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+                if(decoded.GenerateMips)
+                {
+                    features |= VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+                }
+                if(!HasFormatFeatures(decoded.Format, features))
+                {
+                    logger()->info("Model Load: Import cache entry for \"{}\" uses format {} not supported by this device", utf8Path, (uint32_t)decoded.Format);
+                    lClearState();
+                    return false;
+                }
+            }
+
+            reader.Align(16);
+            size_t payloadStart = reader.GetOffset();
+            for(size_t i = 0; i < payloads.size(); i++)
+            {
+                if(payloads[i].Offset > cache.GetSize() - payloadStart || payloads[i].Size > cache.GetSize() - payloadStart - payloads[i].Offset)
+                {
+                    HSK_THROWFMT("Payload of image #{} exceeds the file size", i);
+                }
+            }
+            for(size_t i = 0; i < payloads.size(); i++)
+            {
+                if(payloads[i].Size)
+                {
+                    mDecodedImages[i].Staging = mUploads.AllocateStaging(payloads[i].Size);
+                }
+            }
+
+            // Pages of the mapping are faulted in by the copies, spread over the workers
+            ThreadPool& workers = mConfig.Workers ? *mConfig.Workers : ThreadPool::Default();
+            workers.ParallelFor(mDecodedImages.size(), [&](size_t i) {
+                if(mDecodedImages[i].Staging.Mapped)
+                {
+                    memcpy(mDecodedImages[i].Staging.Mapped, cache.GetData() + payloadStart + payloads[i].Offset, payloads[i].Size);
+                    mDecodedImageCount++;
+                }
+            });
+        }
+        catch(const Exception& ex)
+        {
+            logger()->warn("Model Load: Ignoring invalid import cache file \"{}\": {}", cachePath.string(), ex.what());
+            lClearState();
+            return false;
+        }
+
+        logger()->info("Model Load: Read \"{}\" from import cache \"{}\" ({} meshes, {} textures, {} nodes)", utf8Path, cachePath.string(), mMeshes.size(),
+                       mRecords.Textures.size(), mRecords.Nodes.size());
+        return true;
+    }
+
+    void ModelConverter::WriteImportCache(const std::string& utf8Path)
+    {
+        std::filesystem::path sourcePath = utf8Path;
+        uint64_t              sourceSize = 0;
+        uint64_t              key        = 0;
+        if(!HashFile(sourcePath, ComputeImportSettingsHash(), sourceSize, key))
+        {
+            return;
+        }
+
+        std::vector<Dependency> dependencies;
+        auto                    lAddDependency = [&](const std::string& uri) -> bool {
+            if(uri.empty() || tinygltf::IsDataURI(uri))
+            {
+                return true;
+            }
+            Dependency dependency{.Uri = uri};
+            if(!HashFile(sourcePath.parent_path() / DecodeUri(uri), 0, dependency.Size, dependency.Hash))
+            {
+                logger()->warn("Model Load: Not writing import cache entry for \"{}\", unable to read \"{}\"", utf8Path, uri);
+                return false;
+            }
+            dependencies.push_back(std::move(dependency));
+            return true;
+        };
+        for(const tinygltf::Buffer& buffer : mGltfModel.buffers)
+        {
+            if(!lAddDependency(buffer.uri))
+            {
+                return;
+            }
+        }
+        for(const tinygltf::Image& image : mGltfModel.images)
+        {
+            if(!lAddDependency(image.uri))
+            {
+                return;
+            }
+        }
+
+        // Only staged images are stored, textures uploaded from tinygltf's buffers would be missing on load
+        for(const TextureRecord& texture : mRecords.Textures)
+        {
+            if(texture.ImageIndex < 0 || !mDecodedImages[texture.ImageIndex].Staging.Mapped)
+            {
+                logger()->debug("Model Load: Not writing import cache entry for \"{}\", texture \"{}\" is not staged", utf8Path, texture.Name);
+                return;
+            }
+        }
+
+        std::filesystem::path directory = mConfig.ImportCacheDirectory;
+        std::filesystem::path path      = directory / fmt::format("{:016x}.hskmodel", key);
+        std::filesystem::path temporary = path;
+        temporary += fmt::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            CacheWriter   writer(file);
+
+            writer.WriteBytes(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+            writer.Write<uint32_t>(IMPORT_CACHE_VERSION);
+            writer.Write<uint64_t>(key);
+
+            writer.Write<uint64_t>(dependencies.size());
+            for(const Dependency& dependency : dependencies)
+            {
+                writer.WriteString(dependency.Uri);
+                writer.Write(dependency.Size);
+                writer.Write(dependency.Hash);
+            }
+
+            // Meshes. Material indices are still relative to the model, the material buffer offset is applied by UploadGeometry()
+            writer.Write<uint64_t>(mMeshes.size());
+            for(const std::unique_ptr<Mesh>& mesh : mMeshes)
+            {
+                writer.Write(mesh->GetFirstVertex());
+                writer.Write(mesh->GetVertexCount());
+                writer.WriteVector(mesh->GetPrimitives());
+                const MorphTargetSet* morphTargets = mesh->GetMorphTargets().get();
+                writer.Write<uint8_t>(morphTargets ? 1 : 0);
+                if(morphTargets)
+                {
+                    writer.WriteVector(morphTargets->GetDefaultWeights());
+                    writer.Write<uint64_t>(morphTargets->GetTargets().size());
+                    for(const MorphTarget& target : morphTargets->GetTargets())
+                    {
+                        writer.WriteVector(target.Deltas);
+                    }
+                    writer.WriteVector(morphTargets->GetBaseVertices());
+                }
+            }
+
+            writer.WriteVector(mVertexBuffer);
+            writer.WriteVector(mIndexBuffer);
+            writer.WriteVector(mSkinDataBuffer);
+            writer.WriteVector(mMeshletBuffer.Meshlets);
+            writer.WriteVector(mMeshletBuffer.Bounds);
+            writer.WriteVector(mMeshletBuffer.Vertices);
+            writer.WriteVector(mMeshletBuffer.Triangles);
+
+            writer.WriteVector(mRecords.Materials);
+            writer.Write<uint64_t>(mRecords.Textures.size());
+            for(const TextureRecord& texture : mRecords.Textures)
+            {
+                writer.WriteString(texture.Name);
+                writer.Write(texture.ImageIndex);
+                writer.Write(texture.SamplerCI);
+            }
+            writer.Write<uint64_t>(mRecords.Nodes.size());
+            for(const NodeRecord& node : mRecords.Nodes)
+            {
+                writer.Write(node.Parent);
+                writer.Write(node.Translation);
+                writer.Write(node.Rotation);
+                writer.Write(node.Scale);
+                writer.Write(node.LocalMatrix);
+                writer.Write<uint8_t>(node.Static ? 1 : 0);
+                writer.Write(node.Mesh);
+                writer.Write(node.Skin);
+                writer.WriteVector(node.Weights);
+                writer.WriteVector(node.Instances);
+            }
+            writer.Write<uint64_t>(mRecords.Skins.size());
+            for(const SkinRecord& skin : mRecords.Skins)
+            {
+                writer.WriteString(skin.Name);
+                writer.WriteVector(skin.Joints);
+                writer.Write(skin.SkeletonRoot);
+                writer.WriteVector(skin.InverseBindMatrices);
+            }
+            writer.Write<uint64_t>(mRecords.Animations.size());
+            for(AnimationRecord& record : mRecords.Animations)
+            {
+                Animation& animation = record.Animation;
+                writer.WriteString(animation.GetName());
+                writer.Write(animation.GetStart());
+                writer.Write(animation.GetEnd());
+                writer.Write<uint64_t>(animation.GetSamplers().size());
+                for(const AnimationSampler& sampler : animation.GetSamplers())
+                {
+                    writer.Write<uint32_t>((uint32_t)sampler.Interpolation);
+                    writer.WriteVector(sampler.Keyframes);
+                    writer.Write(sampler.WeightCount);
+                    writer.WriteVector(sampler.Weights);
+                }
+                writer.Write<uint64_t>(animation.GetChannels().size());
+                for(size_t i = 0; i < animation.GetChannels().size(); i++)
+                {
+                    const AnimationChannel& channel = animation.GetChannels()[i];
+                    writer.Write(channel.SamplerIndex);
+                    writer.Write<uint32_t>((uint32_t)channel.TargetPath);
+                    writer.Write(record.ChannelTargets[i]);
+                }
+            }
+
+            // Image descriptions, payloads are laid out in order, each aligned to 16 bytes
+            writer.Write<uint64_t>(mDecodedImages.size());
+            uint64_t payloadOffset = 0;
+            for(const DecodedImage& decoded : mDecodedImages)
+            {
+                writer.Write<uint8_t>(decoded.Staging.Mapped ? 1 : 0);
+                if(!decoded.Staging.Mapped)
+                {
+                    continue;
+                }
+                writer.Write(decoded.Width);
+                writer.Write(decoded.Height);
+                writer.Write<uint32_t>((uint32_t)decoded.Format);
+                writer.Write<uint8_t>(decoded.GenerateMips ? 1 : 0);
+                writer.WriteVector(decoded.Levels);
+                writer.Write(decoded.ContentHash);
+                writer.Write(payloadOffset);
+                writer.Write<uint64_t>(decoded.Staging.Size);
+                payloadOffset += (decoded.Staging.Size + 15) / 16 * 16;
+            }
+            writer.Align(16);
+            for(const DecodedImage& decoded : mDecodedImages)
+            {
+                if(decoded.Staging.Mapped)
+                {
+                    writer.WriteBytes(decoded.Staging.Mapped, decoded.Staging.Size);
+                    writer.Align(16);
+                }
+            }
+
+            if(!file)
+            {
+                logger()->warn("Model Load: Unable to write import cache file \"{}\"", temporary.string());
+                file.close();
+                std::filesystem::remove(temporary, error);
+                return;
+            }
+        }
+        std::filesystem::rename(temporary, path, error);
+        if(error)
+        {
+            logger()->warn("Model Load: Unable to write import cache file \"{}\": {}", path.string(), error.message());
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+        logger()->info("Model Load: Wrote import cache entry \"{}\"", path.string());
+    }
+}  // namespace hsk
\ No newline at end of file
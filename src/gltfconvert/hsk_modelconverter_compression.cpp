@@ -0,0 +1,157 @@
+#include "../meshprocessing/hsk_meshoptdecoder.hpp"
+#include "../utility/hsk_threadpool.hpp"
+#include "hsk_modelconverter.hpp"
+#include <algorithm>
+#include <map>
+#include <tinygltf/json.hpp>
+
+namespace hsk {
+    namespace {
+        const char* MESHOPT_EXTENSION = "EXT_meshopt_compression";
+        const char* DRACO_EXTENSION   = "KHR_draco_mesh_compression";
+
+        /// @brief A buffer view compressed with EXT_meshopt_compression
+        struct CompressedBufferView
+        {
+            int32_t                 BufferViewIndex = -1;
+            GltfBufferData          Source          = {};
+            size_t                  Count           = 0;
+            size_t                  ByteStride      = 0;
+            MeshoptDecoder::EMode   Mode            = MeshoptDecoder::EMode::Attributes;
+            MeshoptDecoder::EFilter Filter          = MeshoptDecoder::EFilter::None;
+        };
+
+        int64_t GetIntProperty(const tinygltf::Value& object, const char* key, int64_t fallback)
+        {
+            return object.Has(key) && object.Get(key).IsNumber() ? (int64_t)object.Get(key).GetNumberAsDouble() : fallback;
+        }
+
+        std::string GetStringProperty(const tinygltf::Value& object, const char* key, const char* fallback)
+        {
+            return object.Has(key) && object.Get(key).IsString() ? object.Get(key).Get<std::string>() : std::string(fallback);
+        }
+    }  // namespace
+
+    bool ModelConverter::PatchCompressionFallbacks(std::string_view json, std::string& outpatched)
+    {
+        if(json.find(MESHOPT_EXTENSION) == std::string_view::npos)
+        {
+            return false;
+        }
+
+        // Malformed JSON is left for tinygltf to report
+        nlohmann::json document = nlohmann::json::parse(json.begin(), json.end(), nullptr, false);
+        if(document.is_discarded() || !document.is_object() || !document.contains("buffers") || !document["buffers"].is_array())
+        {
+            return false;
+        }
+
+        bool patched = false;
+        for(nlohmann::json& buffer : document["buffers"])
+        {
+            if(!buffer.is_object() || !buffer.contains("extensions") || !buffer["extensions"].is_object() || !buffer["extensions"].contains(MESHOPT_EXTENSION))
+            {
+                continue;
+            }
+            const nlohmann::json& extension = buffer["extensions"][MESHOPT_EXTENSION];
+            if(extension.is_object() && extension.value("fallback", false))
+            {
+                // Fallback buffers only reserve the size of the decompressed data and usually have neither uri nor data. tinygltf rejects those,
+                // so they are replaced by a single byte. All views into them are compressed and redirected by DecompressBufferViews().
+                buffer["uri"]        = "data:application/octet-stream;base64,AA==";
+                buffer["byteLength"] = 1;
+                patched              = true;
+            }
+        }
+        if(patched)
+        {
+            outpatched = document.dump();
+        }
+        return patched;
+    }
+
+    void ModelConverter::DecompressBufferViews()
+    {
+        for(const std::string& required : mGltfModel.extensionsRequired)
+        {
+            HSK_ASSERTFMT(required != DRACO_EXTENSION, "Model Load: {} is required, but not supported!", DRACO_EXTENSION)
+        }
+        if(std::find(mGltfModel.extensionsUsed.begin(), mGltfModel.extensionsUsed.end(), DRACO_EXTENSION) != mGltfModel.extensionsUsed.end())
+        {
+            logger()->warn("Model Load: {} is not supported, using uncompressed fallback attributes", DRACO_EXTENSION);
+        }
+
+        std::map<std::string_view, MeshoptDecoder::EMode> modeMap = {
+            {"ATTRIBUTES", MeshoptDecoder::EMode::Attributes}, {"TRIANGLES", MeshoptDecoder::EMode::Triangles}, {"INDICES", MeshoptDecoder::EMode::Indices}};
+        std::map<std::string_view, MeshoptDecoder::EFilter> filterMap = {{"NONE", MeshoptDecoder::EFilter::None},
+                                                                         {"OCTAHEDRAL", MeshoptDecoder::EFilter::Octahedral},
+                                                                         {"QUATERNION", MeshoptDecoder::EFilter::Quaternion},
+                                                                         {"EXPONENTIAL", MeshoptDecoder::EFilter::Exponential}};
+
+        std::vector<CompressedBufferView> compressedViews;
+        for(int32_t i = 0; i < (int32_t)mGltfModel.bufferViews.size(); i++)
+        {
+            const tinygltf::BufferView& bufferView = mGltfModel.bufferViews[i];
+            auto                        extension  = bufferView.extensions.find(MESHOPT_EXTENSION);
+            if(extension == bufferView.extensions.end())
+            {
+                continue;
+            }
+            const tinygltf::Value& properties = extension->second;
+
+            int64_t     bufferIndex = GetIntProperty(properties, "buffer", -1);
+            int64_t     byteOffset  = GetIntProperty(properties, "byteOffset", 0);
+            int64_t     byteLength  = GetIntProperty(properties, "byteLength", -1);
+            std::string mode        = GetStringProperty(properties, "mode", "");
+            std::string filter      = GetStringProperty(properties, "filter", "NONE");
+
+            CompressedBufferView view{.BufferViewIndex = i,
+                                      .Count           = (size_t)std::max<int64_t>(GetIntProperty(properties, "count", 0), 0),
+                                      .ByteStride      = (size_t)std::max<int64_t>(GetIntProperty(properties, "byteStride", 0), 0)};
+
+            HSK_ASSERTFMT(bufferIndex >= 0 && (size_t)bufferIndex < mGltfBuffers.size(), "Buffer view #{}: Compressed data references invalid buffer {}!", i, bufferIndex)
+            const GltfBufferData& buffer = mGltfBuffers[bufferIndex];
+            HSK_ASSERTFMT(byteOffset >= 0 && byteLength >= 0 && (size_t)(byteOffset + byteLength) <= buffer.Size, "Buffer view #{}: Compressed data exceeds buffer {}!", i,
+                          bufferIndex)
+            HSK_ASSERTFMT(modeMap.contains(mode), "Buffer view #{}: Unknown compression mode \"{}\"!", i, mode)
+            HSK_ASSERTFMT(filterMap.contains(filter), "Buffer view #{}: Unknown compression filter \"{}\"!", i, filter)
+            HSK_ASSERTFMT(view.Count * view.ByteStride == bufferView.byteLength, "Buffer view #{}: Decompressed size {} does not match byte length {}!", i,
+                          view.Count * view.ByteStride, bufferView.byteLength)
+
+            view.Source = GltfBufferData{.Data = buffer.Data + byteOffset, .Size = (size_t)byteLength};
+            view.Mode   = modeMap[mode];
+            view.Filter = filterMap[filter];
+            compressedViews.push_back(view);
+        }
+        if(compressedViews.empty())
+        {
+            return;
+        }
+
+        logger()->info("Model Load: Decompressing {} buffer views ...", compressedViews.size());
+
+        // Every view is decoded into a buffer of its own, appended after the gltf buffers
+        mDecompressedBuffers.resize(compressedViews.size());
+        ThreadPool& workers = mConfig.Workers ? *mConfig.Workers : ThreadPool::Default();
+        workers.ParallelFor(compressedViews.size(), [this, &compressedViews](size_t i) {
+            const CompressedBufferView& view   = compressedViews[i];
+            std::vector<uint8_t>&       output = mDecompressedBuffers[i];
+            output.resize(view.Count * view.ByteStride);
+            if(!MeshoptDecoder::Decode(view.Mode, view.Filter, output.data(), view.Count, view.ByteStride, view.Source.Data, view.Source.Size))
+            {
+                HSK_THROWFMT("Buffer view #{}: Failed to decode compressed data!", view.BufferViewIndex);
+            }
+        });
+
+        size_t decompressedSize = 0;
+        for(size_t i = 0; i < compressedViews.size(); i++)
+        {
+            tinygltf::BufferView& bufferView = mGltfModel.bufferViews[compressedViews[i].BufferViewIndex];
+            bufferView.buffer                = (int32_t)mGltfBuffers.size();
+            bufferView.byteOffset            = 0;
+            mGltfBuffers.push_back(GltfBufferData{.Data = mDecompressedBuffers[i].data(), .Size = mDecompressedBuffers[i].size()});
+            decompressedSize += mDecompressedBuffers[i].size();
+        }
+        logger()->debug("Model Load: Decompressed {} bytes of buffer data", decompressedSize);
+    }
+}  // namespace hsk
\ No newline at end of file
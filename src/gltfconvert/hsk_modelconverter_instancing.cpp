@@ -0,0 +1,75 @@
+#include "../scenegraph/globalcomponents/hsk_instancebuffer.hpp"
+#include "hsk_accessorconverter.hpp"
+#include "hsk_modelconverter.hpp"
+
+namespace hsk {
+    namespace {
+        const char* INSTANCING_EXTENSION = "EXT_mesh_gpu_instancing";
+    }  // namespace
+
+    void ModelConverter::TranslateGpuInstances(int32_t gltfIndex, NodeRecord& node)
+    {
+        const tinygltf::Node& gltfNode  = mGltfModel.nodes[gltfIndex];
+        auto                  extension = gltfNode.extensions.find(INSTANCING_EXTENSION);
+        if(extension == gltfNode.extensions.end() || !extension->second.Has("attributes"))
+        {
+            return;
+        }
+        if(gltfNode.mesh < 0)
+        {
+            logger()->warn("Model Load: Node #{} uses {} without a mesh, ignoring instances", gltfIndex, INSTANCING_EXTENSION);
+            return;
+        }
+
+        const tinygltf::Value& attributes = extension->second.Get("attributes");
+
+        int32_t     accessors[3] = {-1, -1, -1};
+        const char* names[3]     = {"TRANSLATION", "ROTATION", "SCALE"};
+        size_t      count        = 0;
+        for(int32_t i = 0; i < 3; i++)
+        {
+            if(!attributes.Has(names[i]))
+            {
+                continue;
+            }
+            accessors[i] = attributes.Get(names[i]).GetNumberAsInt();
+            HSK_ASSERTFMT(accessors[i] >= 0 && (size_t)accessors[i] < mGltfModel.accessors.size(), "Model Load: Node #{} {} accessor #{} out of range!", gltfIndex,
+                          names[i], accessors[i])
+            size_t accessorCount = mGltfModel.accessors[accessors[i]].count;
+            HSK_ASSERTFMT(count == 0 || count == accessorCount, "Model Load: Node #{} {} attributes differ in element count ({} vs {})!", gltfIndex,
+                          INSTANCING_EXTENSION, count, accessorCount)
+            count = accessorCount;
+        }
+        if(!count)
+        {
+            return;
+        }
+
+        // Missing attributes default to identity
+        std::vector<glm::vec3> translations(count, glm::vec3(0.f));
+        std::vector<glm::vec4> rotations(count, glm::vec4(0.f, 0.f, 0.f, 1.f));
+        std::vector<glm::vec3> scales(count, glm::vec3(1.f));
+        // Rotations may be normalized integers (KHR_mesh_quantization), which the accessor converter maps to [-1, 1]
+        if(accessors[0] >= 0)
+        {
+            AccessorConverter::ToFloat(mGltfModel, mGltfBuffers, accessors[0], 3, &translations[0].x, sizeof(glm::vec3), count);
+        }
+        if(accessors[1] >= 0)
+        {
+            AccessorConverter::ToFloat(mGltfModel, mGltfBuffers, accessors[1], 4, &rotations[0].x, sizeof(glm::vec4), count);
+        }
+        if(accessors[2] >= 0)
+        {
+            AccessorConverter::ToFloat(mGltfModel, mGltfBuffers, accessors[2], 3, &scales[0].x, sizeof(glm::vec3), count);
+        }
+
+        node.Instances.resize(count);
+        for(size_t i = 0; i < count; i++)
+        {
+            // glTF quaternions are stored x, y, z, w
+            glm::quat rotation  = glm::normalize(glm::quat(rotations[i].w, rotations[i].x, rotations[i].y, rotations[i].z));
+            glm::mat4 transform = glm::translate(glm::mat4(1.f), translations[i]) * glm::mat4(rotation) * glm::scale(glm::mat4(1.f), scales[i]);
+            node.Instances[i]   = InstanceTransform::FromMatrix(transform);
+        }
+    }
+}  // namespace hsk
\ No newline at end of file
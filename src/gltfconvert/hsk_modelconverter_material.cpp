@@ -1,26 +1,48 @@
 #include "../scenegraph/globalcomponents/hsk_materialbuffer.hpp"
 #include "hsk_modelconverter.hpp"
+#include <algorithm>
 
 namespace hsk {
-    void ModelConverter::LoadMaterials()
+    void ModelConverter::TranslateMaterials()
     {
+        mRecords.Materials.resize(mGltfModel.materials.size());
         for(int32_t i = 0; i < mGltfModel.materials.size(); i++)
         {
             const auto& gltfMaterial = mGltfModel.materials[i];
-            auto&       material     = mMaterialBuffer.GetVector()[mIndexBindings.MaterialBufferOffset + i];
+            auto&       material     = mRecords.Materials[i];
 
             // Pbr Base Info
             material.BaseColorFactor = glm::vec4(gltfMaterial.pbrMetallicRoughness.baseColorFactor[0], gltfMaterial.pbrMetallicRoughness.baseColorFactor[1],
                                                  gltfMaterial.pbrMetallicRoughness.baseColorFactor[2], gltfMaterial.pbrMetallicRoughness.baseColorFactor[3]);
             material.MetallicFactor           = gltfMaterial.pbrMetallicRoughness.metallicFactor;
             material.RoughnessFactor          = gltfMaterial.pbrMetallicRoughness.roughnessFactor;
-            material.BaseColorTextureIndex         = gltfMaterial.pbrMetallicRoughness.baseColorTexture.index + mIndexBindings.TextureBufferOffset;
-            material.MetallicRoughnessTextureIndex = gltfMaterial.pbrMetallicRoughness.metallicRoughnessTexture.index + mIndexBindings.TextureBufferOffset;
+            material.BaseColorTextureIndex         = gltfMaterial.pbrMetallicRoughness.baseColorTexture.index;
+            material.MetallicRoughnessTextureIndex = gltfMaterial.pbrMetallicRoughness.metallicRoughnessTexture.index;
 
             // Aux Info
             material.EmissiveFactor  = glm::vec3(gltfMaterial.emissiveFactor[0], gltfMaterial.emissiveFactor[1], gltfMaterial.emissiveFactor[2]);
-            material.EmissiveTextureIndex = gltfMaterial.emissiveTexture.index + mIndexBindings.TextureBufferOffset;
-            material.NormalTextureIndex   = gltfMaterial.normalTexture.index + mIndexBindings.TextureBufferOffset;
+            material.EmissiveTextureIndex = gltfMaterial.emissiveTexture.index;
+            material.NormalTextureIndex   = gltfMaterial.normalTexture.index;
+        }
+    }
+
+    void ModelConverter::LoadMaterials()
+    {
+        auto lTextureIndex = [this](int32_t textureIndex) { return textureIndex >= 0 ? mIndexBindings.Textures[textureIndex] : -1; };
+
+        // Ranges of models loaded concurrently may be filled out of order
+        std::vector<MaterialBufferEntry>& materials = mMaterialBuffer.GetVector();
+        materials.resize(std::max(materials.size(), mIndexBindings.MaterialBufferOffset + mRecords.Materials.size()));
+
+        for(size_t i = 0; i < mRecords.Materials.size(); i++)
+        {
+            auto& material = materials[mIndexBindings.MaterialBufferOffset + i];
+            material       = mRecords.Materials[i];
+
+            material.BaseColorTextureIndex         = lTextureIndex(material.BaseColorTextureIndex);
+            material.MetallicRoughnessTextureIndex = lTextureIndex(material.MetallicRoughnessTextureIndex);
+            material.EmissiveTextureIndex          = lTextureIndex(material.EmissiveTextureIndex);
+            material.NormalTextureIndex            = lTextureIndex(material.NormalTextureIndex);
         }
     }
 }  // namespace hsk
\ No newline at end of file
@@ -1,9 +1,30 @@
 #include "../scenegraph/globalcomponents/hsk_geometrystore.hpp"
+#include "hsk_accessorconverter.hpp"
 #include "hsk_modelconverter.hpp"
 
 namespace hsk {
-    void ModelConverter::BuildGeometryBuffer()
+    void ModelConverter::BuildGeometry()
     {
+        mVertexCacheStatsBefore = {};
+        mVertexCacheStatsAfter  = {};
+
+        // Reserve the vertex buffer for all primitives up front, attribute conversion writes straight into it
+        size_t totalVertexCount = 0;
+        for(auto& gltfMesh : mGltfModel.meshes)
+        {
+            for(auto& gltfPrimitive : gltfMesh.primitives)
+            {
+                auto query = gltfPrimitive.attributes.find("POSITION");
+                if(query != gltfPrimitive.attributes.cend())
+                {
+                    totalVertexCount += mGltfModel.accessors[query->second].count;
+                }
+            }
+        }
+        mVertexBuffer.reserve(mVertexBuffer.size() + totalVertexCount);
+
+        mMeshes.reserve(mGltfModel.meshes.size());
+        mIndexBindings.Meshes.resize(mGltfModel.meshes.size());
         for(int32_t i = 0; i < mGltfModel.meshes.size(); i++)
         {
             auto&                   gltfMesh = mGltfModel.meshes[i];
@@ -11,27 +32,99 @@ namespace hsk {
             
             logger()->debug("Model Load: Processing mesh #{} \"{}\" with {} primitives", i, gltfMesh.name, gltfMesh.primitives.size());
 
+            uint32_t firstVertex = static_cast<uint32_t>(mVertexBuffer.size());
             PushGltfMeshToBuffers(gltfMesh, primitives);
             auto mesh = std::make_unique<Mesh>();
             mesh->SetPrimitives(primitives);
+            mesh->SetFirstVertex(firstVertex);
+            mesh->SetVertexCount(static_cast<uint32_t>(mVertexBuffer.size()) - firstVertex);
+            LoadMorphTargets(gltfMesh, mesh.get());
             mIndexBindings.Meshes[i] = mesh.get();
-            mGeo.GetMeshes().push_back(std::move(mesh));
+            mMeshes.push_back(std::move(mesh));
+        }
+
+        if(mSkinDataBuffer.size())
+        {
+            // Unskinned vertices pushed after the last skinned primitive
+            mSkinDataBuffer.resize(mVertexBuffer.size());
+        }
+
+        if(!mMeshletBuffer.IsEmpty())
+        {
+            logger()->info("Model Load: Built {} meshlets ({} meshlet vertices for {} vertices)", mMeshletBuffer.Meshlets.size(), mMeshletBuffer.Vertices.size(),
+                           mVertexBuffer.size());
+        }
+
+        if(mVertexCacheStatsBefore.TriangleCount)
+        {
+            logger()->info("Model Load: Optimized {} triangles. ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}", mVertexCacheStatsAfter.TriangleCount,
+                           mVertexCacheStatsBefore.GetAcmr(), mVertexCacheStatsAfter.GetAcmr(), mVertexCacheStatsBefore.GetAtvr(), mVertexCacheStatsAfter.GetAtvr());
+        }
+    }
+
+    void ModelConverter::UploadGeometry()
+    {
+        // BuildGeometry() may run on a worker thread and only stores glTF material indices. The material range is reserved on the main thread,
+        // right before the indices are offset and baked into the uploaded vertices. Filled by LoadMaterials().
+        mIndexBindings.MaterialBufferOffset = (int32_t)mMaterialBuffer.ReserveRange(mRecords.Materials.size());
+
+        int32_t materialOffset  = (int32_t)mIndexBindings.MaterialBufferOffset;
+        auto    lOffsetMaterial = [materialOffset](int32_t& materialIndex) {
+            if(materialIndex >= 0)
+            {
+                materialIndex += materialOffset;
+            }
+        };
+        for(Vertex& vertex : mVertexBuffer)
+        {
+            lOffsetMaterial(vertex.MaterialIndex);
         }
 
-        mGeo.GetBufferSets().push_back(std::make_unique<GeometryBufferSet>());
-        auto geoBufferSet = mGeo.GetBufferSets().back().get();
+        mGeometryBufferSet = std::make_unique<GeometryBufferSet>();
+        mGeometryBufferSet->SetVertexLayout(mConfig.VertexLayout);
+        if(mConfig.UseGeometryArena)
+        {
+            mGeometryBufferSet->SetArena(mGeo.GetArena(mConfig.VertexLayout));
+        }
 
         for(auto& mesh : mIndexBindings.Meshes)
         {
-            mesh->SetBuffer(geoBufferSet);
+            mesh->SetBuffer(mGeometryBufferSet.get());
+            for(Primitive& primitive : mesh->GetPrimitives())
+            {
+                lOffsetMaterial(primitive.MaterialIndex);
+            }
+            if(mesh->GetMorphTargets())
+            {
+                for(Vertex& vertex : mesh->GetMorphTargets()->GetBaseVertices())
+                {
+                    lOffsetMaterial(vertex.MaterialIndex);
+                }
+            }
+        }
+
+        if(!mMeshletBuffer.IsEmpty())
+        {
+            mGeometryBufferSet->GetMeshlets() = std::make_unique<MeshletBuffer>(std::move(mMeshletBuffer));
+            mMeshletBuffer.Clear();
         }
 
-        geoBufferSet->Init(mContext, mVertexBuffer, mIndexBuffer);
+        mGeometryBufferSet->Init(mContext, mVertexBuffer, mIndexBuffer, mSkinDataBuffer, &mUploads);
+        mLoadStats.VertexCount = mVertexBuffer.size();
+        mLoadStats.IndexCount  = mIndexBuffer.size();
+
+        // Contents are in staging memory now
+        std::vector<Vertex>().swap(mVertexBuffer);
+        std::vector<uint32_t>().swap(mIndexBuffer);
+        std::vector<VertexSkinData>().swap(mSkinDataBuffer);
     }
 
     void ModelConverter::PushGltfMeshToBuffers(const tinygltf::Mesh& mesh, std::vector<Primitive>& outprimitives)
     {
         outprimitives.resize(mesh.primitives.size());
+        mPrimitiveVertexRemaps.clear();
+        mPrimitiveVertexRemaps.resize(mesh.primitives.size());
+        mPrimitiveVertexStarts.resize(mesh.primitives.size());
 
         for(int32_t i = 0; i < mesh.primitives.size(); i++)
         {
@@ -41,6 +134,8 @@ namespace hsk {
             auto& gltfPrimitive = mesh.primitives[i];
             auto& primitive     = outprimitives[i];
 
+            mPrimitiveVertexStarts[i] = vertexStart;
+
             const std::string POSITION = "POSITION";
             const std::string NORMAL   = "NORMAL";
             const std::string TANGENT  = "TANGENT";
@@ -53,115 +148,176 @@ namespace hsk {
             auto failedQuery           = gltfPrimitive.attributes.cend();
 
             int32_t vertexCount = 0;
-
-            std::function<glm::vec3(int32_t index)> lGetPosition = nullptr;
-            std::function<glm::vec3(int32_t index)> lGetNormal   = nullptr;
-            std::function<glm::vec3(int32_t index)> lGetTangent  = nullptr;
-            std::function<glm::vec2(int32_t index)> lGetUv       = nullptr;
             if(positionAccessorQuery != failedQuery)
             {
-                auto& accessor = mGltfModel.accessors[positionAccessorQuery->second];  // The glTF accessor describes in which buffer to look and how to interprete the data stored
-                auto& bufferView = mGltfModel.bufferViews[accessor.bufferView];        // The bufferView is a section of a buffer
+                vertexCount = static_cast<int32_t>(mGltfModel.accessors[positionAccessorQuery->second].count);
+            }
+
+            // Defaults for attributes the primitive does not have, then every attribute is converted in bulk straight into the vertex buffer
+            mVertexBuffer.resize(vertexStart + vertexCount, Vertex{.Pos           = glm::vec3(),
+                                                                   .Normal        = glm::vec3(0.f, 1.f, 0.f),
+                                                                   .Tangent       = glm::vec3(0.f, 0.f, 1.f),
+                                                                   .Uv            = glm::vec2(),
+                                                                   .MaterialIndex = gltfPrimitive.material});
+            Vertex* vertices = mVertexBuffer.data() + vertexStart;
 
-                vertexCount = static_cast<uint32_t>(accessor.count);
+            auto lConvert = [&](std::map<std::string, int>::const_iterator query, uint32_t components, float* out) {
+                if(query != failedQuery)
+                {
+                    AccessorConverter::ToFloat(mGltfModel, mGltfBuffers, query->second, components, out, sizeof(Vertex), vertexCount);
+                }
+            };
+            lConvert(positionAccessorQuery, 3, &vertices->Pos.x);
+            lConvert(normalAccessorQuery, 3, &vertices->Normal.x);
+            // Tangents are VEC4 (w is the bitangent sign), only xyz are stored
+            lConvert(tangentAccessorQuery, 3, &vertices->Tangent.x);
+            lConvert(uvAccessorQuery, 2, &vertices->Uv.x);
 
-                // Calculate a pointer to the beginning of the relevant buffer
-                const float* buffer = reinterpret_cast<const float*>(&(mGltfModel.buffers[bufferView.buffer].data[accessor.byteOffset + bufferView.byteOffset]));
-                // Type of the component in bytes
-                int32_t typeSize = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(accessor.componentType)) * tinygltf::GetNumComponentsInType(accessor.type);
+            PushGltfSkinDataToBuffer(gltfPrimitive, vertexStart, vertexCount);
 
-                // Stride of the data (distance in bytes between each value)
-                int32_t byteStride = accessor.ByteStride(bufferView) ? (accessor.ByteStride(bufferView) / sizeof(float)) : typeSize;
+            // Primitive local indices
+            std::vector<uint32_t> indices;
+            bool                  indexed = false;
 
-                // Set the local function to a lambda
-                lGetPosition = [buffer, byteStride](int32_t index) { return glm::make_vec3(&buffer[index * byteStride]); };
+            if(gltfPrimitive.indices >= 0)
+            {
+                indices.resize(mGltfModel.accessors[gltfPrimitive.indices].count);
+                AccessorConverter::ToUint(mGltfModel, mGltfBuffers, gltfPrimitive.indices, 1, indices.data(), sizeof(uint32_t), indices.size());
+                indexed = true;
             }
-            if(normalAccessorQuery != failedQuery)
+            else if(mConfig.WeldVertices && gltfPrimitive.targets.empty())
             {
-                auto&        accessor   = mGltfModel.accessors[normalAccessorQuery->second];
-                auto&        bufferView = mGltfModel.bufferViews[accessor.bufferView];
-                const float* buffer     = reinterpret_cast<const float*>(&(mGltfModel.buffers[bufferView.buffer].data[accessor.byteOffset + bufferView.byteOffset]));
-                int32_t      typeSize   = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(accessor.componentType)) * tinygltf::GetNumComponentsInType(accessor.type);
-                int32_t      byteStride = accessor.ByteStride(bufferView) ? (accessor.ByteStride(bufferView) / sizeof(float)) : typeSize;
-
-                lGetNormal = [buffer, byteStride](int32_t index) { return glm::make_vec3(&buffer[index * byteStride]); };
+                // Morph target deltas address the original vertices, primitives with targets are left as is
+                indexed = WeldPrimitive(vertexStart, vertexCount, indices);
             }
-            if(tangentAccessorQuery != failedQuery)
+
+            if(indexed)
             {
-                auto&        accessor   = mGltfModel.accessors[tangentAccessorQuery->second];
-                auto&        bufferView = mGltfModel.bufferViews[accessor.bufferView];
-                const float* buffer     = reinterpret_cast<const float*>(&(mGltfModel.buffers[bufferView.buffer].data[accessor.byteOffset + bufferView.byteOffset]));
-                int32_t      typeSize   = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(accessor.componentType)) * tinygltf::GetNumComponentsInType(accessor.type);
-                int32_t      byteStride = accessor.ByteStride(bufferView) ? (accessor.ByteStride(bufferView) / sizeof(float)) : typeSize;
+                primitive = Primitive(Primitive::EType::Index, indexStart, (uint32_t)indices.size(), (int32_t)vertexStart);
+
+                if(gltfPrimitive.mode == TINYGLTF_MODE_TRIANGLES)
+                {
+                    OptimizePrimitive(indices, vertexStart, vertexCount, mPrimitiveVertexRemaps[i]);
+                    if(mConfig.BuildMeshlets)
+                    {
+                        // Built after optimization: meshlets follow the optimized triangle order and reference the final vertex positions
+                        primitive.FirstMeshlet = (uint32_t)mMeshletBuffer.Meshlets.size();
+                        primitive.MeshletCount = MeshletBuilder::Build(mMeshletBuffer, indices.data(), indices.size(), &mVertexBuffer[0].Pos.x, sizeof(Vertex), vertexCount,
+                                                                       vertexStart, mConfig.MeshletMaxVertices, mConfig.MeshletMaxTriangles);
+                    }
+                }
 
-                lGetTangent = [buffer, byteStride](int32_t index) { return glm::make_vec3(&buffer[index * byteStride]); };
+                // Indices stay primitive local, the primitive start is applied as base vertex. This keeps indices within 16 bit range for most buffer sets.
+                mIndexBuffer.insert(mIndexBuffer.end(), indices.begin(), indices.end());
             }
-            if(uvAccessorQuery != failedQuery)
+            else
             {
-                auto&        accessor   = mGltfModel.accessors[uvAccessorQuery->second];
-                auto&        bufferView = mGltfModel.bufferViews[accessor.bufferView];
-                const float* buffer     = reinterpret_cast<const float*>(&(mGltfModel.buffers[bufferView.buffer].data[accessor.byteOffset + bufferView.byteOffset]));
-                int32_t      typeSize   = tinygltf::GetComponentSizeInBytes(static_cast<uint32_t>(accessor.componentType)) * tinygltf::GetNumComponentsInType(accessor.type);
-                int32_t      byteStride = accessor.ByteStride(bufferView) ? (accessor.ByteStride(bufferView) / sizeof(float)) : typeSize;
-
-                lGetUv = [buffer, byteStride](int32_t index) { return glm::make_vec2(&buffer[index * byteStride]); };
+                primitive = Primitive(Primitive::EType::Vertex, vertexStart, vertexCount);
             }
+            // glTF material index, offset into the scene's material buffer by UploadGeometry()
+            primitive.MaterialIndex = gltfPrimitive.material;
+        }
+    }
+
+    void ModelConverter::OptimizePrimitive(std::vector<uint32_t>& indices, uint32_t vertexStart, uint32_t vertexCount, std::vector<uint32_t>& outremap)
+    {
+        outremap.clear();
+        if(!mConfig.OptimizeVertexCache && !mConfig.OptimizeVertexFetch)
+        {
+            return;
+        }
+        for(uint32_t index : indices)
+        {
+            HSK_ASSERTFMT(index < vertexCount, "Vertex index {} out of range of primitive with {} vertices!", index, vertexCount)
+        }
+
+        mVertexCacheStatsBefore += MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertexCount);
 
-            for(int32_t vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++)
+        if(mConfig.OptimizeVertexCache)
+        {
+            MeshOptimizer::OptimizeVertexCache(indices.data(), indices.size(), vertexCount);
+            if(mConfig.OptimizeOverdraw)
             {
-                mVertexBuffer.push_back(Vertex{.Pos           = lGetPosition ? lGetPosition(vertexIndex) : glm::vec3(),
-                                                .Normal        = lGetNormal ? lGetNormal(vertexIndex) : glm::vec3(0.f, 1.f, 0.f),
-                                                .Tangent       = lGetTangent ? lGetTangent(vertexIndex) : glm::vec3(0.f, 0.f, 1.f),
-                                                .Uv            = lGetUv ? lGetUv(vertexIndex) : glm::vec2(),
-                                                .MaterialIndex = gltfPrimitive.material + mIndexBindings.MaterialBufferOffset});
+                MeshOptimizer::OptimizeOverdraw(indices.data(), indices.size(), &mVertexBuffer[vertexStart].Pos.x, sizeof(Vertex), vertexCount, mConfig.OverdrawThreshold);
             }
+        }
 
-            if(gltfPrimitive.indices >= 0)
+        mVertexCacheStatsAfter += MeshOptimizer::AnalyzeVertexCache(indices.data(), indices.size(), vertexCount);
+
+        if(mConfig.OptimizeVertexFetch)
+        {
+            // Skin data has already been pushed for this primitive and is reordered alongside the vertices
+            MeshOptimizer::BuildVertexFetchRemap(outremap, indices.data(), indices.size(), vertexCount);
+            MeshOptimizer::RemapIndices(indices.data(), indices.size(), outremap);
+            MeshOptimizer::RemapVertices(&mVertexBuffer[vertexStart], outremap);
+            if(mSkinDataBuffer.size() >= vertexStart + vertexCount)
             {
-                auto& accessor   = mGltfModel.accessors[gltfPrimitive.indices > -1 ? gltfPrimitive.indices : 0];
-                auto& bufferView = mGltfModel.bufferViews[accessor.bufferView];
-                auto& buffer     = mGltfModel.buffers[bufferView.buffer];
+                MeshOptimizer::RemapVertices(&mSkinDataBuffer[vertexStart], outremap);
+            }
+        }
+    }
+
+    bool ModelConverter::WeldPrimitive(uint32_t vertexStart, int32_t& vertexCount, std::vector<uint32_t>& outindices)
+    {
+        if(vertexCount <= 0)
+        {
+            return false;
+        }
 
-                int32_t indexCount = (int32_t)accessor.count;
+        // Skin data is either empty or parallel to the vertex buffer
+        bool skinned = mSkinDataBuffer.size() > 0;
 
-                const void* dataPtr = &(buffer.data[accessor.byteOffset + bufferView.byteOffset]);
+        std::vector<uint32_t> remap;
+        uint32_t              uniqueCount = MeshOptimizer::BuildWeldRemap(remap, &mVertexBuffer[vertexStart], sizeof(Vertex), sizeof(Vertex), (uint32_t)vertexCount,
+                                                                          skinned ? &mSkinDataBuffer[vertexStart] : nullptr, sizeof(VertexSkinData), sizeof(VertexSkinData));
+        if(uniqueCount == (uint32_t)vertexCount)
+        {
+            return false;
+        }
 
-                switch(accessor.componentType)
-                {
-                    case TINYGLTF_PARAMETER_TYPE_UNSIGNED_INT: {
-                        const uint32_t* buf = static_cast<const uint32_t*>(dataPtr);
-                        for(size_t index = 0; index < accessor.count; index++)
-                        {
-                            mIndexBuffer.push_back(buf[index] + vertexStart);
-                        }
-                        break;
-                    }
-                    case TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT: {
-                        const uint16_t* buf = static_cast<const uint16_t*>(dataPtr);
-                        for(size_t index = 0; index < accessor.count; index++)
-                        {
-                            mIndexBuffer.push_back(buf[index] + vertexStart);
-                        }
-                        break;
-                    }
-                    case TINYGLTF_PARAMETER_TYPE_UNSIGNED_BYTE: {
-                        const uint8_t* buf = static_cast<const uint8_t*>(dataPtr);
-                        for(size_t index = 0; index < accessor.count; index++)
-                        {
-                            mIndexBuffer.push_back(buf[index] + vertexStart);
-                        }
-                        break;
-                    }
-                    default:
-                        HSK_THROWFMT("Index component type {} not supported!", accessor.componentType);
-                }
+        MeshOptimizer::CompactVertices(&mVertexBuffer[vertexStart], remap);
+        mVertexBuffer.resize(vertexStart + uniqueCount);
+        if(skinned)
+        {
+            MeshOptimizer::CompactVertices(&mSkinDataBuffer[vertexStart], remap);
+            mSkinDataBuffer.resize(vertexStart + uniqueCount);
+        }
 
-                primitive = Primitive(Primitive::EType::Index, indexStart, indexCount);
-            }
-            else
+        logger()->debug("Model Load: Welded {} vertices into {} unique vertices", vertexCount, uniqueCount);
+
+        // Vertex i of the non-indexed primitive is now found at remap[i]
+        outindices  = std::move(remap);
+        vertexCount = (int32_t)uniqueCount;
+        return true;
+    }
+
+    void ModelConverter::PushGltfSkinDataToBuffer(const tinygltf::Primitive& gltfPrimitive, uint32_t vertexStart, int32_t vertexCount)
+    {
+        auto jointsAccessorQuery  = gltfPrimitive.attributes.find("JOINTS_0");
+        auto weightsAccessorQuery = gltfPrimitive.attributes.find("WEIGHTS_0");
+        auto failedQuery          = gltfPrimitive.attributes.cend();
+
+        if(jointsAccessorQuery == failedQuery || weightsAccessorQuery == failedQuery)
+        {
+            if(mSkinDataBuffer.size())
             {
-                primitive = Primitive(Primitive::EType::Vertex, vertexStart, vertexCount);
+                // Keep skin data parallel to the vertex buffer
+                mSkinDataBuffer.resize(vertexStart + vertexCount);
             }
+            return;
         }
+
+        // Skin data is allocated lazily, fill in entries for all previously pushed unskinned vertices
+        mSkinDataBuffer.resize(vertexStart + vertexCount);
+        VertexSkinData* out = mSkinDataBuffer.data() + vertexStart;
+
+        HSK_ASSERTFMT(mGltfModel.accessors[jointsAccessorQuery->second].type == TINYGLTF_TYPE_VEC4, "JOINTS_0 accessor type {} not supported!",
+                      mGltfModel.accessors[jointsAccessorQuery->second].type)
+        HSK_ASSERTFMT(mGltfModel.accessors[weightsAccessorQuery->second].type == TINYGLTF_TYPE_VEC4, "WEIGHTS_0 accessor type {} not supported!",
+                      mGltfModel.accessors[weightsAccessorQuery->second].type)
+
+        AccessorConverter::ToUint(mGltfModel, mGltfBuffers, jointsAccessorQuery->second, 4, &out->Joints.x, sizeof(VertexSkinData), vertexCount);
+        // Weights may be normalized unsigned byte / short
+        AccessorConverter::ToFloat(mGltfModel, mGltfBuffers, weightsAccessorQuery->second, 4, &out->Weights.x, sizeof(VertexSkinData), vertexCount);
     }
 }  // namespace hsk
\ No newline at end of file
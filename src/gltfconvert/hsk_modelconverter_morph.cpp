@@ -0,0 +1,115 @@
+#include "../scenegraph/globalcomponents/hsk_geometrystore.hpp"
+#include "../scenegraph/hsk_morphtargets.hpp"
+#include "hsk_accessorconverter.hpp"
+#include "hsk_modelconverter.hpp"
+#include <algorithm>
+
+namespace hsk {
+    void ModelConverter::ReadAccessorVec3(int32_t accessorIndex, std::vector<glm::vec3>& out)
+    {
+        auto& accessor = mGltfModel.accessors[accessorIndex];
+
+        HSK_ASSERTFMT(accessor.type == TINYGLTF_TYPE_VEC3, "Accessor #{}: Expected vec3 (type {})!", accessorIndex, accessor.type)
+
+        // Sparse accessors (the common encoding of morph targets) and quantized targets are handled by the converter
+        out.assign(accessor.count, glm::vec3());
+        AccessorConverter::ToFloat(mGltfModel, mGltfBuffers, accessorIndex, 3, reinterpret_cast<float*>(out.data()), sizeof(glm::vec3), out.size());
+    }
+
+    void ModelConverter::LoadMorphTargets(const tinygltf::Mesh& gltfMesh, Mesh* mesh)
+    {
+        size_t targetCount = 0;
+        for(auto& gltfPrimitive : gltfMesh.primitives)
+        {
+            targetCount = std::max(targetCount, gltfPrimitive.targets.size());
+        }
+        if(!targetCount)
+        {
+            return;
+        }
+
+        auto morphTargets = std::make_unique<MorphTargetSet>();
+        morphTargets->GetTargets().resize(targetCount);
+
+        auto& defaultWeights = morphTargets->GetDefaultWeights();
+        defaultWeights.assign(targetCount, 0.f);
+        for(size_t i = 0; i < std::min(targetCount, gltfMesh.weights.size()); i++)
+        {
+            defaultWeights[i] = (float)gltfMesh.weights[i];
+        }
+
+        const std::string POSITION = "POSITION";
+        const std::string NORMAL   = "NORMAL";
+        const std::string TANGENT  = "TANGENT";
+
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec3> tangents;
+
+        for(size_t primitiveIndex = 0; primitiveIndex < gltfMesh.primitives.size(); primitiveIndex++)
+        {
+            auto& gltfPrimitive = gltfMesh.primitives[primitiveIndex];
+            // Primitives without targets may have been welded, so their vertex count can differ from the POSITION accessor count
+            uint32_t primitiveStart = mPrimitiveVertexStarts[primitiveIndex] - mesh->GetFirstVertex();
+            // Vertices may have been reordered by OptimizePrimitive()
+            auto& remap = mPrimitiveVertexRemaps[primitiveIndex];
+
+            auto     positionAccessorQuery = gltfPrimitive.attributes.find(POSITION);
+            uint32_t vertexCount = positionAccessorQuery != gltfPrimitive.attributes.cend() ? (uint32_t)mGltfModel.accessors[positionAccessorQuery->second].count : 0;
+
+            for(size_t targetIndex = 0; targetIndex < gltfPrimitive.targets.size(); targetIndex++)
+            {
+                auto& gltfTarget = gltfPrimitive.targets[targetIndex];
+
+                positions.assign(vertexCount, glm::vec3());
+                normals.assign(vertexCount, glm::vec3());
+                tangents.assign(vertexCount, glm::vec3());
+
+                auto query = gltfTarget.find(POSITION);
+                if(query != gltfTarget.cend())
+                {
+                    ReadAccessorVec3(query->second, positions);
+                }
+                query = gltfTarget.find(NORMAL);
+                if(query != gltfTarget.cend())
+                {
+                    ReadAccessorVec3(query->second, normals);
+                }
+                query = gltfTarget.find(TANGENT);
+                if(query != gltfTarget.cend())
+                {
+                    ReadAccessorVec3(query->second, tangents);
+                }
+
+                HSK_ASSERTFMT(positions.size() == vertexCount && normals.size() == vertexCount && tangents.size() == vertexCount,
+                              "Mesh \"{}\": Morph target #{} attribute count does not match primitive vertex count {}!", gltfMesh.name, targetIndex, vertexCount)
+
+                // Only keep vertices which are actually displaced
+                auto& deltas = morphTargets->GetTargets()[targetIndex].Deltas;
+                for(uint32_t vertexIndex = 0; vertexIndex < vertexCount; vertexIndex++)
+                {
+                    if(positions[vertexIndex] == glm::vec3() && normals[vertexIndex] == glm::vec3() && tangents[vertexIndex] == glm::vec3())
+                    {
+                        continue;
+                    }
+                    uint32_t localIndex = remap.size() ? remap[vertexIndex] : vertexIndex;
+                    deltas.push_back(MorphDelta{
+                        .VertexIndex = primitiveStart + localIndex, .Position = positions[vertexIndex], .Normal = normals[vertexIndex], .Tangent = tangents[vertexIndex]});
+                }
+            }
+        }
+
+        size_t deltaCount = 0;
+        for(auto& target : morphTargets->GetTargets())
+        {
+            std::sort(target.Deltas.begin(), target.Deltas.end(), [](const MorphDelta& a, const MorphDelta& b) { return a.VertexIndex < b.VertexIndex; });
+            target.Deltas.shrink_to_fit();
+            deltaCount += target.Deltas.size();
+        }
+        logger()->debug("Model Load: Mesh \"{}\" has {} morph targets displacing {} vertices total ({} vertices in mesh)", gltfMesh.name, targetCount, deltaCount,
+                        mesh->GetVertexCount());
+
+        morphTargets->SetBaseVertices(std::vector<Vertex>(mVertexBuffer.begin() + mesh->GetFirstVertex(), mVertexBuffer.begin() + mesh->GetFirstVertex() + mesh->GetVertexCount()));
+        mesh->GetMorphTargets() = std::move(morphTargets);
+    }
+}  // namespace hsk
\ No newline at end of file
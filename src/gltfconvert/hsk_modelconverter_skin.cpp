@@ -0,0 +1,96 @@
+#include "../scenegraph/globalcomponents/hsk_geometrystore.hpp"
+#include "../scenegraph/hsk_skin.hpp"
+#include "hsk_modelconverter.hpp"
+#include <spdlog/fmt/fmt.h>
+
+namespace hsk {
+    void ModelConverter::TranslateSkins(const std::vector<int32_t>& gltfToRecord)
+    {
+        mRecords.Skins.resize(mGltfModel.skins.size());
+        for(int32_t i = 0; i < mGltfModel.skins.size(); i++)
+        {
+            auto&       gltfSkin = mGltfModel.skins[i];
+            SkinRecord& skin     = mRecords.Skins[i];
+
+            skin.Name = gltfSkin.name;
+            if(!skin.Name.length())
+            {
+                skin.Name = fmt::format("Skin #{}", i);
+            }
+
+            auto lNodeRecord = [&](int32_t gltfNodeIndex) { return (gltfNodeIndex >= 0 && gltfNodeIndex < gltfToRecord.size()) ? gltfToRecord[gltfNodeIndex] : -1; };
+
+            skin.Joints.resize(gltfSkin.joints.size());
+            for(int32_t jointIndex = 0; jointIndex < gltfSkin.joints.size(); jointIndex++)
+            {
+                int32_t gltfNodeIndex   = gltfSkin.joints[jointIndex];
+                skin.Joints[jointIndex] = lNodeRecord(gltfNodeIndex);
+                if(skin.Joints[jointIndex] < 0)
+                {
+                    logger()->warn("Model Load: Skin \"{}\" joint #{} references node #{} which is not part of the loaded scene!", skin.Name, jointIndex, gltfNodeIndex);
+                }
+            }
+
+            skin.SkeletonRoot = lNodeRecord(gltfSkin.skeleton);
+
+            // Inverse bind matrices default to identity (https://www.khronos.org/registry/glTF/specs/2.0/glTF-2.0.html#skins-overview)
+            auto& inverseBindMatrices = skin.InverseBindMatrices;
+            inverseBindMatrices.assign(skin.Joints.size(), glm::mat4(1.f));
+            if(gltfSkin.inverseBindMatrices >= 0)
+            {
+                auto& accessor   = mGltfModel.accessors[gltfSkin.inverseBindMatrices];
+                auto& bufferView = mGltfModel.bufferViews[accessor.bufferView];
+
+                HSK_ASSERTFMT(accessor.type == TINYGLTF_TYPE_MAT4 && accessor.componentType == TINYGLTF_PARAMETER_TYPE_FLOAT,
+                              "Skin \"{}\": Inverse bind matrix accessor must be of type float mat4!", skin.Name)
+
+                const uint8_t* buffer     = mGltfBuffers[bufferView.buffer].Data + accessor.byteOffset + bufferView.byteOffset;
+                int32_t        byteStride = accessor.ByteStride(bufferView) ? accessor.ByteStride(bufferView) : sizeof(glm::mat4);
+                size_t         count      = std::min<size_t>(accessor.count, inverseBindMatrices.size());
+
+                // GLM and glTF both are column major
+                for(size_t matrixIndex = 0; matrixIndex < count; matrixIndex++)
+                {
+                    inverseBindMatrices[matrixIndex] = glm::make_mat4(reinterpret_cast<const float*>(buffer + matrixIndex * byteStride));
+                }
+            }
+        }
+    }
+
+    void ModelConverter::PrepareSkins()
+    {
+        // Skin objects need to exist before node creation (nodes reference them), joints are resolved in LoadSkins() once all nodes exist
+        mIndexBindings.Skins.resize(mRecords.Skins.size());
+        mGeo.GetSkins().reserve(mGeo.GetSkins().size() + mRecords.Skins.size());
+        for(size_t i = 0; i < mRecords.Skins.size(); i++)
+        {
+            auto skin = std::make_unique<Skin>();
+            skin->SetName(mRecords.Skins[i].Name);
+            mIndexBindings.Skins[i] = skin.get();
+            mGeo.GetSkins().push_back(std::move(skin));
+        }
+    }
+
+    void ModelConverter::LoadSkins()
+    {
+        for(size_t i = 0; i < mRecords.Skins.size(); i++)
+        {
+            const SkinRecord& record = mRecords.Skins[i];
+            Skin*             skin   = mIndexBindings.Skins[i];
+
+            auto& joints = skin->GetJoints();
+            joints.resize(record.Joints.size());
+            for(size_t jointIndex = 0; jointIndex < record.Joints.size(); jointIndex++)
+            {
+                joints[jointIndex] = record.Joints[jointIndex] >= 0 ? mIndexBindings.Nodes[record.Joints[jointIndex]] : nullptr;
+            }
+
+            if(record.SkeletonRoot >= 0)
+            {
+                skin->SetSkeletonRoot(mIndexBindings.Nodes[record.SkeletonRoot]);
+            }
+
+            skin->SetInverseBindMatrices(record.InverseBindMatrices);
+        }
+    }
+}  // namespace hsk
\ No newline at end of file
@@ -1,159 +1,384 @@
-#include "../memory/hsk_commandbuffer.hpp"
+#include "../imageprocessing/hsk_ktx2.hpp"
+#include "../imageprocessing/hsk_pixelops.hpp"
+#include "../imageprocessing/hsk_texturecooker.hpp"
+#include "../memory/hsk_uploadbatch.hpp"
 #include "../scenegraph/globalcomponents/hsk_texturestore.hpp"
+#include "../utility/hsk_hash.hpp"
+#include "../utility/hsk_threadpool.hpp"
 #include "hsk_modelconverter.hpp"
+#include <algorithm>
 #include <spdlog/fmt/fmt.h>
+#include <tinygltf/stb_image.h>
 
 namespace hsk {
-    void ModelConverter::LoadTextures()
+    bool ModelConverter::DeferImageDecoding(tinygltf::Image*     image,
+                                            const int            imageIndex,
+                                            std::string*         error,
+                                            std::string*         warning,
+                                            int                  requestedWidth,
+                                            int                  requestedHeight,
+                                            const unsigned char* bytes,
+                                            int                  size,
+                                            void*                userData)
     {
-        std::vector<uint8_t> rgbaConvertBuffer{};
+        ModelConverter* converter = reinterpret_cast<ModelConverter*>(userData);
+        if(!Ktx2Texture::HasIdentifier(bytes, (size_t)size) && !converter->mConfig.ParallelImageDecoding)
+        {
+            return tinygltf::LoadImageData(image, imageIndex, error, warning, requestedWidth, requestedHeight, bytes, size, nullptr);
+        }
+
+        // Keep the encoded image, DecodeImages() decodes it later. Buffers are parsed before images, so images stored in the binary chunk of a mapped .glb
+        // file can reference the mapping. Other source memory is not owned by the image, so a copy is required.
+        image->as_is = true;
+        if(converter->mGlbBinaryChunk.Data)
+        {
+            for(const tinygltf::Buffer& buffer : converter->mGltfModel.buffers)
+            {
+                if(buffer.uri.empty() && buffer.data.size() && bytes >= buffer.data.data() && bytes + size <= buffer.data.data() + buffer.data.size()
+                   && buffer.data.size() <= converter->mGlbBinaryChunk.Size)
+                {
+                    if(converter->mMappedImages.size() <= (size_t)imageIndex)
+                    {
+                        converter->mMappedImages.resize(imageIndex + 1);
+                    }
+                    converter->mMappedImages[imageIndex] = GltfBufferData{.Data = converter->mGlbBinaryChunk.Data + (bytes - buffer.data.data()), .Size = (size_t)size};
+                    return true;
+                }
+            }
+        }
+        image->image.assign(bytes, bytes + size);
+        return true;
+    }
+
+    bool ModelConverter::HasFormatFeatures(VkFormat format, VkFormatFeatureFlags features) const
+    {
+        VkFormatProperties properties{};
+        vkGetPhysicalDeviceFormatProperties(mContext->PhysicalDevice, format, &properties);
+        return (properties.optimalTilingFeatures & features) == features;
+    }
+
+    bool ModelConverter::SelectKtx2Format(int32_t imageIndex, DecodedImage& decoded)
+    {
+        const Ktx2Texture& ktx2 = decoded.Ktx2;
+
+        decoded.Format = VK_FORMAT_UNDEFINED;
+        if(ktx2.IsBasisUniversal())
+        {
+            // Basis Universal transcoding is not implemented. Textures use their regular image source, TranslateTextures() rejects textures without one.
+            logger()->warn("Model Load: Image #{} \"{}\" is Basis Universal (ETC1S / UASTC) encoded, which is not supported. Using the fallback source of its textures",
+                           imageIndex, mGltfModel.images[imageIndex].name);
+            return false;
+        }
+        else if(ktx2.GetSupercompression() == Ktx2Texture::ESupercompression::None && GetFormatBlockInfo(ktx2.GetFormat()).BlockSize
+                && HasFormatFeatures(GetUnormFormat(ktx2.GetFormat()), VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT))
+        {
+            // *_SRGB data is uploaded as is into the matching UNORM format, the shaders decode base color like for PNG / JPEG images
+            decoded.Format = GetUnormFormat(ktx2.GetFormat());
+        }
+
+        if(decoded.Format == VK_FORMAT_UNDEFINED)
+        {
+            logger()->warn("Model Load: Image #{} \"{}\": KTX2 format {} with supercompression scheme {} is not supported", imageIndex, mGltfModel.images[imageIndex].name,
+                           (uint32_t)ktx2.GetFormat(), (uint32_t)ktx2.GetSupercompression());
+            return false;
+        }
+
+        decoded.Width  = (int32_t)ktx2.GetWidth();
+        decoded.Height = (int32_t)ktx2.GetHeight();
+
+        // Levels are packed into one staging range, each aligned to 16 bytes (a multiple of every supported block size)
+        FormatBlockInfo blockInfo = GetFormatBlockInfo(decoded.Format);
+        VkDeviceSize    offset    = 0;
+        decoded.Levels.clear();
+        for(uint32_t i = 0; i < ktx2.GetLevels().size(); i++)
+        {
+            const Ktx2Texture::Level& level = ktx2.GetLevels()[i];
+            decoded.Levels.push_back(VkBufferImageCopy{
+                .bufferOffset      = offset,
+                .imageSubresource  = VkImageSubresourceLayers{.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = i, .baseArrayLayer = 0, .layerCount = 1},
+                .imageExtent       = VkExtent3D{.width = level.Width, .height = level.Height, .depth = 1},
+            });
+            offset += (blockInfo.GetImageSize(level.Width, level.Height) + 15) / 16 * 16;
+        }
+
+        // Block compressed images can't be blitted, they are used with the levels the file provides
+        decoded.GenerateMips = !ktx2.HasMipChain() && !blockInfo.IsCompressed()
+                               && HasFormatFeatures(decoded.Format, VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
+        return true;
+    }
+
+    VkFormat ModelConverter::SelectCookedFormat(ETextureUsage usage, bool hasAlpha) const
+    {
+        const VkFormatFeatureFlags features = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+        if(usage == ETextureUsage::Normal)
+        {
+            // Two channels at full BC4 precision each, the shaders reconstruct z
+            return HasFormatFeatures(VK_FORMAT_BC5_UNORM_BLOCK, features) ? VK_FORMAT_BC5_UNORM_BLOCK : VK_FORMAT_UNDEFINED;
+        }
+        if(mConfig.CookToBC7 && HasFormatFeatures(VK_FORMAT_BC7_UNORM_BLOCK, features))
+        {
+            return VK_FORMAT_BC7_UNORM_BLOCK;
+        }
+        VkFormat format = hasAlpha ? VK_FORMAT_BC3_UNORM_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+        return HasFormatFeatures(format, features) ? format : VK_FORMAT_UNDEFINED;
+    }
+
+    void ModelConverter::GetImageUsages(std::vector<ETextureUsage>& outusages) const
+    {
+        outusages.assign(mGltfModel.images.size(), ETextureUsage::Color);
+        std::vector<bool> assigned(mGltfModel.images.size(), false);
+
+        auto lAssign = [&](int32_t textureIndex, ETextureUsage usage) {
+            if(textureIndex < 0 || textureIndex >= (int32_t)mGltfModel.textures.size())
+            {
+                return;
+            }
+            int32_t imageIndex = GetTextureImageIndex(textureIndex);
+            if(imageIndex < 0 || imageIndex >= (int32_t)outusages.size())
+            {
+                return;
+            }
+            // Images shared between slots of different usage are treated as plain data (no gamma, all channels kept)
+            outusages[imageIndex] = assigned[imageIndex] && outusages[imageIndex] != usage ? ETextureUsage::Data : usage;
+            assigned[imageIndex]  = true;
+        };
+
+        for(const tinygltf::Material& material : mGltfModel.materials)
+        {
+            lAssign(material.pbrMetallicRoughness.baseColorTexture.index, ETextureUsage::Color);
+            lAssign(material.emissiveTexture.index, ETextureUsage::Color);
+            lAssign(material.pbrMetallicRoughness.metallicRoughnessTexture.index, ETextureUsage::Data);
+            lAssign(material.occlusionTexture.index, ETextureUsage::Data);
+            lAssign(material.normalTexture.index, ETextureUsage::Normal);
+        }
+    }
+
+    int32_t ModelConverter::GetTextureImageIndex(int32_t textureIndex) const
+    {
+        const tinygltf::Texture& gltfTexture = mGltfModel.textures[textureIndex];
+
+        auto basisu = gltfTexture.extensions.find("KHR_texture_basisu");
+        if(basisu != gltfTexture.extensions.end() && basisu->second.Has("source"))
+        {
+            int32_t source = basisu->second.Get("source").GetNumberAsInt();
+            if(source >= 0 && (size_t)source < mDecodedImages.size() && mDecodedImages[source].Format != VK_FORMAT_UNDEFINED)
+            {
+                return source;
+            }
+        }
+        return gltfTexture.source;
+    }
+
+    GltfBufferData ModelConverter::GetEncodedImage(int32_t imageIndex) const
+    {
+        if((size_t)imageIndex < mMappedImages.size() && mMappedImages[imageIndex].Data)
+        {
+            return mMappedImages[imageIndex];
+        }
+        const tinygltf::Image& image = mGltfModel.images[imageIndex];
+        return GltfBufferData{.Data = image.image.data(), .Size = image.image.size()};
+    }
+
+    void ModelConverter::DecodeImages()
+    {
+        mDecodedImages.clear();
+        mDecodedImages.resize(mGltfModel.images.size());
+        mDecodedImageCount = 0;
+
+        // KTX2 images are inspected first: Textures with a usable KHR_texture_basisu source don't need their fallback image decoded
+        for(int32_t i = 0; i < mGltfModel.images.size(); i++)
+        {
+            auto&          gltfImage = mGltfModel.images[i];
+            GltfBufferData encoded   = GetEncodedImage(i);
+            mLoadStats.EncodedImageBytes += encoded.Size;
+            if(gltfImage.as_is && Ktx2Texture::HasIdentifier(encoded.Data, encoded.Size))
+            {
+                auto& decoded = mDecodedImages[i];
+                decoded.Ktx2.Read(encoded.Data, encoded.Size);
+                SelectKtx2Format(i, decoded);
+            }
+        }
+
+        std::vector<bool> imageUsed(mGltfModel.images.size(), false);
         for(int32_t i = 0; i < mGltfModel.textures.size(); i++)
         {
-            const auto& gltfTexture = mGltfModel.textures[i];
-            const auto& gltfImage   = mGltfModel.images[gltfTexture.source];
+            int32_t imageIndex = GetTextureImageIndex(i);
+            if(imageIndex >= 0 && (size_t)imageIndex < imageUsed.size())
+            {
+                imageUsed[imageIndex] = true;
+            }
+        }
+
+        std::unique_ptr<TextureCooker> cooker;
+        std::vector<ETextureUsage>     imageUsages;
+        if(mConfig.TextureCacheDirectory.size())
+        {
+            cooker = std::make_unique<TextureCooker>(mConfig.TextureCacheDirectory);
+            GetImageUsages(imageUsages);
+        }
 
-            std::string textureName;
-            textureName = gltfTexture.name;
-            if(!textureName.size())
+        // Staging memory is sized from the image headers and allocated from the upload batch, the workers only write to the mapped memory
+        for(int32_t i = 0; i < mGltfModel.images.size(); i++)
+        {
+            auto&          gltfImage = mGltfModel.images[i];
+            auto&          decoded   = mDecodedImages[i];
+            GltfBufferData encoded   = GetEncodedImage(i);
+            if(!gltfImage.as_is || !encoded.Size || !imageUsed[i])
             {
-                textureName = gltfImage.name;
+                continue;
             }
-            if(!textureName.size())
+
+            if(decoded.Ktx2.GetData())
             {
-                textureName = fmt::format("Texture #{}", i);
+                if(decoded.Format == VK_FORMAT_UNDEFINED)
+                {
+                    // Not usable on this device, UploadTexture() reports textures without other source
+                    continue;
+                }
+                const VkBufferImageCopy& last = decoded.Levels.back();
+                decoded.Staging = mUploads.AllocateStaging(last.bufferOffset + GetFormatBlockInfo(decoded.Format).GetImageSize(last.imageExtent.width, last.imageExtent.height));
+                continue;
             }
 
-            logger()->debug("Model Load: Processing texture #{} \"{}\"", i, textureName);
+            int32_t width      = 0;
+            int32_t height     = 0;
+            int32_t components = 0;
+            if(!stbi_info_from_memory(encoded.Data, (int)encoded.Size, &width, &height, &components))
+            {
+                HSK_THROWFMT("Model Load: Unable to read header of image #{} \"{}\": {}", i, gltfImage.name, stbi_failure_reason());
+            }
 
-            mTextures.GetTextures().push_back(SampledTexture{.Image = std::make_unique<ManagedImage>(), .Sampler = nullptr});
-            SampledTexture& sampledTexture = mTextures.GetTextures().back();
+            decoded.Width  = width;
+            decoded.Height = height;
 
-            const unsigned char* buffer     = nullptr;
-            VkDeviceSize         bufferSize = 0;
-            if(gltfImage.component == 3)
+            VkFormat cookedFormat = cooker ? SelectCookedFormat(imageUsages[i], components == 2 || components == 4) : VK_FORMAT_UNDEFINED;
+            if(cookedFormat != VK_FORMAT_UNDEFINED)
             {
-                // Most devices don't support RGB only on Vulkan so convert if necessary
-                // TODO: Check actual format support and transform only if required
-                bufferSize = gltfImage.width * gltfImage.height * 4;
-                rgbaConvertBuffer.resize(bufferSize);
-                buffer                          = rgbaConvertBuffer.data();
-                unsigned char*       rgba       = rgbaConvertBuffer.data();
-                const unsigned char* rgb        = &gltfImage.image[0];
-                int32_t              pixelCount = gltfImage.width * gltfImage.height;
-                for(int32_t i = 0; i < pixelCount; ++i)
+                decoded.Format       = cookedFormat;
+                decoded.Cook         = true;
+                decoded.Usage        = imageUsages[i];
+                decoded.GenerateMips = false;
+                decoded.Staging      = mUploads.AllocateStaging(TextureCooker::ComputeLevels(cookedFormat, width, height, decoded.Levels));
+                continue;
+            }
+
+            decoded.Levels  = {VkBufferImageCopy{
+                 .imageSubresource = VkImageSubresourceLayers{.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = 0, .baseArrayLayer = 0, .layerCount = 1},
+                 .imageExtent      = VkExtent3D{.width = (uint32_t)width, .height = (uint32_t)height, .depth = 1},
+            }};
+            decoded.Staging = mUploads.AllocateStaging((VkDeviceSize)width * height * 4);
+        }
+
+        std::atomic<uint32_t> cookedCount = 0;
+        std::atomic<uint32_t> cacheHits   = 0;
+
+        ThreadPool& workers = mConfig.Workers ? *mConfig.Workers : ThreadPool::Default();
+        workers.ParallelFor(mDecodedImages.size(), [this, &cooker, &cookedCount, &cacheHits](size_t i) {
+            auto& decoded = mDecodedImages[i];
+            if(!decoded.Staging.Mapped)
+            {
+                return;
+            }
+            auto&          gltfImage = mGltfModel.images[i];
+            GltfBufferData encoded   = GetEncodedImage((int32_t)i);
+
+            if(decoded.Ktx2.GetData())
+            {
+                const Ktx2Texture& ktx2      = decoded.Ktx2;
+                FormatBlockInfo    blockInfo = GetFormatBlockInfo(decoded.Format);
+                decoded.ContentHash          = ComputeImageHashSeed(decoded.Format, ktx2.GetWidth(), ktx2.GetHeight(), (uint32_t)decoded.Levels.size());
+                for(uint32_t level = 0; level < decoded.Levels.size(); level++)
                 {
-                    for(int32_t j = 0; j < 3; ++j)
+                    const VkBufferImageCopy& region = decoded.Levels[level];
+                    decoded.ContentHash             = HashBytes(ktx2.GetLevelData(level), ktx2.GetLevels()[level].Size, decoded.ContentHash);
+                    uint8_t*                 dst    = reinterpret_cast<uint8_t*>(decoded.Staging.Mapped) + region.bufferOffset;
+                    memcpy(dst, ktx2.GetLevelData(level), blockInfo.GetImageSize(region.imageExtent.width, region.imageExtent.height));
+                }
+                // References the encoded data released below
+                decoded.Ktx2 = Ktx2Texture{};
+            }
+            else
+            {
+                uint8_t* mapped   = reinterpret_cast<uint8_t*>(decoded.Staging.Mapped);
+                uint64_t cacheKey = 0;
+                bool     cached   = false;
+                if(decoded.Cook)
+                {
+                    cacheKey = TextureCooker::ComputeKey(encoded.Data, encoded.Size, decoded.Format, decoded.Usage);
+                    cached   = cooker->Load(cacheKey, decoded.Format, decoded.Levels, mapped);
+                    cacheHits += cached ? 1 : 0;
+                    // The key covers source content and cook settings, so it identifies the cooked result as well
+                    decoded.ContentHash = HashBytes(&cacheKey, sizeof(cacheKey), ComputeImageHashSeed(decoded.Format, decoded.Width, decoded.Height, (uint32_t)decoded.Levels.size()));
+                }
+                if(!cached)
+                {
+                    // Vulkan devices rarely support RGB formats, so always expand to RGBA
+                    int32_t  width      = 0;
+                    int32_t  height     = 0;
+                    int32_t  components = 0;
+                    stbi_uc* pixels     = stbi_load_from_memory(encoded.Data, (int)encoded.Size, &width, &height, &components, 4);
+                    if(!pixels || width != decoded.Width || height != decoded.Height)
+                    {
+                        HSK_THROWFMT("Model Load: Unable to decode image #{} \"{}\": {}", i, gltfImage.name, pixels ? "Size mismatch" : stbi_failure_reason());
+                    }
+                    if(decoded.Cook)
                     {
-                        rgba[j] = rgb[j];
+                        TextureCooker::Cook(pixels, decoded.Usage, decoded.Format, decoded.Levels, mapped);
+                        cooker->Store(cacheKey, decoded.Format, decoded.Levels, mapped);
+                        cookedCount++;
                     }
-                    rgba += 4;
-                    rgb += 3;
+                    else
+                    {
+                        memcpy(mapped, pixels, (size_t)width * height * 4);
+                        decoded.ContentHash = HashBytes(pixels, (size_t)width * height * 4, ComputeImageHashSeed(decoded.Format, width, height, 1));
+                    }
+                    stbi_image_free(pixels);
                 }
+                gltfImage.component = 4;
             }
-            else
+
+            // Encoded data is no longer needed (mapped images are released with the mapping)
+            std::vector<unsigned char>().swap(gltfImage.image);
+            gltfImage.width  = decoded.Width;
+            gltfImage.height = decoded.Height;
+            mDecodedImageCount++;
+        });
+
+        if(cooker)
+        {
+            logger()->info("Model Load: Cooked {} images, {} read from texture cache \"{}\"", cookedCount.load(), cacheHits.load(), cooker->GetCacheDirectory().string());
+        }
+    }
+
+    void ModelConverter::TranslateTextures()
+    {
+        mRecords.Textures.resize(mGltfModel.textures.size());
+        for(int32_t i = 0; i < mGltfModel.textures.size(); i++)
+        {
+            const auto&    gltfTexture = mGltfModel.textures[i];
+            TextureRecord& texture     = mRecords.Textures[i];
+
+            texture.ImageIndex = GetTextureImageIndex(i);
+            bool basisuOnly    = gltfTexture.extensions.find("KHR_texture_basisu") != gltfTexture.extensions.end()
+                              && (texture.ImageIndex < 0 || ((size_t)texture.ImageIndex < mDecodedImages.size() && mDecodedImages[texture.ImageIndex].Ktx2.IsBasisUniversal()));
+            HSK_ASSERTFMT(!basisuOnly,
+                          "Model Load: Texture #{} \"{}\" only has a Basis Universal (KHR_texture_basisu) source. Basis Universal transcoding is not supported, "
+                          "provide a PNG / JPEG fallback source or KTX2 images with a block compressed Vulkan format",
+                          i, gltfTexture.name)
+            HSK_ASSERTFMT(texture.ImageIndex >= 0 && (size_t)texture.ImageIndex < mGltfModel.images.size(),
+                          "Model Load: Texture #{} \"{}\" has no image source supported by this device!", i, gltfTexture.name)
+
+            texture.Name = gltfTexture.name;
+            if(!texture.Name.size())
             {
-                buffer     = &gltfImage.image[0];
-                bufferSize = gltfImage.image.size();
+                texture.Name = mGltfModel.images[texture.ImageIndex].name;
+            }
+            if(!texture.Name.size())
+            {
+                texture.Name = fmt::format("Texture #{}", i);
             }
 
-            uint32_t   mipLevelCount = (uint32_t)(floorf(log2f(std::max(gltfImage.width, gltfImage.height))));
-            VkExtent2D extent        = VkExtent2D{.width = (uint32_t)gltfImage.width, .height = (uint32_t)gltfImage.height};
-
-            ManagedImage::CreateInfo imageCI;
-            imageCI.AllocCI.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
-
-            imageCI.ImageCI.imageType     = VK_IMAGE_TYPE_2D;
-            imageCI.ImageCI.format        = VkFormat::VK_FORMAT_R8G8B8A8_UNORM;
-            imageCI.ImageCI.mipLevels     = mipLevelCount;
-            imageCI.ImageCI.arrayLayers   = 1;
-            imageCI.ImageCI.samples       = VK_SAMPLE_COUNT_1_BIT;
-            imageCI.ImageCI.tiling        = VK_IMAGE_TILING_OPTIMAL;
-            imageCI.ImageCI.usage         = VK_IMAGE_USAGE_SAMPLED_BIT;
-            imageCI.ImageCI.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
-            imageCI.ImageCI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            imageCI.ImageCI.extent        = VkExtent3D{.width = extent.width, .height = extent.height, .depth = 1};
-            imageCI.ImageCI.usage         = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-
-            imageCI.ImageViewCI.viewType                    = VK_IMAGE_VIEW_TYPE_2D;
-            imageCI.ImageViewCI.format                      = VkFormat::VK_FORMAT_R8G8B8A8_UNORM;
-            imageCI.ImageViewCI.components                  = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A};
-            imageCI.ImageViewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            imageCI.ImageViewCI.subresourceRange.layerCount = 1;
-            imageCI.ImageViewCI.subresourceRange.levelCount = mipLevelCount;
-            imageCI.Name                                    = textureName;
-
-            sampledTexture.Image->Create(mContext, imageCI);
-            sampledTexture.Image->WriteDeviceLocalData(buffer, bufferSize, VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-
-            CommandBuffer cmdBuf;
-            cmdBuf.Create(mContext, VkCommandBufferLevel::VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
-
-            for(int32_t i = 0; i < mipLevelCount - 1; i++)
-            {
-                uint32_t sourceMipLevel = (uint32_t)i;
-                uint32_t destMipLevel   = sourceMipLevel + 1;
-
-                // Step #1 Transition dest miplevel to transfer dst optimal
-                VkImageSubresourceRange mipSubRange = {};
-                mipSubRange.aspectMask              = VK_IMAGE_ASPECT_COLOR_BIT;
-                mipSubRange.baseMipLevel            = destMipLevel;
-                mipSubRange.levelCount              = 1;
-                mipSubRange.layerCount              = 1;
-
-                ManagedImage::LayoutTransitionInfo layoutTransition;
-                layoutTransition.CommandBuffer        = cmdBuf.GetCommandBuffer();
-                layoutTransition.OldImageLayout       = VK_IMAGE_LAYOUT_UNDEFINED;
-                layoutTransition.NewImageLayout       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-                layoutTransition.BarrierSrcAccessMask = 0;
-                layoutTransition.BarrierDstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-                layoutTransition.SubresourceRange     = mipSubRange;
-                layoutTransition.SrcStage             = VkPipelineStageFlagBits::VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
-                layoutTransition.DstStage             = VkPipelineStageFlagBits::VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
-
-                sampledTexture.Image->TransitionLayout(layoutTransition);
-
-                VkOffset3D  srcArea{.x = (int32_t)extent.width >> i, .y = (int32_t)extent.height >> i, .z = 1};
-                VkOffset3D  dstArea{.x = (int32_t)extent.width >> i + 1, .y = (int32_t)extent.height >> i + 1, .z = 1};
-                VkImageBlit blit{
-                    .srcSubresource =
-                        VkImageSubresourceLayers{.aspectMask = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = (uint32_t)i, .baseArrayLayer = 0, .layerCount = 1},
-                    .dstSubresource = VkImageSubresourceLayers{
-                        .aspectMask = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = (uint32_t)i + 1, .baseArrayLayer = 0, .layerCount = 1}};
-                blit.srcOffsets[1] = srcArea;
-                blit.dstOffsets[1] = dstArea;
-                vkCmdBlitImage(cmdBuf.GetCommandBuffer(), sampledTexture.Image->GetImage(), VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, sampledTexture.Image->GetImage(),
-                               VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VkFilter::VK_FILTER_LINEAR);
-
-                // Step #3 Transition dest miplevel to transfer src optimal
-                layoutTransition.OldImageLayout       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-                layoutTransition.NewImageLayout       = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-                layoutTransition.BarrierSrcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
-                layoutTransition.BarrierDstAccessMask = 0;
-
-                sampledTexture.Image->TransitionLayout(layoutTransition);
-            }
-
-            {
-                // All mip levels are transfer src optimal after mip creation, fix it
-
-                VkImageSubresourceRange mipSubRange = {
-                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = VK_REMAINING_MIP_LEVELS, .layerCount = VK_REMAINING_ARRAY_LAYERS};
-                ManagedImage::LayoutTransitionInfo layoutTransition;
-                layoutTransition.CommandBuffer        = cmdBuf.GetCommandBuffer();
-                layoutTransition.OldImageLayout       = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
-                layoutTransition.NewImageLayout       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                layoutTransition.BarrierSrcAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
-                layoutTransition.BarrierDstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
-                layoutTransition.SubresourceRange     = mipSubRange;
-                layoutTransition.SrcStage             = VkPipelineStageFlagBits::VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
-                layoutTransition.DstStage             = VkPipelineStageFlagBits::VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
-
-                sampledTexture.Image->TransitionLayout(layoutTransition);
-            }
-
-            cmdBuf.Submit();
-
-            VkSamplerCreateInfo samplerCI
+            texture.SamplerCI = VkSamplerCreateInfo
             {
                 .sType = VkStructureType::VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO, .magFilter = VkFilter::VK_FILTER_LINEAR, .minFilter = VkFilter::VK_FILTER_LINEAR,
                 .addressModeU = VkSamplerAddressMode::VK_SAMPLER_ADDRESS_MODE_REPEAT, .addressModeV = VkSamplerAddressMode::VK_SAMPLER_ADDRESS_MODE_REPEAT,
@@ -170,11 +395,243 @@ namespace hsk {
             };
             if(gltfTexture.sampler >= 0)
             {
-                TranslateSampler(mGltfModel.samplers[gltfTexture.sampler], samplerCI);
+                TranslateSampler(mGltfModel.samplers[gltfTexture.sampler], texture.SamplerCI);
+            }
+        }
+    }
+
+    void ModelConverter::LoadTextures()
+    {
+        for(int32_t i = 0; i < mRecords.Textures.size(); i++)
+        {
+            UploadTexture(i);
+        }
+    }
+
+    void ModelConverter::UploadTexture(int32_t textureIndex)
+    {
+        if(mLoadedTextures.size() < mRecords.Textures.size())
+        {
+            mLoadedTextures.resize(mRecords.Textures.size());
+            mLoadedTextureHashes.resize(mRecords.Textures.size());
+        }
+
+        std::vector<uint8_t> rgbaConvertBuffer{};
+        const TextureRecord& texture     = mRecords.Textures[textureIndex];
+        int32_t              imageIndex  = texture.ImageIndex;
+        const std::string&   textureName = texture.Name;
+
+        logger()->debug("Model Load: Processing texture #{} \"{}\"", textureIndex, textureName);
+
+        SampledTexture& sampledTexture = mLoadedTextures[textureIndex];
+
+        const unsigned char* buffer     = nullptr;
+        VkDeviceSize         bufferSize = 0;
+        const DecodedImage*  decoded    = nullptr;
+        VkFormat             format     = VkFormat::VK_FORMAT_R8G8B8A8_UNORM;
+        VkExtent2D           extent     = {};
+        if((size_t)imageIndex < mDecodedImages.size() && mDecodedImages[imageIndex].Staging.Mapped)
+        {
+            // Decoded in parallel (or read from the import cache), pixels (or compressed blocks) are already in staging memory
+            decoded = &mDecodedImages[imageIndex];
+            format  = decoded->Format;
+            extent  = VkExtent2D{.width = (uint32_t)decoded->Width, .height = (uint32_t)decoded->Height};
+        }
+        else
+        {
+            const auto& gltfImage = mGltfModel.images[imageIndex];
+            extent                = VkExtent2D{.width = (uint32_t)gltfImage.width, .height = (uint32_t)gltfImage.height};
+            if(gltfImage.as_is)
+            {
+                HSK_THROWFMT("Model Load: Image #{} \"{}\" of texture #{} could not be decoded!", imageIndex, gltfImage.name, textureIndex);
+            }
+            else if(gltfImage.component == 3)
+            {
+                // Most devices don't support RGB only on Vulkan so convert if necessary
+                // TODO: Check actual format support and transform only if required
+                bufferSize = gltfImage.width * gltfImage.height * 4;
+                rgbaConvertBuffer.resize(bufferSize);
+                buffer = rgbaConvertBuffer.data();
+                PixelOps::ExpandRgbToRgba(&gltfImage.image[0], rgbaConvertBuffer.data(), (size_t)gltfImage.width * gltfImage.height);
+            }
+            else
+            {
+                buffer     = &gltfImage.image[0];
+                bufferSize = gltfImage.image.size();
             }
+        }
 
-            sampledTexture.Sampler = mTextures.GetOrCreateSampler(samplerCI);
+        // Textures with identical content share one image, within this model and with all models already attached to the scene
+        uint64_t contentHash = decoded ? decoded->ContentHash : HashBytes(buffer, (size_t)bufferSize, ComputeImageHashSeed(format, extent.width, extent.height, 1));
+
+        std::shared_ptr<ManagedImage> image;
+        auto                          find = mLoadedImages.find(contentHash);
+        if(find != mLoadedImages.end())
+        {
+            image = find->second;
+        }
+        else
+        {
+            image = mTextures.FindImage(contentHash);
+        }
+        if(!image && mSharedImages)
+        {
+            // Models loading concurrently share identical images as well. The registry only holds images whose upload has been recorded successfully.
+            std::lock_guard<std::mutex> lock(mSharedImages->Mutex);
+            auto                        shared = mSharedImages->Images.find(contentHash);
+            if(shared != mSharedImages->Images.end())
+            {
+                image = shared->second;
+            }
+        }
+        // Pixels are not compared on a hash hit (see TextureStore), but a hit with a different format or size is a certain collision
+        if(image && (image->GetFormat() != format || image->GetExtent3D().width != extent.width || image->GetExtent3D().height != extent.height))
+        {
+            logger()->warn("Model Load: Texture #{} \"{}\" collides with the content hash of a different image, uploading it separately", textureIndex, textureName);
+            image = nullptr;
+        }
+        if(image)
+        {
+            logger()->debug("Model Load: Texture #{} \"{}\" reuses an identical image", textureIndex, textureName);
+            mDeduplicatedImageCount++;
+        }
+        else
+        {
+            image = std::make_shared<ManagedImage>();
+            UploadImage(*image, textureName, decoded, buffer, bufferSize, extent);
+            if(mSharedImages)
+            {
+                // Registered only now, so a failed upload is never picked up by another model. Should another converter have registered the same
+                // content meanwhile, this model keeps its own copy.
+                std::lock_guard<std::mutex> lock(mSharedImages->Mutex);
+                mSharedImages->Images.emplace(contentHash, image);
+            }
         }
+        mLoadedImages[contentHash]         = image;
+        mLoadedTextureHashes[textureIndex] = contentHash;
+        sampledTexture                     = SampledTexture{.Image = std::move(image), .Sampler = mTextures.GetOrCreateSampler(texture.SamplerCI)};
+        // Pixels decoded by tinygltf have been copied to staging memory. Released once no later texture uses the image.
+        auto lUsesImage = [imageIndex](const TextureRecord& other) { return other.ImageIndex == imageIndex; };
+        if(!decoded && std::none_of(mRecords.Textures.begin() + textureIndex + 1, mRecords.Textures.end(), lUsesImage))
+        {
+            std::vector<unsigned char>().swap(mGltfModel.images[imageIndex].image);
+        }
+    }
+
+    void ModelConverter::UploadImage(ManagedImage& image, const std::string& name, const DecodedImage* decoded, const unsigned char* buffer, VkDeviceSize bufferSize, VkExtent2D extent)
+    {
+        VkFormat format        = decoded ? decoded->Format : VkFormat::VK_FORMAT_R8G8B8A8_UNORM;
+        bool     generateMips  = !decoded || decoded->GenerateMips;
+        uint32_t mipLevelCount = generateMips ? (uint32_t)(floorf(log2f(std::max(extent.width, extent.height)))) : (uint32_t)decoded->Levels.size();
+
+        ManagedImage::CreateInfo imageCI;
+        imageCI.AllocCI.usage = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+        imageCI.ImageCI.imageType     = VK_IMAGE_TYPE_2D;
+        imageCI.ImageCI.format        = format;
+        imageCI.ImageCI.mipLevels     = mipLevelCount;
+        imageCI.ImageCI.arrayLayers   = 1;
+        imageCI.ImageCI.samples       = VK_SAMPLE_COUNT_1_BIT;
+        imageCI.ImageCI.tiling        = VK_IMAGE_TILING_OPTIMAL;
+        imageCI.ImageCI.usage         = VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageCI.ImageCI.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+        imageCI.ImageCI.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        imageCI.ImageCI.extent        = VkExtent3D{.width = extent.width, .height = extent.height, .depth = 1};
+        imageCI.ImageCI.usage         = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | (generateMips ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0);
+
+        imageCI.ImageViewCI.viewType                    = VK_IMAGE_VIEW_TYPE_2D;
+        imageCI.ImageViewCI.format                      = format;
+        imageCI.ImageViewCI.components                  = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A};
+        imageCI.ImageViewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        imageCI.ImageViewCI.subresourceRange.layerCount = 1;
+        imageCI.ImageViewCI.subresourceRange.levelCount = mipLevelCount;
+        imageCI.Name                                    = name;
+
+        image.Create(mContext, imageCI);
+        // Upload and mip map generation are recorded into the upload batch, submitted once for all textures
+        // Images with a complete mip chain in staging memory are ready for sampling right after the copy
+        VkImageLayout layoutAfterWrite = generateMips ? VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        if(decoded)
+        {
+            mUploads.CopyToImage(image, decoded->Staging, layoutAfterWrite, decoded->Levels);
+        }
+        else
+        {
+            mUploads.UploadImage(image, buffer, bufferSize, layoutAfterWrite);
+        }
+
+        VkCommandBuffer commandBuffer = mUploads.GetCommandBuffer();
+
+        for(int32_t i = 0; generateMips && i < mipLevelCount - 1; i++)
+        {
+            uint32_t sourceMipLevel = (uint32_t)i;
+            uint32_t destMipLevel   = sourceMipLevel + 1;
+
+            // Step #1 Transition dest miplevel to transfer dst optimal
+            VkImageSubresourceRange mipSubRange = {};
+            mipSubRange.aspectMask              = VK_IMAGE_ASPECT_COLOR_BIT;
+            mipSubRange.baseMipLevel            = destMipLevel;
+            mipSubRange.levelCount              = 1;
+            mipSubRange.layerCount              = 1;
+
+            ManagedImage::LayoutTransitionInfo layoutTransition;
+            layoutTransition.CommandBuffer        = commandBuffer;
+            layoutTransition.OldImageLayout       = VK_IMAGE_LAYOUT_UNDEFINED;
+            layoutTransition.NewImageLayout       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            layoutTransition.BarrierSrcAccessMask = 0;
+            layoutTransition.BarrierDstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            layoutTransition.SubresourceRange     = mipSubRange;
+            layoutTransition.SrcStage             = VkPipelineStageFlagBits::VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            layoutTransition.DstStage             = VkPipelineStageFlagBits::VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+            image.TransitionLayout(layoutTransition);
+
+            VkOffset3D  srcArea{.x = (int32_t)extent.width >> i, .y = (int32_t)extent.height >> i, .z = 1};
+            VkOffset3D  dstArea{.x = (int32_t)extent.width >> i + 1, .y = (int32_t)extent.height >> i + 1, .z = 1};
+            VkImageBlit blit{
+                .srcSubresource =
+                    VkImageSubresourceLayers{.aspectMask = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = (uint32_t)i, .baseArrayLayer = 0, .layerCount = 1},
+                .dstSubresource = VkImageSubresourceLayers{
+                    .aspectMask = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = (uint32_t)i + 1, .baseArrayLayer = 0, .layerCount = 1}};
+            blit.srcOffsets[1] = srcArea;
+            blit.dstOffsets[1] = dstArea;
+            vkCmdBlitImage(commandBuffer, image.GetImage(), VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image.GetImage(),
+                           VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VkFilter::VK_FILTER_LINEAR);
+
+            // Step #3 Transition dest miplevel to transfer src optimal
+            layoutTransition.OldImageLayout       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            layoutTransition.NewImageLayout       = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            // Blit writes have to be visible to the next blit reading this level (all mip blits are recorded into the same command buffer)
+            layoutTransition.BarrierSrcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            layoutTransition.BarrierDstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+            image.TransitionLayout(layoutTransition);
+        }
+
+        if(generateMips)
+        {
+            // All mip levels are transfer src optimal after mip creation, fix it
+
+            VkImageSubresourceRange mipSubRange = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = VK_REMAINING_MIP_LEVELS, .layerCount = VK_REMAINING_ARRAY_LAYERS};
+            ManagedImage::LayoutTransitionInfo layoutTransition;
+            layoutTransition.CommandBuffer        = commandBuffer;
+            layoutTransition.OldImageLayout       = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            layoutTransition.NewImageLayout       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+            layoutTransition.BarrierSrcAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+            layoutTransition.BarrierDstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT;
+            layoutTransition.SubresourceRange     = mipSubRange;
+            layoutTransition.SrcStage             = VkPipelineStageFlagBits::VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            layoutTransition.DstStage             = VkPipelineStageFlagBits::VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+            image.TransitionLayout(layoutTransition);
+        }
+    }
+
+    uint64_t ModelConverter::ComputeImageHashSeed(VkFormat format, uint32_t width, uint32_t height, uint32_t levelCount)
+    {
+        uint32_t header[4] = {(uint32_t)format, width, height, levelCount};
+        return HashBytes(header, sizeof(header));
     }
 
     void ModelConverter::TranslateSampler(const tinygltf::Sampler& tinygltfSampler, VkSamplerCreateInfo& outsamplerCI)
@@ -0,0 +1,141 @@
+#include "hsk_multimodelload.hpp"
+#include "../base/hsk_vkcontext.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace hsk {
+    namespace {
+        /// @brief Every model keeps its staging memory until the commit, smaller chunks keep the overhead of small models low
+        const VkDeviceSize STAGING_CHUNK_SIZE = 16 * 1024 * 1024;
+    }  // namespace
+
+    MultiModelLoad::MultiModelLoad(Scene* scene) : mScene(scene) {}
+
+    size_t MultiModelLoad::Load(const std::vector<std::string>& utf8Paths, const VkContext* context)
+    {
+        auto loadStart = std::chrono::steady_clock::now();
+        context        = context ? context : mScene->GetContext();
+
+        mResults.clear();
+        mResults.resize(utf8Paths.size());
+        mSubmitMs = 0.0;
+
+        // Identical images of different models are uploaded by whichever converter gets to them first
+        ModelConverter::SharedImageRegistry          sharedImages;
+        std::vector<std::unique_ptr<ModelConverter>> converters(utf8Paths.size());
+        for(size_t i = 0; i < utf8Paths.size(); i++)
+        {
+            mResults[i].Path = utf8Paths[i];
+            converters[i]    = std::make_unique<ModelConverter>(mScene);
+            converters[i]->SetConfig(mConfig);
+            converters[i]->mContext      = context;
+            converters[i]->mSharedImages = &sharedImages;
+            // Recording into the context's command pool from several threads is not allowed
+            converters[i]->mUploads.Create(context, STAGING_CHUNK_SIZE, true);
+        }
+
+        // Plain threads instead of pool tasks: The converters distribute their own work (image decoding, mesh optimization) on the worker pool
+        uint32_t threadCount = mMaxConcurrentModels ? mMaxConcurrentModels : std::max(std::thread::hardware_concurrency(), 1u);
+        threadCount          = (uint32_t)std::min<size_t>(threadCount, utf8Paths.size());
+
+        std::atomic<size_t> nextModel = 0;
+        auto                lConvert  = [&]() {
+            for(size_t i = nextModel++; i < converters.size(); i = nextModel++)
+            {
+                Convert(*converters[i], mResults[i]);
+            }
+        };
+        std::vector<std::thread> threads;
+        for(uint32_t i = 1; i < threadCount; i++)
+        {
+            threads.emplace_back(lConvert);
+        }
+        lConvert();
+        for(std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        // Batches of failed models are submitted as well, their images may be shared by other models
+        ModelConverter::MeasurePhase(mSubmitMs, [&]() {
+            for(auto& converter : converters)
+            {
+                converter->mUploads.Submit(false);
+            }
+            for(auto& converter : converters)
+            {
+                converter->mUploads.WaitIdle();
+            }
+        });
+
+        size_t          loadedCount  = 0;
+        ModelConverter* lastAttached = nullptr;
+        for(size_t i = 0; i < converters.size(); i++)
+        {
+            ModelConverter& converter = *converters[i];
+            Result&         result    = mResults[i];
+            if(result.Success)
+            {
+                try
+                {
+                    ModelConverter::MeasurePhase(converter.mLoadStats.AttachToSceneMs, [&]() { converter.AttachToScene(); });
+                    converter.mLoadStats.TotalMs += converter.mLoadStats.AttachToSceneMs;
+                    result.Textures = converter.GetAttachedTextures();
+                    lastAttached    = &converter;
+                    loadedCount++;
+                }
+                catch(const Exception& ex)
+                {
+                    Fail(result, ex.what());
+                }
+                catch(const std::exception& ex)
+                {
+                    Fail(result, ex.what());
+                }
+            }
+            result.Stats = converter.GetLoadStats();
+        }
+        // Root node matrices and the material buffer are updated once for all models
+        if(lastAttached)
+        {
+            lastAttached->InitialUpdate();
+        }
+        for(auto& converter : converters)
+        {
+            converter->Reset();
+        }
+        converters.clear();
+
+        mTotalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+        logger()->info("Model Load: Loaded {} of {} models ({:.1f} ms, {} threads)", loadedCount, utf8Paths.size(), mTotalMs, threadCount);
+        return loadedCount;
+    }
+
+    void MultiModelLoad::Convert(ModelConverter& converter, Result& result)
+    {
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            converter.ConvertAndRecordUploads(result.Path, nullptr);
+            result.Success = true;
+        }
+        catch(const Exception& ex)
+        {
+            Fail(result, ex.what());
+        }
+        catch(const std::exception& ex)
+        {
+            Fail(result, ex.what());
+        }
+        converter.mLoadStats.TotalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void MultiModelLoad::Fail(Result& result, std::string_view reason)
+    {
+        logger()->error("Model Load: Loading \"{}\" failed: {}", result.Path, reason);
+        result.Success = false;
+        result.Error   = reason;
+    }
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+#include "hsk_modelconverter.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace hsk {
+
+    /// @brief Loads several models concurrently and attaches all of them to the scene in a single commit
+    /// @remark Every model is converted by its own ModelConverter on its own thread: Parsing, geometry building and image decoding (or reading the import cache),
+    /// then recording all uploads into the converter's UploadBatch. Material ranges, geometry arena ranges and samplers are reserved thread safe, identical images
+    /// of different models are uploaded once. The calling thread then submits all batches, waits for the GPU once and attaches the models in input order,
+    /// so texture indices, material indices and node order don't depend on thread timing.
+    /// Staging memory of all models is held until the commit. Split levels exceeding the available host memory into several Load() calls.
+    class MultiModelLoad : public NoMoveDefaults
+    {
+      public:
+        /// @brief Outcome of loading a single model
+        struct Result
+        {
+            std::string Path    = {};
+            bool        Success = false;
+            /// @brief Reason for the failure if not successful
+            std::string Error = {};
+            /// @brief Phase timings of the model. SubmitMs and SubmitCount stay 0, the commit is shared by all models (see GetSubmitMs()).
+            ModelConverter::LoadStats Stats = {};
+            /// @brief TextureStore indices of the model's textures, see ModelConverter::GetAttachedTextures()
+            std::vector<int32_t> Textures = {};
+        };
+
+        explicit MultiModelLoad(Scene* scene);
+
+        /// @brief Loads all models, blocks until they are attached to the scene. Models failing to load are logged and skipped.
+        /// @param context Context used for device resources. nullptr selects the scene's context.
+        /// @return Number of models loaded successfully
+        size_t Load(const std::vector<std::string>& utf8Paths, const VkContext* context = nullptr);
+
+        HSK_PROPERTY_ALL(Scene)
+        /// @brief Import options used for every model
+        HSK_PROPERTY_ALL(Config)
+        /// @brief Maximum number of models converted at the same time, including the calling thread. 0 selects std::thread::hardware_concurrency()
+        HSK_PROPERTY_ALL(MaxConcurrentModels)
+        /// @brief Outcome of every model of the last Load() call, in input order
+        HSK_PROPERTY_CGET(Results)
+        /// @brief Time spent submitting all upload batches and waiting for their completion in the last Load() call, in milliseconds
+        HSK_PROPERTY_CGET(SubmitMs)
+        /// @brief Wall time of the last Load() call in milliseconds
+        HSK_PROPERTY_CGET(TotalMs)
+
+      protected:
+        Scene*                 mScene               = nullptr;
+        ModelConverter::Config mConfig              = {};
+        uint32_t               mMaxConcurrentModels = 0;
+        std::vector<Result>    mResults             = {};
+        double                 mSubmitMs            = 0.0;
+        double                 mTotalMs             = 0.0;
+
+        /// @brief Converts a model and records its uploads. Runs on a worker thread, failures are stored in result.
+        void Convert(ModelConverter& converter, Result& result);
+        /// @brief Stores the error of a failed load in result
+        void Fail(Result& result, std::string_view reason);
+    };
+}  // namespace hsk
\ No newline at end of file
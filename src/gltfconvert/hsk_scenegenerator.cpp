@@ -0,0 +1,699 @@
+#include "hsk_scenegenerator.hpp"
+#include "../base/hsk_logger.hpp"
+#include "../base/hsk_vkcontext.hpp"
+#include "../hsk_exception.hpp"
+#include "../imageprocessing/hsk_texturecooker.hpp"
+#include "../memory/hsk_managedimage.hpp"
+#include "../memory/hsk_uploadbatch.hpp"
+#include "../scenegraph/components/hsk_meshinstance.hpp"
+#include "../scenegraph/components/hsk_transform.hpp"
+#include "../scenegraph/globalcomponents/hsk_animationdirector.hpp"
+#include "../scenegraph/globalcomponents/hsk_geometrystore.hpp"
+#include "../scenegraph/globalcomponents/hsk_materialbuffer.hpp"
+#include "../scenegraph/globalcomponents/hsk_texturestore.hpp"
+#include "../scenegraph/hsk_scene.hpp"
+#include "../utility/hsk_hash.hpp"
+#include "../utility/hsk_threadpool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <spdlog/fmt/fmt.h>
+#include <tinygltf/stb_image_write.h>
+#include <tinygltf/tiny_gltf.h>
+
+namespace hsk {
+    namespace {
+        /// @brief splitmix64. Unlike the distributions of <random>, the sequence is identical with every standard library.
+        class Random
+        {
+          public:
+            explicit Random(uint64_t seed) : mState(seed) {}
+            /// @brief Independent sequence for one part of the scene, so e.g. changing the texture count leaves hierarchy and meshes unchanged
+            Random(uint64_t seed, uint64_t stream) : mState(HashBytes(&stream, sizeof(stream), seed)) {}
+
+            uint64_t Next()
+            {
+                uint64_t z = (mState += 0x9E3779B97F4A7C15ull);
+                z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z          = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                return z ^ (z >> 31);
+            }
+            /// @brief Uniform in [0, 1)
+            float Float() { return (float)(Next() >> 40) * (1.f / 16777216.f); }
+            float Range(float min, float max) { return min + (max - min) * Float(); }
+            /// @brief Uniform in [0, bound)
+            uint32_t Below(uint32_t bound) { return (uint32_t)(((Next() >> 32) * bound) >> 32); }
+            glm::vec3 UnitVector()
+            {
+                float z     = Range(-1.f, 1.f);
+                float angle = Range(0.f, glm::two_pi<float>());
+                float r     = std::sqrt(std::max(1.f - z * z, 0.f));
+                return glm::vec3(r * std::cos(angle), r * std::sin(angle), z);
+            }
+            glm::quat Rotation() { return glm::angleAxis(Range(0.f, glm::two_pi<float>()), UnitVector()); }
+
+          protected:
+            uint64_t mState;
+        };
+
+        enum EStream : uint64_t
+        {
+            Hierarchy = 1,
+            Materials = 2,
+            Meshes    = 0x100000000ull,
+            Textures  = 0x200000000ull,
+        };
+
+        /// @brief Rings of the sphere generated for a triangle count. Segments are twice the rings, so triangles = 2 * segments * (rings - 1) = 4 * rings * (rings - 1).
+        uint32_t GetRingCount(uint32_t triangles) { return std::max((uint32_t)std::lround((1.0 + std::sqrt(1.0 + triangles)) * 0.5), 2u); }
+
+        const uint32_t ANIMATION_KEYFRAMES = 5;
+    }  // namespace
+
+    void SceneGenerator::Generate()
+    {
+        mNodes.clear();
+        mMeshes.clear();
+        mVertices.clear();
+        mIndices.clear();
+        mMaterials.clear();
+        mTextures.clear();
+        mAnimations.clear();
+        mStats = {};
+
+        // Materials, one per texture
+        Random   materialRandom(mConfig.Seed, EStream::Materials);
+        uint32_t materialCount = std::max(mConfig.TextureCount, 1u);
+        for(uint32_t i = 0; i < materialCount; i++)
+        {
+            glm::vec4 baseColor = glm::vec4(materialRandom.Range(0.6f, 1.f), materialRandom.Range(0.6f, 1.f), materialRandom.Range(0.6f, 1.f), 1.f);
+            float     metallic  = materialRandom.Float() < 0.3f ? 1.f : 0.f;
+            float     roughness = materialRandom.Range(0.3f, 1.f);
+            mMaterials.push_back(MaterialBufferEntry{.BaseColorFactor               = baseColor,
+                                                     .EmissiveFactor                = glm::vec3(0.f),
+                                                     .MetallicFactor                = metallic,
+                                                     .RoughnessFactor               = roughness,
+                                                     .BaseColorTextureIndex         = mConfig.TextureCount ? (int32_t)i : -1,
+                                                     .MetallicRoughnessTextureIndex = -1,
+                                                     .EmissiveTextureIndex          = -1,
+                                                     .NormalTextureIndex            = -1});
+        }
+
+        // Meshes and textures are independent of each other (every one has its own random sequence) and generated in parallel
+        uint32_t rings         = GetRingCount(mConfig.TrianglesPerMesh);
+        uint32_t segments      = rings * 2;
+        uint32_t meshVertices  = (rings + 1) * (segments + 1);
+        uint32_t meshTriangles = 2 * segments * (rings - 1);
+        mMeshes.resize(mConfig.UniqueMeshCount);
+        for(uint32_t i = 0; i < mConfig.UniqueMeshCount; i++)
+        {
+            mMeshes[i] = MeshDesc{.FirstVertex = i * meshVertices,
+                                  .VertexCount = meshVertices,
+                                  .FirstIndex  = i * meshTriangles * 3,
+                                  .IndexCount  = meshTriangles * 3,
+                                  .Material    = (int32_t)(i % materialCount)};
+        }
+        mVertices.resize((size_t)meshVertices * mConfig.UniqueMeshCount);
+        mIndices.resize((size_t)meshTriangles * 3 * mConfig.UniqueMeshCount);
+        mTextures.resize(mConfig.TextureCount);
+
+        ThreadPool::Default().ParallelFor(mMeshes.size() + mTextures.size(), [this](size_t index) {
+            if(index < mMeshes.size())
+            {
+                GenerateMesh((uint32_t)index);
+            }
+            else
+            {
+                GenerateTexture((uint32_t)(index - mMeshes.size()));
+            }
+        });
+
+        GenerateHierarchy();
+
+        mStats.VertexCount   = mVertices.size();
+        mStats.TriangleCount = mIndices.size() / 3;
+    }
+
+    void SceneGenerator::GenerateHierarchy()
+    {
+        Random   random(mConfig.Seed, EStream::Hierarchy);
+        uint32_t nodeCount = std::max(mConfig.NodeCount, 1u);
+        uint32_t maxDepth  = std::max(mConfig.MaxDepth, 1u);
+
+        // Average child count of a tree of maxDepth levels holding all nodes. Its inverse is the share of root nodes.
+        float branching       = std::max(std::pow((float)nodeCount, 1.f / (float)maxDepth), 2.f);
+        float rootProbability = maxDepth > 1 ? 1.f / branching : 1.f;
+        float rootExtent      = mConfig.NodeSpacing * std::cbrt(std::max((float)nodeCount * rootProbability, 1.f));
+
+        std::vector<uint32_t> depths(nodeCount);
+        // Nodes above the depth limit, which may receive children
+        std::vector<int32_t> openParents;
+        mNodes.resize(nodeCount);
+        for(uint32_t i = 0; i < nodeCount; i++)
+        {
+            NodeDesc& node = mNodes[i];
+            bool      root = openParents.empty() || random.Float() < rootProbability;
+            if(root)
+            {
+                depths[i]        = 1;
+                node.Translation = glm::vec3(random.Range(-0.5f, 0.5f), random.Range(-0.5f, 0.5f), random.Range(-0.5f, 0.5f)) * rootExtent;
+                node.Scale       = glm::vec3(random.Range(0.5f, 1.5f));
+                mStats.RootNodeCount++;
+            }
+            else
+            {
+                node.Parent      = openParents[random.Below((uint32_t)openParents.size())];
+                depths[i]        = depths[node.Parent] + 1;
+                node.Translation = random.UnitVector() * random.Range(0.5f, 1.f) * mConfig.NodeSpacing;
+                node.Scale       = glm::vec3(random.Range(0.6f, 1.f));
+            }
+            node.Rotation = random.Rotation();
+            if(depths[i] < maxDepth)
+            {
+                openParents.push_back((int32_t)i);
+            }
+            mStats.Depth = std::max(mStats.Depth, depths[i]);
+
+            if(mMeshes.size() && random.Float() < mConfig.MeshNodeRatio)
+            {
+                node.Mesh = (int32_t)random.Below((uint32_t)mMeshes.size());
+                mStats.MeshInstanceCount++;
+                mStats.InstancedTriangleCount += mMeshes[node.Mesh].IndexCount / 3;
+            }
+
+            if(random.Float() < mConfig.AnimatedNodeRatio)
+            {
+                // Full turn around a random axis, starting at the node's rotation
+                AnimationDesc animation{.Node = (int32_t)i, .Duration = random.Range(2.f, 8.f)};
+                glm::vec3     axis = random.UnitVector();
+                for(uint32_t k = 0; k < ANIMATION_KEYFRAMES; k++)
+                {
+                    glm::quat rotation = glm::angleAxis(glm::two_pi<float>() * k / (ANIMATION_KEYFRAMES - 1), axis) * node.Rotation;
+                    animation.Rotations.push_back(glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w));
+                }
+                node.Animation = (int32_t)mAnimations.size();
+                mAnimations.push_back(std::move(animation));
+            }
+        }
+        mStats.NodeCount         = nodeCount;
+        mStats.AnimatedNodeCount = (uint32_t)mAnimations.size();
+    }
+
+    void SceneGenerator::GenerateMesh(uint32_t meshIndex)
+    {
+        // A sphere with a random stretch and a random number of bulges, so instances of different meshes are distinguishable
+        Random    random(mConfig.Seed, EStream::Meshes + meshIndex);
+        glm::vec3 stretch   = glm::vec3(random.Range(0.6f, 1.4f), random.Range(0.6f, 1.4f), random.Range(0.6f, 1.4f));
+        float     amplitude = random.Range(0.f, 0.35f);
+        float     polarFreq = (float)(1 + random.Below(4));
+        float     azimFreq  = (float)(1 + random.Below(4));
+
+        auto lPosition = [&](float polar, float azimuth) {
+            float     radius    = 1.f + amplitude * std::sin(polarFreq * polar) * std::cos(azimFreq * azimuth);
+            glm::vec3 direction = glm::vec3(std::sin(polar) * std::cos(azimuth), std::cos(polar), std::sin(polar) * std::sin(azimuth));
+            return direction * radius * stretch;
+        };
+
+        const MeshDesc& mesh     = mMeshes[meshIndex];
+        uint32_t        rings    = GetRingCount(mConfig.TrianglesPerMesh);
+        uint32_t        segments = rings * 2;
+        const float     epsilon  = 1e-3f;
+
+        Vertex* vertices = mVertices.data() + mesh.FirstVertex;
+        for(uint32_t y = 0; y <= rings; y++)
+        {
+            float polar = glm::pi<float>() * y / rings;
+            for(uint32_t x = 0; x <= segments; x++)
+            {
+                float     azimuth = glm::two_pi<float>() * x / segments;
+                Vertex&   vertex  = vertices[y * (segments + 1) + x];
+                glm::vec3 dPolar  = lPosition(polar + epsilon, azimuth) - lPosition(polar - epsilon, azimuth);
+                glm::vec3 dAzim   = lPosition(polar, azimuth + epsilon) - lPosition(polar, azimuth - epsilon);
+
+                vertex.Pos           = lPosition(polar, azimuth);
+                vertex.Uv            = glm::vec2(2.f * x / segments, (float)y / rings);
+                vertex.MaterialIndex = mesh.Material;
+                if(y == 0 || y == rings)
+                {
+                    // The azimuth derivative vanishes at the poles
+                    vertex.Normal  = glm::vec3(0.f, y == 0 ? 1.f : -1.f, 0.f);
+                    vertex.Tangent = glm::vec3(1.f, 0.f, 0.f);
+                }
+                else
+                {
+                    vertex.Normal  = glm::normalize(glm::cross(dAzim, dPolar));
+                    vertex.Tangent = glm::normalize(dAzim - vertex.Normal * glm::dot(dAzim, vertex.Normal));
+                }
+            }
+        }
+
+        // Counter clockwise seen from outside. The pole rows have a single triangle per quad.
+        uint32_t* indices = mIndices.data() + mesh.FirstIndex;
+        for(uint32_t y = 0; y < rings; y++)
+        {
+            for(uint32_t x = 0; x < segments; x++)
+            {
+                uint32_t v0 = y * (segments + 1) + x;
+                uint32_t v1 = v0 + 1;
+                uint32_t v2 = v0 + segments + 1;
+                uint32_t v3 = v2 + 1;
+                if(y != 0)
+                {
+                    *indices++ = v0;
+                    *indices++ = v1;
+                    *indices++ = v2;
+                }
+                if(y != rings - 1)
+                {
+                    *indices++ = v1;
+                    *indices++ = v3;
+                    *indices++ = v2;
+                }
+            }
+        }
+    }
+
+    void SceneGenerator::GenerateTexture(uint32_t textureIndex)
+    {
+        // Checkerboard of two random colors
+        Random   random(mConfig.Seed, EStream::Textures + textureIndex);
+        uint8_t  colors[2][4];
+        for(auto& color : colors)
+        {
+            for(uint32_t c = 0; c < 3; c++)
+            {
+                color[c] = (uint8_t)(40 + random.Below(191));
+            }
+            color[3] = 255;
+        }
+        uint32_t size      = std::max(mConfig.TextureSize, 1u);
+        uint32_t cellShift = std::min(1 + random.Below(4), 31u);
+        uint32_t cellSize  = std::max(size >> cellShift, 1u);
+
+        std::vector<uint8_t>& pixels = mTextures[textureIndex];
+        pixels.resize((size_t)size * size * 4);
+        for(uint32_t y = 0; y < size; y++)
+        {
+            for(uint32_t x = 0; x < size; x++)
+            {
+                memcpy(&pixels[((size_t)y * size + x) * 4], colors[(x / cellSize + y / cellSize) % 2], 4);
+            }
+        }
+    }
+
+    void SceneGenerator::BuildScene(Scene* scene, const VkContext* context) const
+    {
+        HSK_ASSERTFMT(mNodes.size(), "Scene generator: {} requires a generated scene, call Generate() first!", "BuildScene()")
+
+        context                        = context ? context : scene->GetContext();
+        MaterialBuffer& materialBuffer = *(scene->GetComponent<MaterialBuffer>());
+        GeometryStore&  geo            = *(scene->GetComponent<GeometryStore>());
+        TextureStore&   textures       = *(scene->GetComponent<TextureStore>());
+
+        UploadBatch uploads;
+        uploads.Create(context);
+
+        // Textures. Mip chains are generated on the CPU, there are no blits to record.
+        std::vector<int32_t> textureIndices(mTextures.size());
+        if(mTextures.size())
+        {
+            VkSampler sampler = textures.GetOrCreateSampler(VkSamplerCreateInfo{.sType                   = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+                                                                                .magFilter               = VK_FILTER_LINEAR,
+                                                                                .minFilter               = VK_FILTER_LINEAR,
+                                                                                .mipmapMode              = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+                                                                                .addressModeU            = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+                                                                                .addressModeV            = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+                                                                                .addressModeW            = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+                                                                                .anisotropyEnable        = VK_TRUE,
+                                                                                .maxAnisotropy           = 4,
+                                                                                .minLod                  = 0,
+                                                                                .maxLod                  = VK_LOD_CLAMP_NONE,
+                                                                                .unnormalizedCoordinates = VK_FALSE});
+
+            const VkFormat                 format = VK_FORMAT_R8G8B8A8_UNORM;
+            uint32_t                       size   = std::max(mConfig.TextureSize, 1u);
+            std::vector<VkBufferImageCopy> levels;
+            VkDeviceSize                   chainSize = TextureCooker::ComputeLevels(format, size, size, levels);
+            std::vector<uint8_t>           chain(chainSize);
+            uint32_t                       header[4] = {(uint32_t)format, size, size, (uint32_t)levels.size()};
+            uint64_t                       hashSeed  = HashBytes(header, sizeof(header));
+            for(size_t i = 0; i < mTextures.size(); i++)
+            {
+                memcpy(chain.data(), mTextures[i].data(), mTextures[i].size());
+                for(size_t level = 1; level < levels.size(); level++)
+                {
+                    const VkExtent3D& previous = levels[level - 1].imageExtent;
+                    TextureCooker::Downsample(chain.data() + levels[level - 1].bufferOffset, previous.width, previous.height, ETextureUsage::Color,
+                                              chain.data() + levels[level].bufferOffset);
+                }
+
+                ManagedImage::CreateInfo imageCI;
+                imageCI.AllocCI.usage                           = VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+                imageCI.ImageCI.imageType                       = VK_IMAGE_TYPE_2D;
+                imageCI.ImageCI.format                          = format;
+                imageCI.ImageCI.mipLevels                       = (uint32_t)levels.size();
+                imageCI.ImageCI.arrayLayers                     = 1;
+                imageCI.ImageCI.samples                         = VK_SAMPLE_COUNT_1_BIT;
+                imageCI.ImageCI.tiling                          = VK_IMAGE_TILING_OPTIMAL;
+                imageCI.ImageCI.usage                           = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+                imageCI.ImageCI.sharingMode                     = VK_SHARING_MODE_EXCLUSIVE;
+                imageCI.ImageCI.initialLayout                   = VK_IMAGE_LAYOUT_UNDEFINED;
+                imageCI.ImageCI.extent                          = VkExtent3D{.width = size, .height = size, .depth = 1};
+                imageCI.ImageViewCI.viewType                    = VK_IMAGE_VIEW_TYPE_2D;
+                imageCI.ImageViewCI.format                      = format;
+                imageCI.ImageViewCI.components                  = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A};
+                imageCI.ImageViewCI.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                imageCI.ImageViewCI.subresourceRange.layerCount = 1;
+                imageCI.ImageViewCI.subresourceRange.levelCount = (uint32_t)levels.size();
+                imageCI.Name                                    = fmt::format("Synthetic Texture #{}", i);
+
+                auto image = std::make_shared<ManagedImage>();
+                image->Create(context, imageCI);
+                UploadBatch::StagingRange staging = uploads.AllocateStaging(chainSize);
+                memcpy(staging.Mapped, chain.data(), chainSize);
+                uploads.CopyToImage(*image, staging, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, levels);
+                textureIndices[i] = textures.AddTexture(std::move(image), sampler, HashBytes(mTextures[i].data(), mTextures[i].size(), hashSeed));
+            }
+        }
+
+        // Materials
+        size_t materialOffset = materialBuffer.ReserveRange(mMaterials.size());
+        materialBuffer.GetVector().resize(std::max(materialBuffer.GetVector().size(), materialOffset + mMaterials.size()));
+        for(size_t i = 0; i < mMaterials.size(); i++)
+        {
+            MaterialBufferEntry& material = materialBuffer.GetVector()[materialOffset + i];
+            material                      = mMaterials[i];
+            if(material.BaseColorTextureIndex >= 0)
+            {
+                material.BaseColorTextureIndex = textureIndices[material.BaseColorTextureIndex];
+            }
+        }
+
+        // Geometry, all unique meshes share one buffer set
+        std::vector<Mesh*> meshes;
+        if(mMeshes.size())
+        {
+            std::vector<Vertex> vertices = mVertices;
+            for(Vertex& vertex : vertices)
+            {
+                vertex.MaterialIndex += (int32_t)materialOffset;
+            }
+
+            auto bufferSet = std::make_unique<GeometryBufferSet>();
+            bufferSet->SetVertexLayout(mConfig.VertexLayout);
+            if(mConfig.UseGeometryArena)
+            {
+                bufferSet->SetArena(geo.GetArena(mConfig.VertexLayout));
+            }
+            bufferSet->Init(context, vertices, mIndices, {}, &uploads);
+
+            geo.GetMeshes().reserve(geo.GetMeshes().size() + mMeshes.size());
+            for(const MeshDesc& desc : mMeshes)
+            {
+                Primitive primitive(Primitive::EType::Index, desc.FirstIndex, desc.IndexCount, (int32_t)desc.FirstVertex);
+                primitive.MaterialIndex = desc.Material + (int32_t)materialOffset;
+
+                auto mesh = std::make_unique<Mesh>(bufferSet.get());
+                mesh->GetPrimitives().push_back(primitive);
+                mesh->SetFirstVertex(desc.FirstVertex);
+                mesh->SetVertexCount(desc.VertexCount);
+                meshes.push_back(mesh.get());
+                geo.GetMeshes().push_back(std::move(mesh));
+            }
+            geo.GetBufferSets().push_back(std::move(bufferSet));
+        }
+
+        // Nodes. Instance indices continue after the mesh instances already in the scene.
+        std::vector<Node*> nodesWithMeshInstances;
+        scene->FindNodesWithComponent<MeshInstance>(nodesWithMeshInstances);
+        int32_t nextInstanceIndex = 0;
+        for(Node* node : nodesWithMeshInstances)
+        {
+            nextInstanceIndex = std::max(nextInstanceIndex, node->GetComponent<MeshInstance>()->GetInstanceIndex() + 1);
+        }
+
+        size_t firstRootNode = scene->GetRootNodes().size();
+        scene->GetNodeBuffer().reserve(scene->GetNodeBuffer().size() + mNodes.size());
+        std::vector<Node*> nodes(mNodes.size());
+        for(size_t i = 0; i < mNodes.size(); i++)
+        {
+            const NodeDesc& desc = mNodes[i];
+            Node*           node = scene->MakeNode(desc.Parent >= 0 ? nodes[desc.Parent] : nullptr);
+            nodes[i]             = node;
+
+            Transform* transform = node->GetTransform();
+            transform->SetTranslation(desc.Translation);
+            transform->SetRotation(desc.Rotation);
+            transform->SetScale(desc.Scale);
+            transform->RecalculateLocalMatrix();
+            // Only animated nodes need their local matrix recalculated
+            transform->SetStatic(desc.Animation < 0);
+
+            if(desc.Mesh >= 0)
+            {
+                MeshInstance* meshInstance = node->MakeComponent<MeshInstance>();
+                meshInstance->SetMesh(meshes[desc.Mesh]);
+                meshInstance->SetInstanceIndex(nextInstanceIndex++);
+            }
+        }
+
+        // Animations
+        if(mAnimations.size())
+        {
+            AnimationDirector* animDirector = scene->GetComponent<AnimationDirector>();
+            if(!animDirector)
+            {
+                animDirector = scene->MakeComponent<AnimationDirector>();
+            }
+            animDirector->GetAnimations().reserve(animDirector->GetAnimations().size() + mAnimations.size());
+            for(size_t i = 0; i < mAnimations.size(); i++)
+            {
+                const AnimationDesc& desc = mAnimations[i];
+
+                AnimationSampler sampler;
+                sampler.Interpolation = EAnimationInterpolation::Linear;
+                for(uint32_t k = 0; k < desc.Rotations.size(); k++)
+                {
+                    sampler.Keyframes.push_back(AnimationKeyframe(desc.Duration * k / (desc.Rotations.size() - 1), desc.Rotations[k]));
+                }
+
+                Animation animation;
+                animation.SetName(fmt::format("Synthetic Animation #{}", i));
+                animation.GetSamplers().push_back(std::move(sampler));
+                animation.GetChannels().push_back(AnimationChannel{.SamplerIndex = 0, .Target = nodes[desc.Node], .TargetPath = EAnimationTargetPath::Rotation});
+                animation.SetStart(0.f);
+                animation.SetEnd(desc.Duration);
+                animDirector->GetAnimations().push_back(std::move(animation));
+            }
+        }
+
+        for(size_t i = firstRootNode; i < scene->GetRootNodes().size(); i++)
+        {
+            scene->GetRootNodes()[i]->GetTransform()->RecalculateGlobalMatrix(nullptr);
+        }
+        materialBuffer.UpdateDeviceLocal();
+        uploads.Submit();
+
+        logger()->info("Scene generator: Built {} nodes ({} roots, depth {}), {} mesh instances of {} meshes, {} textures, {} animations", mStats.NodeCount,
+                       mStats.RootNodeCount, mStats.Depth, mStats.MeshInstanceCount, mMeshes.size(), mTextures.size(), mStats.AnimatedNodeCount);
+    }
+
+    void SceneGenerator::WriteGlb(const std::string& utf8Path) const
+    {
+        HSK_ASSERTFMT(mNodes.size(), "Scene generator: {} requires a generated scene, call Generate() first!", "WriteGlb()")
+
+        tinygltf::Model model;
+        model.asset.version   = "2.0";
+        model.asset.generator = "hsk SceneGenerator";
+        model.buffers.resize(1);
+        std::vector<unsigned char>& data = model.buffers[0].data;
+
+        auto lAddBufferView = [&](const void* source, size_t size, int target) {
+            data.resize((data.size() + 3) / 4 * 4);
+            tinygltf::BufferView bufferView;
+            bufferView.buffer     = 0;
+            bufferView.byteOffset = data.size();
+            bufferView.byteLength = size;
+            bufferView.target     = target;
+            data.insert(data.end(), reinterpret_cast<const unsigned char*>(source), reinterpret_cast<const unsigned char*>(source) + size);
+            model.bufferViews.push_back(std::move(bufferView));
+            return (int)model.bufferViews.size() - 1;
+        };
+        auto lAddAccessor = [&](int bufferView, size_t byteOffset, int componentType, int type, size_t count) {
+            tinygltf::Accessor accessor;
+            accessor.bufferView    = bufferView;
+            accessor.byteOffset    = byteOffset;
+            accessor.componentType = componentType;
+            accessor.type          = type;
+            accessor.count         = count;
+            model.accessors.push_back(std::move(accessor));
+            return (int)model.accessors.size() - 1;
+        };
+
+        // Geometry: One buffer view per attribute, accessors per mesh
+        if(mMeshes.size())
+        {
+            std::vector<glm::vec3> positions(mVertices.size());
+            std::vector<glm::vec3> normals(mVertices.size());
+            std::vector<glm::vec4> tangents(mVertices.size());
+            std::vector<glm::vec2> uvs(mVertices.size());
+            for(size_t i = 0; i < mVertices.size(); i++)
+            {
+                positions[i] = mVertices[i].Pos;
+                normals[i]   = mVertices[i].Normal;
+                tangents[i]  = glm::vec4(mVertices[i].Tangent, 1.f);
+                uvs[i]       = mVertices[i].Uv;
+            }
+            int positionView = lAddBufferView(positions.data(), positions.size() * sizeof(glm::vec3), TINYGLTF_TARGET_ARRAY_BUFFER);
+            int normalView   = lAddBufferView(normals.data(), normals.size() * sizeof(glm::vec3), TINYGLTF_TARGET_ARRAY_BUFFER);
+            int tangentView  = lAddBufferView(tangents.data(), tangents.size() * sizeof(glm::vec4), TINYGLTF_TARGET_ARRAY_BUFFER);
+            int uvView       = lAddBufferView(uvs.data(), uvs.size() * sizeof(glm::vec2), TINYGLTF_TARGET_ARRAY_BUFFER);
+            int indexView    = lAddBufferView(mIndices.data(), mIndices.size() * sizeof(uint32_t), TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER);
+
+            for(size_t i = 0; i < mMeshes.size(); i++)
+            {
+                const MeshDesc& desc = mMeshes[i];
+
+                tinygltf::Primitive primitive;
+                primitive.mode     = TINYGLTF_MODE_TRIANGLES;
+                primitive.material = desc.Material;
+                primitive.indices  = lAddAccessor(indexView, desc.FirstIndex * sizeof(uint32_t), TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT, TINYGLTF_TYPE_SCALAR, desc.IndexCount);
+
+                // Position accessors require bounds
+                int       position = lAddAccessor(positionView, desc.FirstVertex * sizeof(glm::vec3), TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3, desc.VertexCount);
+                glm::vec3 min      = positions[desc.FirstVertex];
+                glm::vec3 max      = min;
+                for(uint32_t v = desc.FirstVertex; v < desc.FirstVertex + desc.VertexCount; v++)
+                {
+                    min = glm::min(min, positions[v]);
+                    max = glm::max(max, positions[v]);
+                }
+                model.accessors[position].minValues = {min.x, min.y, min.z};
+                model.accessors[position].maxValues = {max.x, max.y, max.z};
+
+                primitive.attributes["POSITION"]   = position;
+                primitive.attributes["NORMAL"]     = lAddAccessor(normalView, desc.FirstVertex * sizeof(glm::vec3), TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC3, desc.VertexCount);
+                primitive.attributes["TANGENT"]    = lAddAccessor(tangentView, desc.FirstVertex * sizeof(glm::vec4), TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC4, desc.VertexCount);
+                primitive.attributes["TEXCOORD_0"] = lAddAccessor(uvView, desc.FirstVertex * sizeof(glm::vec2), TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC2, desc.VertexCount);
+
+                tinygltf::Mesh mesh;
+                mesh.name = fmt::format("Synthetic Mesh #{}", i);
+                mesh.primitives.push_back(std::move(primitive));
+                model.meshes.push_back(std::move(mesh));
+            }
+        }
+
+        // Textures, PNG encoded into the binary chunk
+        if(mTextures.size())
+        {
+            tinygltf::Sampler sampler;
+            sampler.magFilter = TINYGLTF_TEXTURE_FILTER_LINEAR;
+            sampler.minFilter = TINYGLTF_TEXTURE_FILTER_LINEAR_MIPMAP_LINEAR;
+            model.samplers.push_back(std::move(sampler));
+        }
+        uint32_t textureSize = std::max(mConfig.TextureSize, 1u);
+        for(size_t i = 0; i < mTextures.size(); i++)
+        {
+            std::vector<unsigned char> png;
+            auto                       lWrite = [](void* context, void* bytes, int size) {
+                auto target = reinterpret_cast<std::vector<unsigned char>*>(context);
+                target->insert(target->end(), reinterpret_cast<unsigned char*>(bytes), reinterpret_cast<unsigned char*>(bytes) + size);
+            };
+            HSK_ASSERTFMT(stbi_write_png_to_func(lWrite, &png, (int)textureSize, (int)textureSize, 4, mTextures[i].data(), (int)textureSize * 4),
+                          "Scene generator: Unable to encode texture #{}", i)
+
+            tinygltf::Image image;
+            image.name       = fmt::format("Synthetic Texture #{}", i);
+            image.mimeType   = "image/png";
+            image.bufferView = lAddBufferView(png.data(), png.size(), 0);
+            model.images.push_back(std::move(image));
+
+            tinygltf::Texture texture;
+            texture.source  = (int)i;
+            texture.sampler = 0;
+            model.textures.push_back(std::move(texture));
+        }
+
+        for(const MaterialBufferEntry& entry : mMaterials)
+        {
+            tinygltf::Material material;
+            material.name                                 = fmt::format("Synthetic Material #{}", model.materials.size());
+            material.pbrMetallicRoughness.baseColorFactor = {entry.BaseColorFactor.r, entry.BaseColorFactor.g, entry.BaseColorFactor.b, entry.BaseColorFactor.a};
+            material.pbrMetallicRoughness.metallicFactor  = entry.MetallicFactor;
+            material.pbrMetallicRoughness.roughnessFactor = entry.RoughnessFactor;
+            material.pbrMetallicRoughness.baseColorTexture.index = entry.BaseColorTextureIndex;
+            model.materials.push_back(std::move(material));
+        }
+
+        // Nodes
+        model.scenes.resize(1);
+        model.defaultScene = 0;
+        model.nodes.resize(mNodes.size());
+        for(size_t i = 0; i < mNodes.size(); i++)
+        {
+            const NodeDesc& desc = mNodes[i];
+            tinygltf::Node& node = model.nodes[i];
+            node.translation     = {desc.Translation.x, desc.Translation.y, desc.Translation.z};
+            node.rotation        = {desc.Rotation.x, desc.Rotation.y, desc.Rotation.z, desc.Rotation.w};
+            node.scale           = {desc.Scale.x, desc.Scale.y, desc.Scale.z};
+            node.mesh            = desc.Mesh;
+            if(desc.Parent >= 0)
+            {
+                model.nodes[desc.Parent].children.push_back((int)i);
+            }
+            else
+            {
+                model.scenes[0].nodes.push_back((int)i);
+            }
+        }
+
+        // Keyframes of all animations are stored in one buffer view for times and one for rotations
+        if(mAnimations.size())
+        {
+            std::vector<float>     times;
+            std::vector<glm::vec4> rotations;
+            for(const AnimationDesc& desc : mAnimations)
+            {
+                for(uint32_t k = 0; k < desc.Rotations.size(); k++)
+                {
+                    times.push_back(desc.Duration * k / (desc.Rotations.size() - 1));
+                    rotations.push_back(desc.Rotations[k]);
+                }
+            }
+            int timeView     = lAddBufferView(times.data(), times.size() * sizeof(float), 0);
+            int rotationView = lAddBufferView(rotations.data(), rotations.size() * sizeof(glm::vec4), 0);
+
+            size_t keyframe = 0;
+            for(size_t i = 0; i < mAnimations.size(); i++)
+            {
+                const AnimationDesc& desc  = mAnimations[i];
+                size_t               count = desc.Rotations.size();
+
+                tinygltf::AnimationSampler sampler;
+                sampler.interpolation = "LINEAR";
+                sampler.input         = lAddAccessor(timeView, keyframe * sizeof(float), TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_SCALAR, count);
+                sampler.output        = lAddAccessor(rotationView, keyframe * sizeof(glm::vec4), TINYGLTF_COMPONENT_TYPE_FLOAT, TINYGLTF_TYPE_VEC4, count);
+                // Animation input accessors require bounds
+                model.accessors[sampler.input].minValues = {0.0};
+                model.accessors[sampler.input].maxValues = {desc.Duration};
+                keyframe += count;
+
+                tinygltf::AnimationChannel channel;
+                channel.sampler     = 0;
+                channel.target_node = desc.Node;
+                channel.target_path = "rotation";
+
+                tinygltf::Animation animation;
+                animation.name = fmt::format("Synthetic Animation #{}", i);
+                animation.samplers.push_back(std::move(sampler));
+                animation.channels.push_back(std::move(channel));
+                model.animations.push_back(std::move(animation));
+            }
+        }
+        data.resize((data.size() + 3) / 4 * 4);
+
+        tinygltf::TinyGLTF writer;
+        HSK_ASSERTFMT(writer.WriteGltfSceneToFile(&model, utf8Path, true, true, false, true), "Scene generator: Unable to write \"{}\"", utf8Path)
+        logger()->info("Scene generator: Wrote \"{}\" ({} nodes, {} bytes of binary data)", utf8Path, mNodes.size(), data.size());
+    }
+}  // namespace hsk
\ No newline at end of file
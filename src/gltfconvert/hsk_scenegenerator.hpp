@@ -0,0 +1,124 @@
+#pragma once
+#include "../hsk_basics.hpp"
+#include "../hsk_glm.hpp"
+#include "../scenegraph/hsk_geo.hpp"
+#include "../scenegraph/hsk_material.hpp"
+#include "../scenegraph/hsk_scenegraph_declares.hpp"
+#include <string>
+#include <vector>
+
+namespace hsk {
+
+    /// @brief Procedurally generates scenes of configurable size and shape for scaling benchmarks, without any external assets.
+    /// The result of Generate() is fully determined by the config. The random sequences are platform independent, so hierarchy, counts and mesh assignment match on every platform.
+    /// A generated scene is either built directly into a Scene (BuildScene()) or written as .glb file for benchmarking the import path (WriteGlb()).
+    class SceneGenerator
+    {
+      public:
+        struct Config
+        {
+            uint64_t Seed = 1;
+            uint32_t NodeCount = 1000;
+            /// @brief Maximum number of nodes on the path from a root node to a leaf (1: all nodes are root nodes)
+            uint32_t MaxDepth = 4;
+            /// @brief Fraction of nodes carrying a mesh instance, the others are plain transform nodes
+            float MeshNodeRatio = 1.f;
+            /// @brief Number of distinct meshes. Mesh nodes reference one of them at random, so every mesh has about MeshNodeCount / UniqueMeshCount instances.
+            uint32_t UniqueMeshCount = 16;
+            /// @brief Approximate triangle count of every unique mesh (a deformed sphere, at least 8 triangles)
+            uint32_t TrianglesPerMesh = 512;
+            /// @brief Number of distinct base color textures. Meshes share one material per texture (a single untextured material if 0).
+            uint32_t TextureCount = 4;
+            /// @brief Width and height of the generated textures (power of two)
+            uint32_t TextureSize = 256;
+            /// @brief Fraction of nodes with a looping rotation animation (one Animation per animated node)
+            float AnimatedNodeRatio = 0.1f;
+            /// @brief Average distance between root nodes. Root nodes are scattered in a cube sized to keep this density.
+            float NodeSpacing = 4.f;
+            /// @brief Layout of the vertex buffer created by BuildScene()
+            EVertexLayout VertexLayout = EVertexLayout::Full;
+            /// @brief Sub-allocates the geometry from the GeometryStore's shared arena (see ModelConverter::Config::UseGeometryArena)
+            bool UseGeometryArena = true;
+        };
+
+        /// @brief Size of the generated scene
+        struct Stats
+        {
+            uint32_t NodeCount         = 0;
+            uint32_t RootNodeCount     = 0;
+            /// @brief Length of the longest path from a root node to a leaf
+            uint32_t Depth             = 0;
+            uint32_t MeshInstanceCount = 0;
+            uint32_t AnimatedNodeCount = 0;
+            uint64_t VertexCount       = 0;
+            /// @brief Triangles of all unique meshes
+            uint64_t TriangleCount = 0;
+            /// @brief Triangles of all mesh instances, i.e. the triangles of a frame drawing every instance
+            uint64_t InstancedTriangleCount = 0;
+        };
+
+        HSK_PROPERTY_ALL(Config)
+        HSK_PROPERTY_CGET(Stats)
+
+        /// @brief Generates hierarchy, geometry, textures, materials and animations on the CPU. Replaces the previously generated scene.
+        void Generate();
+
+        /// @brief Adds the generated scene to scene: Nodes with Transform and MeshInstance components, one GeometryBufferSet holding all unique meshes,
+        /// materials, textures (with CPU generated mip chain) and animations (in the AnimationDirector, created if missing)
+        /// @param context Context used for device resources. nullptr selects the scene's context.
+        /// @remark Blocks until all uploads are complete
+        void BuildScene(Scene* scene, const VkContext* context = nullptr) const;
+
+        /// @brief Writes the generated scene as binary glTF. Textures are stored PNG encoded in the binary chunk.
+        void WriteGlb(const std::string& utf8Path) const;
+
+      protected:
+        struct NodeDesc
+        {
+            int32_t   Parent      = -1;
+            glm::vec3 Translation = {};
+            glm::quat Rotation    = glm::quat(1.f, 0.f, 0.f, 0.f);
+            glm::vec3 Scale       = glm::vec3(1.f);
+            int32_t   Mesh        = -1;
+            /// @brief Index into mAnimations, -1 if the node is not animated
+            int32_t Animation = -1;
+        };
+
+        struct MeshDesc
+        {
+            uint32_t FirstVertex = 0;
+            uint32_t VertexCount = 0;
+            uint32_t FirstIndex  = 0;
+            uint32_t IndexCount  = 0;
+            int32_t  Material    = -1;
+        };
+
+        struct AnimationDesc
+        {
+            int32_t Node = -1;
+            /// @brief Rotation keyframes (x, y, z, w), one full turn spread evenly over the duration
+            std::vector<glm::vec4> Rotations = {};
+            float                  Duration  = 1.f;
+        };
+
+        Config mConfig = {};
+        Stats  mStats  = {};
+
+        /// @brief Parents are always stored before their children
+        std::vector<NodeDesc> mNodes = {};
+        std::vector<MeshDesc> mMeshes = {};
+        /// @brief Vertices of all meshes. MaterialIndex is an index into mMaterials.
+        std::vector<Vertex> mVertices = {};
+        /// @brief Indices of all meshes, relative to the mesh's first vertex
+        std::vector<uint32_t> mIndices = {};
+        /// @brief Texture indices are indices into mTextures
+        std::vector<MaterialBufferEntry> mMaterials = {};
+        /// @brief RGBA8 pixels of every texture, TextureSize x TextureSize
+        std::vector<std::vector<uint8_t>> mTextures = {};
+        std::vector<AnimationDesc>        mAnimations = {};
+
+        void GenerateHierarchy();
+        void GenerateMesh(uint32_t meshIndex);
+        void GenerateTexture(uint32_t textureIndex);
+    };
+}  // namespace hsk
\ No newline at end of file
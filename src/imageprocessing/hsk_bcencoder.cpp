@@ -0,0 +1,514 @@
+#include "hsk_bcencoder.hpp"
+#include "../hsk_exception.hpp"
+#include "hsk_ktx2.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace hsk {
+    namespace {
+        const uint32_t BLOCK_PIXELS = 16;
+
+        /// @brief Fits a line through the first N channels of the block's pixels and returns its extent over the pixels
+        template <uint32_t N>
+        void FitPrincipalAxis(const uint8_t* rgba, float (&outStart)[N], float (&outEnd)[N])
+        {
+            float mean[N] = {};
+            for(uint32_t p = 0; p < BLOCK_PIXELS; p++)
+            {
+                for(uint32_t c = 0; c < N; c++)
+                {
+                    mean[c] += rgba[p * 4 + c];
+                }
+            }
+            for(uint32_t c = 0; c < N; c++)
+            {
+                mean[c] /= BLOCK_PIXELS;
+            }
+
+            float covariance[N][N] = {};
+            for(uint32_t p = 0; p < BLOCK_PIXELS; p++)
+            {
+                for(uint32_t a = 0; a < N; a++)
+                {
+                    for(uint32_t b = 0; b < N; b++)
+                    {
+                        covariance[a][b] += (rgba[p * 4 + a] - mean[a]) * (rgba[p * 4 + b] - mean[b]);
+                    }
+                }
+            }
+
+            // Power iteration converges to the eigenvector with the largest eigenvalue. It starts from the covariance column of the channel varying most:
+            // A constant start vector can be orthogonal to the principal axis (e.g. red against blue), which would collapse both endpoints to the mean.
+            uint32_t widest = 0;
+            for(uint32_t c = 1; c < N; c++)
+            {
+                widest = covariance[c][c] > covariance[widest][widest] ? c : widest;
+            }
+            float axis[N];
+            for(uint32_t c = 0; c < N; c++)
+            {
+                axis[c] = covariance[c][widest];
+            }
+            for(uint32_t iteration = 0; iteration < 8; iteration++)
+            {
+                float next[N] = {};
+                float largest = 0.f;
+                for(uint32_t a = 0; a < N; a++)
+                {
+                    for(uint32_t b = 0; b < N; b++)
+                    {
+                        next[a] += covariance[a][b] * axis[b];
+                    }
+                    largest = std::max(largest, std::abs(next[a]));
+                }
+                if(largest <= 0.f)
+                {
+                    break;
+                }
+                for(uint32_t a = 0; a < N; a++)
+                {
+                    axis[a] = next[a] / largest;
+                }
+            }
+
+            float axisLengthSquared = 0.f;
+            for(uint32_t c = 0; c < N; c++)
+            {
+                axisLengthSquared += axis[c] * axis[c];
+            }
+
+            float minT = 0.f;
+            float maxT = 0.f;
+            for(uint32_t p = 0; p < BLOCK_PIXELS && axisLengthSquared > 0.f; p++)
+            {
+                float t = 0.f;
+                for(uint32_t c = 0; c < N; c++)
+                {
+                    t += (rgba[p * 4 + c] - mean[c]) * axis[c];
+                }
+                minT = std::min(minT, t);
+                maxT = std::max(maxT, t);
+            }
+
+            for(uint32_t c = 0; c < N; c++)
+            {
+                float scale = axisLengthSquared > 0.f ? axis[c] / axisLengthSquared : 0.f;
+                outStart[c] = std::clamp(mean[c] + minT * scale, 0.f, 255.f);
+                outEnd[c]   = std::clamp(mean[c] + maxT * scale, 0.f, 255.f);
+            }
+        }
+
+        /// @brief Solves for the endpoints minimizing the squared error, given each pixel's interpolation weight (0 = start, 1 = end)
+        /// @return False if all weights are equal (singular system)
+        template <uint32_t N>
+        bool FitLeastSquares(const uint8_t* rgba, const float* weights, float (&outStart)[N], float (&outEnd)[N])
+        {
+            float aa = 0.f;
+            float ab = 0.f;
+            float bb = 0.f;
+            float ax[N] = {};
+            float bx[N] = {};
+            for(uint32_t p = 0; p < BLOCK_PIXELS; p++)
+            {
+                float b = weights[p];
+                float a = 1.f - b;
+                aa += a * a;
+                ab += a * b;
+                bb += b * b;
+                for(uint32_t c = 0; c < N; c++)
+                {
+                    ax[c] += a * rgba[p * 4 + c];
+                    bx[c] += b * rgba[p * 4 + c];
+                }
+            }
+            float determinant = aa * bb - ab * ab;
+            if(std::abs(determinant) < 1e-6f)
+            {
+                return false;
+            }
+            for(uint32_t c = 0; c < N; c++)
+            {
+                outStart[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.f, 255.f);
+                outEnd[c]   = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.f, 255.f);
+            }
+            return true;
+        }
+
+        /// @brief Selects the nearest palette entry for every pixel
+        /// @return Sum of squared errors
+        template <uint32_t N>
+        uint32_t SelectIndices(const uint8_t* rgba, const int32_t (*palette)[4], uint32_t paletteSize, uint8_t* outIndices)
+        {
+            uint32_t totalError = 0;
+            for(uint32_t p = 0; p < BLOCK_PIXELS; p++)
+            {
+                uint32_t bestError = std::numeric_limits<uint32_t>::max();
+                for(uint32_t i = 0; i < paletteSize; i++)
+                {
+                    uint32_t error = 0;
+                    for(uint32_t c = 0; c < N; c++)
+                    {
+                        int32_t delta = (int32_t)rgba[p * 4 + c] - palette[i][c];
+                        error += (uint32_t)(delta * delta);
+                    }
+                    if(error < bestError)
+                    {
+                        bestError     = error;
+                        outIndices[p] = (uint8_t)i;
+                    }
+                }
+                totalError += bestError;
+            }
+            return totalError;
+        }
+
+        uint16_t To565(const float (&color)[3])
+        {
+            uint32_t r = (uint32_t)std::lround(color[0] * 31.f / 255.f);
+            uint32_t g = (uint32_t)std::lround(color[1] * 63.f / 255.f);
+            uint32_t b = (uint32_t)std::lround(color[2] * 31.f / 255.f);
+            return (uint16_t)((r << 11) | (g << 5) | b);
+        }
+
+        void From565(uint16_t color, int32_t (&out)[4])
+        {
+            int32_t r = (color >> 11) & 31;
+            int32_t g = (color >> 5) & 63;
+            int32_t b = color & 31;
+            out[0]    = (r << 3) | (r >> 2);
+            out[1]    = (g << 2) | (g >> 4);
+            out[2]    = (b << 3) | (b >> 2);
+            out[3]    = 255;
+        }
+
+        /// @brief Builds the 4 color palette of quantized endpoints and selects indices
+        uint32_t EvaluateBC1(const uint8_t* rgba, uint16_t color0, uint16_t color1, uint8_t* outIndices)
+        {
+            int32_t palette[4][4];
+            From565(color0, palette[0]);
+            From565(color1, palette[1]);
+            for(uint32_t c = 0; c < 3; c++)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            return SelectIndices<3>(rgba, palette, 4, outIndices);
+        }
+
+        const float BC1_WEIGHTS[4] = {0.f, 1.f, 1.f / 3.f, 2.f / 3.f};
+
+        const int32_t BC7_WEIGHTS[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+        /// @brief Quantizes a BC7 mode 6 endpoint to 7 bits per channel plus a shared p-bit
+        void QuantizeBC7Endpoint(const float (&color)[4], uint32_t (&outBits)[4], uint32_t& outPBit)
+        {
+            float bestError = std::numeric_limits<float>::max();
+            for(uint32_t p = 0; p < 2; p++)
+            {
+                uint32_t bits[4];
+                float    error = 0.f;
+                for(uint32_t c = 0; c < 4; c++)
+                {
+                    bits[c]     = (uint32_t)std::clamp((int32_t)std::lround((color[c] - p) / 2.f), 0, 127);
+                    float delta = (float)(bits[c] * 2 + p) - color[c];
+                    error += delta * delta;
+                }
+                if(error < bestError)
+                {
+                    bestError = error;
+                    outPBit   = p;
+                    std::copy(bits, bits + 4, outBits);
+                }
+            }
+        }
+
+        uint32_t EvaluateBC7(const uint8_t* rgba, const uint32_t (&bits0)[4], uint32_t p0, const uint32_t (&bits1)[4], uint32_t p1, uint8_t* outIndices)
+        {
+            int32_t palette[16][4];
+            for(uint32_t c = 0; c < 4; c++)
+            {
+                int32_t e0 = (int32_t)(bits0[c] * 2 + p0);
+                int32_t e1 = (int32_t)(bits1[c] * 2 + p1);
+                for(uint32_t i = 0; i < 16; i++)
+                {
+                    palette[i][c] = ((64 - BC7_WEIGHTS[i]) * e0 + BC7_WEIGHTS[i] * e1 + 32) >> 6;
+                }
+            }
+            return SelectIndices<4>(rgba, palette, 16, outIndices);
+        }
+
+        class BitWriter
+        {
+          public:
+            explicit BitWriter(uint8_t* out) : mOut(out) {}
+
+            void Write(uint32_t value, uint32_t bitCount)
+            {
+                for(uint32_t i = 0; i < bitCount; i++, mPosition++)
+                {
+                    if((value >> i) & 1)
+                    {
+                        mOut[mPosition / 8] |= (uint8_t)(1 << (mPosition % 8));
+                    }
+                }
+            }
+
+          protected:
+            uint8_t* mOut;
+            uint32_t mPosition = 0;
+        };
+
+        using EncodeBlockFunc = void (*)(const uint8_t* rgba, uint8_t* out);
+    }  // namespace
+
+    void BcEncoder::EncodeBC1(const uint8_t* rgba, uint8_t* out)
+    {
+        float start[3];
+        float end[3];
+        FitPrincipalAxis<3>(rgba, start, end);
+
+        uint16_t color0 = To565(end);
+        uint16_t color1 = To565(start);
+        uint8_t  indices[BLOCK_PIXELS];
+        uint32_t error = EvaluateBC1(rgba, color0, color1, indices);
+
+        // One least squares pass on the selected indices usually improves on the principal axis extent
+        float weights[BLOCK_PIXELS];
+        for(uint32_t p = 0; p < BLOCK_PIXELS; p++)
+        {
+            weights[p] = BC1_WEIGHTS[indices[p]];
+        }
+        if(FitLeastSquares<3>(rgba, weights, end, start))
+        {
+            uint16_t refined0 = To565(end);
+            uint16_t refined1 = To565(start);
+            uint8_t  refinedIndices[BLOCK_PIXELS];
+            uint32_t refinedError = EvaluateBC1(rgba, refined0, refined1, refinedIndices);
+            if(refinedError < error)
+            {
+                color0 = refined0;
+                color1 = refined1;
+                std::copy(refinedIndices, refinedIndices + BLOCK_PIXELS, indices);
+            }
+        }
+
+        // color0 > color1 selects the 4 color mode, swapping the endpoints swaps index 0 <-> 1 and 2 <-> 3
+        if(color0 < color1)
+        {
+            std::swap(color0, color1);
+            for(uint8_t& index : indices)
+            {
+                index ^= 1;
+            }
+        }
+        if(color0 == color1)
+        {
+            std::fill(indices, indices + BLOCK_PIXELS, (uint8_t)0);
+        }
+
+        uint32_t packedIndices = 0;
+        for(uint32_t p = 0; p < BLOCK_PIXELS; p++)
+        {
+            packedIndices |= (uint32_t)indices[p] << (p * 2);
+        }
+        memcpy(out, &color0, 2);
+        memcpy(out + 2, &color1, 2);
+        memcpy(out + 4, &packedIndices, 4);
+    }
+
+    void BcEncoder::EncodeBC4(const uint8_t* rgba, uint32_t channel, uint8_t* out)
+    {
+        uint8_t minValue = 255;
+        uint8_t maxValue = 0;
+        for(uint32_t p = 0; p < BLOCK_PIXELS; p++)
+        {
+            minValue = std::min(minValue, rgba[p * 4 + channel]);
+            maxValue = std::max(maxValue, rgba[p * 4 + channel]);
+        }
+
+        // 8 value mode (first endpoint greater than the second): 0 = max, 1 = min, 2..7 interpolated
+        int32_t palette[8];
+        palette[0] = maxValue;
+        palette[1] = minValue;
+        for(int32_t i = 2; i < 8; i++)
+        {
+            palette[i] = ((8 - i) * maxValue + (i - 1) * minValue + 3) / 7;
+        }
+
+        uint64_t packedIndices = 0;
+        for(uint32_t p = 0; p < BLOCK_PIXELS && maxValue > minValue; p++)
+        {
+            int32_t  value     = rgba[p * 4 + channel];
+            uint32_t bestIndex = 0;
+            int32_t  bestError = std::numeric_limits<int32_t>::max();
+            for(uint32_t i = 0; i < 8; i++)
+            {
+                int32_t error = std::abs(value - palette[i]);
+                if(error < bestError)
+                {
+                    bestError = error;
+                    bestIndex = i;
+                }
+            }
+            packedIndices |= (uint64_t)bestIndex << (p * 3);
+        }
+
+        out[0] = maxValue;
+        out[1] = minValue;
+        for(uint32_t i = 0; i < 6; i++)
+        {
+            out[2 + i] = (uint8_t)(packedIndices >> (i * 8));
+        }
+    }
+
+    void BcEncoder::EncodeBC3(const uint8_t* rgba, uint8_t* out)
+    {
+        EncodeBC4(rgba, 3, out);
+        EncodeBC1(rgba, out + 8);
+    }
+
+    void BcEncoder::EncodeBC5(const uint8_t* rgba, uint8_t* out)
+    {
+        EncodeBC4(rgba, 0, out);
+        EncodeBC4(rgba, 1, out + 8);
+    }
+
+    void BcEncoder::EncodeBC7(const uint8_t* rgba, uint8_t* out)
+    {
+        float start[4];
+        float end[4];
+        FitPrincipalAxis<4>(rgba, start, end);
+
+        uint32_t bits0[4];
+        uint32_t bits1[4];
+        uint32_t p0 = 0;
+        uint32_t p1 = 0;
+        QuantizeBC7Endpoint(start, bits0, p0);
+        QuantizeBC7Endpoint(end, bits1, p1);
+        uint8_t  indices[BLOCK_PIXELS];
+        uint32_t error = EvaluateBC7(rgba, bits0, p0, bits1, p1, indices);
+
+        float weights[BLOCK_PIXELS];
+        for(uint32_t p = 0; p < BLOCK_PIXELS; p++)
+        {
+            weights[p] = BC7_WEIGHTS[indices[p]] / 64.f;
+        }
+        if(FitLeastSquares<4>(rgba, weights, start, end))
+        {
+            uint32_t refinedBits0[4];
+            uint32_t refinedBits1[4];
+            uint32_t refinedP0 = 0;
+            uint32_t refinedP1 = 0;
+            QuantizeBC7Endpoint(start, refinedBits0, refinedP0);
+            QuantizeBC7Endpoint(end, refinedBits1, refinedP1);
+            uint8_t  refinedIndices[BLOCK_PIXELS];
+            uint32_t refinedError = EvaluateBC7(rgba, refinedBits0, refinedP0, refinedBits1, refinedP1, refinedIndices);
+            if(refinedError < error)
+            {
+                std::copy(refinedBits0, refinedBits0 + 4, bits0);
+                std::copy(refinedBits1, refinedBits1 + 4, bits1);
+                p0 = refinedP0;
+                p1 = refinedP1;
+                std::copy(refinedIndices, refinedIndices + BLOCK_PIXELS, indices);
+            }
+        }
+
+        // The index of the first pixel is stored without its most significant bit, which therefore must be 0
+        if(indices[0] >= 8)
+        {
+            for(uint32_t c = 0; c < 4; c++)
+            {
+                std::swap(bits0[c], bits1[c]);
+            }
+            std::swap(p0, p1);
+            for(uint8_t& index : indices)
+            {
+                index = 15 - index;
+            }
+        }
+
+        memset(out, 0, 16);
+        BitWriter writer(out);
+        writer.Write(1 << 6, 7);
+        for(uint32_t c = 0; c < 4; c++)
+        {
+            writer.Write(bits0[c], 7);
+            writer.Write(bits1[c], 7);
+        }
+        writer.Write(p0, 1);
+        writer.Write(p1, 1);
+        writer.Write(indices[0], 3);
+        for(uint32_t p = 1; p < BLOCK_PIXELS; p++)
+        {
+            writer.Write(indices[p], 4);
+        }
+    }
+
+    bool BcEncoder::SupportsFormat(VkFormat format)
+    {
+        switch(format)
+        {
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            case VK_FORMAT_BC3_UNORM_BLOCK:
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+            case VK_FORMAT_BC4_UNORM_BLOCK:
+            case VK_FORMAT_BC5_UNORM_BLOCK:
+            case VK_FORMAT_BC7_UNORM_BLOCK:
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void BcEncoder::EncodeImage(VkFormat format, const uint8_t* rgba, uint32_t width, uint32_t height, uint8_t* out)
+    {
+        EncodeBlockFunc encodeBlock = nullptr;
+        switch(format)
+        {
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+                encodeBlock = &EncodeBC1;
+                break;
+            case VK_FORMAT_BC3_UNORM_BLOCK:
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+                encodeBlock = &EncodeBC3;
+                break;
+            case VK_FORMAT_BC4_UNORM_BLOCK:
+                encodeBlock = [](const uint8_t* rgba, uint8_t* out) { EncodeBC4(rgba, 0, out); };
+                break;
+            case VK_FORMAT_BC5_UNORM_BLOCK:
+                encodeBlock = &EncodeBC5;
+                break;
+            case VK_FORMAT_BC7_UNORM_BLOCK:
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+                encodeBlock = &EncodeBC7;
+                break;
+            default:
+                HSK_THROWFMT("BC encoder: Format {} not supported!", (uint32_t)format);
+        }
+
+        uint32_t blockSize = GetFormatBlockInfo(format).BlockSize;
+        uint8_t  block[BLOCK_PIXELS * 4];
+        for(uint32_t blockY = 0; blockY < height; blockY += 4)
+        {
+            for(uint32_t blockX = 0; blockX < width; blockX += 4)
+            {
+                for(uint32_t y = 0; y < 4; y++)
+                {
+                    uint32_t sourceY = std::min(blockY + y, height - 1);
+                    for(uint32_t x = 0; x < 4; x++)
+                    {
+                        uint32_t sourceX = std::min(blockX + x, width - 1);
+                        memcpy(block + (y * 4 + x) * 4, rgba + ((size_t)sourceY * width + sourceX) * 4, 4);
+                    }
+                }
+                encodeBlock(block, out);
+                out += blockSize;
+            }
+        }
+    }
+}  // namespace hsk
\ No newline at end of file
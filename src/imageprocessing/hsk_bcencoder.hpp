@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vulkan/vulkan.h>
+
+namespace hsk {
+
+    /// @brief CPU encoders for BC1, BC3, BC4, BC5 and BC7 (mode 6) blocks
+    /// @remark Endpoints are fitted along the principal axis of the block's colors, no exhaustive search. Quality is good enough for offline cooking at interactive speed.
+    class BcEncoder
+    {
+      public:
+        /// @brief Encodes an opaque BC1 block (8 bytes)
+        /// @param rgba 16 pixels, 4 bytes each, row major
+        static void EncodeBC1(const uint8_t* rgba, uint8_t* out);
+        /// @brief Encodes one channel into a BC4 block (8 bytes)
+        /// @param channel Component of the rgba pixels encoded
+        static void EncodeBC4(const uint8_t* rgba, uint32_t channel, uint8_t* out);
+        /// @brief BC4 alpha followed by BC1 color (16 bytes)
+        static void EncodeBC3(const uint8_t* rgba, uint8_t* out);
+        /// @brief BC4 red followed by BC4 green (16 bytes)
+        static void EncodeBC5(const uint8_t* rgba, uint8_t* out);
+        /// @brief Encodes a BC7 mode 6 block (16 bytes): RGBA, one subset, 7 bit endpoints with p-bit, 4 bit indices
+        static void EncodeBC7(const uint8_t* rgba, uint8_t* out);
+
+        /// @brief Checks if EncodeImage() supports a format. sRGB variants are accepted, encoding is identical.
+        static bool SupportsFormat(VkFormat format);
+
+        /// @brief Encodes an RGBA8 image. Blocks overlapping the image border repeat the border pixels.
+        /// @param out Receives GetFormatBlockInfo(format).GetImageSize(width, height) bytes
+        static void EncodeImage(VkFormat format, const uint8_t* rgba, uint32_t width, uint32_t height, uint8_t* out);
+    };
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,317 @@
+#include "hsk_ktx2.hpp"
+#include "../hsk_exception.hpp"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace hsk {
+    namespace {
+        const uint8_t KTX2_IDENTIFIER[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+        const size_t KTX2_HEADER_SIZE      = 80;
+        const size_t KTX2_LEVEL_INDEX_SIZE = 24;
+
+        // Khronos data format descriptor values (https://registry.khronos.org/DataFormat/specs/1.3/dataformat.1.3.html)
+        const uint8_t KHR_DF_MODEL_UASTC    = 166;
+        const uint8_t KHR_DF_TRANSFER_SRGB  = 2;
+        const size_t  KHR_DF_MIN_BLOCK_SIZE = 16;
+
+        template <typename T>
+        T ReadValue(const uint8_t* data, size_t offset)
+        {
+            T value;
+            memcpy(&value, data + offset, sizeof(T));
+            return value;
+        }
+
+        template <typename T>
+        void AppendValue(std::vector<uint8_t>& out, T value)
+        {
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+            out.insert(out.end(), bytes, bytes + sizeof(T));
+        }
+
+        struct DfdSample
+        {
+            uint16_t BitOffset = 0;
+            uint8_t  BitLength = 0;
+            uint8_t  Channel   = 0;
+            uint32_t Upper     = 0;
+        };
+
+        const uint8_t KHR_DF_MODEL_RGBSDA           = 1;
+        const uint8_t KHR_DF_MODEL_BC1A             = 128;
+        const uint8_t KHR_DF_MODEL_BC3              = 130;
+        const uint8_t KHR_DF_MODEL_BC4              = 131;
+        const uint8_t KHR_DF_MODEL_BC5              = 132;
+        const uint8_t KHR_DF_MODEL_BC7              = 134;
+        const uint8_t KHR_DF_PRIMARIES_BT709        = 1;
+        const uint8_t KHR_DF_TRANSFER_LINEAR        = 1;
+        const uint8_t KHR_DF_CHANNEL_ALPHA          = 15;
+        const uint8_t KHR_DF_SAMPLE_DATATYPE_LINEAR = 0x10;
+
+        /// @brief Builds the data format descriptor (total size followed by one basic descriptor block)
+        std::vector<uint8_t> BuildDataFormatDescriptor(VkFormat format, bool srgb)
+        {
+            uint8_t                colorModel = 0;
+            std::vector<DfdSample> samples;
+            switch(format)
+            {
+                case VK_FORMAT_R8G8B8A8_UNORM:
+                    colorModel = KHR_DF_MODEL_RGBSDA;
+                    samples    = {DfdSample{0, 7, 0, 255}, DfdSample{8, 7, 1, 255}, DfdSample{16, 7, 2, 255},
+                                  DfdSample{24, 7, (uint8_t)(KHR_DF_CHANNEL_ALPHA | (srgb ? KHR_DF_SAMPLE_DATATYPE_LINEAR : 0)), 255}};
+                    break;
+                case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+                    colorModel = KHR_DF_MODEL_BC1A;
+                    samples    = {DfdSample{0, 63, 0, UINT32_MAX}};
+                    break;
+                case VK_FORMAT_BC3_UNORM_BLOCK:
+                    colorModel = KHR_DF_MODEL_BC3;
+                    samples    = {DfdSample{0, 63, KHR_DF_CHANNEL_ALPHA, UINT32_MAX}, DfdSample{64, 63, 0, UINT32_MAX}};
+                    break;
+                case VK_FORMAT_BC4_UNORM_BLOCK:
+                    colorModel = KHR_DF_MODEL_BC4;
+                    samples    = {DfdSample{0, 63, 0, UINT32_MAX}};
+                    break;
+                case VK_FORMAT_BC5_UNORM_BLOCK:
+                    colorModel = KHR_DF_MODEL_BC5;
+                    samples    = {DfdSample{0, 63, 0, UINT32_MAX}, DfdSample{64, 63, 1, UINT32_MAX}};
+                    break;
+                case VK_FORMAT_BC7_UNORM_BLOCK:
+                    colorModel = KHR_DF_MODEL_BC7;
+                    samples    = {DfdSample{0, 127, 0, UINT32_MAX}};
+                    break;
+                default:
+                    HSK_THROWFMT("KTX2: Writing format {} not supported!", (uint32_t)format);
+            }
+
+            FormatBlockInfo blockInfo = GetFormatBlockInfo(format);
+            uint16_t        blockSize = (uint16_t)(24 + 16 * samples.size());
+
+            std::vector<uint8_t> dfd;
+            AppendValue<uint32_t>(dfd, 4 + blockSize);
+            AppendValue<uint32_t>(dfd, 0);  // Khronos vendor id, basic descriptor type
+            AppendValue<uint16_t>(dfd, 2);  // Version 1.3
+            AppendValue<uint16_t>(dfd, blockSize);
+            AppendValue<uint8_t>(dfd, colorModel);
+            AppendValue<uint8_t>(dfd, KHR_DF_PRIMARIES_BT709);
+            AppendValue<uint8_t>(dfd, srgb ? KHR_DF_TRANSFER_SRGB : KHR_DF_TRANSFER_LINEAR);
+            AppendValue<uint8_t>(dfd, 0);  // Straight alpha
+            AppendValue<uint8_t>(dfd, (uint8_t)(blockInfo.BlockWidth - 1));
+            AppendValue<uint8_t>(dfd, (uint8_t)(blockInfo.BlockHeight - 1));
+            AppendValue<uint16_t>(dfd, 0);
+            AppendValue<uint8_t>(dfd, (uint8_t)blockInfo.BlockSize);
+            dfd.resize(dfd.size() + 7, 0);
+            for(const DfdSample& sample : samples)
+            {
+                AppendValue<uint16_t>(dfd, sample.BitOffset);
+                AppendValue<uint8_t>(dfd, sample.BitLength);
+                AppendValue<uint8_t>(dfd, sample.Channel);
+                AppendValue<uint32_t>(dfd, 0);  // Sample position
+                AppendValue<uint32_t>(dfd, 0);
+                AppendValue<uint32_t>(dfd, sample.Upper);
+            }
+            return dfd;
+        }
+    }  // namespace
+
+    FormatBlockInfo GetFormatBlockInfo(VkFormat format)
+    {
+        switch(format)
+        {
+            case VK_FORMAT_R8_UNORM:
+            case VK_FORMAT_R8_SRGB:
+                return FormatBlockInfo{.BlockSize = 1};
+            case VK_FORMAT_R8G8_UNORM:
+            case VK_FORMAT_R8G8_SRGB:
+            case VK_FORMAT_R16_SFLOAT:
+                return FormatBlockInfo{.BlockSize = 2};
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+            case VK_FORMAT_B8G8R8A8_UNORM:
+            case VK_FORMAT_B8G8R8A8_SRGB:
+            case VK_FORMAT_R16G16_SFLOAT:
+            case VK_FORMAT_R32_SFLOAT:
+                return FormatBlockInfo{.BlockSize = 4};
+            case VK_FORMAT_R16G16B16A16_SFLOAT:
+            case VK_FORMAT_R32G32_SFLOAT:
+                return FormatBlockInfo{.BlockSize = 8};
+            case VK_FORMAT_R32G32B32A32_SFLOAT:
+                return FormatBlockInfo{.BlockSize = 16};
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            case VK_FORMAT_BC4_UNORM_BLOCK:
+            case VK_FORMAT_BC4_SNORM_BLOCK:
+                return FormatBlockInfo{.BlockWidth = 4, .BlockHeight = 4, .BlockSize = 8};
+            case VK_FORMAT_BC2_UNORM_BLOCK:
+            case VK_FORMAT_BC2_SRGB_BLOCK:
+            case VK_FORMAT_BC3_UNORM_BLOCK:
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+            case VK_FORMAT_BC5_UNORM_BLOCK:
+            case VK_FORMAT_BC5_SNORM_BLOCK:
+            case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+            case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+            case VK_FORMAT_BC7_UNORM_BLOCK:
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+                return FormatBlockInfo{.BlockWidth = 4, .BlockHeight = 4, .BlockSize = 16};
+            default:
+                return FormatBlockInfo{};
+        }
+    }
+
+    VkFormat GetUnormFormat(VkFormat format)
+    {
+        switch(format)
+        {
+            case VK_FORMAT_R8_SRGB:
+                return VK_FORMAT_R8_UNORM;
+            case VK_FORMAT_R8G8_SRGB:
+                return VK_FORMAT_R8G8_UNORM;
+            case VK_FORMAT_R8G8B8A8_SRGB:
+                return VK_FORMAT_R8G8B8A8_UNORM;
+            case VK_FORMAT_B8G8R8A8_SRGB:
+                return VK_FORMAT_B8G8R8A8_UNORM;
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+                return VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+            case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+                return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+            case VK_FORMAT_BC2_SRGB_BLOCK:
+                return VK_FORMAT_BC2_UNORM_BLOCK;
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+                return VK_FORMAT_BC3_UNORM_BLOCK;
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+                return VK_FORMAT_BC7_UNORM_BLOCK;
+            default:
+                return format;
+        }
+    }
+
+    bool Ktx2Texture::HasIdentifier(const uint8_t* data, size_t size)
+    {
+        return size >= sizeof(KTX2_IDENTIFIER) && memcmp(data, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0;
+    }
+
+    void Ktx2Texture::Read(const uint8_t* data, size_t size)
+    {
+        HSK_ASSERTFMT(HasIdentifier(data, size) && size >= KTX2_HEADER_SIZE, "KTX2: Missing file identifier or truncated header ({} bytes)!", size)
+
+        mData             = data;
+        mSize             = size;
+        mFormat           = (VkFormat)ReadValue<uint32_t>(data, 12);
+        mWidth            = ReadValue<uint32_t>(data, 20);
+        mHeight           = ReadValue<uint32_t>(data, 24);
+        uint32_t depth    = ReadValue<uint32_t>(data, 28);
+        uint32_t layers   = ReadValue<uint32_t>(data, 32);
+        uint32_t faces    = ReadValue<uint32_t>(data, 36);
+        uint32_t levels   = ReadValue<uint32_t>(data, 40);
+        mSupercompression = (ESupercompression)ReadValue<uint32_t>(data, 44);
+
+        uint32_t dfdOffset = ReadValue<uint32_t>(data, 48);
+        uint32_t dfdSize   = ReadValue<uint32_t>(data, 52);
+        mGlobalDataOffset  = ReadValue<uint64_t>(data, 64);
+        mGlobalDataSize    = ReadValue<uint64_t>(data, 72);
+
+        HSK_ASSERTFMT(mWidth > 0 && mHeight > 0 && depth == 0 && layers <= 1 && faces == 1, "KTX2: Only 2D textures are supported ({}x{}x{}, {} layers, {} faces)!", mWidth,
+                      mHeight, depth, layers, faces)
+        HSK_ASSERTFMT(mGlobalDataOffset + mGlobalDataSize <= size, "KTX2: Supercompression global data ({} bytes at {}) out of bounds!", mGlobalDataSize, mGlobalDataOffset)
+
+        // Level count 0 requests the mip chain to be generated after loading, the file holds the base level only
+        mHasMipChain       = levels > 0;
+        uint32_t maxLevels = 1;
+        while(std::max(mWidth, mHeight) >> maxLevels)
+        {
+            maxLevels++;
+        }
+        levels = std::max(levels, 1u);
+        HSK_ASSERTFMT(levels <= maxLevels && KTX2_HEADER_SIZE + levels * KTX2_LEVEL_INDEX_SIZE <= size, "KTX2: Invalid level count {}!", levels)
+
+        mLevels.resize(levels);
+        for(uint32_t i = 0; i < levels; i++)
+        {
+            size_t indexOffset = KTX2_HEADER_SIZE + i * KTX2_LEVEL_INDEX_SIZE;
+            Level& level       = mLevels[i];
+            level.Offset       = ReadValue<uint64_t>(data, indexOffset);
+            level.Size         = ReadValue<uint64_t>(data, indexOffset + 8);
+            level.Width        = std::max(mWidth >> i, 1u);
+            level.Height       = std::max(mHeight >> i, 1u);
+            HSK_ASSERTFMT(level.Offset <= size && level.Size <= size - level.Offset, "KTX2: Data of level {} out of bounds!", i)
+        }
+
+        // The basic descriptor block tells Basis UASTC apart and carries the transfer function
+        mUastc = false;
+        mSrgb  = false;
+        if(dfdSize >= KHR_DF_MIN_BLOCK_SIZE && (uint64_t)dfdOffset + dfdSize <= size)
+        {
+            mUastc = data[dfdOffset + 12] == KHR_DF_MODEL_UASTC;
+            mSrgb  = data[dfdOffset + 14] == KHR_DF_TRANSFER_SRGB;
+        }
+
+        if(mSupercompression == ESupercompression::None && mFormat != VK_FORMAT_UNDEFINED)
+        {
+            FormatBlockInfo blockInfo = GetFormatBlockInfo(mFormat);
+            for(uint32_t i = 0; i < levels && blockInfo.BlockSize; i++)
+            {
+                uint64_t expected = blockInfo.GetImageSize(mLevels[i].Width, mLevels[i].Height);
+                HSK_ASSERTFMT(mLevels[i].Size >= expected, "KTX2: Level {} holds {} bytes, expected {}!", i, mLevels[i].Size, expected)
+            }
+        }
+    }
+
+    void Ktx2Texture::Write(std::ostream& out, VkFormat format, const uint8_t* data, const std::vector<Level>& levels, bool srgb)
+    {
+        HSK_ASSERTFMT(levels.size() > 0, "KTX2: Writing texture of format {} without levels!", (uint32_t)format)
+
+        std::vector<uint8_t> dfd       = BuildDataFormatDescriptor(format, srgb);
+        FormatBlockInfo      blockInfo = GetFormatBlockInfo(format);
+        uint64_t             alignment = std::lcm<uint64_t>(blockInfo.BlockSize, 4);
+
+        // Level data is stored smallest level first, each level aligned to lcm(texel block size, 4)
+        uint64_t              dfdOffset = KTX2_HEADER_SIZE + levels.size() * KTX2_LEVEL_INDEX_SIZE;
+        uint64_t              offset    = dfdOffset + dfd.size();
+        std::vector<uint64_t> fileOffsets(levels.size());
+        for(size_t i = levels.size(); i-- > 0;)
+        {
+            offset         = (offset + alignment - 1) / alignment * alignment;
+            fileOffsets[i] = offset;
+            offset += levels[i].Size;
+        }
+
+        std::vector<uint8_t> header;
+        header.insert(header.end(), KTX2_IDENTIFIER, KTX2_IDENTIFIER + sizeof(KTX2_IDENTIFIER));
+        AppendValue<uint32_t>(header, (uint32_t)format);
+        AppendValue<uint32_t>(header, 1);  // Type size, 1 for block compressed and 8 bit formats
+        AppendValue<uint32_t>(header, levels[0].Width);
+        AppendValue<uint32_t>(header, levels[0].Height);
+        AppendValue<uint32_t>(header, 0);  // Depth
+        AppendValue<uint32_t>(header, 0);  // Layers
+        AppendValue<uint32_t>(header, 1);  // Faces
+        AppendValue<uint32_t>(header, (uint32_t)levels.size());
+        AppendValue<uint32_t>(header, (uint32_t)ESupercompression::None);
+        AppendValue<uint32_t>(header, (uint32_t)dfdOffset);
+        AppendValue<uint32_t>(header, (uint32_t)dfd.size());
+        AppendValue<uint32_t>(header, 0);  // Key/value data
+        AppendValue<uint32_t>(header, 0);
+        AppendValue<uint64_t>(header, 0);  // Supercompression global data
+        AppendValue<uint64_t>(header, 0);
+        for(size_t i = 0; i < levels.size(); i++)
+        {
+            AppendValue<uint64_t>(header, fileOffsets[i]);
+            AppendValue<uint64_t>(header, levels[i].Size);
+            AppendValue<uint64_t>(header, levels[i].Size);
+        }
+        header.insert(header.end(), dfd.begin(), dfd.end());
+        out.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+        uint64_t   position    = header.size();
+        const char padding[16] = {};
+        for(size_t i = levels.size(); i-- > 0;)
+        {
+            out.write(padding, fileOffsets[i] - position);
+            out.write(reinterpret_cast<const char*>(data + levels[i].Offset), levels[i].Size);
+            position = fileOffsets[i] + levels[i].Size;
+        }
+    }
+}  // namespace hsk
\ No newline at end of file
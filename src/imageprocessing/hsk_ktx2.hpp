@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace hsk {
+
+    /// @brief Texel block dimensions and size of a format
+    struct FormatBlockInfo
+    {
+        uint32_t BlockWidth  = 1;
+        uint32_t BlockHeight = 1;
+        /// @brief Size of a block in bytes. 0 for formats not known to GetFormatBlockInfo()
+        uint32_t BlockSize = 0;
+
+        inline bool IsCompressed() const { return BlockWidth > 1 || BlockHeight > 1; }
+        /// @brief Size in bytes of an image of the given dimensions
+        inline uint64_t GetImageSize(uint32_t width, uint32_t height) const
+        {
+            return (uint64_t)((width + BlockWidth - 1) / BlockWidth) * ((height + BlockHeight - 1) / BlockHeight) * BlockSize;
+        }
+    };
+
+    /// @brief Block info of 8 bit, half and float color formats and all BCn formats. Formats with a texel size not dividing 16 (e.g. RGB8) are not listed.
+    FormatBlockInfo GetFormatBlockInfo(VkFormat format);
+
+    /// @brief UNORM format with the same data layout as an *_SRGB format, other formats are returned unchanged
+    /// @remark Textures are always sampled as UNORM, the shaders decode sRGB color themselves (like for PNG / JPEG images uploaded as R8G8B8A8_UNORM)
+    VkFormat GetUnormFormat(VkFormat format);
+
+    /// @brief A 2D texture stored in a KTX2 container (https://registry.khronos.org/KTX/specs/2.0/ktxspec.v2.html)
+    /// @remark Only references the file contents, which must outlive the object. Cube maps, arrays and 3D textures are not supported.
+    class Ktx2Texture
+    {
+      public:
+        enum class ESupercompression : uint32_t
+        {
+            None      = 0,
+            BasisLZ   = 1,
+            Zstandard = 2,
+            Zlib      = 3
+        };
+
+        struct Level
+        {
+            /// @brief Offset of the level data in the file
+            uint64_t Offset = 0;
+            /// @brief Size of the (possibly supercompressed) level data
+            uint64_t Size   = 0;
+            uint32_t Width  = 0;
+            uint32_t Height = 0;
+        };
+
+        /// @brief Checks for the KTX2 file identifier
+        static bool HasIdentifier(const uint8_t* data, size_t size);
+
+        /// @brief Parses header, data format descriptor and level index. Throws if the file is malformed or not a 2D texture.
+        void Read(const uint8_t* data, size_t size);
+
+        /// @brief Writes a 2D texture without supercompression. Supports the UNORM formats written by the texture cooker (RGBA8, BC1, BC3, BC4, BC5, BC7).
+        /// @param data Level data, Level::Offset is relative to data
+        /// @param levels Mip levels, largest first
+        /// @param srgb Stored as transfer function of the data format descriptor
+        static void Write(std::ostream& out, VkFormat format, const uint8_t* data, const std::vector<Level>& levels, bool srgb);
+
+        inline const uint8_t* GetData() const { return mData; }
+        inline size_t         GetSize() const { return mSize; }
+        /// @brief VK_FORMAT_UNDEFINED for Basis Universal payloads
+        inline VkFormat          GetFormat() const { return mFormat; }
+        inline uint32_t          GetWidth() const { return mWidth; }
+        inline uint32_t          GetHeight() const { return mHeight; }
+        inline ESupercompression GetSupercompression() const { return mSupercompression; }
+        /// @brief Mip levels, largest first. Holds a single level if the file requests runtime mip generation (see HasMipChain()).
+        inline const std::vector<Level>& GetLevels() const { return mLevels; }
+        /// @brief False if the file has a level count of 0, which requests mip map generation after upload
+        inline bool HasMipChain() const { return mHasMipChain; }
+        /// @brief True if the data format descriptor specifies the sRGB transfer function
+        inline bool IsSrgb() const { return mSrgb; }
+        /// @brief True for Basis Universal payloads (ETC1S with BasisLZ supercompression, or UASTC). These have no Vulkan format and are rejected by ModelConverter
+        inline bool IsBasisUniversal() const { return mFormat == VK_FORMAT_UNDEFINED && (mSupercompression == ESupercompression::BasisLZ || mUastc); }
+        /// @brief Supercompression global data (BasisLZ codebooks). Empty for other schemes.
+        inline const uint8_t* GetGlobalData() const { return mGlobalDataSize ? mData + mGlobalDataOffset : nullptr; }
+        inline uint64_t       GetGlobalDataSize() const { return mGlobalDataSize; }
+        inline const uint8_t* GetLevelData(uint32_t level) const { return mData + mLevels[level].Offset; }
+
+      protected:
+        const uint8_t*     mData             = nullptr;
+        size_t             mSize             = 0;
+        VkFormat           mFormat           = VK_FORMAT_UNDEFINED;
+        uint32_t           mWidth            = 0;
+        uint32_t           mHeight           = 0;
+        ESupercompression  mSupercompression = ESupercompression::None;
+        std::vector<Level> mLevels           = {};
+        bool               mHasMipChain      = false;
+        bool               mSrgb             = false;
+        bool               mUastc            = false;
+        uint64_t           mGlobalDataOffset = 0;
+        uint64_t           mGlobalDataSize   = 0;
+    };
+
+}  // namespace hsk
\ No newline at end of file
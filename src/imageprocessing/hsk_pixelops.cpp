@@ -0,0 +1,1069 @@
+#include "hsk_pixelops.hpp"
+#include "../hsk_exception.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define HSK_PIXELOPS_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(HSK_PIXELOPS_SSE2) && (defined(__SSSE3__) || defined(__AVX__))
+#define HSK_PIXELOPS_SSSE3
+#include <tmmintrin.h>
+#endif
+#if defined(HSK_PIXELOPS_SSE2) && (defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#define HSK_PIXELOPS_F16C
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#define HSK_PIXELOPS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace hsk {
+    namespace {
+        inline uint32_t FloatBits(float value)
+        {
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        inline float BitsToFloat(uint32_t bits)
+        {
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        inline double DecodeSrgb(double value) { return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4); }
+
+        /// @brief Exact sRGB encoding, the reference of the table based encoding
+        inline uint8_t EncodeSrgbExact(float value)
+        {
+            if(!(value > 0.f))
+            {
+                return 0;
+            }
+            if(value >= 1.f)
+            {
+                return 255;
+            }
+            double linear  = value;
+            double encoded = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+            return (uint8_t)std::lround(encoded * 255.0);
+        }
+
+        const std::array<float, 256>& GetSrgbToLinearTable()
+        {
+            static const std::array<float, 256> table = []() {
+                std::array<float, 256> result;
+                for(uint32_t i = 0; i < 256; i++)
+                {
+                    result[i] = (float)DecodeSrgb(i / 255.0);
+                }
+                return result;
+            }();
+            return table;
+        }
+
+        /// @brief Table based sRGB encoding. Values are clamped to [2^-13, 1 - ulp] (everything below encodes to 0) and split into buckets by exponent and
+        /// the upper 7 mantissa bits. The encoded value rises by at most one within a bucket, so every bucket stores its first encoded value and the threshold
+        /// at which it increments. Both are derived from EncodeSrgbExact(), so results are identical.
+        struct SrgbEncodeTable
+        {
+            static constexpr uint32_t MIN_BITS     = (127 - 13) << 23;
+            static constexpr uint32_t MAX_BITS     = 0x3f7fffff;
+            static constexpr uint32_t BUCKET_SHIFT = 16;
+            static constexpr uint32_t BUCKET_COUNT = ((MAX_BITS - MIN_BITS) >> BUCKET_SHIFT) + 1;
+
+            std::array<uint8_t, BUCKET_COUNT> Base;
+            std::array<float, BUCKET_COUNT>   Threshold;
+
+            SrgbEncodeTable()
+            {
+                for(uint32_t bucket = 0; bucket < BUCKET_COUNT; bucket++)
+                {
+                    uint32_t first = MIN_BITS + (bucket << BUCKET_SHIFT);
+                    uint32_t last  = std::min(first + (1u << BUCKET_SHIFT) - 1, MAX_BITS);
+                    Base[bucket]   = EncodeSrgbExact(BitsToFloat(first));
+                    if(EncodeSrgbExact(BitsToFloat(last)) == Base[bucket])
+                    {
+                        Threshold[bucket] = std::numeric_limits<float>::infinity();
+                        continue;
+                    }
+                    // Encoding is monotonic, search the first value encoding to Base + 1
+                    while(first < last)
+                    {
+                        uint32_t middle = first + (last - first) / 2;
+                        if(EncodeSrgbExact(BitsToFloat(middle)) > Base[bucket])
+                        {
+                            last = middle;
+                        }
+                        else
+                        {
+                            first = middle + 1;
+                        }
+                    }
+                    Threshold[bucket] = BitsToFloat(first);
+                }
+            }
+
+            inline uint8_t Encode(float value) const
+            {
+                // Written this way to map NaN to 0
+                value           = value > BitsToFloat(MIN_BITS) ? value : BitsToFloat(MIN_BITS);
+                value           = value < BitsToFloat(MAX_BITS) ? value : BitsToFloat(MAX_BITS);
+                uint32_t bucket = (FloatBits(value) - MIN_BITS) >> BUCKET_SHIFT;
+                return Base[bucket] + (value >= Threshold[bucket] ? 1 : 0);
+            }
+        };
+
+        const SrgbEncodeTable& GetSrgbEncodeTable()
+        {
+            static const SrgbEncodeTable table;
+            return table;
+        }
+
+        inline float ClampUnorm(float value)
+        {
+            // Written this way to map NaN to 0
+            value = value > 0.f ? value : 0.f;
+            return value < 1.f ? value : 1.f;
+        }
+
+        inline uint16_t FloatToHalfScalar(float value)
+        {
+            // Round to nearest even, see https://gist.github.com/rygorous/2156668
+            const uint32_t f16Max      = (127 + 16) << 23;
+            const uint32_t f32Infinity = 255 << 23;
+            const uint32_t denormMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+            uint32_t bits = FloatBits(value);
+            uint32_t sign = bits & 0x80000000u;
+            bits ^= sign;
+
+            uint32_t result;
+            if(bits >= f16Max)
+            {
+                // Infinity or NaN (quieted)
+                result = bits > f32Infinity ? 0x7e00 : 0x7c00;
+            }
+            else if(bits < (113u << 23))
+            {
+                // Denormal or zero: Let the float addition round the mantissa
+                result = FloatBits(BitsToFloat(bits) + BitsToFloat(denormMagic)) - denormMagic;
+            }
+            else
+            {
+                uint32_t mantissaOdd = (bits >> 13) & 1;
+                bits += ((uint32_t)(15 - 127) << 23) + 0xfff;
+                bits += mantissaOdd;
+                result = bits >> 13;
+            }
+            return (uint16_t)(result | (sign >> 16));
+        }
+
+        inline float HalfToFloatScalar(uint16_t value)
+        {
+            const uint32_t shiftedExponent = 0x7c00 << 13;
+
+            uint32_t bits     = (uint32_t)(value & 0x7fff) << 13;
+            uint32_t exponent = bits & shiftedExponent;
+            bits += (127 - 15) << 23;
+            if(exponent == shiftedExponent)
+            {
+                // Infinity or NaN
+                bits += (128 - 16) << 23;
+            }
+            else if(exponent == 0)
+            {
+                // Denormal or zero: Renormalize
+                bits += 1 << 23;
+                bits = FloatBits(BitsToFloat(bits) - BitsToFloat(113 << 23));
+            }
+            return BitsToFloat(bits | ((uint32_t)(value & 0x8000) << 16));
+        }
+
+        inline void BoxPixel(const uint8_t* const (&rows)[2], uint32_t x, uint32_t width, uint8_t* target)
+        {
+            uint32_t x0 = std::min(x * 2, width - 1) * 4;
+            uint32_t x1 = std::min(x * 2 + 1, width - 1) * 4;
+            for(uint32_t c = 0; c < 4; c++)
+            {
+                target[c] = (uint8_t)((rows[0][x0 + c] + rows[0][x1 + c] + rows[1][x0 + c] + rows[1][x1 + c] + 2) / 4);
+            }
+        }
+
+        /// @brief Source samples and weights of every output pixel along one axis of a downsampling pass
+        struct FilterTaps
+        {
+            uint32_t TapCount = 0;
+            /// @brief TapCount source indices per output index, clamped to the image
+            std::vector<uint32_t> Indices = {};
+            /// @brief TapCount weights per output index, normalized
+            std::vector<float> Weights = {};
+        };
+
+        double BesselI0(double x)
+        {
+            double sum  = 1.0;
+            double term = 1.0;
+            for(int32_t k = 1; k < 32 && term > sum * 1e-12; k++)
+            {
+                term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                sum += term;
+            }
+            return sum;
+        }
+
+        void ComputeFilterTaps(uint32_t srcSize, uint32_t dstSize, EMipFilter filter, FilterTaps& out)
+        {
+            if(filter == EMipFilter::Box || srcSize == dstSize)
+            {
+                // Same clamping of odd sizes as DownsampleBox()
+                out.TapCount = 2;
+                out.Indices.resize((size_t)dstSize * 2);
+                out.Weights.assign((size_t)dstSize * 2, 0.5f);
+                for(uint32_t x = 0; x < dstSize; x++)
+                {
+                    out.Indices[x * 2]     = std::min(x * 2, srcSize - 1);
+                    out.Indices[x * 2 + 1] = std::min(x * 2 + 1, srcSize - 1);
+                }
+                return;
+            }
+
+            const double alpha  = 4.0;
+            const double radius = 2.0;  // In output pixels
+            const double pi     = 3.14159265358979323846;
+            double       scale  = (double)srcSize / dstSize;
+
+            out.TapCount = (uint32_t)std::ceil(radius * scale * 2.0) + 1;
+            out.Indices.assign((size_t)dstSize * out.TapCount, 0);
+            out.Weights.assign((size_t)dstSize * out.TapCount, 0.f);
+            std::vector<double> weights(out.TapCount);
+            for(uint32_t x = 0; x < dstSize; x++)
+            {
+                double  center = (x + 0.5) * scale;
+                int32_t first  = (int32_t)std::floor(center - radius * scale);
+                double  sum    = 0.0;
+                for(uint32_t tap = 0; tap < out.TapCount; tap++)
+                {
+                    double distance = (first + (int32_t)tap + 0.5 - center) / scale;
+                    double weight   = 0.0;
+                    if(std::abs(distance) < radius)
+                    {
+                        double sinc   = distance == 0.0 ? 1.0 : std::sin(pi * distance) / (pi * distance);
+                        double window = BesselI0(alpha * std::sqrt(1.0 - (distance / radius) * (distance / radius))) / BesselI0(alpha);
+                        weight        = sinc * window;
+                    }
+                    weights[tap] = weight;
+                    sum += weight;
+                }
+                for(uint32_t tap = 0; tap < out.TapCount; tap++)
+                {
+                    out.Indices[(size_t)x * out.TapCount + tap] = (uint32_t)std::clamp(first + (int32_t)tap, 0, (int32_t)srcSize - 1);
+                    out.Weights[(size_t)x * out.TapCount + tap] = (float)(weights[tap] / sum);
+                }
+            }
+        }
+
+        /// @brief out = sum of weights[i] * pixel at base + offsets[i] * stride (RGBA float)
+        template <bool Simd>
+        inline void AccumulateTaps(const float* base, size_t stride, const uint32_t* offsets, const float* weights, uint32_t tapCount, float* out)
+        {
+#if defined(HSK_PIXELOPS_SSE2)
+            if constexpr(Simd)
+            {
+                __m128 sum = _mm_setzero_ps();
+                for(uint32_t tap = 0; tap < tapCount; tap++)
+                {
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(base + offsets[tap] * stride), _mm_set1_ps(weights[tap])));
+                }
+                _mm_storeu_ps(out, sum);
+                return;
+            }
+#elif defined(HSK_PIXELOPS_NEON)
+            if constexpr(Simd)
+            {
+                float32x4_t sum = vdupq_n_f32(0.f);
+                for(uint32_t tap = 0; tap < tapCount; tap++)
+                {
+                    sum = vaddq_f32(sum, vmulq_n_f32(vld1q_f32(base + offsets[tap] * stride), weights[tap]));
+                }
+                vst1q_f32(out, sum);
+                return;
+            }
+#endif
+            for(uint32_t c = 0; c < 4; c++)
+            {
+                float sum = 0.f;
+                for(uint32_t tap = 0; tap < tapCount; tap++)
+                {
+                    sum += base[offsets[tap] * stride + c] * weights[tap];
+                }
+                out[c] = sum;
+            }
+        }
+
+        /// @brief Separable downsampling: Rows first into a temporary image, then columns
+        template <bool Simd>
+        void DownsampleSeparable(const float* src, uint32_t width, uint32_t height, EMipFilter filter, float* dst)
+        {
+            uint32_t   outWidth  = std::max(width / 2, 1u);
+            uint32_t   outHeight = std::max(height / 2, 1u);
+            FilterTaps horizontal;
+            FilterTaps vertical;
+            ComputeFilterTaps(width, outWidth, filter, horizontal);
+            ComputeFilterTaps(height, outHeight, filter, vertical);
+
+            std::vector<float> rows((size_t)outWidth * height * 4);
+            for(uint32_t y = 0; y < height; y++)
+            {
+                const float* srcRow = src + (size_t)y * width * 4;
+                for(uint32_t x = 0; x < outWidth; x++)
+                {
+                    size_t tapOffset = (size_t)x * horizontal.TapCount;
+                    AccumulateTaps<Simd>(srcRow, 4, &horizontal.Indices[tapOffset], &horizontal.Weights[tapOffset], horizontal.TapCount,
+                                         &rows[((size_t)y * outWidth + x) * 4]);
+                }
+            }
+            for(uint32_t y = 0; y < outHeight; y++)
+            {
+                size_t tapOffset = (size_t)y * vertical.TapCount;
+                for(uint32_t x = 0; x < outWidth; x++)
+                {
+                    AccumulateTaps<Simd>(&rows[(size_t)x * 4], (size_t)outWidth * 4, &vertical.Indices[tapOffset], &vertical.Weights[tapOffset], vertical.TapCount,
+                                         dst + ((size_t)y * outWidth + x) * 4);
+                }
+            }
+        }
+
+        void AssertSwizzleOrder(const uint8_t (&order)[4])
+        {
+            HSK_ASSERTFMT(order[0] < 4 && order[1] < 4 && order[2] < 4 && order[3] < 4, "Pixel ops: Invalid swizzle order {} {} {} {}!", order[0], order[1], order[2], order[3])
+        }
+
+#ifdef HSK_PIXELOPS_SSE2
+        /// @brief Packs the low 16 bits of every 32 bit lane of a and b (packs_epi32 saturates, so the lanes are sign extended first)
+        inline __m128i PackLow16(__m128i a, __m128i b)
+        {
+            return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16), _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+        }
+
+        inline __m128i Select(__m128i mask, __m128i a, __m128i b) { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+
+        /// @brief Clamps to [0, 1] (NaN to 0), scales and rounds half up
+        inline __m128i FloatToUnormSse(__m128 value, float scale)
+        {
+            value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.f));
+            return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(scale)), _mm_set1_ps(0.5f)));
+        }
+
+#ifndef HSK_PIXELOPS_F16C
+        inline __m128i FloatToHalfSse(__m128 value)
+        {
+            const __m128i f16Max      = _mm_set1_epi32((127 + 16) << 23);
+            const __m128i f32Infinity = _mm_set1_epi32(255 << 23);
+            const __m128i denormMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+
+            __m128i bits = _mm_castps_si128(value);
+            __m128i sign = _mm_and_si128(bits, _mm_set1_epi32((int32_t)0x80000000u));
+            bits         = _mm_xor_si128(bits, sign);
+
+            __m128i infinityOrNan = _mm_cmpgt_epi32(bits, _mm_sub_epi32(f16Max, _mm_set1_epi32(1)));
+            __m128i nan           = _mm_cmpgt_epi32(bits, f32Infinity);
+            __m128i special       = _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_and_si128(nan, _mm_set1_epi32(0x0200)));
+
+            __m128i denormal       = _mm_cmplt_epi32(bits, _mm_set1_epi32(113 << 23));
+            __m128i denormalResult = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(bits), _mm_castsi128_ps(denormMagic))), denormMagic);
+
+            __m128i mantissaOdd  = _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(1));
+            __m128i normalResult = _mm_add_epi32(bits, _mm_set1_epi32((int32_t)((uint32_t)(15 - 127) << 23) + 0xfff));
+            normalResult         = _mm_srli_epi32(_mm_add_epi32(normalResult, mantissaOdd), 13);
+
+            __m128i result = Select(infinityOrNan, special, Select(denormal, denormalResult, normalResult));
+            return _mm_or_si128(result, _mm_srli_epi32(sign, 16));
+        }
+
+        /// @param value Half floats zero extended to 32 bit
+        inline __m128 HalfToFloatSse(__m128i value)
+        {
+            const __m128i shiftedExponent = _mm_set1_epi32(0x7c00 << 13);
+
+            __m128i bits     = _mm_slli_epi32(_mm_and_si128(value, _mm_set1_epi32(0x7fff)), 13);
+            __m128i exponent = _mm_and_si128(bits, shiftedExponent);
+            bits             = _mm_add_epi32(bits, _mm_set1_epi32((127 - 15) << 23));
+
+            __m128i infinityOrNan = _mm_cmpeq_epi32(exponent, shiftedExponent);
+            bits                  = _mm_add_epi32(bits, _mm_and_si128(infinityOrNan, _mm_set1_epi32((128 - 16) << 23)));
+
+            __m128i denormal       = _mm_cmpeq_epi32(exponent, _mm_setzero_si128());
+            __m128  renormalized   = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(1 << 23))), _mm_castsi128_ps(_mm_set1_epi32(113 << 23)));
+            bits                   = Select(denormal, _mm_castps_si128(renormalized), bits);
+            return _mm_castsi128_ps(_mm_or_si128(bits, _mm_slli_epi32(_mm_and_si128(value, _mm_set1_epi32(0x8000)), 16)));
+        }
+#endif
+#endif
+    }  // namespace
+
+    // Scalar reference implementations
+
+    void PixelOps::Scalar::ExpandRgbToRgba(const uint8_t* rgb, uint8_t* rgba, size_t pixelCount, uint8_t alpha)
+    {
+        for(size_t i = 0; i < pixelCount; i++)
+        {
+            rgba[i * 4]     = rgb[i * 3];
+            rgba[i * 4 + 1] = rgb[i * 3 + 1];
+            rgba[i * 4 + 2] = rgb[i * 3 + 2];
+            rgba[i * 4 + 3] = alpha;
+        }
+    }
+
+    void PixelOps::Scalar::Swizzle(const uint8_t* src, uint8_t* dst, size_t pixelCount, const uint8_t (&order)[4])
+    {
+        AssertSwizzleOrder(order);
+        for(size_t i = 0; i < pixelCount; i++)
+        {
+            uint8_t pixel[4];
+            memcpy(pixel, src + i * 4, 4);
+            for(uint32_t c = 0; c < 4; c++)
+            {
+                dst[i * 4 + c] = pixel[order[c]];
+            }
+        }
+    }
+
+    void PixelOps::Scalar::Unorm8ToUnorm16(const uint8_t* src, uint16_t* dst, size_t count)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            dst[i] = (uint16_t)(src[i] * 257);
+        }
+    }
+
+    void PixelOps::Scalar::Unorm16ToUnorm8(const uint16_t* src, uint8_t* dst, size_t count)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            // round(v / 257)
+            dst[i] = (uint8_t)((src[i] * 255u + 32895u) >> 16);
+        }
+    }
+
+    void PixelOps::Scalar::Unorm8ToFloat(const uint8_t* src, float* dst, size_t count)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            dst[i] = src[i] / 255.f;
+        }
+    }
+
+    void PixelOps::Scalar::FloatToUnorm8(const float* src, uint8_t* dst, size_t count)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            dst[i] = (uint8_t)(ClampUnorm(src[i]) * 255.f + 0.5f);
+        }
+    }
+
+    void PixelOps::Scalar::Unorm16ToFloat(const uint16_t* src, float* dst, size_t count)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            dst[i] = src[i] / 65535.f;
+        }
+    }
+
+    void PixelOps::Scalar::FloatToUnorm16(const float* src, uint16_t* dst, size_t count)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            dst[i] = (uint16_t)(ClampUnorm(src[i]) * 65535.f + 0.5f);
+        }
+    }
+
+    void PixelOps::Scalar::FloatToHalf(const float* src, uint16_t* dst, size_t count)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            dst[i] = FloatToHalfScalar(src[i]);
+        }
+    }
+
+    void PixelOps::Scalar::HalfToFloat(const uint16_t* src, float* dst, size_t count)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            dst[i] = HalfToFloatScalar(src[i]);
+        }
+    }
+
+    void PixelOps::Scalar::SrgbToLinear(const uint8_t* src, float* dst, size_t count)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            dst[i] = (float)DecodeSrgb(src[i] / 255.0);
+        }
+    }
+
+    void PixelOps::Scalar::LinearToSrgb(const float* src, uint8_t* dst, size_t count)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            dst[i] = EncodeSrgbExact(src[i]);
+        }
+    }
+
+    void PixelOps::Scalar::SrgbToLinearRgba(const uint8_t* src, float* dst, size_t pixelCount)
+    {
+        for(size_t i = 0; i < pixelCount; i++)
+        {
+            SrgbToLinear(src + i * 4, dst + i * 4, 3);
+            dst[i * 4 + 3] = src[i * 4 + 3] / 255.f;
+        }
+    }
+
+    void PixelOps::Scalar::LinearToSrgbRgba(const float* src, uint8_t* dst, size_t pixelCount)
+    {
+        for(size_t i = 0; i < pixelCount; i++)
+        {
+            LinearToSrgb(src + i * 4, dst + i * 4, 3);
+            FloatToUnorm8(src + i * 4 + 3, dst + i * 4 + 3, 1);
+        }
+    }
+
+    void PixelOps::Scalar::PremultiplyAlpha(float* rgba, size_t pixelCount)
+    {
+        for(size_t i = 0; i < pixelCount; i++)
+        {
+            float* pixel = rgba + i * 4;
+            pixel[0] *= pixel[3];
+            pixel[1] *= pixel[3];
+            pixel[2] *= pixel[3];
+        }
+    }
+
+    void PixelOps::Scalar::PremultiplyAlpha(uint8_t* rgba, size_t pixelCount)
+    {
+        for(size_t i = 0; i < pixelCount; i++)
+        {
+            uint8_t* pixel = rgba + i * 4;
+            for(uint32_t c = 0; c < 3; c++)
+            {
+                // round(c * a / 255)
+                uint32_t product = pixel[c] * pixel[3] + 128u;
+                pixel[c]         = (uint8_t)((product + (product >> 8)) >> 8);
+            }
+        }
+    }
+
+    void PixelOps::Scalar::PremultiplyAlphaSrgb(uint8_t* rgba, size_t pixelCount)
+    {
+        for(size_t i = 0; i < pixelCount; i++)
+        {
+            uint8_t* pixel = rgba + i * 4;
+            float    alpha = pixel[3] / 255.f;
+            for(uint32_t c = 0; c < 3; c++)
+            {
+                pixel[c] = EncodeSrgbExact((float)DecodeSrgb(pixel[c] / 255.0) * alpha);
+            }
+        }
+    }
+
+    void PixelOps::Scalar::DownsampleBox(const uint8_t* src, uint32_t width, uint32_t height, uint8_t* dst)
+    {
+        uint32_t outWidth  = std::max(width / 2, 1u);
+        uint32_t outHeight = std::max(height / 2, 1u);
+        for(uint32_t y = 0; y < outHeight; y++)
+        {
+            const uint8_t* rows[2] = {src + (size_t)std::min(y * 2, height - 1) * width * 4, src + (size_t)std::min(y * 2 + 1, height - 1) * width * 4};
+            for(uint32_t x = 0; x < outWidth; x++)
+            {
+                BoxPixel(rows, x, width, dst + ((size_t)y * outWidth + x) * 4);
+            }
+        }
+    }
+
+    void PixelOps::Scalar::Downsample(const float* src, uint32_t width, uint32_t height, EMipFilter filter, float* dst)
+    {
+        DownsampleSeparable<false>(src, width, height, filter, dst);
+    }
+
+    void PixelOps::Scalar::DownsampleSrgb(const uint8_t* src, uint32_t width, uint32_t height, EMipFilter filter, uint8_t* dst)
+    {
+        std::vector<float> linear((size_t)width * height * 4);
+        std::vector<float> filtered((size_t)std::max(width / 2, 1u) * std::max(height / 2, 1u) * 4);
+        SrgbToLinearRgba(src, linear.data(), (size_t)width * height);
+        Downsample(linear.data(), width, height, filter, filtered.data());
+        LinearToSrgbRgba(filtered.data(), dst, filtered.size() / 4);
+    }
+
+    // Vectorized implementations. Each processes whole vectors and leaves the remainder to the scalar implementation.
+
+    void PixelOps::ExpandRgbToRgba(const uint8_t* rgb, uint8_t* rgba, size_t pixelCount, uint8_t alpha)
+    {
+        size_t i = 0;
+#if defined(HSK_PIXELOPS_SSSE3)
+        // 16 bytes are read per 4 pixels, so the loop stops 2 pixels early
+        const __m128i shuffle   = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m128i alphaMask = _mm_set1_epi32((int32_t)((uint32_t)alpha << 24));
+        for(; i + 6 <= pixelCount; i += 4)
+        {
+            __m128i pixels = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + i * 3)), shuffle);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4), _mm_or_si128(pixels, alphaMask));
+        }
+#elif defined(HSK_PIXELOPS_SSE2)
+        // 4 bytes are read per pixel, so the loop stops a pixel early
+        const __m128i rgbMask   = _mm_set1_epi32(0x00ffffff);
+        const __m128i alphaMask = _mm_set1_epi32((int32_t)((uint32_t)alpha << 24));
+        for(; i + 5 <= pixelCount; i += 4)
+        {
+            uint32_t pixels[4];
+            for(uint32_t j = 0; j < 4; j++)
+            {
+                memcpy(&pixels[j], rgb + (i + j) * 3, 4);
+            }
+            __m128i vector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4), _mm_or_si128(_mm_and_si128(vector, rgbMask), alphaMask));
+        }
+#elif defined(HSK_PIXELOPS_NEON)
+        for(; i + 16 <= pixelCount; i += 16)
+        {
+            uint8x16x3_t source = vld3q_u8(rgb + i * 3);
+            uint8x16x4_t result = {{source.val[0], source.val[1], source.val[2], vdupq_n_u8(alpha)}};
+            vst4q_u8(rgba + i * 4, result);
+        }
+#endif
+        Scalar::ExpandRgbToRgba(rgb + i * 3, rgba + i * 4, pixelCount - i, alpha);
+    }
+
+    void PixelOps::Swizzle(const uint8_t* src, uint8_t* dst, size_t pixelCount, const uint8_t (&order)[4])
+    {
+        AssertSwizzleOrder(order);
+        size_t i = 0;
+#if defined(HSK_PIXELOPS_SSSE3)
+        alignas(16) int8_t shuffleBytes[16];
+        for(uint32_t j = 0; j < 16; j++)
+        {
+            shuffleBytes[j] = (int8_t)((j & ~3u) + order[j & 3]);
+        }
+        const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(shuffleBytes));
+        for(; i + 4 <= pixelCount; i += 4)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_shuffle_epi8(pixels, shuffle));
+        }
+#elif defined(HSK_PIXELOPS_SSE2)
+        // Moves every channel to its destination byte with variable shifts
+        __m128i shiftsIn[4];
+        __m128i shiftsOut[4];
+        for(uint32_t c = 0; c < 4; c++)
+        {
+            shiftsIn[c]  = _mm_cvtsi32_si128(order[c] * 8);
+            shiftsOut[c] = _mm_cvtsi32_si128(c * 8);
+        }
+        const __m128i byteMask = _mm_set1_epi32(0xff);
+        for(; i + 4 <= pixelCount; i += 4)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+            __m128i result = _mm_setzero_si128();
+            for(uint32_t c = 0; c < 4; c++)
+            {
+                result = _mm_or_si128(result, _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(pixels, shiftsIn[c]), byteMask), shiftsOut[c]));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), result);
+        }
+#elif defined(HSK_PIXELOPS_NEON)
+        for(; i + 16 <= pixelCount; i += 16)
+        {
+            uint8x16x4_t source = vld4q_u8(src + i * 4);
+            uint8x16x4_t result = {{source.val[order[0]], source.val[order[1]], source.val[order[2]], source.val[order[3]]}};
+            vst4q_u8(dst + i * 4, result);
+        }
+#endif
+        Scalar::Swizzle(src + i * 4, dst + i * 4, pixelCount - i, order);
+    }
+
+    void PixelOps::Unorm8ToUnorm16(const uint8_t* src, uint16_t* dst, size_t count)
+    {
+        size_t i = 0;
+#if defined(HSK_PIXELOPS_SSE2)
+        for(; i + 16 <= count; i += 16)
+        {
+            // Interleaving a byte with itself multiplies by 257
+            __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(values, values));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(values, values));
+        }
+#elif defined(HSK_PIXELOPS_NEON)
+        for(; i + 16 <= count; i += 16)
+        {
+            uint8x16_t   values = vld1q_u8(src + i);
+            uint8x16x2_t zipped = vzipq_u8(values, values);
+            vst1q_u16(dst + i, vreinterpretq_u16_u8(zipped.val[0]));
+            vst1q_u16(dst + i + 8, vreinterpretq_u16_u8(zipped.val[1]));
+        }
+#endif
+        Scalar::Unorm8ToUnorm16(src + i, dst + i, count - i);
+    }
+
+    void PixelOps::Unorm16ToUnorm8(const uint16_t* src, uint8_t* dst, size_t count)
+    {
+        size_t i = 0;
+#if defined(HSK_PIXELOPS_SSE2)
+        const __m128i bias = _mm_set1_epi32(32895);
+        auto          lNarrow = [&](__m128i values) {
+            // (v * 255 + 32895) >> 16, v * 255 computed as (v << 8) - v
+            __m128i low  = _mm_unpacklo_epi16(values, _mm_setzero_si128());
+            __m128i high = _mm_unpackhi_epi16(values, _mm_setzero_si128());
+            low          = _mm_srli_epi32(_mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(low, 8), low), bias), 16);
+            high         = _mm_srli_epi32(_mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(high, 8), high), bias), 16);
+            return _mm_packs_epi32(low, high);
+        };
+        for(; i + 16 <= count; i += 16)
+        {
+            __m128i first  = lNarrow(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+            __m128i second = lNarrow(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(first, second));
+        }
+#elif defined(HSK_PIXELOPS_NEON)
+        const uint32x4_t bias = vdupq_n_u32(32895);
+        for(; i + 8 <= count; i += 8)
+        {
+            uint16x8_t values = vld1q_u16(src + i);
+            uint16x4_t low    = vshrn_n_u32(vaddq_u32(vmulq_n_u32(vmovl_u16(vget_low_u16(values)), 255), bias), 16);
+            uint16x4_t high   = vshrn_n_u32(vaddq_u32(vmulq_n_u32(vmovl_u16(vget_high_u16(values)), 255), bias), 16);
+            vst1_u8(dst + i, vmovn_u16(vcombine_u16(low, high)));
+        }
+#endif
+        Scalar::Unorm16ToUnorm8(src + i, dst + i, count - i);
+    }
+
+    void PixelOps::Unorm8ToFloat(const uint8_t* src, float* dst, size_t count)
+    {
+        size_t i = 0;
+#if defined(HSK_PIXELOPS_SSE2)
+        const __m128 divisor = _mm_set1_ps(255.f);
+        for(; i + 16 <= count; i += 16)
+        {
+            __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i words[2] = {_mm_unpacklo_epi8(values, _mm_setzero_si128()), _mm_unpackhi_epi8(values, _mm_setzero_si128())};
+            for(uint32_t j = 0; j < 2; j++)
+            {
+                _mm_storeu_ps(dst + i + j * 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(words[j], _mm_setzero_si128())), divisor));
+                _mm_storeu_ps(dst + i + j * 8 + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(words[j], _mm_setzero_si128())), divisor));
+            }
+        }
+#elif defined(HSK_PIXELOPS_NEON)
+        const float32x4_t divisor = vdupq_n_f32(255.f);
+        for(; i + 8 <= count; i += 8)
+        {
+            uint16x8_t words = vmovl_u8(vld1_u8(src + i));
+            vst1q_f32(dst + i, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(words))), divisor));
+            vst1q_f32(dst + i + 4, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(words))), divisor));
+        }
+#endif
+        Scalar::Unorm8ToFloat(src + i, dst + i, count - i);
+    }
+
+    void PixelOps::FloatToUnorm8(const float* src, uint8_t* dst, size_t count)
+    {
+        size_t i = 0;
+#if defined(HSK_PIXELOPS_SSE2)
+        for(; i + 16 <= count; i += 16)
+        {
+            __m128i values[4];
+            for(uint32_t j = 0; j < 4; j++)
+            {
+                values[j] = FloatToUnormSse(_mm_loadu_ps(src + i + j * 4), 255.f);
+            }
+            __m128i words = _mm_packs_epi32(values[0], values[1]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(words, _mm_packs_epi32(values[2], values[3])));
+        }
+#elif defined(HSK_PIXELOPS_NEON)
+        const float32x4_t one  = vdupq_n_f32(1.f);
+        const float32x4_t half = vdupq_n_f32(0.5f);
+        for(; i + 8 <= count; i += 8)
+        {
+            // vmaxnm maps NaN to the other operand (0)
+            float32x4_t low  = vminq_f32(vmaxnmq_f32(vld1q_f32(src + i), vdupq_n_f32(0.f)), one);
+            float32x4_t high = vminq_f32(vmaxnmq_f32(vld1q_f32(src + i + 4), vdupq_n_f32(0.f)), one);
+            uint32x4_t  lowInt  = vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(low, 255.f), half));
+            uint32x4_t  highInt = vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(high, 255.f), half));
+            vst1_u8(dst + i, vmovn_u16(vcombine_u16(vmovn_u32(lowInt), vmovn_u32(highInt))));
+        }
+#endif
+        Scalar::FloatToUnorm8(src + i, dst + i, count - i);
+    }
+
+    void PixelOps::Unorm16ToFloat(const uint16_t* src, float* dst, size_t count)
+    {
+        size_t i = 0;
+#if defined(HSK_PIXELOPS_SSE2)
+        const __m128 divisor = _mm_set1_ps(65535.f);
+        for(; i + 8 <= count; i += 8)
+        {
+            __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_ps(dst + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(values, _mm_setzero_si128())), divisor));
+            _mm_storeu_ps(dst + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(values, _mm_setzero_si128())), divisor));
+        }
+#elif defined(HSK_PIXELOPS_NEON)
+        const float32x4_t divisor = vdupq_n_f32(65535.f);
+        for(; i + 8 <= count; i += 8)
+        {
+            uint16x8_t values = vld1q_u16(src + i);
+            vst1q_f32(dst + i, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(values))), divisor));
+            vst1q_f32(dst + i + 4, vdivq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(values))), divisor));
+        }
+#endif
+        Scalar::Unorm16ToFloat(src + i, dst + i, count - i);
+    }
+
+    void PixelOps::FloatToUnorm16(const float* src, uint16_t* dst, size_t count)
+    {
+        size_t i = 0;
+#if defined(HSK_PIXELOPS_SSE2)
+        for(; i + 8 <= count; i += 8)
+        {
+            __m128i low  = FloatToUnormSse(_mm_loadu_ps(src + i), 65535.f);
+            __m128i high = FloatToUnormSse(_mm_loadu_ps(src + i + 4), 65535.f);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), PackLow16(low, high));
+        }
+#elif defined(HSK_PIXELOPS_NEON)
+        const float32x4_t one  = vdupq_n_f32(1.f);
+        const float32x4_t half = vdupq_n_f32(0.5f);
+        for(; i + 8 <= count; i += 8)
+        {
+            float32x4_t low  = vminq_f32(vmaxnmq_f32(vld1q_f32(src + i), vdupq_n_f32(0.f)), one);
+            float32x4_t high = vminq_f32(vmaxnmq_f32(vld1q_f32(src + i + 4), vdupq_n_f32(0.f)), one);
+            uint32x4_t  lowInt  = vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(low, 65535.f), half));
+            uint32x4_t  highInt = vcvtq_u32_f32(vaddq_f32(vmulq_n_f32(high, 65535.f), half));
+            vst1q_u16(dst + i, vcombine_u16(vmovn_u32(lowInt), vmovn_u32(highInt)));
+        }
+#endif
+        Scalar::FloatToUnorm16(src + i, dst + i, count - i);
+    }
+
+    void PixelOps::FloatToHalf(const float* src, uint16_t* dst, size_t count)
+    {
+        size_t i = 0;
+#if defined(HSK_PIXELOPS_F16C)
+        for(; i + 8 <= count; i += 8)
+        {
+            __m128i low  = _mm_cvtps_ph(_mm_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            __m128i high = _mm_cvtps_ph(_mm_loadu_ps(src + i + 4), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi64(low, high));
+        }
+#elif defined(HSK_PIXELOPS_SSE2)
+        for(; i + 8 <= count; i += 8)
+        {
+            __m128i low  = FloatToHalfSse(_mm_loadu_ps(src + i));
+            __m128i high = FloatToHalfSse(_mm_loadu_ps(src + i + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), PackLow16(low, high));
+        }
+#elif defined(HSK_PIXELOPS_NEON)
+        for(; i + 4 <= count; i += 4)
+        {
+            vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+        }
+#endif
+        Scalar::FloatToHalf(src + i, dst + i, count - i);
+    }
+
+    void PixelOps::HalfToFloat(const uint16_t* src, float* dst, size_t count)
+    {
+        size_t i = 0;
+#if defined(HSK_PIXELOPS_F16C)
+        for(; i + 4 <= count; i += 4)
+        {
+            _mm_storeu_ps(dst + i, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i))));
+        }
+#elif defined(HSK_PIXELOPS_SSE2)
+        for(; i + 8 <= count; i += 8)
+        {
+            __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_ps(dst + i, HalfToFloatSse(_mm_unpacklo_epi16(values, _mm_setzero_si128())));
+            _mm_storeu_ps(dst + i + 4, HalfToFloatSse(_mm_unpackhi_epi16(values, _mm_setzero_si128())));
+        }
+#elif defined(HSK_PIXELOPS_NEON)
+        for(; i + 4 <= count; i += 4)
+        {
+            vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i))));
+        }
+#endif
+        Scalar::HalfToFloat(src + i, dst + i, count - i);
+    }
+
+    void PixelOps::SrgbToLinear(const uint8_t* src, float* dst, size_t count)
+    {
+        const std::array<float, 256>& table = GetSrgbToLinearTable();
+        for(size_t i = 0; i < count; i++)
+        {
+            dst[i] = table[src[i]];
+        }
+    }
+
+    void PixelOps::LinearToSrgb(const float* src, uint8_t* dst, size_t count)
+    {
+        const SrgbEncodeTable& table = GetSrgbEncodeTable();
+        for(size_t i = 0; i < count; i++)
+        {
+            dst[i] = table.Encode(src[i]);
+        }
+    }
+
+    void PixelOps::SrgbToLinearRgba(const uint8_t* src, float* dst, size_t pixelCount)
+    {
+        const std::array<float, 256>& table = GetSrgbToLinearTable();
+        for(size_t i = 0; i < pixelCount; i++)
+        {
+            dst[i * 4]     = table[src[i * 4]];
+            dst[i * 4 + 1] = table[src[i * 4 + 1]];
+            dst[i * 4 + 2] = table[src[i * 4 + 2]];
+            dst[i * 4 + 3] = src[i * 4 + 3] / 255.f;
+        }
+    }
+
+    void PixelOps::LinearToSrgbRgba(const float* src, uint8_t* dst, size_t pixelCount)
+    {
+        const SrgbEncodeTable& table = GetSrgbEncodeTable();
+        for(size_t i = 0; i < pixelCount; i++)
+        {
+            dst[i * 4]     = table.Encode(src[i * 4]);
+            dst[i * 4 + 1] = table.Encode(src[i * 4 + 1]);
+            dst[i * 4 + 2] = table.Encode(src[i * 4 + 2]);
+            dst[i * 4 + 3] = (uint8_t)(ClampUnorm(src[i * 4 + 3]) * 255.f + 0.5f);
+        }
+    }
+
+    void PixelOps::PremultiplyAlpha(float* rgba, size_t pixelCount)
+    {
+        size_t i = 0;
+#if defined(HSK_PIXELOPS_SSE2)
+        const __m128 rgbMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+        for(; i < pixelCount; i++)
+        {
+            __m128 pixel      = _mm_loadu_ps(rgba + i * 4);
+            __m128 multiplied = _mm_mul_ps(pixel, _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(3, 3, 3, 3)));
+            _mm_storeu_ps(rgba + i * 4, _mm_or_ps(_mm_and_ps(rgbMask, multiplied), _mm_andnot_ps(rgbMask, pixel)));
+        }
+#elif defined(HSK_PIXELOPS_NEON)
+        for(; i < pixelCount; i++)
+        {
+            float32x4_t pixel      = vld1q_f32(rgba + i * 4);
+            float32x4_t multiplied = vmulq_laneq_f32(pixel, pixel, 3);
+            vst1q_f32(rgba + i * 4, vsetq_lane_f32(vgetq_lane_f32(pixel, 3), multiplied, 3));
+        }
+#endif
+        Scalar::PremultiplyAlpha(rgba + i * 4, pixelCount - i);
+    }
+
+    void PixelOps::PremultiplyAlpha(uint8_t* rgba, size_t pixelCount)
+    {
+        size_t i = 0;
+#if defined(HSK_PIXELOPS_SSE2)
+        // 16 bit lanes: The alpha lane is multiplied by 255, which rounds back to alpha
+        const __m128i rgbMask   = _mm_setr_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+        const __m128i alpha255  = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+        const __m128i rounding  = _mm_set1_epi16(128);
+        auto          lMultiply = [&](__m128i pixels) {
+            __m128i alpha   = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            alpha           = _mm_or_si128(_mm_and_si128(alpha, rgbMask), alpha255);
+            __m128i product = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha), rounding);
+            return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+        };
+        for(; i + 4 <= pixelCount; i += 4)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + i * 4));
+            __m128i low    = lMultiply(_mm_unpacklo_epi8(pixels, _mm_setzero_si128()));
+            __m128i high   = lMultiply(_mm_unpackhi_epi8(pixels, _mm_setzero_si128()));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4), _mm_packus_epi16(low, high));
+        }
+#elif defined(HSK_PIXELOPS_NEON)
+        for(; i + 8 <= pixelCount; i += 8)
+        {
+            uint8x8x4_t pixels = vld4_u8(rgba + i * 4);
+            for(uint32_t c = 0; c < 3; c++)
+            {
+                uint16x8_t product = vaddq_u16(vmull_u8(pixels.val[c], pixels.val[3]), vdupq_n_u16(128));
+                pixels.val[c]      = vshrn_n_u16(vaddq_u16(product, vshrq_n_u16(product, 8)), 8);
+            }
+            vst4_u8(rgba + i * 4, pixels);
+        }
+#endif
+        Scalar::PremultiplyAlpha(rgba + i * 4, pixelCount - i);
+    }
+
+    void PixelOps::PremultiplyAlphaSrgb(uint8_t* rgba, size_t pixelCount)
+    {
+        const std::array<float, 256>& toLinear = GetSrgbToLinearTable();
+        const SrgbEncodeTable&        toSrgb   = GetSrgbEncodeTable();
+        for(size_t i = 0; i < pixelCount; i++)
+        {
+            uint8_t* pixel = rgba + i * 4;
+            float    alpha = pixel[3] / 255.f;
+            for(uint32_t c = 0; c < 3; c++)
+            {
+                pixel[c] = toSrgb.Encode(toLinear[pixel[c]] * alpha);
+            }
+        }
+    }
+
+    void PixelOps::DownsampleBox(const uint8_t* src, uint32_t width, uint32_t height, uint8_t* dst)
+    {
+        uint32_t outWidth  = std::max(width / 2, 1u);
+        uint32_t outHeight = std::max(height / 2, 1u);
+        for(uint32_t y = 0; y < outHeight; y++)
+        {
+            const uint8_t* rows[2] = {src + (size_t)std::min(y * 2, height - 1) * width * 4, src + (size_t)std::min(y * 2 + 1, height - 1) * width * 4};
+            uint8_t*       target  = dst + (size_t)y * outWidth * 4;
+            uint32_t       x       = 0;
+            // Two output pixels from 4 source pixels of both rows, as long as no column needs clamping
+#if defined(HSK_PIXELOPS_SSE2)
+            const __m128i rounding = _mm_set1_epi16(2);
+            for(; x * 2 + 4 <= width && x + 2 <= outWidth; x += 2)
+            {
+                __m128i top    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[0] + x * 8));
+                __m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[1] + x * 8));
+                // Vertical sums of pixel pairs 0, 1 (low) and 2, 3 (high)
+                __m128i low  = _mm_add_epi16(_mm_unpacklo_epi8(top, _mm_setzero_si128()), _mm_unpacklo_epi8(bottom, _mm_setzero_si128()));
+                __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(top, _mm_setzero_si128()), _mm_unpackhi_epi8(bottom, _mm_setzero_si128()));
+                __m128i sum  = _mm_add_epi16(_mm_unpacklo_epi64(low, high), _mm_unpackhi_epi64(low, high));
+                __m128i mean = _mm_srli_epi16(_mm_add_epi16(sum, rounding), 2);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(target + x * 4), _mm_packus_epi16(mean, mean));
+            }
+#elif defined(HSK_PIXELOPS_NEON)
+            for(; x * 2 + 4 <= width && x + 2 <= outWidth; x += 2)
+            {
+                uint16x8_t low  = vaddl_u8(vld1_u8(rows[0] + x * 8), vld1_u8(rows[1] + x * 8));
+                uint16x8_t high = vaddl_u8(vld1_u8(rows[0] + x * 8 + 8), vld1_u8(rows[1] + x * 8 + 8));
+                uint16x8_t sum  = vcombine_u16(vadd_u16(vget_low_u16(low), vget_high_u16(low)), vadd_u16(vget_low_u16(high), vget_high_u16(high)));
+                vst1_u8(target + x * 4, vrshrn_n_u16(sum, 2));
+            }
+#endif
+            for(; x < outWidth; x++)
+            {
+                BoxPixel(rows, x, width, target + x * 4);
+            }
+        }
+    }
+
+    void PixelOps::Downsample(const float* src, uint32_t width, uint32_t height, EMipFilter filter, float* dst)
+    {
+        DownsampleSeparable<true>(src, width, height, filter, dst);
+    }
+
+    void PixelOps::DownsampleSrgb(const uint8_t* src, uint32_t width, uint32_t height, EMipFilter filter, uint8_t* dst)
+    {
+        std::vector<float> linear((size_t)width * height * 4);
+        std::vector<float> filtered((size_t)std::max(width / 2, 1u) * std::max(height / 2, 1u) * 4);
+        SrgbToLinearRgba(src, linear.data(), (size_t)width * height);
+        Downsample(linear.data(), width, height, filter, filtered.data());
+        LinearToSrgbRgba(filtered.data(), dst, filtered.size() / 4);
+    }
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace hsk {
+
+    /// @brief Reconstruction filter used for generating mip levels
+    enum class EMipFilter
+    {
+        /// @brief 2x2 average. Cheapest, but blurs and aliases more than Kaiser.
+        Box,
+        /// @brief Kaiser windowed sinc (alpha = 4, radius of two output pixels). Sharper mips with less aliasing, about four times the cost of Box.
+        Kaiser
+    };
+
+    /// @brief Pixel format conversion, premultiplication and mip filtering kernels for CPU side texture preparation
+    /// @remark Kernels run on SSE2 (SSSE3 / F16C where the compiler targets them) or NEON, with the scalar implementations of PixelOps::Scalar as fallback.
+    /// Results match the scalar implementations exactly, except where the compiler fuses multiply-add sequences differently (float results and rounding ties on e.g. NEON).
+    /// All images are tightly packed. 4 channel images are RGBA, sRGB variants encode RGB only (alpha is linear). src and dst may be identical for conversions between
+    /// elements of equal size, no other overlap is allowed.
+    class PixelOps
+    {
+      public:
+        /// @brief Scalar reference implementations of all kernels, e.g. for validating the vectorized versions
+        struct Scalar
+        {
+            static void ExpandRgbToRgba(const uint8_t* rgb, uint8_t* rgba, size_t pixelCount, uint8_t alpha = 255);
+            static void Swizzle(const uint8_t* src, uint8_t* dst, size_t pixelCount, const uint8_t (&order)[4]);
+
+            static void Unorm8ToUnorm16(const uint8_t* src, uint16_t* dst, size_t count);
+            static void Unorm16ToUnorm8(const uint16_t* src, uint8_t* dst, size_t count);
+            static void Unorm8ToFloat(const uint8_t* src, float* dst, size_t count);
+            static void FloatToUnorm8(const float* src, uint8_t* dst, size_t count);
+            static void Unorm16ToFloat(const uint16_t* src, float* dst, size_t count);
+            static void FloatToUnorm16(const float* src, uint16_t* dst, size_t count);
+            static void FloatToHalf(const float* src, uint16_t* dst, size_t count);
+            static void HalfToFloat(const uint16_t* src, float* dst, size_t count);
+
+            static void SrgbToLinear(const uint8_t* src, float* dst, size_t count);
+            static void LinearToSrgb(const float* src, uint8_t* dst, size_t count);
+            static void SrgbToLinearRgba(const uint8_t* src, float* dst, size_t pixelCount);
+            static void LinearToSrgbRgba(const float* src, uint8_t* dst, size_t pixelCount);
+
+            static void PremultiplyAlpha(float* rgba, size_t pixelCount);
+            static void PremultiplyAlpha(uint8_t* rgba, size_t pixelCount);
+            static void PremultiplyAlphaSrgb(uint8_t* rgba, size_t pixelCount);
+
+            static void DownsampleBox(const uint8_t* src, uint32_t width, uint32_t height, uint8_t* dst);
+            static void Downsample(const float* src, uint32_t width, uint32_t height, EMipFilter filter, float* dst);
+            static void DownsampleSrgb(const uint8_t* src, uint32_t width, uint32_t height, EMipFilter filter, uint8_t* dst);
+        };
+
+        /// @brief Appends alpha to every pixel of an RGB8 image
+        static void ExpandRgbToRgba(const uint8_t* rgb, uint8_t* rgba, size_t pixelCount, uint8_t alpha = 255);
+        /// @brief Reorders the channels of an RGBA8 image: dst channel c is src channel order[c] (e.g. {2, 1, 0, 3} for BGRA <-> RGBA)
+        static void Swizzle(const uint8_t* src, uint8_t* dst, size_t pixelCount, const uint8_t (&order)[4]);
+
+        /// @brief Widens unorm values exactly (v * 257)
+        static void Unorm8ToUnorm16(const uint8_t* src, uint16_t* dst, size_t count);
+        /// @brief Narrows unorm values, rounding to nearest
+        static void Unorm16ToUnorm8(const uint16_t* src, uint8_t* dst, size_t count);
+        static void Unorm8ToFloat(const uint8_t* src, float* dst, size_t count);
+        /// @brief Clamps to [0, 1] (NaN to 0) and rounds to nearest
+        static void FloatToUnorm8(const float* src, uint8_t* dst, size_t count);
+        static void Unorm16ToFloat(const uint16_t* src, float* dst, size_t count);
+        /// @copydoc FloatToUnorm8
+        static void FloatToUnorm16(const float* src, uint16_t* dst, size_t count);
+        /// @brief Converts to IEEE half floats, rounding to nearest even. Values out of range become infinity, NaN payloads are not preserved.
+        static void FloatToHalf(const float* src, uint16_t* dst, size_t count);
+        /// @brief Converts IEEE half floats exactly (including denormals, infinities and NaN)
+        static void HalfToFloat(const uint16_t* src, float* dst, size_t count);
+
+        /// @brief Decodes sRGB encoded values to linear
+        static void SrgbToLinear(const uint8_t* src, float* dst, size_t count);
+        /// @brief Encodes linear values to sRGB, rounding to nearest. Clamps to [0, 1] (NaN to 0).
+        /// @remark Table based, results are identical to the exact (double precision) encoding of PixelOps::Scalar
+        static void LinearToSrgb(const float* src, uint8_t* dst, size_t count);
+        /// @brief SrgbToLinear() for RGBA pixels, alpha is converted linearly
+        static void SrgbToLinearRgba(const uint8_t* src, float* dst, size_t pixelCount);
+        /// @brief LinearToSrgb() for RGBA pixels, alpha is converted linearly
+        static void LinearToSrgbRgba(const float* src, uint8_t* dst, size_t pixelCount);
+
+        /// @brief Multiplies RGB by alpha
+        static void PremultiplyAlpha(float* rgba, size_t pixelCount);
+        /// @brief Multiplies RGB by alpha, rounding to nearest
+        static void PremultiplyAlpha(uint8_t* rgba, size_t pixelCount);
+        /// @brief Multiplies RGB by alpha in linear space, for sRGB encoded colors
+        static void PremultiplyAlphaSrgb(uint8_t* rgba, size_t pixelCount);
+
+        /// @brief Halves an RGBA8 image of linear values with a 2x2 box filter, rounding to nearest. Odd sizes (and sizes of 1) clamp to the last row / column.
+        /// @param dst Receives max(width / 2, 1) x max(height / 2, 1) pixels
+        static void DownsampleBox(const uint8_t* src, uint32_t width, uint32_t height, uint8_t* dst);
+        /// @brief Halves a linear float RGBA image. Samples outside the image clamp to the edge.
+        /// @param dst Receives max(width / 2, 1) x max(height / 2, 1) pixels
+        static void Downsample(const float* src, uint32_t width, uint32_t height, EMipFilter filter, float* dst);
+        /// @brief Halves an sRGB encoded RGBA8 image, filtering in linear space
+        /// @param dst Receives max(width / 2, 1) x max(height / 2, 1) pixels
+        static void DownsampleSrgb(const uint8_t* src, uint32_t width, uint32_t height, EMipFilter filter, uint8_t* dst);
+    };
+}  // namespace hsk
\ No newline at end of file
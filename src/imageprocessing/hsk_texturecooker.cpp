@@ -0,0 +1,207 @@
+#include "hsk_texturecooker.hpp"
+#include "../base/hsk_logger.hpp"
+#include "../hsk_exception.hpp"
+#include "../utility/hsk_hash.hpp"
+#include "hsk_bcencoder.hpp"
+#include "hsk_ktx2.hpp"
+#include "hsk_pixelops.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <spdlog/fmt/fmt.h>
+#include <thread>
+
+namespace hsk {
+    TextureCooker::TextureCooker(std::filesystem::path cacheDirectory) : mCacheDirectory(std::move(cacheDirectory)) {}
+
+    uint64_t TextureCooker::ComputeKey(const uint8_t* encoded, size_t size, VkFormat format, ETextureUsage usage)
+    {
+        uint32_t settings[3] = {VERSION, (uint32_t)format, (uint32_t)usage};
+        return HashBytes(encoded, size, HashBytes(settings, sizeof(settings)));
+    }
+
+    VkDeviceSize TextureCooker::ComputeLevels(VkFormat format, uint32_t width, uint32_t height, std::vector<VkBufferImageCopy>& outlevels)
+    {
+        FormatBlockInfo blockInfo = GetFormatBlockInfo(format);
+        HSK_ASSERTFMT(blockInfo.BlockSize, "Texture cooker: Format {} not supported!", (uint32_t)format)
+
+        outlevels.clear();
+        VkDeviceSize offset = 0;
+        for(uint32_t level = 0;; level++)
+        {
+            uint32_t levelWidth  = std::max(width >> level, 1u);
+            uint32_t levelHeight = std::max(height >> level, 1u);
+            outlevels.push_back(VkBufferImageCopy{
+                .bufferOffset     = offset,
+                .imageSubresource = VkImageSubresourceLayers{.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = level, .baseArrayLayer = 0, .layerCount = 1},
+                .imageExtent      = VkExtent3D{.width = levelWidth, .height = levelHeight, .depth = 1},
+            });
+            offset += (blockInfo.GetImageSize(levelWidth, levelHeight) + 15) / 16 * 16;
+            if(levelWidth == 1 && levelHeight == 1)
+            {
+                break;
+            }
+        }
+        return offset;
+    }
+
+    void TextureCooker::Downsample(const uint8_t* rgba, uint32_t width, uint32_t height, ETextureUsage usage, uint8_t* out)
+    {
+        switch(usage)
+        {
+            case ETextureUsage::Color:
+                PixelOps::DownsampleSrgb(rgba, width, height, EMipFilter::Box, out);
+                return;
+            case ETextureUsage::Normal:
+                break;
+            default:
+                PixelOps::DownsampleBox(rgba, width, height, out);
+                return;
+        }
+
+        uint32_t outWidth  = std::max(width / 2, 1u);
+        uint32_t outHeight = std::max(height / 2, 1u);
+        for(uint32_t y = 0; y < outHeight; y++)
+        {
+            // Odd sizes (and sizes of 1) clamp to the last row / column
+            const uint8_t* rows[2] = {rgba + (size_t)std::min(y * 2, height - 1) * width * 4, rgba + (size_t)std::min(y * 2 + 1, height - 1) * width * 4};
+            for(uint32_t x = 0; x < outWidth; x++)
+            {
+                const uint8_t* pixels[4] = {rows[0] + std::min(x * 2, width - 1) * 4, rows[0] + std::min(x * 2 + 1, width - 1) * 4,
+                                            rows[1] + std::min(x * 2, width - 1) * 4, rows[1] + std::min(x * 2 + 1, width - 1) * 4};
+                uint8_t*       target    = out + ((size_t)y * outWidth + x) * 4;
+
+                uint32_t alpha     = 0;
+                float    normal[3] = {};
+                for(const uint8_t* pixel : pixels)
+                {
+                    alpha += pixel[3];
+                    for(uint32_t c = 0; c < 3; c++)
+                    {
+                        normal[c] += pixel[c] / 127.5f - 1.f;
+                    }
+                }
+                target[3] = (uint8_t)((alpha + 2) / 4);
+
+                float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+                if(length <= 0.f)
+                {
+                    normal[0] = normal[1] = 0.f;
+                    normal[2]             = length = 1.f;
+                }
+                for(uint32_t c = 0; c < 3; c++)
+                {
+                    target[c] = (uint8_t)std::clamp(std::lround((normal[c] / length * 0.5f + 0.5f) * 255.f), 0l, 255l);
+                }
+            }
+        }
+    }
+
+    void TextureCooker::Cook(const uint8_t* rgba, ETextureUsage usage, VkFormat format, const std::vector<VkBufferImageCopy>& levels, uint8_t* out)
+    {
+        std::vector<uint8_t> current;
+        std::vector<uint8_t> next;
+        const uint8_t*       source = rgba;
+        for(size_t i = 0; i < levels.size(); i++)
+        {
+            const VkExtent3D& extent = levels[i].imageExtent;
+            if(i > 0)
+            {
+                const VkExtent3D& previous = levels[i - 1].imageExtent;
+                next.resize((size_t)extent.width * extent.height * 4);
+                Downsample(source, previous.width, previous.height, usage, next.data());
+                std::swap(current, next);
+                source = current.data();
+            }
+            BcEncoder::EncodeImage(format, source, extent.width, extent.height, out + levels[i].bufferOffset);
+        }
+    }
+
+    std::filesystem::path TextureCooker::GetPath(uint64_t key) const
+    {
+        return mCacheDirectory / fmt::format("{:016x}.ktx2", key);
+    }
+
+    bool TextureCooker::Load(uint64_t key, VkFormat format, const std::vector<VkBufferImageCopy>& levels, uint8_t* out) const
+    {
+        std::ifstream file(GetPath(key), std::ios::binary | std::ios::ate);
+        if(!file)
+        {
+            return false;
+        }
+        std::vector<uint8_t> contents((size_t)file.tellg());
+        file.seekg(0);
+        if(!file.read(reinterpret_cast<char*>(contents.data()), contents.size()))
+        {
+            return false;
+        }
+
+        Ktx2Texture texture;
+        try
+        {
+            texture.Read(contents.data(), contents.size());
+        }
+        catch(const Exception& ex)
+        {
+            logger()->warn("Texture cooker: Ignoring invalid cache entry \"{}\": {}", GetPath(key).string(), ex.what());
+            return false;
+        }
+
+        // Key collisions are practically impossible, but a stale file must not be uploaded with mismatching levels
+        if(texture.GetFormat() != format || texture.GetSupercompression() != Ktx2Texture::ESupercompression::None || texture.GetLevels().size() != levels.size())
+        {
+            return false;
+        }
+        FormatBlockInfo blockInfo = GetFormatBlockInfo(format);
+        for(size_t i = 0; i < levels.size(); i++)
+        {
+            const Ktx2Texture::Level& level = texture.GetLevels()[i];
+            if(level.Width != levels[i].imageExtent.width || level.Height != levels[i].imageExtent.height)
+            {
+                return false;
+            }
+            memcpy(out + levels[i].bufferOffset, texture.GetLevelData((uint32_t)i), blockInfo.GetImageSize(level.Width, level.Height));
+        }
+        return true;
+    }
+
+    void TextureCooker::Store(uint64_t key, VkFormat format, const std::vector<VkBufferImageCopy>& levels, const uint8_t* data) const
+    {
+        FormatBlockInfo                 blockInfo = GetFormatBlockInfo(format);
+        std::vector<Ktx2Texture::Level> ktxLevels;
+        for(const VkBufferImageCopy& level : levels)
+        {
+            ktxLevels.push_back(Ktx2Texture::Level{.Offset = level.bufferOffset,
+                                                   .Size   = blockInfo.GetImageSize(level.imageExtent.width, level.imageExtent.height),
+                                                   .Width  = level.imageExtent.width,
+                                                   .Height = level.imageExtent.height});
+        }
+
+        // Written to a file unique to this thread and renamed, so concurrent loads of the same image never read a partial file
+        std::filesystem::path path      = GetPath(key);
+        std::filesystem::path temporary = path;
+        temporary += fmt::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        std::error_code error;
+        std::filesystem::create_directories(mCacheDirectory, error);
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if(file)
+            {
+                Ktx2Texture::Write(file, format, data, ktxLevels, false);
+            }
+            if(!file)
+            {
+                logger()->warn("Texture cooker: Unable to write cache file \"{}\"", temporary.string());
+                return;
+            }
+        }
+        std::filesystem::rename(temporary, path, error);
+        if(error)
+        {
+            logger()->warn("Texture cooker: Unable to write cache file \"{}\": {}", path.string(), error.message());
+            std::filesystem::remove(temporary, error);
+        }
+    }
+}  // namespace hsk
\ No newline at end of file
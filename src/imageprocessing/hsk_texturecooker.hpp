@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace hsk {
+
+    /// @brief How a texture is sampled. Determines mip filtering and the cooked format.
+    enum class ETextureUsage
+    {
+        /// @brief sRGB encoded color (base color, emissive). Mips are averaged in linear space.
+        Color,
+        /// @brief Linear data (metallic / roughness, occlusion)
+        Data,
+        /// @brief Tangent space normal map. Mips are renormalized, only x and y are kept when cooked to BC5.
+        Normal
+    };
+
+    /// @brief Generates mip chains and block compresses images on the CPU, caching the results as KTX2 files keyed by source content and settings
+    class TextureCooker
+    {
+      public:
+        /// @brief Part of every cache key. Increment whenever the cooked output changes.
+        static const uint32_t VERSION = 3;
+
+        explicit TextureCooker(std::filesystem::path cacheDirectory);
+
+        /// @brief Cache key of an encoded source image (e.g. the PNG file contents) cooked to format for usage
+        static uint64_t ComputeKey(const uint8_t* encoded, size_t size, VkFormat format, ETextureUsage usage);
+
+        /// @brief Lays out the complete mip chain of an image in format, each level aligned to 16 bytes
+        /// @param outlevels Receives one copy region per level, bufferOffset relative to the first level
+        /// @return Total size of all levels
+        static VkDeviceSize ComputeLevels(VkFormat format, uint32_t width, uint32_t height, std::vector<VkBufferImageCopy>& outlevels);
+
+        /// @brief Downsamples an RGBA8 image to half its size (2x2 box filter, in linear space for color textures and renormalized for normal maps)
+        static void Downsample(const uint8_t* rgba, uint32_t width, uint32_t height, ETextureUsage usage, uint8_t* out);
+
+        /// @brief Generates the mip chain of an RGBA8 image and encodes every level to format
+        /// @param levels Layout of out, as computed by ComputeLevels()
+        static void Cook(const uint8_t* rgba, ETextureUsage usage, VkFormat format, const std::vector<VkBufferImageCopy>& levels, uint8_t* out);
+
+        /// @brief Reads a cooked texture from the cache
+        /// @return False if there is no cache entry matching format and levels (out is left in an undefined state)
+        bool Load(uint64_t key, VkFormat format, const std::vector<VkBufferImageCopy>& levels, uint8_t* out) const;
+        /// @brief Writes a cooked texture to the cache. Thread safe. Failures are logged only, the cache is an optimization.
+        void Store(uint64_t key, VkFormat format, const std::vector<VkBufferImageCopy>& levels, const uint8_t* data) const;
+
+        std::filesystem::path GetPath(uint64_t key) const;
+
+        inline const std::filesystem::path& GetCacheDirectory() const { return mCacheDirectory; }
+
+      protected:
+        std::filesystem::path mCacheDirectory;
+    };
+}  // namespace hsk
\ No newline at end of file
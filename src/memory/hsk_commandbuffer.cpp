@@ -1,14 +1,16 @@
 #include "hsk_commandbuffer.hpp"
+#include "hsk_stagingring.hpp"
 #include "../hsk_vkHelpers.hpp"
 
 namespace hsk {
 
-    VkCommandBuffer CommandBuffer::Create(const VkContext* context, VkCommandBufferLevel cmdBufferLvl, bool begin)
+    VkCommandBuffer CommandBuffer::Create(const VkContext* context, VkCommandBufferLevel cmdBufferLvl, bool begin, VkCommandPool commandPool)
     {
-        mContext = context;
+        mContext     = context;
+        mCommandPool = commandPool ? commandPool : context->CommandPool;
         VkCommandBufferAllocateInfo cmdBufAllocateInfo{};
         cmdBufAllocateInfo.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        cmdBufAllocateInfo.commandPool        = context->CommandPool;
+        cmdBufAllocateInfo.commandPool        = mCommandPool;
         cmdBufAllocateInfo.level              = cmdBufferLvl;
         cmdBufAllocateInfo.commandBufferCount = 1;
 
@@ -42,6 +44,12 @@ namespace hsk {
     {
         AssertVkResult(vkEndCommandBuffer(mCommandBuffer));
 
+        // Writes recorded into the staging ring have to execute before this command buffer
+        if(mContext->StagingRing)
+        {
+            mContext->StagingRing->Flush();
+        }
+
         VkSubmitInfo submitInfo{};
         submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
         submitInfo.commandBufferCount = 1;
@@ -77,7 +85,7 @@ namespace hsk {
     {
         if(mCommandBuffer)
         {
-            vkFreeCommandBuffers(mContext->Device, mContext->CommandPool, 1, &mCommandBuffer);
+            vkFreeCommandBuffers(mContext->Device, mCommandPool, 1, &mCommandBuffer);
             mCommandBuffer = nullptr;
         }
         if(mFence)
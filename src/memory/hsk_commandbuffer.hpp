@@ -11,7 +11,11 @@ namespace hsk {
         CommandBuffer() = default;
         inline virtual ~CommandBuffer() { Cleanup(); }
 
-        VkCommandBuffer Create(const VkContext* context, VkCommandBufferLevel cmdBufferLvl = VK_COMMAND_BUFFER_LEVEL_PRIMARY, bool begin = false);
+        /// @param commandPool Pool the command buffer is allocated from. VK_NULL_HANDLE selects the context's CommandPool.
+        VkCommandBuffer Create(const VkContext*     context,
+                               VkCommandBufferLevel cmdBufferLvl = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                               bool                 begin        = false,
+                               VkCommandPool        commandPool  = VK_NULL_HANDLE);
         void            Begin();
         void            Submit(bool fireAndForget = false);
         void            FlushAndReset();
@@ -24,8 +28,10 @@ namespace hsk {
         inline operator const VkCommandBuffer() const { return mCommandBuffer; }
 
         HSK_PROPERTY_CGET(CommandBuffer)
+        HSK_PROPERTY_CGET(Fence)
       protected:
         const VkContext* mContext{};
+        VkCommandPool    mCommandPool{};
         VkCommandBuffer  mCommandBuffer{};
         VkFence          mFence{};
     };
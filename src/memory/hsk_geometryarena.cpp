@@ -0,0 +1,215 @@
+#include "hsk_geometryarena.hpp"
+#include "../hsk_vkHelpers.hpp"
+#include <algorithm>
+#include <spdlog/fmt/fmt.h>
+
+namespace hsk {
+    GeometryArena::GeometryArena(const VkContext* context, size_t vertexStride, VkDeviceSize pageSize)
+        : mContext(context), mVertexStride(vertexStride), mPageSize(pageSize)
+    {
+    }
+
+    GeometryArena::Page& GeometryArena::CreatePage(int32_t index, VkDeviceSize vertexCapacity, VkDeviceSize indexCapacity)
+    {
+        std::unique_ptr<Page> page = std::make_unique<Page>();
+
+        // Vertex blocks are measured in vertices (strides are not powers of two), index blocks in bytes
+        VmaVirtualBlockCreateInfo vertexBlockInfo{.size = vertexCapacity};
+        VmaVirtualBlockCreateInfo indexBlockInfo{.size = indexCapacity};
+        AssertVkResult(vmaCreateVirtualBlock(&vertexBlockInfo, &page->VertexBlock));
+        AssertVkResult(vmaCreateVirtualBlock(&indexBlockInfo, &page->IndexBlock));
+
+        // Storage usage allows compute passes (culling, indirect draw generation) to read the shared buffers
+        page->Vertices.SetName(fmt::format("Geometry Arena Vertices #{}", index));
+        page->Vertices.Create(mContext, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                              vertexCapacity * mVertexStride, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+        page->Indices.SetName(fmt::format("Geometry Arena Indices #{}", index));
+        page->Indices.Create(mContext, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, indexCapacity,
+                             VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+
+        logger()->debug("Geometry Arena: Created page #{} ({} vertices, {} index bytes)", index, vertexCapacity, indexCapacity);
+
+        if((size_t)index == mPages.size())
+        {
+            mPages.push_back(std::move(page));
+        }
+        else
+        {
+            mPages[index] = std::move(page);
+        }
+        return *mPages[index];
+    }
+
+    void GeometryArena::DestroyPage(int32_t index)
+    {
+        Page& page = *mPages[index];
+        page.Vertices.Cleanup();
+        page.Indices.Cleanup();
+        vmaClearVirtualBlock(page.VertexBlock);
+        vmaClearVirtualBlock(page.IndexBlock);
+        vmaDestroyVirtualBlock(page.VertexBlock);
+        vmaDestroyVirtualBlock(page.IndexBlock);
+        mPages[index] = nullptr;
+    }
+
+    bool GeometryArena::TryAllocate(int32_t pageIndex, uint32_t vertexCount, VkDeviceSize indexSize, Allocation& outallocation)
+    {
+        Page&      page = *mPages[pageIndex];
+        Allocation result{.Page = pageIndex};
+
+        // Empty ranges are not allocated, VMA rejects allocations of size 0
+        if(vertexCount)
+        {
+            VmaVirtualAllocationCreateInfo vertexInfo{.size = vertexCount, .alignment = 1};
+            VkDeviceSize                   firstVertex = 0;
+            if(vmaVirtualAllocate(page.VertexBlock, &vertexInfo, &result.Vertices, &firstVertex) != VK_SUCCESS)
+            {
+                return false;
+            }
+            result.FirstVertex = (uint32_t)firstVertex;
+        }
+        if(indexSize)
+        {
+            VmaVirtualAllocationCreateInfo indexInfo{.size = indexSize, .alignment = 4};
+            if(vmaVirtualAllocate(page.IndexBlock, &indexInfo, &result.Indices, &result.IndexOffset) != VK_SUCCESS)
+            {
+                if(result.Vertices)
+                {
+                    vmaVirtualFree(page.VertexBlock, result.Vertices);
+                }
+                return false;
+            }
+        }
+        outallocation = result;
+        return true;
+    }
+
+    GeometryArena::Allocation GeometryArena::Allocate(uint32_t vertexCount, VkDeviceSize indexSize)
+    {
+        HSK_ASSERTFMT(mContext, "Geometry Arena: Allocate called without context! ({} vertices)", vertexCount)
+
+        // Index sizes are rounded up, so the following range stays 4 byte aligned
+        indexSize = (indexSize + 3) / 4 * 4;
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        ReleaseCompleted();
+        Allocation result;
+        for(int32_t i = 0; i < (int32_t)mPages.size(); i++)
+        {
+            if(mPages[i] && TryAllocate(i, vertexCount, indexSize, result))
+            {
+                return result;
+            }
+        }
+
+        // Reuse the slot of a destroyed page if there is one
+        int32_t index = (int32_t)mPages.size();
+        for(int32_t i = 0; i < (int32_t)mPages.size(); i++)
+        {
+            if(!mPages[i])
+            {
+                index = i;
+                break;
+            }
+        }
+        VkDeviceSize vertexCapacity = std::max<VkDeviceSize>(mPageSize / mVertexStride, vertexCount);
+        VkDeviceSize indexCapacity  = std::max<VkDeviceSize>(mPageSize / 2, indexSize);
+        CreatePage(index, vertexCapacity, indexCapacity);
+        HSK_ASSERTFMT(TryAllocate(index, vertexCount, indexSize, result), "Geometry Arena: Failed to allocate {} vertices and {} index bytes!", vertexCount, indexSize)
+        return result;
+    }
+
+    void GeometryArena::Free(Allocation& allocation)
+    {
+        if(!allocation.IsValid())
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mMutex);
+        if(mContext && mContext->FrameProgress)
+        {
+            mPendingFrees.push_back(PendingFree{.Freed = allocation, .FrameNumber = mContext->FrameProgress->FrameNumber});
+        }
+        else
+        {
+            Release(allocation);
+        }
+        ReleaseCompleted();
+        allocation = Allocation{};
+    }
+
+    void GeometryArena::Release(const Allocation& allocation)
+    {
+        Page& page = *mPages[allocation.Page];
+        if(allocation.Vertices)
+        {
+            vmaVirtualFree(page.VertexBlock, allocation.Vertices);
+        }
+        if(allocation.Indices)
+        {
+            vmaVirtualFree(page.IndexBlock, allocation.Indices);
+        }
+        // The first page is kept for later loads, others are usually oversized pages of a single large model
+        if(allocation.Page > 0 && vmaIsVirtualBlockEmpty(page.VertexBlock) && vmaIsVirtualBlockEmpty(page.IndexBlock))
+        {
+            DestroyPage(allocation.Page);
+        }
+    }
+
+    void GeometryArena::ReleaseCompleted()
+    {
+        uint64_t completedFrameCount = (mContext && mContext->FrameProgress) ? mContext->FrameProgress->CompletedFrameCount.load() : UINT64_MAX;
+        while(mPendingFrees.size() && mPendingFrees.front().FrameNumber < completedFrameCount)
+        {
+            Release(mPendingFrees.front().Freed);
+            mPendingFrees.pop_front();
+        }
+    }
+
+    ManagedBuffer& GeometryArena::GetVertexBuffer(int32_t page)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mPages[page]->Vertices;
+    }
+
+    ManagedBuffer& GeometryArena::GetIndexBuffer(int32_t page)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mPages[page]->Indices;
+    }
+
+    void GeometryArena::CmdBind(VkCommandBuffer commandBuffer, int32_t page, VkIndexType indexType)
+    {
+        VkBuffer vertexBuffer = VK_NULL_HANDLE;
+        VkBuffer indexBuffer  = VK_NULL_HANDLE;
+        {
+            // Loader threads may create pages meanwhile, which reallocates mPages
+            std::lock_guard<std::mutex> lock(mMutex);
+            vertexBuffer = mPages[page]->Vertices.GetBuffer();
+            indexBuffer  = mPages[page]->Indices.GetBuffer();
+        }
+        const VkDeviceSize offsets[1] = {0};
+        vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, offsets);
+        vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, indexType);
+    }
+
+    size_t GeometryArena::GetPageCount() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return (size_t)std::count_if(mPages.begin(), mPages.end(), [](const std::unique_ptr<Page>& page) { return page != nullptr; });
+    }
+
+    void GeometryArena::Cleanup()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPendingFrees.clear();
+        for(int32_t i = 0; i < (int32_t)mPages.size(); i++)
+        {
+            if(mPages[i])
+            {
+                DestroyPage(i);
+            }
+        }
+        mPages.clear();
+    }
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+#include "hsk_managedbuffer.hpp"
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <vma/vk_mem_alloc.h>
+
+namespace hsk {
+
+    /// @brief Vertex and index buffers shared by many buffer sets. Ranges are sub-allocated with VMA virtual blocks and can be freed individually.
+    /// @remark Space is managed in pages, each holding one vertex and one index buffer. Both ranges of an allocation are placed in the same page, so a buffer set binds
+    /// the buffers of a single page. Pages are created on demand, allocations exceeding the page size get a page of their own.
+    /// Allocate(), Free(), CmdBind() and the buffer getters are thread safe, so models loading concurrently record their uploads into the same pages.
+    /// With a render loop (VkContext::FrameProgress), freed ranges are only released once all frames recorded before the free have completed.
+    class GeometryArena
+    {
+      public:
+        /// @brief Vertex and index range of a buffer set
+        struct Allocation
+        {
+            /// @brief Index of the page holding both ranges, -1 if invalid
+            int32_t              Page     = -1;
+            VmaVirtualAllocation Vertices = VK_NULL_HANDLE;
+            VmaVirtualAllocation Indices  = VK_NULL_HANDLE;
+            /// @brief Position of the first vertex in the page's vertex buffer
+            uint32_t FirstVertex = 0;
+            /// @brief Byte offset of the index range in the page's index buffer. Aligned to 4 bytes, so it can be addressed as 16 and 32 bit indices.
+            VkDeviceSize IndexOffset = 0;
+
+            inline bool IsValid() const { return Page >= 0; }
+        };
+
+        /// @param vertexStride Size of a vertex in bytes (see GetVertexStride())
+        /// @param pageSize Size of the vertex buffer of a page. Index buffers are half this size.
+        GeometryArena(const VkContext* context, size_t vertexStride, VkDeviceSize pageSize = 64 * 1024 * 1024);
+        GeometryArena(const GeometryArena& other)            = delete;
+        GeometryArena& operator=(const GeometryArena& other) = delete;
+        inline ~GeometryArena() { Cleanup(); }
+
+        /// @brief Allocates vertexCount vertices and indexSize bytes of index data from the first page with enough space
+        Allocation Allocate(uint32_t vertexCount, VkDeviceSize indexSize);
+        /// @brief Releases both ranges of an allocation. Resets allocation. Pages other than the first are destroyed once empty.
+        /// @remark Frames in flight may still read the ranges, so they are queued until the current frame has completed (see VkContext::FrameProgress).
+        /// Queued ranges are released by later calls to Allocate() and Free().
+        void Free(Allocation& allocation);
+
+        ManagedBuffer& GetVertexBuffer(int32_t page);
+        ManagedBuffer& GetIndexBuffer(int32_t page);
+        /// @brief Binds the vertex and index buffer of a page. The index buffer is bound at offset 0, index ranges start at Allocation::IndexOffset / index size.
+        void CmdBind(VkCommandBuffer commandBuffer, int32_t page, VkIndexType indexType);
+
+        /// @brief Destroys all pages, including ranges still queued for release. All allocations must have been freed and the device must be idle.
+        void Cleanup();
+
+        HSK_PROPERTY_CGET(VertexStride)
+        /// @brief Number of existing pages
+        size_t GetPageCount() const;
+
+      protected:
+        struct Page
+        {
+            ManagedBuffer   Vertices;
+            ManagedBuffer   Indices;
+            VmaVirtualBlock VertexBlock = VK_NULL_HANDLE;
+            VmaVirtualBlock IndexBlock  = VK_NULL_HANDLE;
+        };
+
+        const VkContext* mContext      = nullptr;
+        size_t           mVertexStride = 0;
+        VkDeviceSize     mPageSize     = 0;
+        /// @brief Freed pages are reset to nullptr, so page indices of allocations stay valid
+        std::vector<std::unique_ptr<Page>> mPages;
+        /// @brief A freed allocation waiting for the frames in flight at the time of the free
+        struct PendingFree
+        {
+            Allocation Freed;
+            /// @brief Released once FrameProgress::CompletedFrameCount exceeds this
+            uint64_t FrameNumber = 0;
+        };
+        /// @brief Ordered by frame number
+        std::deque<PendingFree> mPendingFrees;
+        /// @brief Guards mPages, mPendingFrees and the virtual blocks
+        mutable std::mutex mMutex;
+
+        Page& CreatePage(int32_t index, VkDeviceSize vertexCapacity, VkDeviceSize indexCapacity);
+        void  DestroyPage(int32_t index);
+        /// @brief Releases both ranges of an allocation immediately. Expects mMutex to be locked.
+        void Release(const Allocation& allocation);
+        /// @brief Releases queued allocations whose frame has completed. Expects mMutex to be locked.
+        void ReleaseCompleted();
+        /// @brief Allocates both ranges from a page. Fails without side effects.
+        bool TryAllocate(int32_t page, uint32_t vertexCount, VkDeviceSize indexSize, Allocation& outallocation);
+    };
+}  // namespace hsk
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "hsk_managedbuffer.hpp"
 #include "../hsk_vkHelpers.hpp"
 #include "hsk_commandbuffer.hpp"
+#include "hsk_stagingring.hpp"
 #include "hsk_vmaHelpers.hpp"
 #include "../utility/hsk_fmtutilities.hpp"
 #include <spdlog/fmt/fmt.h>
@@ -101,6 +102,12 @@ namespace hsk {
             logger()->warn("ManagedBuffer::Cleanup called before Unmap!");
             Unmap();
         }
+        if(mStagingSubmitId && mContext->StagingRing)
+        {
+            // A copy to the buffer may still be executing
+            mContext->StagingRing->WaitForSubmit(mStagingSubmitId);
+        }
+        mStagingSubmitId = 0;
         if(mContext && mContext->Allocator && mAllocation)
         {
             vmaDestroyBuffer(mContext->Allocator, mBuffer, mAllocation);
@@ -119,6 +126,15 @@ namespace hsk {
     {
         Assert(size + offsetDstBuffer <= mAllocationInfo.size, "Attempt to write data to device local buffer failed. Size + offsets needs to fit into buffer allocation!");
 
+        StagingRing* stagingRing = mContext->StagingRing;
+        if(stagingRing && size <= stagingRing->GetCapacity())
+        {
+            // Recorded into the ring's open command buffer, which is submitted once per frame (or when the ring runs full)
+            stagingRing->UploadBuffer(*this, data, size, offsetDstBuffer);
+            mStagingSubmitId = stagingRing->GetRecordingSubmitId();
+            return;
+        }
+
         ManagedBuffer stagingBuffer;
         stagingBuffer.CreateForStaging(mContext, size, data);
 
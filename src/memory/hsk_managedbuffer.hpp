@@ -30,6 +30,9 @@ namespace hsk {
 
         virtual bool Exists() const { return mAllocation; }
 
+        /// @brief Writes data via a staging buffer
+        /// @remark If the context has a StagingRing and the data fits, the write is recorded into the ring and submitted with its next flush (see StagingRing). Otherwise a dedicated
+        /// staging buffer is created and the copy is waited on.
         void WriteDataDeviceLocal(const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
 
         void Map(void*& data);
@@ -65,6 +68,8 @@ namespace hsk {
         VmaAllocationInfo mAllocationInfo{};
         VkDeviceSize      mSize     = {};
         bool              mIsMapped = false;
+        /// @brief Submit of the context's StagingRing last writing the buffer
+        uint64_t mStagingSubmitId = 0;
 
         void UpdateDebugNames();
     };
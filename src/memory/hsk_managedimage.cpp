@@ -3,6 +3,7 @@
 #include "../utility/hsk_fmtutilities.hpp"
 #include "hsk_managedbuffer.hpp"
 #include "hsk_commandbuffer.hpp"
+#include "hsk_stagingring.hpp"
 #include "hsk_vmaHelpers.hpp"
 
 namespace hsk {
@@ -148,17 +149,38 @@ namespace hsk {
 
     void ManagedImage::WriteDeviceLocalData(const void* data, size_t size, VkImageLayout layoutAfterWrite, VkBufferImageCopy& imageCopy)
     {
+        StagingRing* stagingRing = mContext->StagingRing;
+        if(stagingRing && size <= stagingRing->GetCapacity())
+        {
+            // Recorded into the ring's open command buffer, which is submitted once per frame (or when the ring runs full)
+            stagingRing->UploadImage(*this, data, size, layoutAfterWrite, imageCopy);
+            mStagingSubmitId = stagingRing->GetRecordingSubmitId();
+            return;
+        }
+
         // create staging buffer
         ManagedBuffer stagingBuffer;
         stagingBuffer.CreateForStaging(mContext, size, data);
 
+        WriteDeviceLocalData(stagingBuffer, layoutAfterWrite, imageCopy);
+    }
+
+    void ManagedImage::WriteDeviceLocalData(const ManagedBuffer& stagingBuffer, VkImageLayout layoutAfterWrite, VkBufferImageCopy& imageCopy)
+    {
         CommandBuffer singleTimeCmdBuf;
         singleTimeCmdBuf.Create(mContext);
         singleTimeCmdBuf.Begin();
 
+        CmdWriteFromStaging(singleTimeCmdBuf.GetCommandBuffer(), stagingBuffer.GetBuffer(), layoutAfterWrite, imageCopy);
+
+        singleTimeCmdBuf.Submit();
+    }
+
+    void ManagedImage::CmdWriteFromStaging(VkCommandBuffer commandBuffer, VkBuffer stagingBuffer, VkImageLayout layoutAfterWrite, const VkBufferImageCopy& imageCopy)
+    {
         // transform image layout to write dst
         LayoutTransitionInfo transitionInfo;
-        transitionInfo.CommandBuffer        = singleTimeCmdBuf.GetCommandBuffer();
+        transitionInfo.CommandBuffer        = commandBuffer;
         transitionInfo.NewImageLayout       = VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
         transitionInfo.BarrierSrcAccessMask = 0;
         transitionInfo.BarrierDstAccessMask = VkAccessFlagBits::VK_ACCESS_TRANSFER_WRITE_BIT;
@@ -168,7 +190,7 @@ namespace hsk {
         TransitionLayout(transitionInfo);
 
         // copy staging buffer data into device local memory
-        vkCmdCopyBufferToImage(singleTimeCmdBuf.GetCommandBuffer(), stagingBuffer.GetBuffer(), mImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageCopy);
+        vkCmdCopyBufferToImage(commandBuffer, stagingBuffer, mImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageCopy);
 
         if (layoutAfterWrite)
         {
@@ -182,8 +204,6 @@ namespace hsk {
 
             TransitionLayout(transitionInfo);
         }
-
-        singleTimeCmdBuf.Submit();
     }
 
     void ManagedImage::WriteDeviceLocalData(const void* data, size_t size, VkImageLayout layoutAfterWrite)
@@ -202,10 +222,32 @@ namespace hsk {
         WriteDeviceLocalData(data, size, layoutAfterWrite, region);
     }
 
+    void ManagedImage::WriteDeviceLocalData(const ManagedBuffer& stagingBuffer, VkImageLayout layoutAfterWrite)
+    {
+        // specify default copy region
+        VkBufferImageCopy region{};
+        region.bufferOffset                    = 0;
+        region.bufferRowLength                 = 0;
+        region.bufferImageHeight               = 0;
+        region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel       = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount     = 1;
+        region.imageOffset                     = {0, 0, 0};
+        region.imageExtent                     = mExtent3D;
+        WriteDeviceLocalData(stagingBuffer, layoutAfterWrite, region);
+    }
+
     void ManagedImage::Cleanup()
     {
         if(mAllocation)
         {
+            if(mStagingSubmitId && mContext->StagingRing)
+            {
+                // A copy to the image may still be executing
+                mContext->StagingRing->WaitForSubmit(mStagingSubmitId);
+            }
+            mStagingSubmitId = 0;
             vkDestroyImageView(mContext->Device, mImageView, nullptr);
             vmaDestroyImage(mContext->Allocator, mImage, mAllocation);
             mImage      = nullptr;
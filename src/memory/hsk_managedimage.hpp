@@ -7,6 +7,8 @@
 #include <vulkan/vulkan.h>
 
 namespace hsk {
+    class ManagedBuffer;
+
     class ManagedImage : public DeviceResourceBase
     {
       public:
@@ -76,12 +78,23 @@ namespace hsk {
         /// @param size - Size of the image
         /// @param layoutAfterWrite - The layout that the image is transitioned to after it has been written.
         /// @param imageCopy - Specify how exactly the image is copied.
+        /// @remark If the context has a StagingRing and the data fits, the write is recorded into the ring and submitted with its next flush instead (see StagingRing).
         void WriteDeviceLocalData(const void* data, size_t size, VkImageLayout layoutAfterWrite, VkBufferImageCopy& imageCopy);
 
         /// @brief See other overload for description. Omits image copy region and assumes a set of default values to write a simple
         /// image (no mimap, no layers) completely.
         void WriteDeviceLocalData(const void* data, size_t size, VkImageLayout layoutAfterWrite);
 
+        /// @brief Variant of WriteDeviceLocalData sourcing from an already filled staging buffer (e.g. written by image decoding threads)
+        void WriteDeviceLocalData(const ManagedBuffer& stagingBuffer, VkImageLayout layoutAfterWrite, VkBufferImageCopy& imageCopy);
+
+        /// @brief See other overload for description. Omits image copy region and assumes a set of default values to write a simple
+        /// image (no mimap, no layers) completely.
+        void WriteDeviceLocalData(const ManagedBuffer& stagingBuffer, VkImageLayout layoutAfterWrite);
+
+        /// @brief Records writing the image from a staging buffer into commandBuffer, transitioning to VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL and to layoutAfterWrite afterwards
+        void CmdWriteFromStaging(VkCommandBuffer commandBuffer, VkBuffer stagingBuffer, VkImageLayout layoutAfterWrite, const VkBufferImageCopy& imageCopy);
+
         virtual void Cleanup() override;
         virtual bool Exists() const override { return mAllocation; }
 
@@ -110,6 +123,8 @@ namespace hsk {
         VmaAllocationInfo mAllocInfo{};
         VkDeviceSize      mSize{};
         VkExtent3D        mExtent3D{};
+        /// @brief Submit of the context's StagingRing last writing the image
+        uint64_t mStagingSubmitId = 0;
 
         void CheckImageFormatSupport(CreateInfo& createInfo);
         void UpdateDebugNames();
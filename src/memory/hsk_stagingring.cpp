@@ -0,0 +1,175 @@
+#include "hsk_stagingring.hpp"
+#include "../hsk_vkHelpers.hpp"
+#include "hsk_managedimage.hpp"
+#include <cstring>
+
+namespace hsk {
+    void StagingRing::Create(const VkContext* context, VkDeviceSize capacity)
+    {
+        mContext  = context;
+        mCapacity = capacity;
+        mHead     = 0;
+        mTail     = 0;
+        mBuffer.SetName(mName);
+        mBuffer.CreateForStaging(mContext, mCapacity);
+        void* mapped = nullptr;
+        mBuffer.Map(mapped);
+        mMapped = reinterpret_cast<uint8_t*>(mapped);
+    }
+
+    StagingRing::Range StagingRing::Allocate(VkDeviceSize size, VkDeviceSize alignment)
+    {
+        HSK_ASSERTFMT(mContext, "{}: Allocate called before Create!", mName)
+        HSK_ASSERTFMT(size <= mCapacity, "{}: Allocation of {} bytes exceeds the capacity of {} bytes!", mName, size, mCapacity)
+
+        // Allocations belong to the command buffer recording now, begin it so Flush() covers them even if nothing is recorded
+        GetCommandBuffer();
+
+        for(bool retired = false;;)
+        {
+            uint64_t     wrapStart = mHead - mHead % mCapacity;
+            VkDeviceSize offset    = (mHead % mCapacity + alignment - 1) / alignment * alignment;
+            if(offset + size > mCapacity)
+            {
+                // Ranges never wrap around, the rest of the buffer is skipped
+                wrapStart += mCapacity;
+                offset = 0;
+            }
+            uint64_t end = wrapStart + offset + size;
+            if(end - mTail <= mCapacity)
+            {
+                mHead = end;
+                return Range{.Buffer = mBuffer.GetBuffer(), .Offset = offset, .Size = size, .Mapped = mMapped + offset};
+            }
+            if(mHead == mTail)
+            {
+                // Nothing allocated, start over at the beginning of the buffer
+                mHead = mTail = (mHead + mCapacity - 1) / mCapacity * mCapacity;
+                continue;
+            }
+            if(!retired)
+            {
+                Retire();
+                retired = true;
+                continue;
+            }
+            if(mInFlight.empty())
+            {
+                // The ring is filled by the command buffer recording now
+                Flush();
+                GetCommandBuffer();
+            }
+            mStallCount++;
+            RetireOldest();
+        }
+    }
+
+    VkCommandBuffer StagingRing::GetCommandBuffer()
+    {
+        if(!mRecording)
+        {
+            if(mFreeCommandBuffers.size())
+            {
+                mRecording = std::move(mFreeCommandBuffers.back());
+                mFreeCommandBuffers.pop_back();
+            }
+            else
+            {
+                mRecording = std::make_unique<CommandBuffer>();
+                mRecording->Create(mContext, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+            }
+            mRecording->Begin();
+
+            // Writes of this submit must not overtake earlier work still reading the destinations (e.g. frames in flight)
+            vkCmdPipelineBarrier(*mRecording, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr);
+        }
+        return *mRecording;
+    }
+
+    void StagingRing::UploadBuffer(ManagedBuffer& dst, const void* data, VkDeviceSize size, VkDeviceSize dstOffset)
+    {
+        Range staging = Allocate(size);
+        memcpy(staging.Mapped, data, size);
+        VkBufferCopy copy{.srcOffset = staging.Offset, .dstOffset = dstOffset, .size = size};
+        vkCmdCopyBuffer(GetCommandBuffer(), staging.Buffer, dst.GetBuffer(), 1, &copy);
+    }
+
+    void StagingRing::UploadImage(ManagedImage& dst, const void* data, VkDeviceSize size, VkImageLayout layoutAfterWrite, const VkBufferImageCopy& imageCopy)
+    {
+        Range staging = Allocate(size);
+        memcpy(staging.Mapped, data, size);
+        VkBufferImageCopy region = imageCopy;
+        region.bufferOffset += staging.Offset;
+        dst.CmdWriteFromStaging(GetCommandBuffer(), staging.Buffer, layoutAfterWrite, region);
+    }
+
+    void StagingRing::Flush()
+    {
+        if(!mRecording)
+        {
+            return;
+        }
+        VkMemoryBarrier barrier{.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                                .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                                .dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT};
+        vkCmdPipelineBarrier(*mRecording, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        // Moved out before submitting, CommandBuffer::Submit() flushes the ring again
+        std::unique_ptr<CommandBuffer> commands = std::move(mRecording);
+        commands->Submit(true);
+        mSubmitCount++;
+        mInFlight.push_back(InFlightSubmit{.Commands = std::move(commands), .SubmitId = mSubmitCount, .End = mHead});
+    }
+
+    void StagingRing::Retire()
+    {
+        while(mInFlight.size() && vkGetFenceStatus(mContext->Device, mInFlight.front().Commands->GetFence()) == VK_SUCCESS)
+        {
+            Release(mInFlight.front());
+            mInFlight.pop_front();
+        }
+    }
+
+    void StagingRing::RetireOldest()
+    {
+        Release(mInFlight.front());
+        mInFlight.pop_front();
+    }
+
+    void StagingRing::Release(InFlightSubmit& submit)
+    {
+        // Fences signal in submission order on a single queue, so every earlier submit has completed as well
+        submit.Commands->WaitForCompletion();
+        mTail                 = submit.End;
+        mCompletedSubmitCount = submit.SubmitId;
+        mFreeCommandBuffers.push_back(std::move(submit.Commands));
+    }
+
+    void StagingRing::WaitForSubmit(uint64_t submitId)
+    {
+        if(submitId > mSubmitCount)
+        {
+            Flush();
+        }
+        while(mCompletedSubmitCount < submitId && mInFlight.size())
+        {
+            RetireOldest();
+        }
+    }
+
+    void StagingRing::WaitIdle() { WaitForSubmit(mSubmitCount + 1); }
+
+    void StagingRing::Cleanup()
+    {
+        if(!mContext)
+        {
+            return;
+        }
+        WaitIdle();
+        mFreeCommandBuffers.clear();
+        mBuffer.Unmap();
+        mBuffer.Cleanup();
+        mMapped   = nullptr;
+        mCapacity = 0;
+        mContext  = nullptr;
+    }
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+#include "../base/hsk_vkcontext.hpp"
+#include "../utility/hsk_deviceresource.hpp"
+#include "hsk_commandbuffer.hpp"
+#include "hsk_managedbuffer.hpp"
+#include <deque>
+#include <memory>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace hsk {
+    class ManagedImage;
+
+    /// @brief Persistently mapped staging buffer used as a ring for small, frequent uploads (per frame buffer updates, streaming)
+    /// @remark Uploads sub-allocate staging memory and record their copies into the ring's current command buffer. Flush() submits it with a fence
+    /// without waiting. The ring's owner flushes once per frame before submitting the frame (see DefaultAppBase::Render()), so all writes of a frame share a
+    /// single submit. Besides that, the ring is only flushed when it runs full and by CommandBuffer::Submit(), so one time command buffers observe earlier writes. Staging memory and command buffers of a submit are reclaimed once its fence has signaled, which is polled whenever memory runs out
+    /// (and by Retire()). Only if the ring is exhausted by submits still executing, the oldest one is waited on.
+    /// Every submit starts with an execution barrier against all earlier work on the queue and ends with a memory barrier making the transfer writes
+    /// visible to all later work on the queue, so uploads are ordered like any other command buffer submitted at Flush() time.
+    /// Not thread safe. Records into the context's CommandPool and submits to its TransferQueue.
+    class StagingRing : public DeviceResourceBase
+    {
+      public:
+        /// @brief Range of staging memory allocated by Allocate()
+        struct Range
+        {
+            VkBuffer     Buffer = nullptr;
+            VkDeviceSize Offset = 0;
+            VkDeviceSize Size   = 0;
+            /// @brief Host pointer to the first byte of the range
+            void* Mapped = nullptr;
+        };
+
+        StagingRing() { mName = "Staging Ring"; }
+        inline virtual ~StagingRing() { Cleanup(); }
+
+        /// @param capacity Size of the staging buffer. Uploads larger than this have to use dedicated staging memory.
+        void Create(const VkContext* context, VkDeviceSize capacity = 32 * 1024 * 1024);
+
+        /// @brief Allocates staging memory released once the current command buffer has executed. Blocks if the ring is exhausted.
+        /// @remark May flush the current command buffer to make room, so record the copy from a range before allocating the next one.
+        Range Allocate(VkDeviceSize size, VkDeviceSize alignment = 16);
+
+        /// @brief Current command buffer. Use to record copies from ranges returned by Allocate(). Begins recording if required.
+        VkCommandBuffer GetCommandBuffer();
+
+        /// @brief Copies data to staging memory and records a copy to dst
+        void UploadBuffer(ManagedBuffer& dst, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+        /// @brief Copies data to staging memory and records writing the region of dst (including layout transitions)
+        void UploadImage(ManagedImage& dst, const void* data, VkDeviceSize size, VkImageLayout layoutAfterWrite, const VkBufferImageCopy& imageCopy);
+
+        /// @brief Submits the current command buffer without waiting. Does nothing if nothing has been allocated or recorded since the last Flush().
+        void Flush();
+        /// @brief Releases staging memory of all submits that have finished executing. Never blocks.
+        void Retire();
+        /// @brief Blocks until the submit with the given id has executed. Flushes first if the id belongs to the current command buffer.
+        void WaitForSubmit(uint64_t submitId);
+        /// @brief Flushes and blocks until all submits have executed
+        void WaitIdle();
+
+        /// @brief Id of the submit commands recorded now end up in. Pass to WaitForSubmit().
+        inline uint64_t GetRecordingSubmitId() const { return mSubmitCount + 1; }
+
+        virtual void Cleanup() override;
+        virtual bool Exists() const override { return mContext; }
+
+        HSK_PROPERTY_CGET(Capacity)
+        HSK_PROPERTY_CGET(SubmitCount)
+        /// @brief Number of times Allocate() had to wait for the GPU because the ring was exhausted
+        HSK_PROPERTY_CGET(StallCount)
+
+        /// @brief Number of bytes allocated and not yet released
+        inline VkDeviceSize GetUsedSize() const { return mHead - mTail; }
+
+      protected:
+        struct InFlightSubmit
+        {
+            std::unique_ptr<CommandBuffer> Commands = {};
+            uint64_t                       SubmitId = 0;
+            /// @brief Ring position behind the last allocation of the submit
+            uint64_t End = 0;
+        };
+
+        const VkContext* mContext  = nullptr;
+        ManagedBuffer    mBuffer   = {};
+        uint8_t*         mMapped   = nullptr;
+        VkDeviceSize     mCapacity = 0;
+        /// @brief Ring positions grow monotonically, the buffer offset is the position modulo mCapacity
+        uint64_t mHead = 0;
+        /// @brief Position behind the last allocation released
+        uint64_t                                    mTail                 = 0;
+        std::unique_ptr<CommandBuffer>              mRecording            = {};
+        std::deque<InFlightSubmit>                  mInFlight             = {};
+        std::vector<std::unique_ptr<CommandBuffer>> mFreeCommandBuffers   = {};
+        uint64_t                                    mSubmitCount          = 0;
+        uint64_t                                    mCompletedSubmitCount = 0;
+        uint32_t                                    mStallCount           = 0;
+
+        /// @brief Waits for the oldest submit in flight and releases its resources
+        void RetireOldest();
+        void Release(InFlightSubmit& submit);
+    };
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,238 @@
+#include "hsk_uploadbatch.hpp"
+#include "../hsk_vkHelpers.hpp"
+#include "hsk_managedimage.hpp"
+#include <spdlog/fmt/fmt.h>
+
+namespace hsk {
+    void UploadBatch::Create(const VkContext* context, VkDeviceSize chunkSize, bool dedicatedCommandPool)
+    {
+        mContext   = context;
+        mChunkSize = chunkSize;
+        if(dedicatedCommandPool && !mCommandPool)
+        {
+            HSK_ASSERTFMT(!mCommandBuffer.Exists(), "{}: Command buffer already allocated from the context's command pool!", mName)
+            VkCommandPoolCreateInfo poolCI{.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                                           .flags            = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+                                           .queueFamilyIndex = mContext->TransferQueue.QueueFamilyIndex};
+            AssertVkResult(vkCreateCommandPool(mContext->Device, &poolCI, nullptr, &mCommandPool));
+        }
+    }
+
+    UploadBatch::Chunk& UploadBatch::AddChunk(VkDeviceSize size)
+    {
+        Chunk chunk;
+        chunk.Size   = size;
+        chunk.Buffer = std::make_unique<ManagedBuffer>();
+        chunk.Buffer->SetName(fmt::format("{} Staging #{}", mName, mChunks.size()));
+        chunk.Buffer->CreateForStaging(mContext, size);
+        void* mapped = nullptr;
+        chunk.Buffer->Map(mapped);
+        chunk.Mapped = reinterpret_cast<uint8_t*>(mapped);
+        mStagingSize += size;
+        mChunks.push_back(std::move(chunk));
+        return mChunks.back();
+    }
+
+    UploadBatch::StagingRange UploadBatch::AllocateStaging(VkDeviceSize size, VkDeviceSize alignment)
+    {
+        HSK_ASSERTFMT(mContext, "{}: AllocateStaging called before Create!", mName)
+
+        std::lock_guard<std::mutex> lock(mChunkMutex);
+
+        // Chunks are filled front to back, only the last chunk may have space left (earlier chunks either are full or dedicated)
+        Chunk*       chunk  = mChunks.size() ? &mChunks.back() : nullptr;
+        VkDeviceSize offset = chunk ? (chunk->Used + alignment - 1) / alignment * alignment : 0;
+        if(!chunk || offset + size > chunk->Size)
+        {
+            chunk  = &AddChunk(std::max(size, mChunkSize));
+            offset = 0;
+        }
+        chunk->Used = offset + size;
+
+        return StagingRange{.Buffer = chunk->Buffer->GetBuffer(), .Offset = offset, .Size = size, .Mapped = chunk->Mapped + offset};
+    }
+
+    VkCommandBuffer UploadBatch::GetCommandBuffer()
+    {
+        if(!mCommandBuffer.Exists())
+        {
+            mCommandBuffer.Create(mContext, VK_COMMAND_BUFFER_LEVEL_PRIMARY, false, mCommandPool);
+        }
+        if(!mRecording)
+        {
+            // A command buffer still in flight must not be reset
+            WaitIdle();
+            mCommandBuffer.Begin();
+            mRecording = true;
+        }
+        return mCommandBuffer.GetCommandBuffer();
+    }
+
+    void UploadBatch::UploadBuffer(ManagedBuffer& dst, const void* data, VkDeviceSize size, VkDeviceSize dstOffset)
+    {
+        StagingRange staging = AllocateStaging(size);
+        memcpy(staging.Mapped, data, size);
+        CopyToBuffer(dst, staging, dstOffset);
+    }
+
+    void UploadBatch::CopyToBuffer(ManagedBuffer& dst, const StagingRange& src, VkDeviceSize dstOffset)
+    {
+        VkBufferCopy copy{.srcOffset = src.Offset, .dstOffset = dstOffset, .size = src.Size};
+        vkCmdCopyBuffer(GetCommandBuffer(), src.Buffer, dst.GetBuffer(), 1, &copy);
+        mRecordedSize += src.Size;
+    }
+
+    void UploadBatch::UploadImage(ManagedImage& dst, const void* data, VkDeviceSize size, VkImageLayout layoutAfterWrite)
+    {
+        StagingRange staging = AllocateStaging(size);
+        memcpy(staging.Mapped, data, size);
+        CopyToImage(dst, staging, layoutAfterWrite);
+    }
+
+    void UploadBatch::CopyToImage(ManagedImage& dst, const StagingRange& src, VkImageLayout layoutAfterWrite)
+    {
+        VkBufferImageCopy region{};
+        region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel       = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount     = 1;
+        region.imageOffset                     = {0, 0, 0};
+        region.imageExtent                     = dst.GetExtent3D();
+
+        CopyToImage(dst, src, layoutAfterWrite, region);
+    }
+
+    void UploadBatch::CopyToImage(ManagedImage& dst, const StagingRange& src, VkImageLayout layoutAfterWrite, VkBufferImageCopy imageCopy)
+    {
+        VkCommandBuffer commandBuffer = GetCommandBuffer();
+
+        ManagedImage::LayoutTransitionInfo transitionInfo;
+        transitionInfo.CommandBuffer                   = commandBuffer;
+        transitionInfo.NewImageLayout                  = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        transitionInfo.BarrierSrcAccessMask            = 0;
+        transitionInfo.BarrierDstAccessMask            = VK_ACCESS_TRANSFER_WRITE_BIT;
+        transitionInfo.SrcStage                        = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        transitionInfo.DstStage                        = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        transitionInfo.SubresourceRange.aspectMask     = imageCopy.imageSubresource.aspectMask;
+        transitionInfo.SubresourceRange.baseMipLevel   = imageCopy.imageSubresource.mipLevel;
+        transitionInfo.SubresourceRange.baseArrayLayer = imageCopy.imageSubresource.baseArrayLayer;
+        transitionInfo.SubresourceRange.layerCount     = imageCopy.imageSubresource.layerCount;
+        dst.TransitionLayout(transitionInfo);
+
+        imageCopy.bufferOffset += src.Offset;
+        vkCmdCopyBufferToImage(commandBuffer, src.Buffer, dst.GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &imageCopy);
+        mRecordedSize += src.Size;
+
+        if(layoutAfterWrite)
+        {
+            // Later commands in the batch (e.g. mip map blits) may read the written subresource
+            transitionInfo.OldImageLayout       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            transitionInfo.NewImageLayout       = layoutAfterWrite;
+            transitionInfo.BarrierSrcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            transitionInfo.BarrierDstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+            transitionInfo.SrcStage             = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            transitionInfo.DstStage             = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            dst.TransitionLayout(transitionInfo);
+        }
+    }
+
+    void UploadBatch::CopyToImage(ManagedImage& dst, const StagingRange& src, VkImageLayout layoutAfterWrite, const std::vector<VkBufferImageCopy>& imageCopies)
+    {
+        VkCommandBuffer commandBuffer = GetCommandBuffer();
+
+        // Transitioning from the layout tracked by the image is only valid for a single subresource, so all mip levels start out undefined
+        ManagedImage::LayoutTransitionInfo transitionInfo;
+        transitionInfo.CommandBuffer                 = commandBuffer;
+        transitionInfo.OldImageLayout                = VK_IMAGE_LAYOUT_UNDEFINED;
+        transitionInfo.NewImageLayout                = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        transitionInfo.BarrierSrcAccessMask          = 0;
+        transitionInfo.BarrierDstAccessMask          = VK_ACCESS_TRANSFER_WRITE_BIT;
+        transitionInfo.SrcStage                      = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        transitionInfo.DstStage                      = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        transitionInfo.SubresourceRange.baseMipLevel = 0;
+        transitionInfo.SubresourceRange.levelCount   = VK_REMAINING_MIP_LEVELS;
+        dst.TransitionLayout(transitionInfo);
+
+        std::vector<VkBufferImageCopy> regions(imageCopies);
+        for(VkBufferImageCopy& region : regions)
+        {
+            region.bufferOffset += src.Offset;
+        }
+        vkCmdCopyBufferToImage(commandBuffer, src.Buffer, dst.GetImage(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32_t)regions.size(), regions.data());
+        mRecordedSize += src.Size;
+
+        if(layoutAfterWrite)
+        {
+            transitionInfo.OldImageLayout       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            transitionInfo.NewImageLayout       = layoutAfterWrite;
+            transitionInfo.BarrierSrcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            transitionInfo.BarrierDstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+            transitionInfo.SrcStage             = VK_PIPELINE_STAGE_TRANSFER_BIT;
+            transitionInfo.DstStage             = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            dst.TransitionLayout(transitionInfo);
+        }
+    }
+
+    void UploadBatch::Submit(bool wait)
+    {
+        if(!mRecording)
+        {
+            return;
+        }
+        mCommandBuffer.Submit(!wait);
+        mPending      = !wait;
+        mRecording    = false;
+        mRecordedSize = 0;
+        mSubmitCount++;
+    }
+
+    void UploadBatch::WaitIdle()
+    {
+        if(mPending)
+        {
+            mCommandBuffer.WaitForCompletion();
+            mPending = false;
+        }
+    }
+
+    void UploadBatch::Reset()
+    {
+        Submit();
+        WaitIdle();
+
+        std::lock_guard<std::mutex> lock(mChunkMutex);
+        while(mChunks.size() > 1)
+        {
+            Chunk& chunk = mChunks.back();
+            chunk.Buffer->Unmap();
+            mStagingSize -= chunk.Size;
+            mChunks.pop_back();
+        }
+        if(mChunks.size())
+        {
+            mChunks.front().Used = 0;
+        }
+    }
+
+    void UploadBatch::Cleanup()
+    {
+        if(mRecording)
+        {
+            Submit();
+        }
+        WaitIdle();
+        for(Chunk& chunk : mChunks)
+        {
+            chunk.Buffer->Unmap();
+        }
+        mChunks.clear();
+        mStagingSize = 0;
+        mCommandBuffer.Cleanup();
+        if(mCommandPool)
+        {
+            vkDestroyCommandPool(mContext->Device, mCommandPool, nullptr);
+            mCommandPool = VK_NULL_HANDLE;
+        }
+        mContext = nullptr;
+    }
+}  // namespace hsk
\ No newline at end of file
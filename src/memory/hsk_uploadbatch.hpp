@@ -0,0 +1,98 @@
+#pragma once
+#include "../base/hsk_vkcontext.hpp"
+#include "../utility/hsk_deviceresource.hpp"
+#include "hsk_commandbuffer.hpp"
+#include "hsk_managedbuffer.hpp"
+#include <mutex>
+#include <vulkan/vulkan.h>
+
+namespace hsk {
+    class ManagedImage;
+
+    /// @brief Collects many uploads (buffer writes, image writes, layout transitions, mip blits) into a single command buffer submitted with a single fence
+    /// @remark Staging memory is sub-allocated from large persistently mapped chunks. Staging memory is retained across Submit() calls
+    /// (staging ranges may be filled before and copied after a submit) and only released by Reset().
+    class UploadBatch : public DeviceResourceBase
+    {
+      public:
+        /// @brief Range of staging memory allocated by AllocateStaging()
+        struct StagingRange
+        {
+            VkBuffer     Buffer = nullptr;
+            VkDeviceSize Offset = 0;
+            VkDeviceSize Size   = 0;
+            /// @brief Host pointer to the first byte of the range
+            void* Mapped = nullptr;
+        };
+
+        UploadBatch() { mName = "Upload Batch"; }
+        inline virtual ~UploadBatch() { Cleanup(); }
+
+        /// @param chunkSize Size of the staging buffers sub-allocated from. Larger allocations get a dedicated chunk.
+        /// @param dedicatedCommandPool If set, commands are recorded into a command pool owned by the batch instead of the context's CommandPool,
+        /// so several batches can record concurrently on different threads. Submits still have to be serialized by the caller (they share a queue).
+        void Create(const VkContext* context, VkDeviceSize chunkSize = 64 * 1024 * 1024, bool dedicatedCommandPool = false);
+
+        /// @brief Allocates a range of mapped staging memory. Thread safe, may be called concurrently with other AllocateStaging() calls.
+        StagingRange AllocateStaging(VkDeviceSize size, VkDeviceSize alignment = 16);
+
+        /// @brief Copies data to staging memory and records a copy to dst
+        void UploadBuffer(ManagedBuffer& dst, const void* data, VkDeviceSize size, VkDeviceSize dstOffset = 0);
+        /// @brief Records a copy from staging memory to dst
+        void CopyToBuffer(ManagedBuffer& dst, const StagingRange& src, VkDeviceSize dstOffset = 0);
+
+        /// @brief Copies data to staging memory and records writing the first mip level of dst (including layout transitions)
+        void UploadImage(ManagedImage& dst, const void* data, VkDeviceSize size, VkImageLayout layoutAfterWrite);
+        /// @brief Records writing the first mip level of dst from staging memory (including layout transitions)
+        void CopyToImage(ManagedImage& dst, const StagingRange& src, VkImageLayout layoutAfterWrite);
+        /// @brief Records writing dst from staging memory (including layout transitions). imageCopy.bufferOffset is relative to the staging range.
+        void CopyToImage(ManagedImage& dst, const StagingRange& src, VkImageLayout layoutAfterWrite, VkBufferImageCopy imageCopy);
+        /// @brief Records writing several regions of dst (e.g. a complete mip chain) with a single copy, transitioning all mip levels.
+        /// The bufferOffset of every region is relative to the staging range.
+        void CopyToImage(ManagedImage& dst, const StagingRange& src, VkImageLayout layoutAfterWrite, const std::vector<VkBufferImageCopy>& imageCopies);
+
+        /// @brief Command buffer uploads are recorded to. Use to record additional transfer work (e.g. mip map generation). Begins recording if required.
+        VkCommandBuffer GetCommandBuffer();
+
+        /// @brief Submits all recorded commands. Does nothing if nothing has been recorded.
+        /// @param wait If false, the submit is only waited on once the batch is used again (or by WaitIdle()), so the GPU can work on it meanwhile.
+        void Submit(bool wait = true);
+        /// @brief Waits for a submit issued with wait = false
+        void WaitIdle();
+        /// @brief Submits pending commands and releases all staging memory except for the first chunk
+        void Reset();
+
+        virtual void Cleanup() override;
+        virtual bool Exists() const override { return mContext; }
+
+        HSK_PROPERTY_CGET(SubmitCount)
+        /// @brief Number of bytes copied by commands recorded since the last submit
+        HSK_PROPERTY_CGET(RecordedSize)
+        /// @brief Total size of staging memory currently allocated
+        HSK_PROPERTY_CGET(StagingSize)
+
+      protected:
+        struct Chunk
+        {
+            std::unique_ptr<ManagedBuffer> Buffer = {};
+            uint8_t*                       Mapped = nullptr;
+            VkDeviceSize                   Size   = 0;
+            VkDeviceSize                   Used   = 0;
+        };
+
+        const VkContext*   mContext       = nullptr;
+        VkDeviceSize       mChunkSize     = 0;
+        std::vector<Chunk> mChunks        = {};
+        std::mutex         mChunkMutex;
+        /// @brief Only set if created with a dedicated command pool
+        VkCommandPool      mCommandPool   = VK_NULL_HANDLE;
+        CommandBuffer      mCommandBuffer = {};
+        bool               mRecording     = false;
+        bool               mPending       = false;
+        uint32_t           mSubmitCount   = 0;
+        VkDeviceSize       mRecordedSize  = 0;
+        VkDeviceSize       mStagingSize   = 0;
+
+        Chunk& AddChunk(VkDeviceSize size);
+    };
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "hsk_meshletbuilder.hpp"
+#include "../hsk_exception.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace hsk {
+    void MeshletBuffer::Clear()
+    {
+        Meshlets.clear();
+        Bounds.clear();
+        Vertices.clear();
+        Triangles.clear();
+    }
+
+    uint32_t MeshletBuilder::Build(MeshletBuffer&  out,
+                                   const uint32_t* indices,
+                                   size_t          indexCount,
+                                   const float*    positions,
+                                   size_t          positionStride,
+                                   uint32_t        vertexCount,
+                                   uint32_t        baseVertex,
+                                   uint32_t        maxVertices,
+                                   uint32_t        maxTriangles)
+    {
+        HSK_ASSERTFMT(maxVertices >= 3 && maxVertices <= 256 && maxTriangles >= 1, "Invalid meshlet limits ({} vertices, {} triangles)!", maxVertices, maxTriangles)
+
+        const uint32_t NOT_IN_MESHLET = UINT32_MAX;
+
+        // Meshlet local index of each vertex for the meshlet currently built
+        std::vector<uint32_t> localIndices(vertexCount, NOT_IN_MESHLET);
+        size_t                firstMeshlet = out.Meshlets.size();
+
+        Meshlet current{.VertexOffset = (uint32_t)out.Vertices.size(), .TriangleOffset = (uint32_t)out.Triangles.size()};
+
+        auto lFinish = [&]() {
+            if(!current.TriangleCount)
+            {
+                return;
+            }
+            for(uint32_t i = 0; i < current.VertexCount; i++)
+            {
+                localIndices[out.Vertices[current.VertexOffset + i] - baseVertex] = NOT_IN_MESHLET;
+            }
+            out.Meshlets.push_back(current);
+            out.Bounds.push_back(ComputeBounds(out, current, positions, positionStride));
+            current = Meshlet{.VertexOffset = (uint32_t)out.Vertices.size(), .TriangleOffset = (uint32_t)out.Triangles.size()};
+        };
+
+        for(size_t triangle = 0; triangle + 2 < indexCount; triangle += 3)
+        {
+            const uint32_t* corners = indices + triangle;
+
+            uint32_t newVertices = 0;
+            for(uint32_t c = 0; c < 3; c++)
+            {
+                HSK_ASSERTFMT(corners[c] < vertexCount, "Vertex index {} out of range of primitive with {} vertices!", corners[c], vertexCount)
+                // Degenerate triangles may reference the same new vertex twice, counting it twice only splits early
+                newVertices += localIndices[corners[c]] == NOT_IN_MESHLET ? 1 : 0;
+            }
+            if(current.VertexCount + newVertices > maxVertices || current.TriangleCount + 1 > maxTriangles)
+            {
+                lFinish();
+            }
+
+            for(uint32_t c = 0; c < 3; c++)
+            {
+                uint32_t& local = localIndices[corners[c]];
+                if(local == NOT_IN_MESHLET)
+                {
+                    local = current.VertexCount++;
+                    out.Vertices.push_back(corners[c] + baseVertex);
+                }
+                out.Triangles.push_back((uint8_t)local);
+            }
+            current.TriangleCount++;
+        }
+        lFinish();
+
+        return (uint32_t)(out.Meshlets.size() - firstMeshlet);
+    }
+
+    MeshletBounds MeshletBuilder::ComputeBounds(const MeshletBuffer& buffer, const Meshlet& meshlet, const float* positions, size_t positionStride)
+    {
+        auto lGetPosition = [&](uint32_t localIndex) {
+            uint32_t vertex = buffer.Vertices[meshlet.VertexOffset + localIndex];
+            return glm::make_vec3(reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(positions) + vertex * positionStride));
+        };
+
+        MeshletBounds bounds;
+
+        // Bounding sphere around the center of the bounding box
+        glm::vec3 min(std::numeric_limits<float>::max());
+        glm::vec3 max(std::numeric_limits<float>::lowest());
+        for(uint32_t i = 0; i < meshlet.VertexCount; i++)
+        {
+            glm::vec3 position = lGetPosition(i);
+            min                = glm::min(min, position);
+            max                = glm::max(max, position);
+        }
+        bounds.Center = (min + max) * 0.5f;
+        for(uint32_t i = 0; i < meshlet.VertexCount; i++)
+        {
+            bounds.Radius = std::max(bounds.Radius, glm::length(lGetPosition(i) - bounds.Center));
+        }
+
+        // Normal cone (see Zeux, meshoptimizer meshopt_computeClusterBounds)
+        std::vector<glm::vec3> normals(meshlet.TriangleCount);
+        std::vector<glm::vec3> corners(meshlet.TriangleCount);
+        glm::vec3              normalSum(0.f);
+        for(uint32_t t = 0; t < meshlet.TriangleCount; t++)
+        {
+            const uint8_t* triangle = &buffer.Triangles[meshlet.TriangleOffset + t * 3];
+            glm::vec3      p0       = lGetPosition(triangle[0]);
+            glm::vec3      normal   = glm::cross(lGetPosition(triangle[1]) - p0, lGetPosition(triangle[2]) - p0);
+            float          length   = glm::length(normal);
+            normals[t]              = length > 0.f ? normal / length : glm::vec3(0.f);
+            corners[t]              = p0;
+            normalSum += normals[t];
+        }
+
+        float axisLength = glm::length(normalSum);
+        if(axisLength <= 0.f)
+        {
+            return bounds;
+        }
+        glm::vec3 axis = normalSum / axisLength;
+
+        float minDot = 1.f;
+        for(const glm::vec3& normal : normals)
+        {
+            minDot = std::min(minDot, glm::dot(normal, axis));
+        }
+        // Cones wider than ~84 degrees half angle are practically never culled
+        if(minDot <= 0.1f)
+        {
+            return bounds;
+        }
+
+        // Move the apex back along the axis until it is behind every triangle plane (center - axis * t lies on the plane of triangle t)
+        float maxT = 0.f;
+        for(uint32_t t = 0; t < meshlet.TriangleCount; t++)
+        {
+            float dn = glm::dot(normals[t], axis);
+            if(dn > 0.f)
+            {
+                maxT = std::max(maxT, glm::dot(bounds.Center - corners[t], normals[t]) / dn);
+            }
+        }
+
+        bounds.ConeApex   = bounds.Center - axis * maxT;
+        bounds.ConeAxis   = axis;
+        bounds.ConeCutoff = std::sqrt(1.f - minDot * minDot);
+        return bounds;
+    }
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+#include "../hsk_glm.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hsk {
+
+    /// @brief A cluster of triangles referencing a small set of vertices
+    struct Meshlet
+    {
+        /// @brief First entry in MeshletBuffer::Vertices
+        uint32_t VertexOffset = 0;
+        /// @brief First entry in MeshletBuffer::Triangles (3 entries per triangle)
+        uint32_t TriangleOffset = 0;
+        uint32_t VertexCount    = 0;
+        uint32_t TriangleCount  = 0;
+    };
+
+    /// @brief Culling data of a meshlet
+    struct MeshletBounds
+    {
+        /// @brief Bounding sphere
+        glm::vec3 Center = {};
+        float     Radius = 0.f;
+        /// @brief Normal cone. The meshlet is entirely backfacing for a camera at position p if dot(normalize(ConeApex - p), ConeAxis) >= ConeCutoff.
+        glm::vec3 ConeApex = {};
+        glm::vec3 ConeAxis = {};
+        /// @brief 1 if the normals are too diverse to ever cull the meshlet
+        float ConeCutoff = 1.f;
+
+        inline bool IsBackfacing(const glm::vec3& cameraPosition) const { return glm::dot(glm::normalize(ConeApex - cameraPosition), ConeAxis) >= ConeCutoff; }
+    };
+
+    /// @brief Meshlets of any number of primitives, with vertex and triangle data packed in shared arrays
+    struct MeshletBuffer
+    {
+        std::vector<Meshlet>       Meshlets  = {};
+        std::vector<MeshletBounds> Bounds    = {};
+        /// @brief Vertex index (as stored in the geometry's vertex buffer) for every meshlet vertex
+        std::vector<uint32_t> Vertices = {};
+        /// @brief Meshlet local vertex indices, 3 per triangle
+        std::vector<uint8_t> Triangles = {};
+
+        inline bool IsEmpty() const { return Meshlets.empty(); }
+        void        Clear();
+    };
+
+    /// @brief Splits triangle lists into meshlets
+    class MeshletBuilder
+    {
+      public:
+        /// @brief Appends meshlets of a triangle list to out. Triangles are consumed in order, so indices should be optimized for vertex cache locality beforehand.
+        /// @param indices Primitive local indices in [0, vertexCount)
+        /// @param positions Position of the first vertex of the vertex buffer (3 floats). The primitive's vertices start at baseVertex.
+        /// @param positionStride Distance between positions in bytes
+        /// @param baseVertex Added to every index to address the vertex buffer, and stored as such in MeshletBuffer::Vertices
+        /// @param maxVertices At most 256
+        /// @return Number of meshlets appended
+        static uint32_t Build(MeshletBuffer&  out,
+                              const uint32_t* indices,
+                              size_t          indexCount,
+                              const float*    positions,
+                              size_t          positionStride,
+                              uint32_t        vertexCount,
+                              uint32_t        baseVertex   = 0,
+                              uint32_t        maxVertices  = 64,
+                              uint32_t        maxTriangles = 124);
+
+        /// @brief Computes bounding sphere and normal cone of a meshlet
+        /// @param positions Position of the first vertex of the vertex buffer MeshletBuffer::Vertices index into
+        static MeshletBounds ComputeBounds(const MeshletBuffer& buffer, const Meshlet& meshlet, const float* positions, size_t positionStride);
+    };
+}  // namespace hsk
\ No newline at end of file
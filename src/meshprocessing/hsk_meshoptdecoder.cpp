@@ -0,0 +1,455 @@
+#include "hsk_meshoptdecoder.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace hsk {
+    namespace {
+        const uint8_t VERTEX_HEADER   = 0xa0;
+        const uint8_t INDEX_HEADER    = 0xe0;
+        const uint8_t SEQUENCE_HEADER = 0xd0;
+
+        /// @brief Attribute bytes are encoded in groups of 16
+        const size_t BYTE_GROUP_SIZE = 16;
+        /// @brief Maximum size of a group (4 or 8 header bytes plus 16 bytes of values), only checked once per group
+        const size_t BYTE_GROUP_DECODE_LIMIT = 24;
+        const size_t VERTEX_BLOCK_SIZE_BYTES = 8192;
+        const size_t VERTEX_BLOCK_MAX_SIZE   = 256;
+        /// @brief The first vertex is stored at the end of the stream, padded to at least 32 bytes
+        const size_t TAIL_MIN_SIZE = 32;
+
+        size_t GetVertexBlockSize(size_t byteStride)
+        {
+            size_t result = (VERTEX_BLOCK_SIZE_BYTES / byteStride) & ~(BYTE_GROUP_SIZE - 1);
+            return std::min(result, VERTEX_BLOCK_MAX_SIZE);
+        }
+
+        uint8_t Unzigzag8(uint8_t value) { return (uint8_t)(-(value & 1) ^ (value >> 1)); }
+
+        /// @brief Decodes 16 bytes stored with 0, 2, 4 or 8 bits each. 2 and 4 bit values with all bits set are escapes, the actual byte follows the packed bits.
+        const uint8_t* DecodeBytesGroup(const uint8_t* data, uint8_t* out, int32_t bitsLog2)
+        {
+            switch(bitsLog2)
+            {
+                case 0:
+                    memset(out, 0, BYTE_GROUP_SIZE);
+                    return data;
+                case 1:
+                case 2: {
+                    uint32_t       bits      = bitsLog2 == 1 ? 2 : 4;
+                    uint32_t       perByte   = 8 / bits;
+                    uint8_t        escape    = (uint8_t)((1 << bits) - 1);
+                    const uint8_t* variables = data + BYTE_GROUP_SIZE / perByte;
+                    for(size_t i = 0; i < BYTE_GROUP_SIZE; i++)
+                    {
+                        uint8_t packed = data[i / perByte];
+                        uint8_t value  = (uint8_t)((packed >> (8 - bits * (i % perByte + 1))) & escape);
+                        out[i]         = value == escape ? *variables++ : value;
+                    }
+                    return variables;
+                }
+                default:
+                    memcpy(out, data, BYTE_GROUP_SIZE);
+                    return data + BYTE_GROUP_SIZE;
+            }
+        }
+
+        const uint8_t* DecodeBytes(const uint8_t* data, const uint8_t* end, uint8_t* out, size_t count)
+        {
+            // 2 bit mode per group, 4 groups per header byte
+            const uint8_t* header     = data;
+            size_t         headerSize = (count / BYTE_GROUP_SIZE + 3) / 4;
+            if((size_t)(end - data) < headerSize)
+            {
+                return nullptr;
+            }
+            data += headerSize;
+
+            for(size_t i = 0; i < count; i += BYTE_GROUP_SIZE)
+            {
+                if((size_t)(end - data) < BYTE_GROUP_DECODE_LIMIT)
+                {
+                    return nullptr;
+                }
+                size_t  group    = i / BYTE_GROUP_SIZE;
+                int32_t bitsLog2 = (header[group / 4] >> ((group % 4) * 2)) & 3;
+                data             = DecodeBytesGroup(data, out + i, bitsLog2);
+            }
+            return data;
+        }
+
+        const uint8_t* DecodeVertexBlock(const uint8_t* data, const uint8_t* end, uint8_t* out, size_t count, size_t byteStride, uint8_t* lastVertex)
+        {
+            uint8_t deltas[VERTEX_BLOCK_MAX_SIZE];
+            size_t  alignedCount = (count + BYTE_GROUP_SIZE - 1) & ~(BYTE_GROUP_SIZE - 1);
+
+            // Byte k of all vertices of the block is stored as a sequence of zigzag encoded deltas
+            for(size_t k = 0; k < byteStride; k++)
+            {
+                data = DecodeBytes(data, end, deltas, alignedCount);
+                if(!data)
+                {
+                    return nullptr;
+                }
+                uint8_t previous = lastVertex[k];
+                for(size_t i = 0; i < count; i++)
+                {
+                    previous                 = (uint8_t)(Unzigzag8(deltas[i]) + previous);
+                    out[i * byteStride + k] = previous;
+                }
+            }
+            memcpy(lastVertex, out + (count - 1) * byteStride, byteStride);
+            return data;
+        }
+
+        uint32_t DecodeVByte(const uint8_t*& data)
+        {
+            uint8_t lead = *data++;
+            if(lead < 128)
+            {
+                return lead;
+            }
+            uint32_t result = lead & 127;
+            uint32_t shift  = 7;
+            for(int32_t i = 0; i < 4; i++)
+            {
+                uint8_t group = *data++;
+                result |= (uint32_t)(group & 127) << shift;
+                shift += 7;
+                if(group < 128)
+                {
+                    break;
+                }
+            }
+            return result;
+        }
+
+        uint32_t DecodeIndex(const uint8_t*& data, uint32_t last)
+        {
+            uint32_t value = DecodeVByte(data);
+            return last + ((value >> 1) ^ (uint32_t)(-(int32_t)(value & 1)));
+        }
+
+        void WriteIndex(uint8_t* out, size_t index, size_t byteStride, uint32_t value)
+        {
+            if(byteStride == 2)
+            {
+                uint16_t shortValue = (uint16_t)value;
+                memcpy(out + index * 2, &shortValue, 2);
+            }
+            else
+            {
+                memcpy(out + index * 4, &value, 4);
+            }
+        }
+
+        /// @brief FIFOs of the index codec. Decoding has to push exactly like the encoder did.
+        struct IndexFifos
+        {
+            uint32_t Edges[16][2];
+            uint32_t Vertices[16];
+            size_t   EdgeOffset   = 0;
+            size_t   VertexOffset = 0;
+
+            IndexFifos()
+            {
+                memset(Edges, -1, sizeof(Edges));
+                memset(Vertices, -1, sizeof(Vertices));
+            }
+
+            inline void PushEdge(uint32_t a, uint32_t b)
+            {
+                Edges[EdgeOffset][0] = a;
+                Edges[EdgeOffset][1] = b;
+                EdgeOffset           = (EdgeOffset + 1) & 15;
+            }
+            inline void PushVertex(uint32_t v, bool condition = true)
+            {
+                Vertices[VertexOffset] = v;
+                VertexOffset           = (VertexOffset + (condition ? 1 : 0)) & 15;
+            }
+        };
+
+        template <typename T>
+        T RoundToInt(float value)
+        {
+            return (T)(int32_t)(value + (value >= 0.f ? 0.5f : -0.5f));
+        }
+
+        template <typename T>
+        void DecodeFilterOctahedral(uint8_t* data, size_t count)
+        {
+            const float max = (float)((1 << (sizeof(T) * 8 - 1)) - 1);
+            for(size_t i = 0; i < count; i++)
+            {
+                T components[4];
+                memcpy(components, data + i * sizeof(components), sizeof(components));
+
+                // The third component holds the value encoding 1.0, z is reconstructed from x and y
+                float x = (float)components[0];
+                float y = (float)components[1];
+                float z = (float)components[2] - std::fabs(x) - std::fabs(y);
+
+                // Lower hemisphere is folded
+                float t = std::min(z, 0.f);
+                x += x >= 0.f ? t : -t;
+                y += y >= 0.f ? t : -t;
+
+                float scale   = max / std::sqrt(x * x + y * y + z * z);
+                components[0] = RoundToInt<T>(x * scale);
+                components[1] = RoundToInt<T>(y * scale);
+                components[2] = RoundToInt<T>(z * scale);
+                memcpy(data + i * sizeof(components), components, sizeof(components));
+            }
+        }
+
+        void DecodeFilterQuaternion(uint8_t* data, size_t count)
+        {
+            const float scale = 1.f / std::sqrt(2.f);
+            for(size_t i = 0; i < count; i++)
+            {
+                int16_t components[4];
+                memcpy(components, data + i * sizeof(components), sizeof(components));
+
+                // The fourth component holds the scale (high bits) and the index of the largest component (low 2 bits)
+                float componentScale = scale / (float)(components[3] | 3);
+                float x              = (float)components[0] * componentScale;
+                float y              = (float)components[1] * componentScale;
+                float z              = (float)components[2] * componentScale;
+                float w              = std::sqrt(std::max(1.f - x * x - y * y - z * z, 0.f));
+
+                int32_t largest                   = components[3] & 3;
+                int16_t result[4]                 = {};
+                result[(largest + 1) & 3]         = RoundToInt<int16_t>(x * 32767.f);
+                result[(largest + 2) & 3]         = RoundToInt<int16_t>(y * 32767.f);
+                result[(largest + 3) & 3]         = RoundToInt<int16_t>(z * 32767.f);
+                result[largest]                   = RoundToInt<int16_t>(w * 32767.f);
+                memcpy(data + i * sizeof(result), result, sizeof(result));
+            }
+        }
+
+        void DecodeFilterExponential(uint8_t* data, size_t count)
+        {
+            for(size_t i = 0; i < count; i++)
+            {
+                uint32_t value;
+                memcpy(&value, data + i * 4, 4);
+
+                // ldexp(mantissa, exponent) by constructing 2^exponent directly
+                int32_t  mantissa = (int32_t)(value << 8) >> 8;
+                int32_t  exponent = (int32_t)value >> 24;
+                uint32_t powerBits = (uint32_t)(exponent + 127) << 23;
+                float    power;
+                memcpy(&power, &powerBits, 4);
+                float result = power * (float)mantissa;
+                memcpy(data + i * 4, &result, 4);
+            }
+        }
+    }  // namespace
+
+    bool MeshoptDecoder::DecodeVertexBuffer(uint8_t* out, size_t count, size_t byteStride, const uint8_t* data, size_t size)
+    {
+        if(byteStride == 0 || byteStride > 256 || byteStride % 4 != 0 || size < 1 + byteStride || (data[0] & 0xf0) != VERTEX_HEADER || (data[0] & 0x0f) > 0)
+        {
+            return false;
+        }
+        const uint8_t* end = data + size;
+        data++;
+
+        uint8_t lastVertex[256];
+        memcpy(lastVertex, end - byteStride, byteStride);
+
+        size_t blockSize = GetVertexBlockSize(byteStride);
+        for(size_t offset = 0; offset < count; offset += blockSize)
+        {
+            data = DecodeVertexBlock(data, end, out + offset * byteStride, std::min(blockSize, count - offset), byteStride, lastVertex);
+            if(!data)
+            {
+                return false;
+            }
+        }
+        return (size_t)(end - data) == std::max(byteStride, TAIL_MIN_SIZE);
+    }
+
+    bool MeshoptDecoder::DecodeIndexBuffer(uint8_t* out, size_t count, size_t byteStride, const uint8_t* data, size_t size)
+    {
+        // Header, one code byte per triangle and the 16 byte codeaux table at the end
+        if(count % 3 != 0 || (byteStride != 2 && byteStride != 4) || size < 1 + count / 3 + 16 || (data[0] & 0xf0) != INDEX_HEADER || (data[0] & 0x0f) > 1)
+        {
+            return false;
+        }
+        int32_t        version     = data[0] & 0x0f;
+        int32_t        fecMax      = version >= 1 ? 13 : 15;
+        const uint8_t* codes       = data + 1;
+        const uint8_t* values      = codes + count / 3;
+        const uint8_t* valuesEnd   = data + size - 16;
+        const uint8_t* codeauxTable = valuesEnd;
+
+        IndexFifos fifos;
+        uint32_t   next = 0;
+        uint32_t   last = 0;
+        for(size_t i = 0; i < count; i += 3)
+        {
+            // A triangle reads at most 16 bytes (codeaux byte and three 5 byte varints), which the codeaux table guarantees to be readable
+            if(values > valuesEnd)
+            {
+                return false;
+            }
+
+            uint8_t  code = *codes++;
+            uint32_t a, b, c;
+            if(code < 0xf0)
+            {
+                // Edge from the FIFO plus a new, cached or free third vertex
+                int32_t fe = code >> 4;
+                a          = fifos.Edges[(fifos.EdgeOffset - 1 - fe) & 15][0];
+                b          = fifos.Edges[(fifos.EdgeOffset - 1 - fe) & 15][1];
+
+                int32_t fec = code & 15;
+                if(fec < fecMax)
+                {
+                    c = fec == 0 ? next++ : fifos.Vertices[(fifos.VertexOffset - 1 - fec) & 15];
+                    fifos.PushVertex(c, fec == 0);
+                }
+                else
+                {
+                    // 13 and 14 are deltas of -1 and 1 to the last free index
+                    last = c = fec != 15 ? last + (fec - (fec ^ 3)) : DecodeIndex(values, last);
+                    fifos.PushVertex(c);
+                }
+                fifos.PushEdge(c, b);
+                fifos.PushEdge(a, c);
+            }
+            else
+            {
+                // Triangle without cached edge
+                int32_t fea, feb, fec;
+                if(code < 0xfe)
+                {
+                    uint8_t codeaux = codeauxTable[code & 15];
+                    fea             = 0;
+                    feb             = codeaux >> 4;
+                    fec             = codeaux & 15;
+                }
+                else
+                {
+                    uint8_t codeaux = *values++;
+                    fea             = code == 0xfe ? 0 : 15;
+                    feb             = codeaux >> 4;
+                    fec             = codeaux & 15;
+                    if(codeaux == 0)
+                    {
+                        next = 0;
+                    }
+                }
+
+                // next is incremented for all three vertices before free indices are decoded, matching the encoder
+                a = fea == 0 ? next++ : 0;
+                b = feb == 0 ? next++ : fifos.Vertices[(fifos.VertexOffset - feb) & 15];
+                c = fec == 0 ? next++ : fifos.Vertices[(fifos.VertexOffset - fec) & 15];
+                if(fea == 15)
+                {
+                    last = a = DecodeIndex(values, last);
+                }
+                if(feb == 15)
+                {
+                    last = b = DecodeIndex(values, last);
+                }
+                if(fec == 15)
+                {
+                    last = c = DecodeIndex(values, last);
+                }
+
+                fifos.PushVertex(a);
+                fifos.PushVertex(b, feb == 0 || feb == 15);
+                fifos.PushVertex(c, fec == 0 || fec == 15);
+                fifos.PushEdge(b, a);
+                fifos.PushEdge(c, b);
+                fifos.PushEdge(a, c);
+            }
+            WriteIndex(out, i + 0, byteStride, a);
+            WriteIndex(out, i + 1, byteStride, b);
+            WriteIndex(out, i + 2, byteStride, c);
+        }
+        return values == valuesEnd;
+    }
+
+    bool MeshoptDecoder::DecodeIndexSequence(uint8_t* out, size_t count, size_t byteStride, const uint8_t* data, size_t size)
+    {
+        // Header, at least one byte per index and a 4 byte tail
+        if((byteStride != 2 && byteStride != 4) || size < 1 + count + 4 || (data[0] & 0xf0) != SEQUENCE_HEADER || (data[0] & 0x0f) > 1)
+        {
+            return false;
+        }
+        const uint8_t* values    = data + 1;
+        const uint8_t* valuesEnd = data + size - 4;
+
+        // Every index is a zigzag encoded delta to one of two baselines, selected by the lowest bit
+        uint32_t last[2] = {};
+        for(size_t i = 0; i < count; i++)
+        {
+            // An index reads at most 5 bytes, which the tail guarantees to be readable
+            if(values >= valuesEnd)
+            {
+                return false;
+            }
+            uint32_t value    = DecodeVByte(values);
+            uint32_t baseline = value & 1;
+            value >>= 1;
+            uint32_t index = last[baseline] + ((value >> 1) ^ (uint32_t)(-(int32_t)(value & 1)));
+            last[baseline] = index;
+            WriteIndex(out, i, byteStride, index);
+        }
+        return values == valuesEnd;
+    }
+
+    bool MeshoptDecoder::ApplyFilter(EFilter filter, uint8_t* data, size_t count, size_t byteStride)
+    {
+        switch(filter)
+        {
+            case EFilter::None:
+                return true;
+            case EFilter::Octahedral:
+                if(byteStride == 4)
+                {
+                    DecodeFilterOctahedral<int8_t>(data, count);
+                    return true;
+                }
+                if(byteStride == 8)
+                {
+                    DecodeFilterOctahedral<int16_t>(data, count);
+                    return true;
+                }
+                return false;
+            case EFilter::Quaternion:
+                if(byteStride != 8)
+                {
+                    return false;
+                }
+                DecodeFilterQuaternion(data, count);
+                return true;
+            case EFilter::Exponential:
+                if(byteStride % 4 != 0)
+                {
+                    return false;
+                }
+                DecodeFilterExponential(data, count * byteStride / 4);
+                return true;
+        }
+        return false;
+    }
+
+    bool MeshoptDecoder::Decode(EMode mode, EFilter filter, uint8_t* out, size_t count, size_t byteStride, const uint8_t* data, size_t size)
+    {
+        switch(mode)
+        {
+            case EMode::Attributes:
+                return DecodeVertexBuffer(out, count, byteStride, data, size) && ApplyFilter(filter, out, count, byteStride);
+            case EMode::Triangles:
+                return filter == EFilter::None && DecodeIndexBuffer(out, count, byteStride, data, size);
+            case EMode::Indices:
+                return filter == EFilter::None && DecodeIndexSequence(out, count, byteStride, data, size);
+        }
+        return false;
+    }
+}  // namespace hsk
\ No newline at end of file
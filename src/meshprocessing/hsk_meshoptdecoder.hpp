@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace hsk {
+
+    /// @brief Decoders for buffer views compressed with EXT_meshopt_compression (https://github.com/KhronosGroup/glTF/tree/main/extensions/2.0/Vendor/EXT_meshopt_compression)
+    /// @remark All decoders validate the input size before reading, malformed input is reported by returning false (out is left in an undefined state).
+    class MeshoptDecoder
+    {
+      public:
+        /// @brief Compression mode of a buffer view
+        enum class EMode
+        {
+            /// @brief Vertex attribute codec: Byte wise deltas, transposed and bit packed in blocks
+            Attributes,
+            /// @brief Index codec for triangle lists, edge and vertex FIFO based
+            Triangles,
+            /// @brief Index sequence codec for arbitrary index data
+            Indices
+        };
+
+        /// @brief Filter applied to attribute data after decoding
+        enum class EFilter
+        {
+            None,
+            /// @brief Octahedral encoded normals / tangents, 4 (int8) or 8 (int16) bytes per element
+            Octahedral,
+            /// @brief Quaternions with the largest component reconstructed, 8 bytes (int16) per element
+            Quaternion,
+            /// @brief Float components stored as 24 bit mantissa and 8 bit exponent
+            Exponential
+        };
+
+        /// @brief Decodes a vertex attribute stream
+        /// @param out Receives count * byteStride bytes
+        /// @param byteStride Multiple of 4, at most 256
+        static bool DecodeVertexBuffer(uint8_t* out, size_t count, size_t byteStride, const uint8_t* data, size_t size);
+
+        /// @brief Decodes a triangle list index buffer
+        /// @param out Receives count indices of byteStride (2 or 4) bytes
+        /// @param count Multiple of 3
+        static bool DecodeIndexBuffer(uint8_t* out, size_t count, size_t byteStride, const uint8_t* data, size_t size);
+
+        /// @brief Decodes an index sequence
+        /// @param out Receives count indices of byteStride (2 or 4) bytes
+        static bool DecodeIndexSequence(uint8_t* out, size_t count, size_t byteStride, const uint8_t* data, size_t size);
+
+        /// @brief Reverts a filter in place
+        /// @param data count elements of byteStride bytes, as decoded by DecodeVertexBuffer()
+        /// @return False if filter does not support byteStride
+        static bool ApplyFilter(EFilter filter, uint8_t* data, size_t count, size_t byteStride);
+
+        /// @brief Decodes a compressed buffer view of any mode and applies its filter
+        /// @param out Receives count * byteStride bytes
+        static bool Decode(EMode mode, EFilter filter, uint8_t* out, size_t count, size_t byteStride, const uint8_t* data, size_t size);
+    };
+}  // namespace hsk
\ No newline at end of file
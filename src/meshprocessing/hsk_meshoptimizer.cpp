@@ -0,0 +1,448 @@
+#include "hsk_meshoptimizer.hpp"
+#include "../utility/hsk_hash.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace hsk {
+    VertexCacheStats MeshOptimizer::AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+    {
+        VertexCacheStats stats;
+        stats.TriangleCount = (uint32_t)(indexCount / 3);
+
+        // A vertex is in the cache if it has been inserted within the last cacheSize insertions
+        std::vector<uint32_t> insertedAt(vertexCount, 0);
+        uint32_t              timestamp = cacheSize + 1;
+        std::vector<bool>     referenced(vertexCount, false);
+
+        for(size_t i = 0; i < stats.TriangleCount * 3; i++)
+        {
+            uint32_t index = indices[i];
+            if(!referenced[index])
+            {
+                referenced[index] = true;
+                stats.VertexCount++;
+            }
+            if(timestamp - insertedAt[index] > cacheSize)
+            {
+                insertedAt[index] = timestamp++;
+                stats.TransformedVertices++;
+            }
+        }
+        return stats;
+    }
+
+    namespace {
+        constexpr uint32_t FORSYTH_CACHE_SIZE = 32;
+
+        float ScoreVertex(int32_t cachePosition, uint32_t remainingTriangles)
+        {
+            if(!remainingTriangles)
+            {
+                // No triangle left to draw, the vertex must not attract triangles
+                return -1.f;
+            }
+            float score = 0.f;
+            if(cachePosition >= 0)
+            {
+                if(cachePosition < 3)
+                {
+                    // Used by the last triangle. Fixed score, so the algorithm doesn't favour continuing strips with the same vertices
+                    score = 0.75f;
+                }
+                else
+                {
+                    score = powf(1.f - (float)(cachePosition - 3) / (float)(FORSYTH_CACHE_SIZE - 3), 1.5f);
+                }
+            }
+            // Vertices with few triangles left are preferred, so lone triangles are not left behind
+            score += 2.f / sqrtf((float)remainingTriangles);
+            return score;
+        }
+    }  // namespace
+
+    void MeshOptimizer::OptimizeVertexCache(uint32_t* indices, size_t indexCount, uint32_t vertexCount)
+    {
+        size_t triangleCount = indexCount / 3;
+        if(triangleCount < 2)
+        {
+            return;
+        }
+
+        std::vector<uint32_t> source(indices, indices + triangleCount * 3);
+
+        // Vertex -> triangle adjacency. The first remainingTriangles[v] entries of each vertex's range are the triangles not yet emitted
+        std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+        for(uint32_t index : source)
+        {
+            remainingTriangles[index]++;
+        }
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+        for(uint32_t v = 0; v < vertexCount; v++)
+        {
+            adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remainingTriangles[v];
+        }
+        std::vector<uint32_t> adjacency(source.size());
+        {
+            std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for(size_t i = 0; i < source.size(); i++)
+            {
+                adjacency[fill[source[i]]++] = (uint32_t)(i / 3);
+            }
+        }
+
+        std::vector<int32_t> cachePositions(vertexCount, -1);
+        std::vector<float>   vertexScores(vertexCount);
+        for(uint32_t v = 0; v < vertexCount; v++)
+        {
+            vertexScores[v] = ScoreVertex(-1, remainingTriangles[v]);
+        }
+
+        std::vector<float> triangleScores(triangleCount);
+        std::vector<bool>  emitted(triangleCount, false);
+        int64_t            bestTriangle = -1;
+        float              bestScore    = -std::numeric_limits<float>::infinity();
+        for(size_t t = 0; t < triangleCount; t++)
+        {
+            triangleScores[t] = vertexScores[source[t * 3]] + vertexScores[source[t * 3 + 1]] + vertexScores[source[t * 3 + 2]];
+            if(triangleScores[t] > bestScore)
+            {
+                bestScore    = triangleScores[t];
+                bestTriangle = (int64_t)t;
+            }
+        }
+
+        // The cache holds up to 3 entries more than its size while updating
+        uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+        uint32_t cacheCount = 0;
+        uint32_t newCache[FORSYTH_CACHE_SIZE + 3];
+
+        size_t outIndex       = 0;
+        size_t fallbackCursor = 0;
+        while(outIndex < triangleCount * 3)
+        {
+            if(bestTriangle < 0)
+            {
+                // Dead end: No triangle shares a vertex with the cache, continue with the first triangle not yet emitted
+                while(fallbackCursor < triangleCount && emitted[fallbackCursor])
+                {
+                    fallbackCursor++;
+                }
+                bestTriangle = (int64_t)fallbackCursor;
+            }
+
+            const uint32_t* triangle = &source[bestTriangle * 3];
+            emitted[bestTriangle]    = true;
+
+            uint32_t newCacheCount = 0;
+            for(uint32_t k = 0; k < 3; k++)
+            {
+                uint32_t v                = triangle[k];
+                indices[outIndex++]       = v;
+                newCache[newCacheCount++] = v;
+
+                // Remove the triangle from the vertex's remaining triangles
+                uint32_t* begin = &adjacency[adjacencyOffsets[v]];
+                uint32_t* end   = begin + remainingTriangles[v];
+                uint32_t* found = std::find(begin, end, (uint32_t)bestTriangle);
+                std::swap(*found, *(end - 1));
+                remainingTriangles[v]--;
+            }
+            for(uint32_t i = 0; i < cacheCount; i++)
+            {
+                uint32_t v = cache[i];
+                if(v != triangle[0] && v != triangle[1] && v != triangle[2])
+                {
+                    newCache[newCacheCount++] = v;
+                }
+            }
+
+            // Update scores of all vertices which were or are in the cache. Vertices beyond the cache size dropped out.
+            for(uint32_t i = 0; i < newCacheCount; i++)
+            {
+                uint32_t v        = newCache[i];
+                cachePositions[v] = i < FORSYTH_CACHE_SIZE ? (int32_t)i : -1;
+                vertexScores[v]   = ScoreVertex(cachePositions[v], remainingTriangles[v]);
+            }
+
+            // Rescore triangles touching updated vertices and select the next triangle among them
+            bestTriangle = -1;
+            bestScore    = -std::numeric_limits<float>::infinity();
+            for(uint32_t i = 0; i < newCacheCount; i++)
+            {
+                uint32_t v     = newCache[i];
+                uint32_t begin = adjacencyOffsets[v];
+                for(uint32_t j = begin; j < begin + remainingTriangles[v]; j++)
+                {
+                    uint32_t t        = adjacency[j];
+                    float    score    = vertexScores[source[t * 3]] + vertexScores[source[t * 3 + 1]] + vertexScores[source[t * 3 + 2]];
+                    triangleScores[t] = score;
+                    if(score > bestScore)
+                    {
+                        bestScore    = score;
+                        bestTriangle = (int64_t)t;
+                    }
+                }
+            }
+
+            cacheCount = std::min(newCacheCount, FORSYTH_CACHE_SIZE);
+            std::copy(newCache, newCache + cacheCount, cache);
+        }
+    }
+
+    void MeshOptimizer::OptimizeOverdraw(uint32_t* indices, size_t indexCount, const float* positions, size_t positionStride, uint32_t vertexCount, float threshold)
+    {
+        const uint32_t cacheSize     = 16;
+        size_t         triangleCount = indexCount / 3;
+        if(triangleCount < 2)
+        {
+            return;
+        }
+
+        auto lGetPosition = [positions, positionStride](uint32_t index) {
+            return reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(positions) + index * positionStride);
+        };
+
+        // Cache misses per triangle of the current order
+        std::vector<uint32_t> misses(triangleCount, 0);
+        {
+            std::vector<uint32_t> insertedAt(vertexCount, 0);
+            uint32_t              timestamp = cacheSize + 1;
+            for(size_t t = 0; t < triangleCount; t++)
+            {
+                for(uint32_t k = 0; k < 3; k++)
+                {
+                    uint32_t index = indices[t * 3 + k];
+                    if(timestamp - insertedAt[index] > cacheSize)
+                    {
+                        insertedAt[index] = timestamp++;
+                        misses[t]++;
+                    }
+                }
+            }
+        }
+
+        // Hard boundaries: Triangles with 3 misses start over with a cold cache, reordering there doesn't cost cache efficiency
+        std::vector<uint32_t> clusterStarts;
+        for(size_t t = 0; t < triangleCount; t++)
+        {
+            if(t == 0 || misses[t] == 3)
+            {
+                clusterStarts.push_back((uint32_t)t);
+            }
+        }
+        clusterStarts.push_back((uint32_t)triangleCount);
+
+        // Soft boundaries: Split hard clusters wherever the cluster so far, drawn starting with a cold cache, stays within threshold of the hard cluster's ACMR.
+        // Since every cluster is simulated cold, the ACMR of any cluster order stays within the threshold.
+        std::vector<uint32_t> softStarts;
+        std::vector<uint32_t> insertedAt(vertexCount, 0);
+        uint32_t              timestamp = cacheSize + 1;
+        for(size_t c = 0; c + 1 < clusterStarts.size(); c++)
+        {
+            uint32_t start = clusterStarts[c];
+            uint32_t end   = clusterStarts[c + 1];
+
+            uint32_t clusterMisses = 0;
+            for(uint32_t t = start; t < end; t++)
+            {
+                clusterMisses += misses[t];
+            }
+            float targetAcmr = (float)clusterMisses / (float)(end - start) * threshold;
+
+            softStarts.push_back(start);
+            uint32_t runningMisses = 0;
+            uint32_t runningStart  = start;
+            timestamp += cacheSize + 1;
+            for(uint32_t t = start; t < end; t++)
+            {
+                for(uint32_t k = 0; k < 3; k++)
+                {
+                    uint32_t index = indices[t * 3 + k];
+                    if(timestamp - insertedAt[index] > cacheSize)
+                    {
+                        insertedAt[index] = timestamp++;
+                        runningMisses++;
+                    }
+                }
+                if(t + 1 < end && (float)runningMisses / (float)(t + 1 - runningStart) <= targetAcmr)
+                {
+                    softStarts.push_back(t + 1);
+                    runningStart  = t + 1;
+                    runningMisses = 0;
+                    // Next cluster starts with a cold cache
+                    timestamp += cacheSize + 1;
+                }
+            }
+        }
+        softStarts.push_back((uint32_t)triangleCount);
+
+        size_t clusterCount = softStarts.size() - 1;
+        if(clusterCount < 2)
+        {
+            return;
+        }
+
+        // Area weighted centroid of the whole mesh
+        float meshCentroid[3] = {};
+        float meshArea        = 0.f;
+        struct Cluster
+        {
+            float    Centroid[3] = {};
+            float    Normal[3]   = {};
+            float    Area        = 0.f;
+            float    SortKey     = 0.f;
+            uint32_t Start       = 0;
+            uint32_t End         = 0;
+        };
+        std::vector<Cluster> clusters(clusterCount);
+        for(size_t c = 0; c < clusterCount; c++)
+        {
+            Cluster& cluster = clusters[c];
+            cluster.Start    = softStarts[c];
+            cluster.End      = softStarts[c + 1];
+            for(uint32_t t = cluster.Start; t < cluster.End; t++)
+            {
+                const float* p0 = lGetPosition(indices[t * 3]);
+                const float* p1 = lGetPosition(indices[t * 3 + 1]);
+                const float* p2 = lGetPosition(indices[t * 3 + 2]);
+
+                float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+                float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+                // Length of the cross product is twice the triangle area, so summing it yields an area weighted normal
+                float normal[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+                float area      = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+                for(uint32_t k = 0; k < 3; k++)
+                {
+                    cluster.Normal[k] += normal[k];
+                    cluster.Centroid[k] += (p0[k] + p1[k] + p2[k]) / 3.f * area;
+                }
+                cluster.Area += area;
+            }
+            for(uint32_t k = 0; k < 3; k++)
+            {
+                meshCentroid[k] += cluster.Centroid[k];
+                cluster.Centroid[k] = cluster.Area > 0.f ? cluster.Centroid[k] / cluster.Area : 0.f;
+            }
+            meshArea += cluster.Area;
+        }
+        for(uint32_t k = 0; k < 3; k++)
+        {
+            meshCentroid[k] = meshArea > 0.f ? meshCentroid[k] / meshArea : 0.f;
+        }
+
+        // Clusters facing away from the mesh center are likely to occlude other clusters, so they are drawn first
+        for(Cluster& cluster : clusters)
+        {
+            float normalLength = sqrtf(cluster.Normal[0] * cluster.Normal[0] + cluster.Normal[1] * cluster.Normal[1] + cluster.Normal[2] * cluster.Normal[2]);
+            float key          = 0.f;
+            for(uint32_t k = 0; k < 3; k++)
+            {
+                key += (cluster.Centroid[k] - meshCentroid[k]) * (normalLength > 0.f ? cluster.Normal[k] / normalLength : 0.f);
+            }
+            cluster.SortKey = key;
+        }
+        std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) { return a.SortKey > b.SortKey; });
+
+        std::vector<uint32_t> source(indices, indices + triangleCount * 3);
+        size_t                outIndex = 0;
+        for(const Cluster& cluster : clusters)
+        {
+            for(uint32_t i = cluster.Start * 3; i < cluster.End * 3; i++)
+            {
+                indices[outIndex++] = source[i];
+            }
+        }
+    }
+
+    uint32_t MeshOptimizer::BuildVertexFetchRemap(std::vector<uint32_t>& outremap, const uint32_t* indices, size_t indexCount, uint32_t vertexCount)
+    {
+        const uint32_t unassigned = std::numeric_limits<uint32_t>::max();
+        outremap.assign(vertexCount, unassigned);
+
+        uint32_t next = 0;
+        for(size_t i = 0; i < indexCount; i++)
+        {
+            uint32_t index = indices[i];
+            if(outremap[index] == unassigned)
+            {
+                outremap[index] = next++;
+            }
+        }
+        uint32_t referencedCount = next;
+        for(uint32_t v = 0; v < vertexCount; v++)
+        {
+            if(outremap[v] == unassigned)
+            {
+                outremap[v] = next++;
+            }
+        }
+        return referencedCount;
+    }
+
+    uint32_t MeshOptimizer::BuildWeldRemap(std::vector<uint32_t>& outremap,
+                                           const void*            vertices,
+                                           size_t                 vertexSize,
+                                           size_t                 vertexStride,
+                                           uint32_t               vertexCount,
+                                           const void*            extra,
+                                           size_t                 extraSize,
+                                           size_t                 extraStride)
+    {
+        const uint8_t* vertexBytes = reinterpret_cast<const uint8_t*>(vertices);
+        const uint8_t* extraBytes  = reinterpret_cast<const uint8_t*>(extra);
+
+        auto lHash = [&](uint32_t index) {
+            uint64_t hash = HashBytes(vertexBytes + index * vertexStride, vertexSize);
+            if(extraBytes)
+            {
+                hash = HashBytes(extraBytes + index * extraStride, extraSize, hash);
+            }
+            return hash;
+        };
+        auto lEqual = [&](uint32_t a, uint32_t b) {
+            return memcmp(vertexBytes + a * vertexStride, vertexBytes + b * vertexStride, vertexSize) == 0
+                   && (!extraBytes || memcmp(extraBytes + a * extraStride, extraBytes + b * extraStride, extraSize) == 0);
+        };
+
+        // Open addressing hash table of unique vertex indices, at most half full
+        const uint32_t        empty     = std::numeric_limits<uint32_t>::max();
+        size_t                tableSize = 16;
+        while(tableSize < (size_t)vertexCount * 2)
+        {
+            tableSize *= 2;
+        }
+        std::vector<uint32_t> table(tableSize, empty);
+
+        outremap.resize(vertexCount);
+        uint32_t uniqueCount = 0;
+        for(uint32_t v = 0; v < vertexCount; v++)
+        {
+            size_t slot = (size_t)lHash(v) & (tableSize - 1);
+            while(table[slot] != empty && !lEqual(table[slot], v))
+            {
+                slot = (slot + 1) & (tableSize - 1);
+            }
+            if(table[slot] == empty)
+            {
+                table[slot] = v;
+                outremap[v] = uniqueCount++;
+            }
+            else
+            {
+                outremap[v] = outremap[table[slot]];
+            }
+        }
+        return uniqueCount;
+    }
+
+    void MeshOptimizer::RemapIndices(uint32_t* indices, size_t indexCount, const std::vector<uint32_t>& remap)
+    {
+        for(size_t i = 0; i < indexCount; i++)
+        {
+            indices[i] = remap[indices[i]];
+        }
+    }
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hsk {
+
+    /// @brief Post-transform vertex cache efficiency of a triangle list
+    struct VertexCacheStats
+    {
+        uint32_t TriangleCount = 0;
+        /// @brief Number of distinct vertices referenced by the triangles
+        uint32_t VertexCount = 0;
+        /// @brief Number of vertex shader invocations (FIFO cache misses)
+        uint32_t TransformedVertices = 0;
+
+        /// @brief Average cache miss ratio: Vertex shader invocations per triangle (0.5 optimal for large regular meshes, 3 worst)
+        inline float GetAcmr() const { return TriangleCount ? (float)TransformedVertices / (float)TriangleCount : 0.f; }
+        /// @brief Average transform to vertex ratio: Vertex shader invocations per referenced vertex (1 optimal)
+        inline float GetAtvr() const { return VertexCount ? (float)TransformedVertices / (float)VertexCount : 0.f; }
+
+        inline VertexCacheStats& operator+=(const VertexCacheStats& other)
+        {
+            TriangleCount += other.TriangleCount;
+            VertexCount += other.VertexCount;
+            TransformedVertices += other.TransformedVertices;
+            return *this;
+        }
+    };
+
+    /// @brief Index buffer post processing for triangle lists. All functions operate on primitive local indices in [0, vertexCount).
+    class MeshOptimizer
+    {
+      public:
+        /// @brief Simulates a FIFO post-transform vertex cache
+        /// @param cacheSize Number of cache entries. 16 approximates common desktop hardware
+        static VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize = 16);
+
+        /// @brief Reorders triangles for post-transform vertex cache locality (Tom Forsyth, "Linear-Speed Vertex Cache Optimisation")
+        static void OptimizeVertexCache(uint32_t* indices, size_t indexCount, uint32_t vertexCount);
+
+        /// @brief Reorders clusters of triangles so that outward facing clusters are drawn first, reducing overdraw.
+        /// Expects indices already optimized by OptimizeVertexCache. Clusters are split at vertex cache flushes and where the running ACMR stays within threshold of the original ACMR
+        /// (Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw").
+        /// @param positions First position, 3 floats
+        /// @param positionStride Distance between positions in bytes
+        /// @param threshold Allowed ACMR increase (1.05 = 5%)
+        static void OptimizeOverdraw(
+            uint32_t* indices, size_t indexCount, const float* positions, size_t positionStride, uint32_t vertexCount, float threshold = 1.05f);
+
+        /// @brief Builds a vertex remap table ordering vertices by first use in indices. Unreferenced vertices are moved to the end.
+        /// @param outremap Receives vertexCount entries: outremap[oldIndex] = newIndex
+        /// @return Number of referenced vertices
+        static uint32_t BuildVertexFetchRemap(std::vector<uint32_t>& outremap, const uint32_t* indices, size_t indexCount, uint32_t vertexCount);
+
+        /// @brief Builds a remap table merging bytewise identical vertices. New indices are assigned in order of first occurrence, so remap[i] <= i.
+        /// @param vertices First vertex
+        /// @param vertexSize Number of bytes compared per vertex
+        /// @param vertexStride Distance between vertices in bytes
+        /// @param extra Optional second attribute stream compared alongside (e.g. skin data), nullptr if unused
+        /// @param outremap Receives vertexCount entries: outremap[oldIndex] = newIndex
+        /// @return Number of unique vertices
+        static uint32_t BuildWeldRemap(std::vector<uint32_t>& outremap,
+                                       const void*            vertices,
+                                       size_t                 vertexSize,
+                                       size_t                 vertexStride,
+                                       uint32_t               vertexCount,
+                                       const void*            extra       = nullptr,
+                                       size_t                 extraSize   = 0,
+                                       size_t                 extraStride = 0);
+
+        /// @brief Replaces every index with remap[index]
+        static void RemapIndices(uint32_t* indices, size_t indexCount, const std::vector<uint32_t>& remap);
+
+        /// @brief Moves element i of data to remap[i]
+        template <typename T>
+        static void RemapVertices(T* data, const std::vector<uint32_t>& remap);
+
+        /// @brief Moves element i of data to remap[i] in place, for remap tables with remap[i] <= i (as built by BuildWeldRemap). Elements past the unique count are left unspecified.
+        template <typename T>
+        static void CompactVertices(T* data, const std::vector<uint32_t>& remap);
+    };
+
+    template <typename T>
+    void MeshOptimizer::RemapVertices(T* data, const std::vector<uint32_t>& remap)
+    {
+        std::vector<T> copy(data, data + remap.size());
+        for(size_t i = 0; i < remap.size(); i++)
+        {
+            data[remap[i]] = copy[i];
+        }
+    }
+
+    template <typename T>
+    void MeshOptimizer::CompactVertices(T* data, const std::vector<uint32_t>& remap)
+    {
+        for(size_t i = 0; i < remap.size(); i++)
+        {
+            if(remap[i] != i)
+            {
+                data[remap[i]] = data[i];
+            }
+        }
+    }
+}  // namespace hsk
\ No newline at end of file
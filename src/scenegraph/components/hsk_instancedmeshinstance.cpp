@@ -0,0 +1,18 @@
+#include "hsk_instancedmeshinstance.hpp"
+#include "../globalcomponents/hsk_geometrystore.hpp"
+#include "../hsk_node.hpp"
+#include "hsk_transform.hpp"
+
+namespace hsk {
+    void InstancedMeshInstance::Draw(SceneDrawInfo& drawInfo)
+    {
+        if(mMesh)
+        {
+            const auto& modelWorldMatrix = GetNode()->GetTransform()->GetGlobalMatrix();
+            drawInfo.CmdPushConstant(mInstanceIndex, modelWorldMatrix, mPreviousWorldMatrix);
+            mMesh->CmdDrawInstanced(drawInfo, mInstanceCount, mFirstInstance);
+
+            mPreviousWorldMatrix = modelWorldMatrix;
+        }
+    }
+}  // namespace hsk
\ No newline at end of file
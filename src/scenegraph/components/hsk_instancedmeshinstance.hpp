@@ -0,0 +1,24 @@
+#pragma once
+#include "hsk_meshinstance.hpp"
+
+namespace hsk {
+
+    /// @brief A mesh instance drawing several copies of its mesh with a single draw call per primitive (glTF EXT_mesh_gpu_instancing)
+    /// @remark Copy i is placed by the node's world matrix multiplied with entry FirstInstance + i of the scene's InstanceBuffer. All copies share the InstanceIndex.
+    class InstancedMeshInstance : public MeshInstance
+    {
+      public:
+        inline virtual ~InstancedMeshInstance() {}
+
+        virtual void Draw(SceneDrawInfo& drawInfo) override;
+
+        /// @brief Index of the first transform in the scene's InstanceBuffer
+        HSK_PROPERTY_ALL(FirstInstance)
+        /// @brief Number of copies drawn
+        HSK_PROPERTY_ALL(InstanceCount)
+
+      protected:
+        uint32_t mFirstInstance = 0;
+        uint32_t mInstanceCount = 1;
+    };
+}  // namespace hsk
\ No newline at end of file
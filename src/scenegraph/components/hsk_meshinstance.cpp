@@ -10,7 +10,7 @@ namespace hsk {
         {
             const auto& modelWorldMatrix = GetNode()->GetTransform()->GetGlobalMatrix();
             drawInfo.CmdPushConstant(mInstanceIndex, modelWorldMatrix, mPreviousWorldMatrix);
-            mMesh->CmdDraw(drawInfo.RenderInfo.GetCommandBuffer(), drawInfo.CurrentlyBoundGeoBuffers);
+            mMesh->CmdDraw(drawInfo);
             
             mPreviousWorldMatrix = modelWorldMatrix;
         }
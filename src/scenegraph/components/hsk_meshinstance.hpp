@@ -13,9 +13,12 @@ namespace hsk {
 
         HSK_PROPERTY_ALL(InstanceIndex)
         HSK_PROPERTY_ALL(Mesh)
+        HSK_PROPERTY_ALL(MorphWeights)
       protected:
         int32_t   mInstanceIndex       = 0;
         Mesh*     mMesh                = nullptr;
         glm::mat4 mPreviousWorldMatrix = glm::mat4(1);
+        /// @brief Morph target weights (glTF node / mesh weights). Written by animations, applied if the instance is a MorphedMeshInstance
+        std::vector<float> mMorphWeights = {};
     };
 }  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "hsk_morphedmeshinstance.hpp"
+#include "../globalcomponents/hsk_geometrystore.hpp"
+#include "../hsk_morphtargets.hpp"
+#include "../hsk_node.hpp"
+#include "hsk_transform.hpp"
+#include <cstring>
+#include <spdlog/fmt/fmt.h>
+
+namespace hsk {
+    void MorphedMeshInstance::InitDeviceResources(const VkContext* context)
+    {
+        if(!mMesh || !mMesh->GetMorphTargets() || mMorphedVertices[0].Exists())
+        {
+            return;
+        }
+        const MorphTargetSet& morphTargets = *(mMesh->GetMorphTargets());
+
+        mMorphWeights.resize(morphTargets.GetTargetCount(), 0.f);
+        mBlendedVertices = morphTargets.GetBaseVertices();
+        mBlendedWeights.assign(morphTargets.GetTargetCount(), 0.f);
+        morphTargets.Reblend(mBlendedWeights.data(), mMorphWeights.data(), mBlendedVertices.data());
+        mBlendedWeights = mMorphWeights;
+
+        EVertexLayout layout     = mMesh->GetBuffer()->GetVertexLayout();
+        size_t        bufferSize = std::max<size_t>(mBlendedVertices.size(), 1) * GetVertexStride(layout);
+        for(size_t i = 0; i < 2; i++)
+        {
+            mMorphedVertices[i].SetName(fmt::format("Morphed Vertices #{}", i));
+            mMorphedVertices[i].Create(context, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, bufferSize, VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+                                       VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+            mMorphedVertices[i].Map(mMorphedMappings[i]);
+            WriteVertices(layout, mBlendedVertices.data(), mMorphedMappings[i], mBlendedVertices.size());
+            mFrameWeights[i] = mBlendedWeights;
+        }
+    }
+
+    bool MorphedMeshInstance::IsMorphed() const { return mMorphedVertices[0].Exists(); }
+
+    bool MorphedMeshInstance::UpdateMorph(const FrameRenderInfo& renderInfo)
+    {
+        if(!IsMorphed())
+        {
+            return false;
+        }
+        const MorphTargetSet& morphTargets = *(mMesh->GetMorphTargets());
+        size_t                frameIndex   = renderInfo.GetFrameNumber() % 2;
+
+        // Animations may only write existing weights, but guard against external resizes
+        mMorphWeights.resize(morphTargets.GetTargetCount(), 0.f);
+
+        if(mBlendedWeights != mMorphWeights)
+        {
+            morphTargets.Reblend(mBlendedWeights.data(), mMorphWeights.data(), mBlendedVertices.data());
+            mBlendedWeights = mMorphWeights;
+        }
+        if(mFrameWeights[frameIndex] != mBlendedWeights)
+        {
+            morphTargets.CopyAffected(mFrameWeights[frameIndex].data(), mBlendedWeights.data(), mBlendedVertices.data(), mMorphedMappings[frameIndex],
+                                      mMesh->GetBuffer()->GetVertexLayout());
+            mFrameWeights[frameIndex] = mBlendedWeights;
+        }
+        return true;
+    }
+
+    void MorphedMeshInstance::Draw(SceneDrawInfo& drawInfo)
+    {
+        if(!IsMorphed())
+        {
+            MeshInstance::Draw(drawInfo);
+            return;
+        }
+        const auto& modelWorldMatrix = GetNode()->GetTransform()->GetGlobalMatrix();
+        drawInfo.CmdPushConstant(mInstanceIndex, modelWorldMatrix, mPreviousWorldMatrix);
+        VkBuffer vertexBuffer = mMorphedVertices[drawInfo.RenderInfo.GetFrameNumber()].GetBuffer();
+        mMesh->CmdDrawDeformed(drawInfo, vertexBuffer);
+
+        mPreviousWorldMatrix = modelWorldMatrix;
+    }
+
+    void MorphedMeshInstance::Cleanup()
+    {
+        for(size_t i = 0; i < 2; i++)
+        {
+            if(mMorphedVertices[i].GetIsMapped())
+            {
+                mMorphedVertices[i].Unmap();
+            }
+            mMorphedMappings[i] = nullptr;
+            mFrameWeights[i].clear();
+        }
+        mMorphedVertices.Cleanup();
+        mBlendedVertices.clear();
+        mBlendedWeights.clear();
+    }
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#include "../../memory/hsk_managedbuffer.hpp"
+#include "../../utility/hsk_framerotator.hpp"
+#include "../hsk_geo.hpp"
+#include "hsk_meshinstance.hpp"
+
+namespace hsk {
+
+    /// @brief A mesh instance deformed by the morph targets of its mesh, weighted by MorphWeights.
+    /// @remark Blending happens on the CPU into a working copy of the mesh's vertex range. Only vertices displaced by targets with a non-zero weight are touched,
+    /// and only these are copied into the host visible vertex buffer of the current frame (one per frame in flight). Blending is recorded by SkinningStage.
+    class MorphedMeshInstance : public MeshInstance
+    {
+      public:
+        inline virtual ~MorphedMeshInstance() { MorphedMeshInstance::Cleanup(); }
+
+        virtual void Draw(SceneDrawInfo& drawInfo) override;
+
+        /// @brief Creates the per frame morphed vertex buffers. Does nothing if the mesh has no morph targets.
+        virtual void InitDeviceResources(const VkContext* context);
+
+        /// @brief Applies the current MorphWeights to the morphed vertex buffer of the frame. Does nothing if the weights are unchanged.
+        /// @return True if the morphed vertex buffer of the frame is in use (the mesh has morph targets)
+        bool UpdateMorph(const FrameRenderInfo& renderInfo);
+
+        /// @brief True if the mesh has morph targets and device resources have been created
+        bool IsMorphed() const;
+
+        virtual void Cleanup();
+
+        /// @brief Per frame buffers holding the mesh's vertex range [FirstVertex, FirstVertex + VertexCount) with morph targets applied
+        HSK_PROPERTY_GET(MorphedVertices)
+
+      protected:
+        /// @brief Working copy of the mesh's vertex range, blended with mBlendedWeights
+        std::vector<Vertex>            mBlendedVertices  = {};
+        std::vector<float>             mBlendedWeights   = {};
+        /// @brief Weights the morphed vertex buffer of each frame currently is blended with
+        std::vector<float>             mFrameWeights[2]  = {};
+        FrameRotator<ManagedBuffer, 2> mMorphedVertices  = {};
+        void*                          mMorphedMappings[2] = {};
+    };
+}  // namespace hsk
\ No newline at end of file
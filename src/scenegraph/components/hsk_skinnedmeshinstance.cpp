@@ -0,0 +1,131 @@
+#include "hsk_skinnedmeshinstance.hpp"
+#include "../globalcomponents/hsk_geometrystore.hpp"
+#include "../hsk_node.hpp"
+#include "../hsk_skin.hpp"
+#include "hsk_transform.hpp"
+#include <spdlog/fmt/fmt.h>
+
+namespace hsk {
+    void SkinnedMeshInstance::InitDeviceResources(const VkContext* context)
+    {
+        Assert(mMesh && mSkin, "SkinnedMeshInstance::InitDeviceResources: Mesh and Skin must be set!");
+        GeometryBufferSet* bufferSet = mMesh->GetBuffer();
+        Assert(bufferSet && bufferSet->GetSkinData().Exists(), "SkinnedMeshInstance::InitDeviceResources: Mesh buffer set has no skin data!");
+
+        if(mSkinnedVertices.Exists())
+        {
+            return;
+        }
+
+        MorphedMeshInstance::InitDeviceResources(context);
+
+        size_t paletteSize = std::max<size_t>(mSkin->GetJoints().size(), 1) * sizeof(glm::mat4);
+        for(size_t i = 0; i < 2; i++)
+        {
+            mJointPalettes[i].SetName(fmt::format("Joint Palette #{}", i));
+            mJointPalettes[i].Create(context, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, paletteSize, VmaMemoryUsage::VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+                                     VmaAllocationCreateFlagBits::VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+            mJointPalettes[i].Map(mPaletteMappings[i]);
+        }
+
+        mSkinnedVertices.SetName("Skinned Vertices");
+        mSkinnedVertices.Create(context, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, std::max<size_t>(mMesh->GetVertexCount(), 1) * GetVertexStride(bufferSet->GetVertexLayout()),
+                                VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+
+        // Binding 0: bind pose or morphed vertices (per frame), 1: skin data, 2: joint palette (per frame), 3: skinned vertices
+        std::vector<VkDescriptorBufferInfo> skinDataInfos({bufferSet->GetSkinData().GetVkDescriptorBufferInfo()});
+        std::vector<VkDescriptorBufferInfo> targetInfos({mSkinnedVertices.GetVkDescriptorBufferInfo()});
+
+        auto sourceDescriptor = std::make_shared<DescriptorSetHelper::DescriptorInfo>();
+        sourceDescriptor->Init(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+        if(IsMorphed())
+        {
+            sourceDescriptor->AddDescriptorSet(std::vector<VkDescriptorBufferInfo>({mMorphedVertices[0].GetVkDescriptorBufferInfo()}));
+            sourceDescriptor->AddDescriptorSet(std::vector<VkDescriptorBufferInfo>({mMorphedVertices[1].GetVkDescriptorBufferInfo()}));
+        }
+        else
+        {
+            sourceDescriptor->AddDescriptorSet(std::vector<VkDescriptorBufferInfo>({bufferSet->GetVertices().GetVkDescriptorBufferInfo()}));
+        }
+        auto skinDataDescriptor = std::make_shared<DescriptorSetHelper::DescriptorInfo>();
+        skinDataDescriptor->Init(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, skinDataInfos);
+        auto paletteDescriptor = std::make_shared<DescriptorSetHelper::DescriptorInfo>();
+        paletteDescriptor->Init(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT);
+        paletteDescriptor->AddDescriptorSet(std::vector<VkDescriptorBufferInfo>({mJointPalettes[0].GetVkDescriptorBufferInfo()}));
+        paletteDescriptor->AddDescriptorSet(std::vector<VkDescriptorBufferInfo>({mJointPalettes[1].GetVkDescriptorBufferInfo()}));
+        auto targetDescriptor = std::make_shared<DescriptorSetHelper::DescriptorInfo>();
+        targetDescriptor->Init(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT, targetInfos);
+
+        mDescriptorSet.SetDescriptorInfoAt(0, sourceDescriptor);
+        mDescriptorSet.SetDescriptorInfoAt(1, skinDataDescriptor);
+        mDescriptorSet.SetDescriptorInfoAt(2, paletteDescriptor);
+        mDescriptorSet.SetDescriptorInfoAt(3, targetDescriptor);
+        mDescriptorSet.Create(context, "Skinning_DescriptorSet");
+    }
+
+    bool SkinnedMeshInstance::CmdSkin(const FrameRenderInfo& renderInfo, VkPipelineLayout pipelineLayout)
+    {
+        if(!mSkinnedVertices.Exists() || mLastSkinnedFrame == renderInfo.GetFrameNumber())
+        {
+            return false;
+        }
+        mLastSkinnedFrame = renderInfo.GetFrameNumber();
+
+        size_t frameIndex = renderInfo.GetFrameNumber() % 2;
+
+        mSkin->CalculateJointPalette(GetNode()->GetTransform()->GetGlobalMatrix(), reinterpret_cast<glm::mat4*>(mPaletteMappings[frameIndex]));
+
+        VkCommandBuffer commandBuffer = renderInfo.GetCommandBuffer();
+        const auto&     descriptorSets = mDescriptorSet.GetDescriptorSets();
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &(descriptorSets[frameIndex]), 0, nullptr);
+
+        SkinningPushConstant pushConstant{
+            .FirstVertex       = mMesh->GetFirstVertex(),
+            .SourceFirstVertex = IsMorphed() ? 0 : mMesh->GetFirstVertex(),
+            .VertexCount       = mMesh->GetVertexCount(),
+            .VertexLayout      = (uint32_t)mMesh->GetBuffer()->GetVertexLayout()};
+        vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(SkinningPushConstant), &pushConstant);
+
+        uint32_t groupCount = (pushConstant.VertexCount + SkinningPushConstant::WorkgroupSize - 1) / SkinningPushConstant::WorkgroupSize;
+        vkCmdDispatch(commandBuffer, groupCount, 1, 1);
+
+        mSkinnedOnce = true;
+        return true;
+    }
+
+    void SkinnedMeshInstance::Draw(SceneDrawInfo& drawInfo)
+    {
+        if(!mSkinnedOnce)
+        {
+            // No skinned vertices available yet, fall back to the bind pose (or morphed vertices)
+            MorphedMeshInstance::Draw(drawInfo);
+            return;
+        }
+        if(mMesh)
+        {
+            const auto& modelWorldMatrix = GetNode()->GetTransform()->GetGlobalMatrix();
+            drawInfo.CmdPushConstant(mInstanceIndex, modelWorldMatrix, mPreviousWorldMatrix);
+            mMesh->CmdDrawDeformed(drawInfo, mSkinnedVertices.GetBuffer());
+
+            mPreviousWorldMatrix = modelWorldMatrix;
+        }
+    }
+
+    void SkinnedMeshInstance::Cleanup()
+    {
+        for(size_t i = 0; i < 2; i++)
+        {
+            if(mJointPalettes[i].GetIsMapped())
+            {
+                mJointPalettes[i].Unmap();
+            }
+            mPaletteMappings[i] = nullptr;
+        }
+        mJointPalettes.Cleanup();
+        mSkinnedVertices.Cleanup();
+        mDescriptorSet.Cleanup();
+        mLastSkinnedFrame = UINT64_MAX;
+        mSkinnedOnce      = false;
+        MorphedMeshInstance::Cleanup();
+    }
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+#include "../../memory/hsk_descriptorsethelper.hpp"
+#include "../../memory/hsk_managedbuffer.hpp"
+#include "../../utility/hsk_framerotator.hpp"
+#include "hsk_morphedmeshinstance.hpp"
+
+namespace hsk {
+
+    /// @brief Push constant of the skinning compute shader (shaders/skinning.comp)
+    struct SkinningPushConstant
+    {
+        /// @brief First vertex of the mesh in the buffer set (indexes skin data)
+        uint32_t FirstVertex = 0;
+        /// @brief First vertex of the mesh in the source vertex buffer (equals FirstVertex when skinning the bind pose, 0 when skinning morphed vertices)
+        uint32_t SourceFirstVertex = 0;
+        /// @brief Number of vertices to skin
+        uint32_t VertexCount = 0;
+        /// @brief EVertexLayout of source and target vertices
+        uint32_t VertexLayout = 0;
+
+        inline static constexpr uint32_t WorkgroupSize = 64;
+    };
+
+    /// @brief A mesh instance deformed by a skin. Owns the joint palette (host visible, one per frame in flight) and an output vertex buffer written by the skinning compute pass.
+    /// @remark Skinning is recorded once per frame by SkinningStage, every pass drawing the scene afterwards consumes the skinned vertices.
+    /// If the mesh has morph targets, the morphed vertices (see MorphedMeshInstance) are skinned instead of the bind pose.
+    class SkinnedMeshInstance : public MorphedMeshInstance
+    {
+      public:
+        inline virtual ~SkinnedMeshInstance() { SkinnedMeshInstance::Cleanup(); }
+
+        virtual void Draw(SceneDrawInfo& drawInfo) override;
+
+        /// @brief Creates joint palette buffers, the skinned vertex buffer and the descriptor sets for the skinning compute pass
+        virtual void InitDeviceResources(const VkContext* context) override;
+
+        /// @brief Updates the joint palette of the current frame and records the skinning dispatch. Expects the skinning pipeline to be bound.
+        /// @return False if skinning had already been recorded for this frame (or the instance is not initialized)
+        bool CmdSkin(const FrameRenderInfo& renderInfo, VkPipelineLayout pipelineLayout);
+
+        virtual void Cleanup() override;
+
+        HSK_PROPERTY_ALL(Skin)
+        HSK_PROPERTY_CGET(SkinnedVertices)
+        HSK_PROPERTY_GET(DescriptorSet)
+
+      protected:
+        Skin*                          mSkin                = nullptr;
+        FrameRotator<ManagedBuffer, 2> mJointPalettes       = {};
+        void*                          mPaletteMappings[2]  = {};
+        ManagedBuffer                  mSkinnedVertices     = {};
+        DescriptorSetHelper            mDescriptorSet       = {};
+        uint64_t                       mLastSkinnedFrame    = UINT64_MAX;
+        bool                           mSkinnedOnce         = false;
+    };
+}  // namespace hsk
\ No newline at end of file
@@ -17,18 +17,13 @@ namespace hsk {
         if(!mStatic)
             RecalculateLocalMatrix();
 
-        glm::mat4 parentGlobalMatrix(1);
-        if(!parentTransform)
+        if(!parentTransform && node->GetParent())
         {
-            auto parent = node->GetParent();
-            if(parent)
-            {
-                parentTransform    = parent->GetTransform();
-                parentGlobalMatrix = parentTransform->GetGlobalMatrix();
-            }
+            parentTransform = node->GetParent()->GetTransform();
         }
+        glm::mat4 parentGlobalMatrix = parentTransform ? parentTransform->GetGlobalMatrix() : glm::mat4(1);
 
-        mGlobalMatrix = mLocalMatrix * parentGlobalMatrix;
+        mGlobalMatrix = parentGlobalMatrix * mLocalMatrix;
 
         for(Node* child : node->GetChildren())
         {
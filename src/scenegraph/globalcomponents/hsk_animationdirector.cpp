@@ -1,8 +1,49 @@
 #include "hsk_animationdirector.hpp"
+#include "../components/hsk_transform.hpp"
+#include "../hsk_node.hpp"
 
 namespace hsk {
+    void AnimationDirector::SetViewerPosition(const glm::vec3& position)
+    {
+        mViewerPosition    = position;
+        mHasViewerPosition = true;
+    }
+
+    void AnimationDirector::ClearViewerPosition() { mHasViewerPosition = false; }
+
+    EAnimationUpdateRate AnimationDirector::SelectUpdateRate(const Animation& animation) const
+    {
+        const AnimationUpdatePolicy& policy = animation.GetUpdatePolicy();
+
+        if(policy.PauseWhenCulled && mVisibilityTest && !mVisibilityTest(animation))
+        {
+            return EAnimationUpdateRate::Paused;
+        }
+
+        Node* anchor = animation.GetAnchor();
+        if(!anchor && animation.GetChannels().size())
+        {
+            anchor = animation.GetChannels().front().Target;
+        }
+        if(mHasViewerPosition && anchor)
+        {
+            glm::vec3 anchorPosition = glm::vec3(anchor->GetTransform()->GetGlobalMatrix()[3]);
+            float     distance       = glm::distance(anchorPosition, mViewerPosition);
+            if(distance > policy.PauseDistance)
+            {
+                return EAnimationUpdateRate::Paused;
+            }
+            if(distance > policy.ReducedRateDistance)
+            {
+                return EAnimationUpdateRate::Reduced;
+            }
+        }
+        return EAnimationUpdateRate::Full;
+    }
+
     void AnimationDirector::Update(const FrameUpdateInfo& updateInfo)
     {
+        mStats = {};
         if(mPlaybackConfig.Enable)
         {
             FrameUpdateInfo animationUpdateInfo(updateInfo);
@@ -10,7 +51,21 @@ namespace hsk {
 
             for(auto& animation : mAnimations)
             {
-                animation.Update(animationUpdateInfo);
+                EAnimationUpdateRate rate = SelectUpdateRate(animation);
+                switch(rate)
+                {
+                    case EAnimationUpdateRate::Full:
+                        mStats.FullRateAnimations++;
+                        break;
+                    case EAnimationUpdateRate::Reduced:
+                        mStats.ReducedRateAnimations++;
+                        break;
+                    case EAnimationUpdateRate::Paused:
+                        mStats.PausedAnimations++;
+                        break;
+                }
+                mStats.EvaluatedChannels += animation.Update(animationUpdateInfo, rate);
+                mStats.TotalChannels += static_cast<uint32_t>(animation.GetChannels().size());
             }
         }
     }
@@ -2,19 +2,47 @@
 #include "../../hsk_glm.hpp"
 #include "../hsk_animation.hpp"
 #include "../hsk_component.hpp"
+#include <functional>
 
 namespace hsk {
 
+    /// @brief Counters of the last AnimationDirector::Update call
+    struct AnimationUpdateStats
+    {
+        /// @brief Number of channels whose sampler was evaluated
+        uint32_t EvaluatedChannels = 0;
+        /// @brief Number of channels of all animations
+        uint32_t TotalChannels = 0;
+        uint32_t FullRateAnimations    = 0;
+        uint32_t ReducedRateAnimations = 0;
+        uint32_t PausedAnimations      = 0;
+    };
+
     class AnimationDirector : public GlobalComponent, public Component::UpdateCallback
     {
       public:
         HSK_PROPERTY_ALLGET(Animations)
         HSK_PROPERTY_ALL(PlaybackConfig)
+        /// @brief Optional test reporting whether an animation's targets are visible. Animations failing the test are paused if their policy requests it.
+        HSK_PROPERTY_ALL(VisibilityTest)
+        HSK_PROPERTY_CGET(Stats)
+
+        /// @brief Sets the viewer position used for distance based update rate selection (see AnimationUpdatePolicy)
+        void SetViewerPosition(const glm::vec3& position);
+        /// @brief Disables distance based update rate selection
+        void ClearViewerPosition();
+
+        /// @brief Selects the update rate of an animation based on its policy and the supplied viewer position / visibility test
+        EAnimationUpdateRate SelectUpdateRate(const Animation& animation) const;
 
         virtual void Update(const FrameUpdateInfo&) override;
 
       protected:
-        std::vector<Animation> mAnimations;
-        PlaybackConfig         mPlaybackConfig;
+        std::vector<Animation>                 mAnimations;
+        PlaybackConfig                         mPlaybackConfig;
+        std::function<bool(const Animation&)> mVisibilityTest    = nullptr;
+        glm::vec3                              mViewerPosition    = {};
+        bool                                   mHasViewerPosition = false;
+        AnimationUpdateStats                   mStats             = {};
     };
 }  // namespace hsk
\ No newline at end of file
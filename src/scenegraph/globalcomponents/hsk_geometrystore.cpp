@@ -1,35 +1,103 @@
 #include "hsk_geometrystore.hpp"
 #include "../hsk_scene.hpp"
+#include <algorithm>
 
 namespace hsk {
 
-    void Mesh::CmdDraw(VkCommandBuffer commandBuffer, GeometryBufferSet*& currentlyBoundSet)
+    void Mesh::CmdDraw(SceneDrawInfo& drawInfo)
     {
         if(mBuffer && mPrimitives.size())
         {
-            if(mBuffer != currentlyBoundSet)
+            if(!mBuffer->SharesBindingWith(drawInfo.CurrentlyBoundGeoBuffers))
             {
-                mBuffer->CmdBindBuffers(commandBuffer);
-                currentlyBoundSet = mBuffer;
+                mBuffer->CmdBindBuffers(drawInfo.RenderInfo.GetCommandBuffer());
+                drawInfo.CurrentlyBoundGeoBuffers = mBuffer;
             }
-            for(auto& primitive : mPrimitives)
+            CmdDrawPrimitives(drawInfo, mBuffer->GetVertexOffset());
+        }
+    }
+
+    void Mesh::CmdDrawDeformed(SceneDrawInfo& drawInfo, VkBuffer vertexBuffer)
+    {
+        if(mBuffer && mPrimitives.size() && vertexBuffer)
+        {
+            VkCommandBuffer    commandBuffer = drawInfo.RenderInfo.GetCommandBuffer();
+            const VkDeviceSize offsets[1]    = {0};
+            vkCmdBindVertexBuffers(commandBuffer, 0, 1, &vertexBuffer, offsets);
+            mBuffer->CmdBindIndexBuffer(commandBuffer);
+            // The vertex binding no longer matches any buffer set
+            drawInfo.CurrentlyBoundGeoBuffers = nullptr;
+
+            CmdDrawPrimitives(drawInfo, -(int32_t)mFirstVertex);
+        }
+    }
+
+    void Mesh::CmdDrawInstanced(SceneDrawInfo& drawInfo, uint32_t instanceCount, uint32_t firstInstance)
+    {
+        if(mBuffer && mPrimitives.size() && instanceCount)
+        {
+            if(!mBuffer->SharesBindingWith(drawInfo.CurrentlyBoundGeoBuffers))
+            {
+                mBuffer->CmdBindBuffers(drawInfo.RenderInfo.GetCommandBuffer());
+                drawInfo.CurrentlyBoundGeoBuffers = mBuffer;
+            }
+            CmdDrawPrimitives(drawInfo, mBuffer->GetVertexOffset(), instanceCount, firstInstance);
+        }
+    }
+
+    void Mesh::CmdDrawPrimitives(SceneDrawInfo& drawInfo, int32_t vertexOffset, uint32_t instanceCount, uint32_t firstInstance)
+    {
+        VkCommandBuffer commandBuffer    = drawInfo.RenderInfo.GetCommandBuffer();
+        bool            pushMaterials    = mBuffer->GetVertexLayout() == EVertexLayout::Compact;
+        uint32_t        firstIndexOffset = mBuffer->GetFirstIndexOffset();
+        for(auto& primitive : mPrimitives)
+        {
+            if(pushMaterials)
             {
-                primitive.CmdDraw(commandBuffer);
+                drawInfo.CmdPushMaterialIndex(primitive.MaterialIndex);
             }
+            primitive.CmdDraw(commandBuffer, vertexOffset, firstIndexOffset, instanceCount, firstInstance);
         }
     }
 
+    bool GeometryBufferSet::SharesBindingWith(const GeometryBufferSet* other) const
+    {
+        if(other == this)
+        {
+            return true;
+        }
+        return other && UsesArena() && other->UsesArena() && other->mArena == mArena && other->mArenaAllocation.Page == mArenaAllocation.Page
+               && other->mIndexType == mIndexType;
+    }
+
     bool GeometryBufferSet::CmdBindBuffers(VkCommandBuffer commandBuffer)
     {
+        if(UsesArena())
+        {
+            mArena->CmdBind(commandBuffer, mArenaAllocation.Page, mIndexType);
+            return true;
+        }
         if(mVertices.GetAllocation())
         {
             const VkDeviceSize offsets[1]      = {0};
             VkBuffer           vertexBuffers[] = {mVertices.GetBuffer()};
             vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-            if(mIndices.GetAllocation())
-            {
-                vkCmdBindIndexBuffer(commandBuffer, mIndices.GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
-            }
+            CmdBindIndexBuffer(commandBuffer);
+            return true;
+        }
+        return false;
+    }
+
+    bool GeometryBufferSet::CmdBindIndexBuffer(VkCommandBuffer commandBuffer)
+    {
+        if(UsesArena())
+        {
+            vkCmdBindIndexBuffer(commandBuffer, mArena->GetIndexBuffer(mArenaAllocation.Page).GetBuffer(), 0, mIndexType);
+            return true;
+        }
+        if(mIndices.GetAllocation())
+        {
+            vkCmdBindIndexBuffer(commandBuffer, mIndices.GetBuffer(), 0, mIndexType);
             return true;
         }
         return false;
@@ -39,29 +107,114 @@ namespace hsk {
     {
         mIndices.SetName("Indices");
         mVertices.SetName("Vertices");
+        mSkinData.SetName("SkinData");
     }
 
     GeometryStore::GeometryStore() {}
 
-    void GeometryBufferSet::Init(const VkContext* context, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+    void GeometryBufferSet::Init(const VkContext*                   context,
+                                 const std::vector<Vertex>&         vertices,
+                                 const std::vector<uint32_t>&       indices,
+                                 const std::vector<VertexSkinData>& skinData,
+                                 UploadBatch*                       uploads)
     {
+        auto lWrite = [uploads](ManagedBuffer& buffer, const void* data, VkDeviceSize size, VkDeviceSize offset) {
+            if(uploads)
+            {
+                uploads->UploadBuffer(buffer, data, size, offset);
+            }
+            else
+            {
+                buffer.WriteDataDeviceLocal(data, size, offset);
+            }
+        };
+
+        // Index type is chosen first, the arena range is sized for it
+        std::vector<uint16_t> indices16;
+        const void*           indexData = indices.data();
+        VkDeviceSize          indexSize = indices.size() * sizeof(uint32_t);
+        if(indices.size())
+        {
+            uint32_t maxIndex = *std::max_element(indices.begin(), indices.end());
+            mIndexType        = maxIndex < 0xFFFF ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+            if(mIndexType == VK_INDEX_TYPE_UINT16)
+            {
+                indices16.assign(indices.begin(), indices.end());
+                indexData = indices16.data();
+                indexSize = indices16.size() * sizeof(uint16_t);
+            }
+        }
+
+        // The skinning compute shader binds the whole vertex buffer and indexes it from 0, skinned geometry keeps dedicated buffers
+        if(mArena && skinData.empty() && (vertices.size() || indices.size()))
+        {
+            HSK_ASSERTFMT(mArena->GetVertexStride() == GetVertexStride(mVertexLayout), "Arena vertex stride {} does not match the buffer set's vertex layout!",
+                          mArena->GetVertexStride())
+            mArenaAllocation = mArena->Allocate((uint32_t)vertices.size(), indexSize);
+        }
+
+        ManagedBuffer* vertexBuffer = UsesArena() ? &mArena->GetVertexBuffer(mArenaAllocation.Page) : &mVertices;
+        ManagedBuffer* indexBuffer  = UsesArena() ? &mArena->GetIndexBuffer(mArenaAllocation.Page) : &mIndices;
+        VkDeviceSize   vertexOffset = (VkDeviceSize)mArenaAllocation.FirstVertex * GetVertexStride(mVertexLayout);
+        VkDeviceSize   indexOffset  = mArenaAllocation.IndexOffset;
+
         if(vertices.size())
         {
-            VkDeviceSize bufferSize = vertices.size() * sizeof(Vertex);
-            mVertices.Create(context, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, bufferSize, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
-            mVertices.WriteDataDeviceLocal(vertices.data(), bufferSize);
+            VkDeviceSize bufferSize = vertices.size() * GetVertexStride(mVertexLayout);
+            if(!UsesArena())
+            {
+                VkBufferUsageFlags usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+                if(skinData.size())
+                {
+                    // Skinning compute shader reads the bind pose vertices
+                    usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+                }
+                mVertices.Create(context, usage, bufferSize, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+            }
+            if(mVertexLayout == EVertexLayout::Full)
+            {
+                lWrite(*vertexBuffer, vertices.data(), bufferSize, vertexOffset);
+            }
+            else
+            {
+                std::vector<uint8_t> packed(bufferSize);
+                WriteVertices(mVertexLayout, vertices.data(), packed.data(), vertices.size());
+                lWrite(*vertexBuffer, packed.data(), bufferSize, vertexOffset);
+            }
+        }
+        if(skinData.size())
+        {
+            HSK_ASSERTFMT(skinData.size() == vertices.size(), "Skin data count {} does not match vertex count {}!", skinData.size(), vertices.size())
+            VkDeviceSize bufferSize = skinData.size() * sizeof(VertexSkinData);
+            mSkinData.Create(context, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, bufferSize, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+            lWrite(mSkinData, skinData.data(), bufferSize, 0);
         }
         if(indices.size())
         {
-            VkDeviceSize bufferSize = indices.size() * sizeof(uint32_t);
-            mIndices.Create(context, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, bufferSize, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
-            mIndices.WriteDataDeviceLocal(indices.data(), bufferSize);
+            if(!UsesArena())
+            {
+                mIndices.Create(context, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, indexSize, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+            }
+            lWrite(*indexBuffer, indexData, indexSize, indexOffset);
+        }
+    }
+
+    GeometryArena* GeometryStore::GetArena(EVertexLayout layout)
+    {
+        std::lock_guard<std::mutex>     lock(mArenaMutex);
+        std::unique_ptr<GeometryArena>& arena = mArenas[layout];
+        if(!arena)
+        {
+            arena = std::make_unique<GeometryArena>(GetContext(), GetVertexStride(layout));
         }
+        return arena.get();
     }
 
     void GeometryStore::Cleanup()
     {
         mMeshes.clear();
         mBufferSets.clear();
+        mSkins.clear();
+        mArenas.clear();
     }
 }  // namespace hsk
\ No newline at end of file
@@ -1,7 +1,14 @@
 #pragma once
+#include "../../memory/hsk_geometryarena.hpp"
 #include "../../memory/hsk_managedbuffer.hpp"
+#include "../../memory/hsk_uploadbatch.hpp"
+#include "../../meshprocessing/hsk_meshletbuilder.hpp"
 #include "../hsk_component.hpp"
 #include "../hsk_geo.hpp"
+#include "../hsk_morphtargets.hpp"
+#include "../hsk_skin.hpp"
+#include <map>
+#include <mutex>
 #include <set>
 
 namespace hsk {
@@ -17,12 +24,23 @@ namespace hsk {
         EType    Type  = {};
         uint32_t First = 0;
         uint32_t Count = 0;
+        /// @brief Indexed draws: Added to every index. Allows storing primitive local indices, which fit 16 bit indices for most primitives
+        int32_t BaseVertex = 0;
+        /// @brief Material of the primitive. Pushed per draw for buffer sets in EVertexLayout::Compact (the full layout stores it per vertex)
+        int32_t MaterialIndex = -1;
+        /// @brief Range of the primitive's meshlets in the buffer set's MeshletBuffer (MeshletCount is 0 if meshlets have not been built)
+        uint32_t FirstMeshlet = 0;
+        uint32_t MeshletCount = 0;
 
         inline Primitive() {}
-        inline Primitive(EType type, uint32_t first, uint32_t count);
+        inline Primitive(EType type, uint32_t first, uint32_t count, int32_t baseVertex = 0);
 
         bool        IsValid() const { return Count > 0; }
-        inline void CmdDraw(VkCommandBuffer commandBuffer);
+        /// @param vertexOffset Added to every vertex index (indexed draw) or to First (non-indexed draw). Used for drawing from per instance vertex buffers
+        /// @param firstIndexOffset Added to First of indexed draws. Used for drawing from index ranges in a shared buffer
+        /// @param instanceCount Number of instances drawn. gl_InstanceIndex runs from firstInstance to firstInstance + instanceCount - 1
+        /// @param firstInstance First entry of the scene's InstanceBuffer used. Entry 0 is the identity transform
+        inline void CmdDraw(VkCommandBuffer commandBuffer, int32_t vertexOffset = 0, uint32_t firstIndexOffset = 0, uint32_t instanceCount = 1, uint32_t firstInstance = 0);
     };
 
     class Mesh
@@ -31,14 +49,31 @@ namespace hsk {
         inline Mesh() {}
         inline Mesh(GeometryBufferSet* buffer) : mBuffer(buffer) {}
 
-        virtual void CmdDraw(VkCommandBuffer commandBuffer, GeometryBufferSet*& currentlyBoundSet);
+        virtual void CmdDraw(SceneDrawInfo& drawInfo);
+        /// @brief Draws the mesh sourcing vertex attributes from vertexBuffer instead of the buffer set. vertexBuffer holds the vertex range [FirstVertex, FirstVertex + VertexCount)
+        /// in the vertex layout of the buffer set.
+        /// @remark Used by deformed (skinned) instances. Index data is still sourced from the buffer set.
+        virtual void CmdDrawDeformed(SceneDrawInfo& drawInfo, VkBuffer vertexBuffer);
+        /// @brief Draws instanceCount copies of the mesh with a single draw call per primitive. Copy i is transformed by entry firstInstance + i of the scene's InstanceBuffer.
+        virtual void CmdDrawInstanced(SceneDrawInfo& drawInfo, uint32_t instanceCount, uint32_t firstInstance);
 
         HSK_PROPERTY_ALL(Buffer)
         HSK_PROPERTY_ALL(Primitives)
+        HSK_PROPERTY_ALL(FirstVertex)
+        HSK_PROPERTY_ALL(VertexCount)
+        HSK_PROPERTY_ALLGET(MorphTargets)
 
       protected:
         GeometryBufferSet*      mBuffer;
         std::vector<Primitive> mPrimitives;
+
+        void CmdDrawPrimitives(SceneDrawInfo& drawInfo, int32_t vertexOffset, uint32_t instanceCount = 1, uint32_t firstInstance = 0);
+        /// @brief First vertex in the buffer set referenced by any of the primitives
+        uint32_t mFirstVertex = 0;
+        /// @brief Number of vertices in the buffer set referenced by the primitives (starting at mFirstVertex)
+        uint32_t mVertexCount = 0;
+        /// @brief Morph targets of the mesh (nullptr if the mesh has none)
+        std::unique_ptr<MorphTargetSet> mMorphTargets;
     };
 
     class GeometryBufferSet
@@ -48,20 +83,60 @@ namespace hsk {
 
         HSK_PROPERTY_ALL(Indices)
         HSK_PROPERTY_ALL(Vertices)
-
-        void Init(const VkContext* context, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices = std::vector<uint32_t>{});
+        HSK_PROPERTY_ALL(SkinData)
+        HSK_PROPERTY_CGET(IndexType)
+        /// @brief Layout vertices are stored in. Set before Init()
+        HSK_PROPERTY_ALL(VertexLayout)
+        /// @brief Meshlets of all indexed triangle list primitives drawn from the buffer set (nullptr if not built, see ModelConverter::Config::BuildMeshlets)
+        HSK_PROPERTY_ALLGET(Meshlets)
+        /// @brief Arena vertices and indices are sub-allocated from. Set before Init(). Buffer sets with skin data always use dedicated buffers.
+        HSK_PROPERTY_ALL(Arena)
+
+        /// @brief True if vertices and indices are stored in the arena instead of the buffer set's own buffers
+        inline bool UsesArena() const { return mArenaAllocation.IsValid(); }
+        /// @brief Position of the buffer set's first vertex in the bound vertex buffer (0 for dedicated buffers)
+        inline int32_t GetVertexOffset() const { return (int32_t)mArenaAllocation.FirstVertex; }
+        /// @brief Position of the buffer set's first index in the bound index buffer (0 for dedicated buffers)
+        inline uint32_t GetFirstIndexOffset() const { return (uint32_t)(mArenaAllocation.IndexOffset / (mIndexType == VK_INDEX_TYPE_UINT16 ? 2 : 4)); }
+        /// @brief True if drawing from this buffer set requires no rebind after other has been bound (same set, or same arena page and index type)
+        bool SharesBindingWith(const GeometryBufferSet* other) const;
+
+        /// @param skinData If not empty, is expected to have one entry per vertex. Also makes the vertex buffer readable as storage buffer (skinning compute source).
+        /// @param vertices Packed into the buffer set's vertex layout on upload
+        /// @param indices Indices relative to the BaseVertex of their primitive. Stored as 16 bit indices if all of them fit.
+        /// @param uploads If set, buffer writes are recorded into the batch (the buffers are valid once the batch is submitted). Otherwise each buffer is written immediately.
+        void Init(const VkContext*                   context,
+                  const std::vector<Vertex>&         vertices,
+                  const std::vector<uint32_t>&       indices  = std::vector<uint32_t>{},
+                  const std::vector<VertexSkinData>& skinData = std::vector<VertexSkinData>{},
+                  UploadBatch*                       uploads  = nullptr);
 
         virtual bool CmdBindBuffers(VkCommandBuffer commandBuffer);
+        virtual bool CmdBindIndexBuffer(VkCommandBuffer commandBuffer);
 
         inline virtual ~GeometryBufferSet()
         {
             mIndices.Cleanup();
             mVertices.Cleanup();
+            mSkinData.Cleanup();
+            if(mArena)
+            {
+                mArena->Free(mArenaAllocation);
+            }
         }
 
       protected:
         ManagedBuffer mIndices;
+        /// @brief VK_INDEX_TYPE_UINT16 if all indices of the buffer set are below 0xFFFF (the primitive restart value), VK_INDEX_TYPE_UINT32 otherwise
+        VkIndexType   mIndexType    = VK_INDEX_TYPE_UINT32;
+        EVertexLayout mVertexLayout = EVertexLayout::Full;
+        /// @brief CPU side cluster data, the foundation for cluster culling and mesh shading paths
+        std::unique_ptr<MeshletBuffer> mMeshlets;
         ManagedBuffer mVertices;
+        /// @brief Storage buffer of VertexSkinData, parallel to mVertices. Only exists if the buffer set contains skinned geometry
+        ManagedBuffer mSkinData;
+        GeometryArena*            mArena           = nullptr;
+        GeometryArena::Allocation mArenaAllocation = {};
     };
 
     class GeometryStore : public GlobalComponent
@@ -75,25 +150,33 @@ namespace hsk {
 
         HSK_PROPERTY_ALL(BufferSets)
         HSK_PROPERTY_ALL(Meshes)
+        HSK_PROPERTY_ALL(Skins)
+
+        /// @brief Shared vertex and index buffers of all buffer sets in layout. Created on first use. Thread safe.
+        GeometryArena* GetArena(EVertexLayout layout);
 
       protected:
+        /// @brief Declared before the buffer sets, which free their ranges on destruction
+        std::map<EVertexLayout, std::unique_ptr<GeometryArena>> mArenas;
+        std::mutex                                              mArenaMutex;
         std::vector<std::unique_ptr<GeometryBufferSet>> mBufferSets;
         std::vector<std::unique_ptr<Mesh>>              mMeshes;
+        std::vector<std::unique_ptr<Skin>>              mSkins;
     };
 
-    inline Primitive::Primitive(EType type, uint32_t first, uint32_t count) : Type(type), First(first), Count(count) {}
+    inline Primitive::Primitive(EType type, uint32_t first, uint32_t count, int32_t baseVertex) : Type(type), First(first), Count(count), BaseVertex(baseVertex) {}
 
-    inline void Primitive::CmdDraw(VkCommandBuffer commandBuffer)
+    inline void Primitive::CmdDraw(VkCommandBuffer commandBuffer, int32_t vertexOffset, uint32_t firstIndexOffset, uint32_t instanceCount, uint32_t firstInstance)
     {
         if(IsValid())
         {
             if(Type == EType::Index)
             {
-                vkCmdDrawIndexed(commandBuffer, Count, 1, First, 0, 0);
+                vkCmdDrawIndexed(commandBuffer, Count, instanceCount, First + firstIndexOffset, BaseVertex + vertexOffset, firstInstance);
             }
             else
             {
-                vkCmdDraw(commandBuffer, Count, 1, First, 0);
+                vkCmdDraw(commandBuffer, Count, instanceCount, (uint32_t)((int32_t)First + vertexOffset), firstInstance);
             }
         }
     }
@@ -0,0 +1,53 @@
+#include "hsk_instancebuffer.hpp"
+
+namespace hsk {
+    InstanceTransform InstanceTransform::FromMatrix(const glm::mat4& matrix)
+    {
+        glm::mat4 transposed = glm::transpose(matrix);
+        return InstanceTransform{.Rows = {transposed[0], transposed[1], transposed[2]}};
+    }
+
+    glm::mat4 InstanceTransform::ToMatrix() const { return glm::transpose(glm::mat4(Rows[0], Rows[1], Rows[2], glm::vec4(0.f, 0.f, 0.f, 1.f))); }
+
+    InstanceBuffer::InstanceBuffer(const VkContext* context) : mBuffer(context, false)
+    {
+        mBuffer.GetBuffer().SetName("InstanceBuffer");
+        mBuffer.GetVector().push_back(InstanceTransform{});
+        mDirtySection = BufferSection{.offset = 0, .count = 1};
+    }
+
+    uint32_t InstanceBuffer::AddInstances(const InstanceTransform* transforms, size_t count)
+    {
+        auto&         vector  = mBuffer.GetVector();
+        BufferSection section = {.offset = vector.size(), .count = count};
+        vector.insert(vector.end(), transforms, transforms + count);
+        mDirtySection = mDirtySection.has_value() ? mDirtySection->Merge(section) : section;
+        return (uint32_t)section.offset;
+    }
+
+    void InstanceBuffer::UpdateDeviceLocal()
+    {
+        if(mDirtySection.has_value())
+        {
+            VkDeviceSize capacity = mBuffer.GetDeviceCapacity();
+            mBuffer.InitOrUpdate(mDirtySection);
+            mDirtySection.reset();
+            if(mBuffer.GetDeviceCapacity() != capacity)
+            {
+                mBufferRevision++;
+            }
+        }
+    }
+
+    void InstanceBuffer::Cleanup() { mBuffer.Cleanup(); }
+
+    std::shared_ptr<DescriptorSetHelper::DescriptorInfo> InstanceBuffer::MakeDescriptorInfo()
+    {
+        UpdateDeviceLocal();
+        auto                                descriptorInfo = std::make_shared<DescriptorSetHelper::DescriptorInfo>();
+        std::vector<VkDescriptorBufferInfo> bufferInfos    = {mBuffer.GetBuffer().GetVkDescriptorBufferInfo()};
+        descriptorInfo->Init(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT, bufferInfos);
+        return descriptorInfo;
+    }
+
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+#include "../../hsk_glm.hpp"
+#include "../../memory/hsk_descriptorsethelper.hpp"
+#include "../../memory/hsk_managedvectorbuffer.hpp"
+#include "../hsk_component.hpp"
+#include <optional>
+
+namespace hsk {
+
+    /// @brief Affine transform of a single instance of an instanced mesh, stored as the first three rows of the matrix (std430 compatible, 48 bytes)
+    struct InstanceTransform
+    {
+        glm::vec4 Rows[3] = {glm::vec4(1.f, 0.f, 0.f, 0.f), glm::vec4(0.f, 1.f, 0.f, 0.f), glm::vec4(0.f, 0.f, 1.f, 0.f)};
+
+        static InstanceTransform FromMatrix(const glm::mat4& matrix);
+        glm::mat4                ToMatrix() const;
+    };
+
+    /// @brief Manages a storage buffer holding the per instance transforms of instanced mesh draws (glTF EXT_mesh_gpu_instancing)
+    /// @remark Read by the vertex stage with gl_InstanceIndex. Entry 0 is the identity, so regular draws (firstInstance = 0, instanceCount = 1) are not affected.
+    class InstanceBuffer : public GlobalComponent
+    {
+      public:
+        explicit InstanceBuffer(const VkContext* context);
+
+        const std::vector<InstanceTransform>& GetVector() const { return mBuffer.GetVector(); }
+
+        /// @brief Appends transforms to the buffer. The device local buffer is updated by the next UpdateDeviceLocal() call.
+        /// @return Index of the first added transform (the firstInstance of draws using them)
+        uint32_t AddInstances(const InstanceTransform* transforms, size_t count);
+
+        /// @brief Apply transforms added since the last call to the device local buffer
+        void UpdateDeviceLocal();
+        void Cleanup();
+
+        std::shared_ptr<DescriptorSetHelper::DescriptorInfo> MakeDescriptorInfo();
+        /// @brief Descriptor info of the current device local buffer, for rewriting descriptors after the buffer has been recreated
+        inline VkDescriptorBufferInfo GetDescriptorBufferInfo() { return mBuffer.GetBuffer().GetVkDescriptorBufferInfo(); }
+
+        /// @brief Incremented whenever UpdateDeviceLocal() recreates the device local buffer to grow it. Descriptors written before reference the destroyed buffer.
+        HSK_PROPERTY_CGET(BufferRevision)
+
+        inline virtual ~InstanceBuffer() { Cleanup(); }
+
+      protected:
+        ManagedVectorBuffer<InstanceTransform> mBuffer = {};
+        /// @brief Range of transforms added since the last UpdateDeviceLocal() call
+        std::optional<BufferSection> mDirtySection = {};
+        uint64_t                     mBufferRevision = 0;
+    };
+}  // namespace hsk
\ No newline at end of file
@@ -1,9 +1,22 @@
 #include "hsk_materialbuffer.hpp"
+#include <algorithm>
 
 namespace hsk {
     MaterialBuffer::MaterialBuffer(const VkContext* context) : mBuffer(context, false) { mBuffer.GetBuffer().SetName("MaterialBuffer"); }
     void MaterialBuffer::UpdateDeviceLocal() { mBuffer.InitOrUpdate(); }
-    void MaterialBuffer::Cleanup() { mBuffer.Cleanup(); }
+    void MaterialBuffer::Cleanup()
+    {
+        mBuffer.Cleanup();
+        mReservedSize = 0;
+    }
+
+    size_t MaterialBuffer::ReserveRange(size_t count)
+    {
+        std::lock_guard<std::mutex> lock(mReserveMutex);
+        size_t                      first = std::max(mReservedSize, mBuffer.GetVector().size());
+        mReservedSize                     = first + count;
+        return first;
+    }
 
     std::shared_ptr<DescriptorSetHelper::DescriptorInfo> MaterialBuffer::MakeDescriptorInfo()
     {
@@ -3,6 +3,7 @@
 #include "../hsk_component.hpp"
 #include "../hsk_material.hpp"
 #include "../../memory/hsk_descriptorsethelper.hpp"
+#include <mutex>
 
 namespace hsk {
 
@@ -14,6 +15,12 @@ namespace hsk {
 
         std::vector<MaterialBufferEntry>& GetVector() { return mBuffer.GetVector(); }
 
+        /// @brief Reserves count consecutive material indices following all entries and all previously reserved ranges. Thread safe.
+        /// @remark The vector is not resized, so loaders running concurrently can bake final material indices before touching it.
+        /// Whoever fills the range resizes the vector to cover it (on the thread owning the scene).
+        /// @return Index of the first reserved material
+        size_t ReserveRange(size_t count);
+
         /// @brief Apply changes made to the cpu local buffer to the device local buffer
         void UpdateDeviceLocal();
         void Cleanup();
@@ -24,5 +31,8 @@ namespace hsk {
 
       protected:
         ManagedVectorBuffer<MaterialBufferEntry> mBuffer = {};
+        /// @brief End of the last range returned by ReserveRange()
+        size_t     mReservedSize = 0;
+        std::mutex mReserveMutex;
     };
 }  // namespace hsk
\ No newline at end of file
@@ -37,6 +37,9 @@ namespace hsk {
     void TextureStore::Cleanup()
     {
         mTextures.clear();
+        mImagesByContent.clear();
+        mTextureIndices.clear();
+        mFreeIndices.clear();
         for(auto& hashSamplerPair : mSamplers)
         {
             vkDestroySampler(GetContext()->Device, hashSamplerPair.second, nullptr);
@@ -48,8 +51,9 @@ namespace hsk {
     VkSampler TextureStore::GetOrCreateSampler(const VkSamplerCreateInfo& samplerCI)
     {
         // hack it by
-        size_t hash = std::hash<VkSamplerCreateInfo>{}(samplerCI);
-        auto   find = mSamplers.find(hash);
+        size_t                      hash = std::hash<VkSamplerCreateInfo>{}(samplerCI);
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto                        find = mSamplers.find(hash);
         if(find != mSamplers.end())
         {
             return find->second;
@@ -71,17 +75,89 @@ namespace hsk {
         return sampler;
     }
 
+    std::shared_ptr<ManagedImage> TextureStore::FindImage(uint64_t contentHash) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto                        find = mImagesByContent.find(contentHash);
+        if(find != mImagesByContent.end())
+        {
+            return find->second.lock();
+        }
+        return nullptr;
+    }
+
+    int32_t TextureStore::AddTexture(std::shared_ptr<ManagedImage> image, VkSampler sampler, uint64_t contentHash)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto                        find = mTextureIndices.find(std::make_pair(image.get(), sampler));
+        if(find != mTextureIndices.end())
+        {
+            mTextures[find->second].RefCount++;
+            return find->second;
+        }
+
+        int32_t index = (int32_t)mTextures.size();
+        if(mFreeIndices.size())
+        {
+            index = mFreeIndices.back();
+            mFreeIndices.pop_back();
+        }
+        else
+        {
+            mTextures.emplace_back();
+        }
+        mTextureIndices[std::make_pair(image.get(), sampler)] = index;
+        mImagesByContent[contentHash]                         = image;
+        mTextures[index]                                      = SampledTexture{.Image = std::move(image), .Sampler = sampler, .RefCount = 1};
+        return index;
+    }
+
+    void TextureStore::ReleaseTexture(int32_t index)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        HSK_ASSERTFMT(index >= 0 && (size_t)index < mTextures.size() && mTextures[index].RefCount > 0, "Texture #{} released more often than added", index)
+        SampledTexture& texture = mTextures[index];
+        if(--texture.RefCount > 0)
+        {
+            return;
+        }
+        mTextureIndices.erase(std::make_pair(texture.Image.get(), texture.Sampler));
+        texture = SampledTexture{};
+        mFreeIndices.push_back(index);
+        std::erase_if(mImagesByContent, [](const auto& hashImagePair) { return hashImagePair.second.expired(); });
+    }
+
+    void TextureStore::ReleaseTextures(const std::vector<int32_t>& indices)
+    {
+        for(int32_t index : indices)
+        {
+            ReleaseTexture(index);
+        }
+    }
+
     std::shared_ptr<DescriptorSetHelper::DescriptorInfo> TextureStore::MakeDescriptorInfo(VkShaderStageFlags shaderStage)
     {
         auto                               descriptorInfo = std::make_shared<DescriptorSetHelper::DescriptorInfo>();
         std::vector<VkDescriptorImageInfo> imageInfos;
 
-        imageInfos.resize(mTextures.size());
-        for(size_t i = 0; i < mTextures.size(); i++)
+        // Free slots are never sampled, but every descriptor of the array has to be valid. They repeat any stored texture.
+        const SampledTexture* fallback = nullptr;
+        for(const SampledTexture& texture : mTextures)
+        {
+            if(texture.Image)
+            {
+                fallback = &texture;
+                break;
+            }
+        }
+
+        imageInfos.resize(fallback ? mTextures.size() : 0);
+        for(size_t i = 0; i < imageInfos.size(); i++)
         {
-            imageInfos[i].imageLayout = mTextures[i].Image->GetImageLayout();
-            imageInfos[i].imageView   = mTextures[i].Image->GetImageView();
-            imageInfos[i].sampler     = mTextures[i].Sampler;
+            const SampledTexture& texture = mTextures[i].Image ? mTextures[i] : *fallback;
+            imageInfos[i].imageLayout     = texture.Image->GetImageLayout();
+            imageInfos[i].imageView       = texture.Image->GetImageView();
+            imageInfos[i].sampler         = texture.Sampler;
         }
 
         descriptorInfo->Init(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, shaderStage, imageInfos);
@@ -3,15 +3,26 @@
 #include "../hsk_component.hpp"
 #include "../../memory/hsk_descriptorsethelper.hpp"
 #include <map>
+#include <mutex>
+#include <unordered_map>
 
 namespace hsk {
     class SampledTexture
     {
       public:
-        std::unique_ptr<ManagedImage> Image;
+        /// @brief Shared by all textures with identical image content
+        std::shared_ptr<ManagedImage> Image;
         VkSampler                     Sampler;
+        /// @brief Number of references held by loaded models (see TextureStore::AddTexture()). Zero for free slots.
+        uint32_t RefCount = 0;
     };
 
+    /// @brief Stores the textures of all loaded models. Textures are addressed by their index in GetTextures(), which is also their index in the descriptor array.
+    /// @remark Images are deduplicated by content hash, identical textures (same image and sampler) share a slot. Slots are reference counted, so textures
+    /// shared between models survive the release of any one of them. Released slots are reused, indices of other textures never change.
+    /// Content hashes are 64 bit and the image content itself is not compared (it only exists on the device). The importer compares format and extent on a
+    /// hash hit, two different images of the same size sharing a hash (probability about n^2 / 2^65 for n distinct images) would show the same texture.
+    /// GetOrCreateSampler(), FindImage(), AddTexture(), ReleaseTexture() and ReleaseTextures() are thread safe.
     class TextureStore : public GlobalComponent
     {
       public:
@@ -24,10 +35,33 @@ namespace hsk {
 
         VkSampler GetOrCreateSampler(const VkSamplerCreateInfo& samplerCI);
 
+        /// @brief Finds an image of a texture stored with the same content hash
+        /// @return nullptr if no such texture is stored
+        std::shared_ptr<ManagedImage> FindImage(uint64_t contentHash) const;
+
+        /// @brief Stores a texture, or adds a reference to a stored texture with the same image and sampler
+        /// @param contentHash Hash of the image content (pixel data, format and size), used by FindImage()
+        /// @return Index of the texture
+        int32_t AddTexture(std::shared_ptr<ManagedImage> image, VkSampler sampler, uint64_t contentHash);
+        /// @brief Releases a reference acquired by AddTexture(). The image is destroyed with the last texture referencing it.
+        void ReleaseTexture(int32_t index);
+        /// @brief Releases the textures of a model that is unloaded (see ModelConverter::GetAttachedTextures()). Textures shared with other models stay valid.
+        /// @remark Images are destroyed immediately, call while no frame using them is in flight. Descriptor infos made before reference the released images,
+        /// recreate them with MakeDescriptorInfo() before the next frame.
+        void ReleaseTextures(const std::vector<int32_t>& indices);
+
         std::shared_ptr<DescriptorSetHelper::DescriptorInfo> MakeDescriptorInfo(VkShaderStageFlags shaderStage = VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT);
 
       protected:
         std::vector<SampledTexture> mTextures;
         std::map<size_t, VkSampler> mSamplers;
+
+        /// @brief Content hash -> image, entries are removed when the last texture referencing the image is released
+        std::unordered_map<uint64_t, std::weak_ptr<ManagedImage>> mImagesByContent;
+        /// @brief Image and sampler -> texture index
+        std::map<std::pair<ManagedImage*, VkSampler>, int32_t> mTextureIndices;
+        /// @brief Released texture slots
+        std::vector<int32_t> mFreeIndices;
+        mutable std::mutex   mMutex;
     };
 }  // namespace hsk
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "hsk_animation.hpp"
+#include "components/hsk_meshinstance.hpp"
 #include "components/hsk_transform.hpp"
 #include "hsk_node.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace hsk {
 
@@ -69,10 +72,77 @@ namespace hsk {
     }
 
 
+    void AnimationSampler::SampleWeights(float time, float* outweights) const
+    {
+        if(!Keyframes.size() || !WeightCount)
+        {
+            return;
+        }
+
+        // Cubic spline samplers store in tangent, value and out tangent per keyframe
+        uint32_t keyframeStride = Interpolation == EAnimationInterpolation::Cubicspline ? WeightCount * 3 : WeightCount;
+        uint32_t valueOffset    = Interpolation == EAnimationInterpolation::Cubicspline ? WeightCount : 0;
+
+        int32_t lowerIndex = 0;
+        int32_t upperIndex = 0;
+        if(Keyframes.size() > 1)
+        {
+            SelectKeyframeIndices(time, lowerIndex, upperIndex);
+        }
+
+        const float* lower = Weights.data() + lowerIndex * keyframeStride;
+        const float* upper = Weights.data() + upperIndex * keyframeStride;
+
+        float dist = Keyframes[upperIndex].Time - Keyframes[lowerIndex].Time;
+        float t    = dist > 0.f ? std::clamp((time - Keyframes[lowerIndex].Time) / dist, 0.f, 1.f) : 0.f;
+
+        switch(Interpolation)
+        {
+            case EAnimationInterpolation::Step: {
+                for(uint32_t i = 0; i < WeightCount; i++)
+                {
+                    outweights[i] = lower[valueOffset + i];
+                }
+                break;
+            }
+            case EAnimationInterpolation::Linear: {
+                for(uint32_t i = 0; i < WeightCount; i++)
+                {
+                    outweights[i] = lower[i] + (upper[i] - lower[i]) * t;
+                }
+                break;
+            }
+            case EAnimationInterpolation::Cubicspline: {
+                float tSquared = t * t;
+                float tCubed   = t * tSquared;
+                for(uint32_t i = 0; i < WeightCount; i++)
+                {
+                    float lowerValue      = lower[WeightCount + i];
+                    float lowerOutTangent = lower[WeightCount * 2 + i];
+                    float upperInTangent  = upper[i];
+                    float upperValue      = upper[WeightCount + i];
+                    outweights[i] = (2 * tCubed - 3 * tSquared + 1) * lowerValue + dist * (tCubed - 2 * tSquared + t) * lowerOutTangent
+                                    + (-2 * tCubed + 3 * tSquared) * upperValue + dist * (tCubed - tSquared) * upperInTangent;
+                }
+                break;
+            }
+        }
+    }
+
     void AnimationSampler::SelectKeyframe(float time, AnimationKeyframe& lower, AnimationKeyframe& upper) const
     {
         int32_t lowerIndex = 0;
-        int32_t upperIndex = Keyframes.size() - 1;
+        int32_t upperIndex = 0;
+        SelectKeyframeIndices(time, lowerIndex, upperIndex);
+
+        lower = Keyframes[lowerIndex];
+        upper = Keyframes[upperIndex];
+    }
+
+    void AnimationSampler::SelectKeyframeIndices(float time, int32_t& lowerIndex, int32_t& upperIndex) const
+    {
+        lowerIndex = 0;
+        upperIndex = Keyframes.size() - 1;
 
         bool done = false;
         while(!done)
@@ -89,9 +159,6 @@ namespace hsk {
                 done = false;
             }
         }
-
-        lower = Keyframes[lowerIndex];
-        upper = Keyframes[upperIndex];
     }
 
     glm::vec4 AnimationSampler::InterpolateStep(float time, const AnimationKeyframe& lower, const AnimationKeyframe& upper)
@@ -130,42 +197,177 @@ namespace hsk {
         return glm::normalize(glm::quat(vec.w, vec.x, vec.y, vec.z));
     }
 
-    void Animation::Update(const FrameUpdateInfo& updateInfo)
+    float Animation::WrapCursor(float cursor) const
+    {
+        float length = mEnd - mStart;
+        if(!mPlaybackConfig.Loop || length <= 0.f)
+        {
+            return std::clamp(cursor, mStart, std::max(mStart, mEnd));
+        }
+        if(cursor >= mStart && cursor < mEnd)
+        {
+            return cursor;
+        }
+        // Keep the overflow, so a cursor ahead of the end continues from the same point of the next cycle
+        float wrapped = std::fmod(cursor - mStart, length);
+        if(wrapped < 0.f)
+        {
+            wrapped += length;
+        }
+        return mStart + wrapped;
+    }
+
+    uint32_t Animation::Update(const FrameUpdateInfo& updateInfo, EAnimationUpdateRate rate)
     {
         if(mPlaybackConfig.Enable)
         {
-            float delta     = updateInfo.GetFrameTime() * mPlaybackConfig.PlaybackSpeed;
-            float newCursor = mPlaybackConfig.Cursor + delta;
-            if(newCursor < mStart)
+            float delta            = updateInfo.GetFrameTime() * mPlaybackConfig.PlaybackSpeed;
+            mPlaybackConfig.Cursor = WrapCursor(mPlaybackConfig.Cursor + delta);
+        }
+
+        switch(rate)
+        {
+            case EAnimationUpdateRate::Paused:
+                mReducedRateElapsed = -1.f;
+                return 0;
+            case EAnimationUpdateRate::Reduced:
+                return UpdateReducedRate(updateInfo.GetFrameTime());
+            default:
+                break;
+        }
+
+        mReducedRateElapsed = -1.f;
+        for(auto& channel : mChannels)
+        {
+            if(channel.TargetPath == EAnimationTargetPath::Weights)
             {
-                newCursor = mPlaybackConfig.Loop ? mEnd : mStart;
+                auto  meshInstance = channel.Target->GetComponent<MeshInstance>();
+                auto& sampler      = mSamplers[channel.SamplerIndex];
+                if(meshInstance && meshInstance->GetMorphWeights().size() >= sampler.WeightCount)
+                {
+                    sampler.SampleWeights(mPlaybackConfig.Cursor, meshInstance->GetMorphWeights().data());
+                }
+                continue;
             }
-            else if(newCursor > mEnd)
+            ApplyChannel(channel, SampleChannel(channel, mPlaybackConfig.Cursor));
+        }
+        return static_cast<uint32_t>(mChannels.size());
+    }
+
+    uint32_t Animation::UpdateReducedRate(float frameTime)
+    {
+        float    interval  = 1.f / std::max(mUpdatePolicy.ReducedRateHz, 0.001f);
+        uint32_t evaluated = 0;
+
+        if(mReducedRateElapsed >= 0.f)
+        {
+            mReducedRateElapsed += frameTime;
+        }
+
+        if(mReducedRateElapsed < 0.f || mReducedRateElapsed >= interval)
+        {
+            // Sample the current cursor and the cursor of the next sample, frames in between interpolate
+            float nextCursor = mPlaybackConfig.Enable ? WrapCursor(mPlaybackConfig.Cursor + interval * mPlaybackConfig.PlaybackSpeed) : mPlaybackConfig.Cursor;
+            mReducedRateStates.resize(mChannels.size());
+            for(size_t i = 0; i < mChannels.size(); i++)
             {
-                newCursor = mPlaybackConfig.Loop ? mStart : mEnd;
+                auto& channel = mChannels[i];
+                auto& state   = mReducedRateStates[i];
+                if(channel.TargetPath == EAnimationTargetPath::Weights)
+                {
+                    auto& sampler = mSamplers[channel.SamplerIndex];
+                    state.WeightsFrom.resize(sampler.WeightCount);
+                    state.WeightsTo.resize(sampler.WeightCount);
+                    sampler.SampleWeights(mPlaybackConfig.Cursor, state.WeightsFrom.data());
+                    sampler.SampleWeights(nextCursor, state.WeightsTo.data());
+                }
+                else
+                {
+                    state.From = SampleChannel(channel, mPlaybackConfig.Cursor);
+                    state.To   = SampleChannel(channel, nextCursor);
+                }
             }
-            mPlaybackConfig.Cursor = newCursor;
+            mReducedRateElapsed = 0.f;
+            evaluated           = static_cast<uint32_t>(mChannels.size());
         }
-        for(auto& channel : mChannels)
-        {
-            auto  transform = channel.Target->GetTransform();
-            auto& sampler   = mSamplers[channel.SamplerIndex];
 
+        float t = std::clamp(mReducedRateElapsed / interval, 0.f, 1.f);
+
+        for(size_t i = 0; i < mChannels.size(); i++)
+        {
+            auto& channel = mChannels[i];
+            auto& state   = mReducedRateStates[i];
             switch(channel.TargetPath)
             {
-                case EAnimationTargetPath::Translation:
-                    transform->SetTranslation(sampler.SampleVec(mPlaybackConfig.Cursor));
+                case EAnimationTargetPath::Rotation: {
+                    glm::quat from = glm::quat(state.From.w, state.From.x, state.From.y, state.From.z);
+                    glm::quat to   = glm::quat(state.To.w, state.To.x, state.To.y, state.To.z);
+                    glm::quat rot  = glm::normalize(glm::slerp(from, to, t));
+                    ApplyChannel(channel, glm::vec4(rot.x, rot.y, rot.z, rot.w));
                     break;
-                case EAnimationTargetPath::Rotation:
-                    transform->SetRotation(sampler.SampleQuat(mPlaybackConfig.Cursor));
-                    break;
-                case EAnimationTargetPath::Scale:
-                    transform->SetScale(sampler.SampleVec(mPlaybackConfig.Cursor));
+                }
+                case EAnimationTargetPath::Weights: {
+                    mReducedRateWeights.resize(state.WeightsFrom.size());
+                    for(size_t weightIndex = 0; weightIndex < mReducedRateWeights.size(); weightIndex++)
+                    {
+                        mReducedRateWeights[weightIndex] = glm::mix(state.WeightsFrom[weightIndex], state.WeightsTo[weightIndex], t);
+                    }
+                    ApplyWeights(channel, mReducedRateWeights.data());
                     break;
+                }
                 default:
-                    continue;
+                    ApplyChannel(channel, glm::mix(state.From, state.To, t));
+                    break;
+            }
+        }
+        return evaluated;
+    }
+
+    glm::vec4 Animation::SampleChannel(const AnimationChannel& channel, float cursor) const
+    {
+        auto& sampler = mSamplers[channel.SamplerIndex];
+        switch(channel.TargetPath)
+        {
+            case EAnimationTargetPath::Translation:
+            case EAnimationTargetPath::Scale:
+                return glm::vec4(sampler.SampleVec(cursor), 0.f);
+            case EAnimationTargetPath::Rotation: {
+                glm::quat rotation = sampler.SampleQuat(cursor);
+                return glm::vec4(rotation.x, rotation.y, rotation.z, rotation.w);
             }
-            transform->RecalculateGlobalMatrix();
+            default:
+                return glm::vec4();
+        }
+    }
+
+    void Animation::ApplyChannel(const AnimationChannel& channel, const glm::vec4& value)
+    {
+        auto transform = channel.Target->GetTransform();
+
+        switch(channel.TargetPath)
+        {
+            case EAnimationTargetPath::Translation:
+                transform->SetTranslation(glm::vec3(value));
+                break;
+            case EAnimationTargetPath::Rotation:
+                transform->SetRotation(glm::quat(value.w, value.x, value.y, value.z));
+                break;
+            case EAnimationTargetPath::Scale:
+                transform->SetScale(glm::vec3(value));
+                break;
+            default:
+                return;
+        }
+        transform->RecalculateGlobalMatrix();
+    }
+
+    void Animation::ApplyWeights(const AnimationChannel& channel, const float* weights)
+    {
+        auto  meshInstance = channel.Target->GetComponent<MeshInstance>();
+        auto& sampler      = mSamplers[channel.SamplerIndex];
+        if(meshInstance && meshInstance->GetMorphWeights().size() >= sampler.WeightCount)
+        {
+            std::copy(weights, weights + sampler.WeightCount, meshInstance->GetMorphWeights().data());
         }
     }
 }  // namespace hsk
\ No newline at end of file
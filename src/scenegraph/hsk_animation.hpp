@@ -2,6 +2,7 @@
 #include "../hsk_basics.hpp"
 #include "../hsk_glm.hpp"
 #include "hsk_scenegraph_declares.hpp"
+#include <limits>
 
 namespace hsk {
     enum class EAnimationInterpolation
@@ -15,7 +16,9 @@ namespace hsk {
     {
         Translation,
         Rotation,
-        Scale
+        Scale,
+        /// @brief Morph target weights of the target node's MeshInstance
+        Weights
     };
 
     struct AnimationKeyframe
@@ -39,6 +42,9 @@ namespace hsk {
       public:
         glm::vec3 SampleVec(float time) const;
         glm::quat SampleQuat(float time) const;
+        /// @brief Samples morph target weights
+        /// @param outweights Destination, expected to have room for WeightCount values
+        void SampleWeights(float time, float* outweights) const;
 
         static glm::vec4 InterpolateStep(float time, const AnimationKeyframe& lower, const AnimationKeyframe& upper);
         static glm::vec4 InterpolateLinear(float time, const AnimationKeyframe& lower, const AnimationKeyframe& upper);
@@ -48,9 +54,14 @@ namespace hsk {
 
         EAnimationInterpolation        Interpolation = {};
         std::vector<AnimationKeyframe> Keyframes     = {};
+        /// @brief Number of morph target weights per keyframe (0 for non-weight samplers)
+        uint32_t WeightCount = 0;
+        /// @brief Morph target weights, WeightCount values per keyframe (Cubicspline: In tangents, values, out tangents per keyframe). Keyframes only provide the time.
+        std::vector<float> Weights = {};
 
       protected:
         void SelectKeyframe(float time, AnimationKeyframe& lower, AnimationKeyframe& upper) const;
+        void SelectKeyframeIndices(float time, int32_t& lowerIndex, int32_t& upperIndex) const;
     };
     struct AnimationChannel
     {
@@ -73,6 +84,31 @@ namespace hsk {
         float Cursor = 0.f;
     };
 
+    /// @brief Rate at which the channels of an animation are evaluated
+    enum class EAnimationUpdateRate
+    {
+        /// @brief All channels are sampled every frame
+        Full,
+        /// @brief Channels are sampled at AnimationUpdatePolicy::ReducedRateHz, frames in between interpolate the last two samples
+        Reduced,
+        /// @brief Channels are not evaluated, the playback cursor keeps advancing so playback resumes in phase
+        Paused
+    };
+
+    /// @brief Determines the update rate of an animation from the information supplied to AnimationDirector (viewer position, visibility)
+    struct AnimationUpdatePolicy
+    {
+      public:
+        /// @brief Distance between viewer and animation anchor beyond which the animation is updated at reduced rate
+        float ReducedRateDistance = std::numeric_limits<float>::infinity();
+        /// @brief Distance between viewer and animation anchor beyond which the animation is paused
+        float PauseDistance = std::numeric_limits<float>::infinity();
+        /// @brief Sample rate of reduced rate updates (in Hz)
+        float ReducedRateHz = 15.f;
+        /// @brief If true, the animation is paused while AnimationDirector's visibility test reports it as culled
+        bool PauseWhenCulled = true;
+    };
+
     class Animation
     {
       public:
@@ -82,16 +118,45 @@ namespace hsk {
         HSK_PROPERTY_ALL(Start)
         HSK_PROPERTY_ALL(End)
         HSK_PROPERTY_ALL(PlaybackConfig)
+        HSK_PROPERTY_ALL(UpdatePolicy)
+        /// @brief Node used as the animation's position for distance based update rate selection. Defaults to the target of the first channel.
+        HSK_PROPERTY_ALL(Anchor)
 
-        void Update(const FrameUpdateInfo&);
+        /// @brief Advances playback and evaluates channels according to rate
+        /// @return Number of channels whose sampler was evaluated
+        uint32_t Update(const FrameUpdateInfo&, EAnimationUpdateRate rate = EAnimationUpdateRate::Full);
 
       protected:
+        /// @brief Channel values of the last two reduced rate samples. Rotations are stored as quaternion (x, y, z, w)
+        struct ReducedRateState
+        {
+            glm::vec4          From        = {};
+            glm::vec4          To          = {};
+            std::vector<float> WeightsFrom = {};
+            std::vector<float> WeightsTo   = {};
+        };
+
         std::string                   mName;
         std::vector<AnimationSampler> mSamplers;
         std::vector<AnimationChannel> mChannels;
         float                         mStart = {};
         float                         mEnd   = {};
         PlaybackConfig                mPlaybackConfig;
+        AnimationUpdatePolicy         mUpdatePolicy;
+        Node*                         mAnchor = nullptr;
+
+        std::vector<ReducedRateState> mReducedRateStates;
+        /// @brief Seconds passed since the last reduced rate sample, negative if no valid samples exist
+        float mReducedRateElapsed = -1.f;
+        /// @brief Scratch buffer for interpolated morph weights, reused across frames
+        std::vector<float> mReducedRateWeights;
+
+        /// @brief Wraps cursor into [Start, End) modulo the clip length for looping playback, clamps it to [Start, End] otherwise
+        float     WrapCursor(float cursor) const;
+        glm::vec4 SampleChannel(const AnimationChannel& channel, float cursor) const;
+        void      ApplyChannel(const AnimationChannel& channel, const glm::vec4& value);
+        void      ApplyWeights(const AnimationChannel& channel, const float* weights);
+        uint32_t  UpdateReducedRate(float frameTime);
     };
 
 }  // namespace hsk
\ No newline at end of file
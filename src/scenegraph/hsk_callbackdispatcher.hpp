@@ -16,6 +16,10 @@ namespace hsk {
         virtual void InvokeOnEvent(std::shared_ptr<Event> event);
         virtual void InvokeOnResized(VkExtent2D event);
 
+        /// @brief Incremented whenever a component is registered or unregistered. Lets users of a set of components (e.g. SkinningStage) detect loads and unloads
+        /// without searching the node hierarchy every frame.
+        HSK_PROPERTY_CGET(ComponentRevision)
+
       protected:
         template <typename TCallback, typename TArg = TCallback::TArg>
         struct CallbackVector
@@ -32,6 +36,8 @@ namespace hsk {
         CallbackVector<Component::DrawCallback>       mDraw       = {};
         CallbackVector<Component::BeforeDrawCallback> mBeforeDraw = {};
         CallbackVector<Component::OnResizedCallback>  mOnResized  = {};
+
+        uint64_t mComponentRevision = 0;
     };
 
     template <typename TCallback, typename TArg>
@@ -12,6 +12,7 @@ namespace hsk {
     {
       public:
         friend Registry;
+        friend NodeBlock;
 
         /// @brief Base class for implementing the update callback
         class UpdateCallback : public Polymorphic
@@ -74,6 +75,8 @@ namespace hsk {
 
       protected:
         Registry* mRegistry = nullptr;
+        /// @brief Set if the component was constructed in a NodeBlock. The registry destroys it in place instead of deleting it.
+        bool mInNodeBlock = false;
     };
 
     class NodeComponent : public Component
@@ -1,5 +1,6 @@
 #include "hsk_geo.hpp"
 #include "../base/hsk_logger.hpp"
+#include <cstring>
 
 namespace hsk {
 
@@ -20,10 +21,32 @@ namespace hsk {
         InputStateCI    = {};
         InputBindings   = {};
         InputAttributes = {};
-        InputBindings.push_back(VkVertexInputBindingDescription{.binding = Binding, .stride = sizeof(Vertex), .inputRate = VkVertexInputRate::VK_VERTEX_INPUT_RATE_VERTEX});
+        InputBindings.push_back(VkVertexInputBindingDescription{.binding = Binding, .stride = (uint32_t)GetVertexStride(Layout), .inputRate = VkVertexInputRate::VK_VERTEX_INPUT_RATE_VERTEX});
 
         for(auto& component : Components)
         {
+            if(Layout == EVertexLayout::Compact)
+            {
+                switch(component.Component)
+                {
+                    case EVertexComponent::Position:
+                        InputAttributes.push_back(VkVertexInputAttributeDescription{component.Location, Binding, VK_FORMAT_R32G32B32_SFLOAT, offsetof(CompactVertex, Pos)});
+                        break;
+                    case EVertexComponent::Normal:
+                        InputAttributes.push_back(VkVertexInputAttributeDescription{component.Location, Binding, VK_FORMAT_R16G16_SNORM, offsetof(CompactVertex, Normal)});
+                        break;
+                    case EVertexComponent::Tangent:
+                        InputAttributes.push_back(VkVertexInputAttributeDescription{component.Location, Binding, VK_FORMAT_R16G16_SNORM, offsetof(CompactVertex, Tangent)});
+                        break;
+                    case EVertexComponent::Uv:
+                        InputAttributes.push_back(VkVertexInputAttributeDescription{component.Location, Binding, VK_FORMAT_R16G16_SFLOAT, offsetof(CompactVertex, Uv)});
+                        break;
+                    default:
+                        Exception::Throw("Failed to add vertex component. The compact vertex layout does not contain this component (material index is supplied per primitive)!");
+                        break;
+                }
+                continue;
+            }
             switch(component.Component)
             {
                 case EVertexComponent::Position:
@@ -53,4 +76,59 @@ namespace hsk {
         InputStateCI.vertexAttributeDescriptionCount = InputAttributes.size();
         InputStateCI.pVertexAttributeDescriptions    = InputAttributes.data();
     }
+
+    size_t GetVertexStride(EVertexLayout layout)
+    {
+        return layout == EVertexLayout::Compact ? sizeof(CompactVertex) : sizeof(Vertex);
+    }
+
+    uint32_t EncodeOctahedral(glm::vec3 vector)
+    {
+        float manhattanLength = std::abs(vector.x) + std::abs(vector.y) + std::abs(vector.z);
+        if(manhattanLength <= 0.f)
+        {
+            // Degenerate (zero length) vectors are encoded as +Z
+            return glm::packSnorm2x16(glm::vec2(0.f));
+        }
+        // Project onto the octahedron, then fold the lower hemisphere over the diagonals
+        vector /= manhattanLength;
+        glm::vec2 encoded(vector.x, vector.y);
+        if(vector.z < 0.f)
+        {
+            encoded = (1.f - glm::abs(glm::vec2(vector.y, vector.x))) * glm::vec2(vector.x >= 0.f ? 1.f : -1.f, vector.y >= 0.f ? 1.f : -1.f);
+        }
+        return glm::packSnorm2x16(encoded);
+    }
+
+    glm::vec3 DecodeOctahedral(uint32_t encoded)
+    {
+        glm::vec2 value = glm::unpackSnorm2x16(encoded);
+        glm::vec3 vector(value.x, value.y, 1.f - std::abs(value.x) - std::abs(value.y));
+        float     fold = std::max(-vector.z, 0.f);
+        vector.x += vector.x >= 0.f ? -fold : fold;
+        vector.y += vector.y >= 0.f ? -fold : fold;
+        return glm::normalize(vector);
+    }
+
+    CompactVertex PackVertex(const Vertex& vertex)
+    {
+        return CompactVertex{
+            .Pos = vertex.Pos, .Normal = EncodeOctahedral(vertex.Normal), .Tangent = EncodeOctahedral(vertex.Tangent), .Uv = glm::packHalf2x16(vertex.Uv)};
+    }
+
+    void WriteVertices(EVertexLayout layout, const Vertex* source, void* dest, size_t count)
+    {
+        if(layout == EVertexLayout::Compact)
+        {
+            CompactVertex* out = reinterpret_cast<CompactVertex*>(dest);
+            for(size_t i = 0; i < count; i++)
+            {
+                out[i] = PackVertex(source[i]);
+            }
+        }
+        else
+        {
+            memcpy(dest, source, count * sizeof(Vertex));
+        }
+    }
 }  // namespace hsk
\ No newline at end of file
@@ -16,6 +16,15 @@ namespace hsk {
         MaterialIndex,
     };
 
+    /// @brief Memory layout of vertices in device buffers. Vertices are always processed as hsk::Vertex on the CPU and packed on upload.
+    enum class EVertexLayout
+    {
+        /// @brief hsk::Vertex (48 bytes)
+        Full,
+        /// @brief hsk::CompactVertex (24 bytes). The material index is supplied per primitive via push constant.
+        Compact,
+    };
+
     struct VertexComponentBinding
     {
         EVertexComponent Component;
@@ -27,6 +36,8 @@ namespace hsk {
         std::vector<VertexComponentBinding> Components;
         uint32_t                            Binding      = 0;
         uint32_t                            NextLocation = 0;
+        /// @brief Layout of the bound vertex buffer. Components are described in the formats of this layout.
+        EVertexLayout Layout = EVertexLayout::Full;
 
         std::vector<VkVertexInputAttributeDescription> InputAttributes{};
         std::vector<VkVertexInputBindingDescription>   InputBindings{};
@@ -45,4 +56,34 @@ namespace hsk {
         int32_t   MaterialIndex = {};
     };
 
+    /// @brief Packed vertex (EVertexLayout::Compact)
+    struct CompactVertex
+    {
+        glm::vec3 Pos = {};
+        /// @brief Octahedral encoded unit vector, 2x 16 bit snorm
+        uint32_t Normal = 0;
+        /// @brief Octahedral encoded unit vector, 2x 16 bit snorm
+        uint32_t Tangent = 0;
+        /// @brief 2x 16 bit float
+        uint32_t Uv = 0;
+    };
+
+    /// @brief Size of a vertex in bytes
+    size_t GetVertexStride(EVertexLayout layout);
+
+    /// @brief Encodes a unit vector into two 16 bit snorm values (octahedral mapping). Zero length vectors are encoded as +Z.
+    uint32_t EncodeOctahedral(glm::vec3 vector);
+    glm::vec3 DecodeOctahedral(uint32_t encoded);
+
+    CompactVertex PackVertex(const Vertex& vertex);
+    /// @brief Writes count vertices into dest in the given layout
+    void WriteVertices(EVertexLayout layout, const Vertex* source, void* dest, size_t count);
+
+    /// @brief Per vertex skinning information (glTF JOINTS_0 and WEIGHTS_0 attributes). Layout matches the std430 struct read by the skinning compute shader.
+    struct VertexSkinData
+    {
+        glm::uvec4 Joints  = {};
+        glm::vec4  Weights = {};
+    };
+
 }  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "hsk_morphtargets.hpp"
+#include <cstring>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64)
+#define HSK_MORPH_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace hsk {
+    void MorphTargetSet::Reblend(const float* fromWeights, const float* toWeights, Vertex* vertices) const
+    {
+        // Restore all vertices a previously active target has displaced ...
+        for(size_t targetIndex = 0; targetIndex < mTargets.size(); targetIndex++)
+        {
+            if(fromWeights[targetIndex] == 0.f)
+            {
+                continue;
+            }
+            for(const MorphDelta& delta : mTargets[targetIndex].Deltas)
+            {
+                const Vertex& base   = mBaseVertices[delta.VertexIndex];
+                Vertex&       vertex = vertices[delta.VertexIndex];
+                vertex.Pos           = base.Pos;
+                vertex.Normal        = base.Normal;
+                vertex.Tangent       = base.Tangent;
+            }
+        }
+        // ... then accumulate all active targets. Vertices displaced by an active target which were not reset above are guaranteed to be in base state.
+        for(size_t targetIndex = 0; targetIndex < mTargets.size(); targetIndex++)
+        {
+            float weight = toWeights[targetIndex];
+            if(weight == 0.f)
+            {
+                continue;
+            }
+            const auto& deltas = mTargets[targetIndex].Deltas;
+            ApplyMorphDeltas(deltas.data(), deltas.size(), weight, vertices);
+        }
+    }
+
+    void MorphTargetSet::CopyAffected(const float* weightsA, const float* weightsB, const Vertex* source, void* dest, EVertexLayout layout) const
+    {
+        size_t   stride    = GetVertexStride(layout);
+        uint8_t* destBytes = reinterpret_cast<uint8_t*>(dest);
+        for(size_t targetIndex = 0; targetIndex < mTargets.size(); targetIndex++)
+        {
+            if(weightsA[targetIndex] == 0.f && weightsB[targetIndex] == 0.f)
+            {
+                continue;
+            }
+            for(const MorphDelta& delta : mTargets[targetIndex].Deltas)
+            {
+                WriteVertices(layout, source + delta.VertexIndex, destBytes + delta.VertexIndex * stride, 1);
+            }
+        }
+    }
+
+    void ApplyMorphDeltas(const MorphDelta* deltas, size_t count, float weight, Vertex* vertices)
+    {
+#ifdef HSK_MORPH_SSE
+        // Position, Normal and Tangent are 9 contiguous floats in both MorphDelta and Vertex: process as 4 + 4 + 1
+        __m128 weight4 = _mm_set1_ps(weight);
+        for(size_t i = 0; i < count; i++)
+        {
+            const MorphDelta& delta  = deltas[i];
+            float*            target = &(vertices[delta.VertexIndex].Pos.x);
+            const float*      source = &(delta.Position.x);
+
+            _mm_storeu_ps(target, _mm_add_ps(_mm_loadu_ps(target), _mm_mul_ps(weight4, _mm_loadu_ps(source))));
+            _mm_storeu_ps(target + 4, _mm_add_ps(_mm_loadu_ps(target + 4), _mm_mul_ps(weight4, _mm_loadu_ps(source + 4))));
+            target[8] += weight * source[8];
+        }
+#else
+        for(size_t i = 0; i < count; i++)
+        {
+            const MorphDelta& delta  = deltas[i];
+            Vertex&           vertex = vertices[delta.VertexIndex];
+            vertex.Pos += weight * delta.Position;
+            vertex.Normal += weight * delta.Normal;
+            vertex.Tangent += weight * delta.Tangent;
+        }
+#endif
+    }
+}  // namespace hsk
\ No newline at end of file
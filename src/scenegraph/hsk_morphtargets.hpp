@@ -0,0 +1,54 @@
+#pragma once
+#include "../hsk_basics.hpp"
+#include "../hsk_glm.hpp"
+#include "hsk_geo.hpp"
+#include "hsk_scenegraph_declares.hpp"
+
+namespace hsk {
+
+    /// @brief Displacement of a single vertex by a morph target. Vertices not displaced by a target are not stored.
+    /// @remark Position, Normal and Tangent are laid out contiguously (9 floats), matching the leading 9 floats of Vertex
+    struct MorphDelta
+    {
+        /// @brief Vertex index relative to Mesh::FirstVertex
+        uint32_t  VertexIndex = 0;
+        glm::vec3 Position    = {};
+        glm::vec3 Normal      = {};
+        glm::vec3 Tangent     = {};
+    };
+
+    /// @brief Sparse list of vertex displacements of one morph target, sorted by vertex index
+    struct MorphTarget
+    {
+        std::vector<MorphDelta> Deltas = {};
+    };
+
+    /// @brief Morph targets of a mesh, plus the undeformed vertices of the mesh's vertex range for restoring blended vertices
+    /// @remark Blending is incremental and sparse: Only vertices referenced by targets with a non-zero weight (before or after a weight change) are ever touched.
+    class MorphTargetSet
+    {
+      public:
+        HSK_PROPERTY_ALL(Targets)
+        HSK_PROPERTY_ALL(DefaultWeights)
+        HSK_PROPERTY_ALL(BaseVertices)
+
+        inline size_t GetTargetCount() const { return mTargets.size(); }
+
+        /// @brief Transitions vertices blended with fromWeights to a blend with toWeights
+        /// @param fromWeights Weights vertices currently are blended with (GetTargetCount() entries)
+        /// @param toWeights Weights to blend with (GetTargetCount() entries)
+        /// @param vertices Vertices of the mesh's vertex range (GetBaseVertices().size() entries)
+        void Reblend(const float* fromWeights, const float* toWeights, Vertex* vertices) const;
+
+        /// @brief Copies all vertices which may differ between a blend with weightsA and a blend with weightsB from source to dest, packing them into the layout of dest
+        void CopyAffected(const float* weightsA, const float* weightsB, const Vertex* source, void* dest, EVertexLayout layout = EVertexLayout::Full) const;
+
+      protected:
+        std::vector<MorphTarget> mTargets        = {};
+        std::vector<float>       mDefaultWeights = {};
+        std::vector<Vertex>      mBaseVertices   = {};
+    };
+
+    /// @brief Adds weight * delta to the position, normal and tangent of the referenced vertices. Uses SSE where available, scalar code otherwise.
+    void ApplyMorphDeltas(const MorphDelta* deltas, size_t count, float weight, Vertex* vertices);
+}  // namespace hsk
\ No newline at end of file
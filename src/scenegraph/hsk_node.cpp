@@ -12,4 +12,9 @@ namespace hsk {
     {
         MakeComponent<Transform>();
     }
+
+    Node::Node(Scene* scene, Node* parent, Transform* transform) : Registry(scene), mParent(parent)
+    {
+        AddComponent(transform);
+    }
 }  // namespace hsk
\ No newline at end of file
@@ -6,6 +6,8 @@ namespace hsk {
     {
       public:
         Node(Scene* scene, Node* parent = nullptr);
+        /// @brief Creates a node using an already constructed transform (see NodeBlock::MakeNode())
+        Node(Scene* scene, Node* parent, Transform* transform);
 
         HSK_PROPERTY_ALL(Parent);
         HSK_PROPERTY_ALL(Children);
@@ -13,7 +15,7 @@ namespace hsk {
         Transform* GetTransform();
 
         template <typename TComponent>
-        inline int32_t FindChildrenWithComponent(std::vector<Node*> outnodes);
+        inline int32_t FindChildrenWithComponent(std::vector<Node*>& outnodes);
 
         inline virtual ~Node(){}
 
@@ -24,7 +26,7 @@ namespace hsk {
 
 
     template <typename TComponent>
-    inline int32_t Node::FindChildrenWithComponent(std::vector<Node*> outnodes){
+    inline int32_t Node::FindChildrenWithComponent(std::vector<Node*>& outnodes){
       int32_t found = 0;
       for (Node* child : mChildren){
         if (child->HasComponent<TComponent>()){
@@ -0,0 +1,27 @@
+#include "hsk_nodeblock.hpp"
+#include "components/hsk_transform.hpp"
+
+namespace hsk {
+    NodeBlock::NodeBlock(size_t capacity) : mMemory(std::make_unique_for_overwrite<std::byte[]>(capacity)), mCapacity(capacity) {}
+
+    size_t NodeBlock::NodeSize() { return SizeOf<Node>() + SizeOf<Transform>(); }
+
+    Node* NodeBlock::MakeNode(Scene* scene, Node* parent)
+    {
+        Transform* transform    = new(Allocate<Transform>()) Transform();
+        transform->mInNodeBlock = true;
+        Node* node              = new(Allocate<Node>()) Node(scene, parent, transform);
+        mNodes.push_back(node);
+        return node;
+    }
+
+    NodeBlock::~NodeBlock()
+    {
+        // Destroying a node destroys its components, including those constructed in the block
+        for(auto iter = mNodes.rbegin(); iter != mNodes.rend(); ++iter)
+        {
+            (*iter)->~Node();
+        }
+        mNodes.clear();
+    }
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+#include "../hsk_basics.hpp"
+#include "../hsk_exception.hpp"
+#include "hsk_node.hpp"
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace hsk {
+
+    /// @brief A single allocation holding nodes and components created together (e.g. the copies of a Prefab)
+    /// @remark Objects are constructed in place one after another and destroyed together with the block. Components made by the block are destroyed in place by their registry.
+    /// Blocks are owned by the scene (see Scene::MakeNodeBlock()), nodes of a block must not outlive it.
+    class NodeBlock : public NoMoveDefaults
+    {
+      public:
+        /// @param capacity Size of the block in bytes. Use SizeOf() to compute it.
+        explicit NodeBlock(size_t capacity);
+        virtual ~NodeBlock();
+
+        /// @brief Bytes an object of type T occupies in a block
+        template <typename T>
+        static constexpr size_t SizeOf();
+        /// @brief Bytes a node (including its Transform) occupies in a block
+        static size_t NodeSize();
+
+        /// @brief Constructs a node and its Transform in the block. The node is not linked to the parent's children, use Scene::MakeNode(NodeBlock*, Node*).
+        Node* MakeNode(Scene* scene, Node* parent);
+        /// @brief Constructs a component in the block and attaches it to node
+        template <typename TComponent, typename... Args>
+        TComponent* MakeComponent(Node* node, Args&&... args);
+
+        /// @brief Size of the block in bytes
+        HSK_PROPERTY_CGET(Capacity)
+        /// @brief Bytes used by constructed objects
+        HSK_PROPERTY_CGET(Size)
+        /// @brief All nodes constructed in the block, in order of construction
+        HSK_PROPERTY_CGET(Nodes)
+
+      protected:
+        std::unique_ptr<std::byte[]> mMemory   = {};
+        size_t                       mCapacity = 0;
+        size_t                       mSize     = 0;
+        std::vector<Node*>           mNodes    = {};
+
+        /// @brief Reserves memory for an object of type T
+        template <typename T>
+        void* Allocate();
+    };
+
+    template <typename T>
+    constexpr size_t NodeBlock::SizeOf()
+    {
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "NodeBlock: Over-aligned types are not supported");
+        return (sizeof(T) + __STDCPP_DEFAULT_NEW_ALIGNMENT__ - 1) / __STDCPP_DEFAULT_NEW_ALIGNMENT__ * __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    }
+
+    template <typename T>
+    void* NodeBlock::Allocate()
+    {
+        HSK_ASSERTFMT(mSize + SizeOf<T>() <= mCapacity, "NodeBlock: Capacity of {} bytes exceeded!", mCapacity)
+        void* result = mMemory.get() + mSize;
+        mSize += SizeOf<T>();
+        return result;
+    }
+
+    template <typename TComponent, typename... Args>
+    TComponent* NodeBlock::MakeComponent(Node* node, Args&&... args)
+    {
+        TComponent* component   = new(Allocate<TComponent>()) TComponent(std::forward<Args>(args)...);
+        component->mInNodeBlock = true;
+        node->AddComponent(component);
+        return component;
+    }
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,286 @@
+#include "hsk_prefab.hpp"
+#include "components/hsk_instancedmeshinstance.hpp"
+#include "components/hsk_meshinstance.hpp"
+#include "components/hsk_morphedmeshinstance.hpp"
+#include "components/hsk_skinnedmeshinstance.hpp"
+#include "components/hsk_transform.hpp"
+#include "globalcomponents/hsk_animationdirector.hpp"
+#include "globalcomponents/hsk_geometrystore.hpp"
+#include "hsk_scene.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+namespace hsk {
+    void Prefab::Capture(Node* root) { Capture(std::vector<Node*>{root}); }
+
+    void Prefab::Capture(const std::vector<Node*>& roots)
+    {
+        mNodes.clear();
+        mAnimations.clear();
+        mSkins.clear();
+        mScene    = roots.size() ? dynamic_cast<Scene*>(roots.front()->GetCallbackDispatcher()) : nullptr;
+        mCopySize = NodeBlock::NodeSize();
+
+        std::vector<Node*>            captured;
+        std::vector<const hsk::Skin*> skins;
+        for(Node* root : roots)
+        {
+            CaptureNode(root, -1, captured, skins);
+        }
+        CaptureAnimations(captured);
+        CaptureSkins(captured, skins);
+    }
+
+    void Prefab::CaptureNode(Node* node, int32_t parentIndex, std::vector<Node*>& outcaptured, std::vector<const hsk::Skin*>& outskins)
+    {
+        int32_t    index     = (int32_t)mNodes.size();
+        Transform* transform = node->GetTransform();
+        NodeDesc   desc{.Parent      = parentIndex,
+                        .Translation = transform->GetTranslation(),
+                        .Rotation    = transform->GetRotation(),
+                        .Scale       = transform->GetScale(),
+                        .LocalMatrix = transform->GetLocalMatrix(),
+                        .Static      = transform->GetStatic()};
+        mCopySize += NodeBlock::NodeSize();
+
+        MeshInstance* meshInstance = node->GetComponent<MeshInstance>();
+        if(meshInstance && meshInstance->GetMesh())
+        {
+            desc.Mesh         = meshInstance->GetMesh();
+            desc.MorphWeights = meshInstance->GetMorphWeights();
+            if(auto instanced = dynamic_cast<InstancedMeshInstance*>(meshInstance))
+            {
+                desc.FirstInstance = instanced->GetFirstInstance();
+                desc.InstanceCount = instanced->GetInstanceCount();
+                mCopySize += NodeBlock::SizeOf<InstancedMeshInstance>();
+            }
+            else if(auto skinned = dynamic_cast<SkinnedMeshInstance*>(meshInstance))
+            {
+                HSK_ASSERTFMT(skinned->GetSkin(), "Prefab: Skinned mesh instance of captured node #{} has no skin!", index)
+                auto iter = std::find(outskins.begin(), outskins.end(), skinned->GetSkin());
+                desc.Skin = (int32_t)(iter - outskins.begin());
+                if(iter == outskins.end())
+                {
+                    outskins.push_back(skinned->GetSkin());
+                }
+                mCopySize += NodeBlock::SizeOf<SkinnedMeshInstance>();
+            }
+            else if(dynamic_cast<MorphedMeshInstance*>(meshInstance))
+            {
+                desc.Morphed = true;
+                mCopySize += NodeBlock::SizeOf<MorphedMeshInstance>();
+            }
+            else
+            {
+                mCopySize += NodeBlock::SizeOf<MeshInstance>();
+            }
+        }
+        mNodes.push_back(std::move(desc));
+        outcaptured.push_back(node);
+
+        for(Node* child : node->GetChildren())
+        {
+            CaptureNode(child, index, outcaptured, outskins);
+        }
+    }
+
+    void Prefab::CaptureAnimations(const std::vector<Node*>& captured)
+    {
+        AnimationDirector* director = mScene ? mScene->GetComponent<AnimationDirector>() : nullptr;
+        if(!director)
+        {
+            return;
+        }
+
+        std::unordered_map<Node*, int32_t> nodeIndices;
+        for(int32_t i = 0; i < (int32_t)captured.size(); i++)
+        {
+            nodeIndices[captured[i]] = i;
+        }
+        auto lGetIndex = [&](Node* node) {
+            auto iter = nodeIndices.find(node);
+            return iter != nodeIndices.end() ? iter->second : -1;
+        };
+
+        for(const Animation& animation : director->GetAnimations())
+        {
+            // Only channels targeting the captured subtree are copied
+            AnimationDesc desc{.Animation = animation, .Anchor = lGetIndex(animation.GetAnchor())};
+            desc.Animation.GetChannels().clear();
+            desc.Animation.SetAnchor(nullptr);
+            for(const AnimationChannel& channel : animation.GetChannels())
+            {
+                int32_t target = lGetIndex(channel.Target);
+                if(target >= 0)
+                {
+                    desc.Animation.GetChannels().push_back(AnimationChannel{.SamplerIndex = channel.SamplerIndex, .TargetPath = channel.TargetPath});
+                    desc.ChannelTargets.push_back(target);
+                }
+            }
+            if(desc.ChannelTargets.size())
+            {
+                mAnimations.push_back(std::move(desc));
+            }
+        }
+    }
+
+    void Prefab::CaptureSkins(const std::vector<Node*>& captured, const std::vector<const hsk::Skin*>& skins)
+    {
+        if(skins.empty())
+        {
+            return;
+        }
+
+        std::unordered_map<Node*, int32_t> nodeIndices;
+        for(int32_t i = 0; i < (int32_t)captured.size(); i++)
+        {
+            nodeIndices[captured[i]] = i;
+        }
+        auto lGetIndex = [&](Node* node) {
+            auto iter = nodeIndices.find(node);
+            return iter != nodeIndices.end() ? iter->second : -1;
+        };
+
+        for(const hsk::Skin* skin : skins)
+        {
+            SkinDesc desc{.Skin = *skin, .SkeletonRoot = lGetIndex(skin->GetSkeletonRoot())};
+            desc.Joints.reserve(skin->GetJoints().size());
+            bool external = false;
+            for(Node* joint : skin->GetJoints())
+            {
+                desc.Joints.push_back(lGetIndex(joint));
+                external |= joint && desc.Joints.back() < 0;
+            }
+            if(external)
+            {
+                logger()->warn("Prefab: Skin \"{}\" has joints outside the captured subtree, copies are posed by the original joints there", skin->GetName());
+            }
+            mSkins.push_back(std::move(desc));
+        }
+    }
+
+    void Prefab::Instantiate(Node* parent, uint32_t count, std::vector<Node*>& outroots)
+    {
+        if(!mScene || !count)
+        {
+            return;
+        }
+
+        // Copies continue the mesh instance indices of the scene
+        int32_t            nextInstanceIndex = 0;
+        std::vector<Node*> nodesWithMeshInstances;
+        mScene->FindNodesWithComponent<MeshInstance>(nodesWithMeshInstances);
+        for(Node* node : nodesWithMeshInstances)
+        {
+            nextInstanceIndex = std::max(nextInstanceIndex, node->GetComponent<MeshInstance>()->GetInstanceIndex() + 1);
+        }
+
+        NodeBlock* block    = mScene->MakeNodeBlock(mCopySize * count);
+        auto&      siblings = parent ? parent->GetChildren() : mScene->GetRootNodes();
+        siblings.reserve(siblings.size() + count);
+        outroots.reserve(outroots.size() + count);
+
+        AnimationDirector* director = mAnimations.size() ? mScene->GetComponent<AnimationDirector>() : nullptr;
+        if(director)
+        {
+            director->GetAnimations().reserve(director->GetAnimations().size() + mAnimations.size() * count);
+        }
+
+        GeometryStore* geo = mSkins.size() ? mScene->GetComponent<GeometryStore>() : nullptr;
+        if(geo)
+        {
+            geo->GetSkins().reserve(geo->GetSkins().size() + mSkins.size() * count);
+        }
+
+        std::vector<Node*>      copies(mNodes.size());
+        std::vector<hsk::Skin*> skins(mSkins.size());
+        for(uint32_t copyIndex = 0; copyIndex < count; copyIndex++)
+        {
+            Node* root = mScene->MakeNode(block, parent);
+            outroots.push_back(root);
+
+            // Skins of the copy are referenced by its skinned mesh instances, their joints are bound once all nodes of the copy exist
+            for(size_t i = 0; i < mSkins.size(); i++)
+            {
+                auto skin = std::make_unique<hsk::Skin>(mSkins[i].Skin);
+                skins[i]  = skin.get();
+                geo->GetSkins().push_back(std::move(skin));
+            }
+
+            for(size_t i = 0; i < mNodes.size(); i++)
+            {
+                const NodeDesc& desc = mNodes[i];
+                Node*           node = mScene->MakeNode(block, desc.Parent >= 0 ? copies[desc.Parent] : root);
+                copies[i]            = node;
+
+                Transform* transform = node->GetTransform();
+                transform->SetTranslation(desc.Translation);
+                transform->SetRotation(desc.Rotation);
+                transform->SetScale(desc.Scale);
+                transform->SetLocalMatrix(desc.LocalMatrix);
+                transform->SetStatic(desc.Static);
+
+                if(desc.Mesh)
+                {
+                    MeshInstance* meshInstance = nullptr;
+                    if(desc.InstanceCount)
+                    {
+                        auto instancedMeshInstance = block->MakeComponent<InstancedMeshInstance>(node);
+                        instancedMeshInstance->SetFirstInstance(desc.FirstInstance);
+                        instancedMeshInstance->SetInstanceCount(desc.InstanceCount);
+                        meshInstance = instancedMeshInstance;
+                    }
+                    else if(desc.Skin >= 0)
+                    {
+                        auto skinnedMeshInstance = block->MakeComponent<SkinnedMeshInstance>(node);
+                        skinnedMeshInstance->SetSkin(skins[desc.Skin]);
+                        meshInstance = skinnedMeshInstance;
+                    }
+                    else if(desc.Morphed)
+                    {
+                        meshInstance = block->MakeComponent<MorphedMeshInstance>(node);
+                    }
+                    else
+                    {
+                        meshInstance = block->MakeComponent<MeshInstance>(node);
+                    }
+                    meshInstance->SetMesh(desc.Mesh);
+                    meshInstance->SetInstanceIndex(nextInstanceIndex++);
+                    meshInstance->GetMorphWeights() = desc.MorphWeights;
+                }
+            }
+
+            for(size_t i = 0; i < mSkins.size(); i++)
+            {
+                const SkinDesc& desc   = mSkins[i];
+                auto&           joints = skins[i]->GetJoints();
+                for(size_t jointIndex = 0; jointIndex < desc.Joints.size(); jointIndex++)
+                {
+                    if(desc.Joints[jointIndex] >= 0)
+                    {
+                        joints[jointIndex] = copies[desc.Joints[jointIndex]];
+                    }
+                }
+                if(desc.SkeletonRoot >= 0)
+                {
+                    skins[i]->SetSkeletonRoot(copies[desc.SkeletonRoot]);
+                }
+            }
+
+            if(director)
+            {
+                for(const AnimationDesc& desc : mAnimations)
+                {
+                    Animation& animation = director->GetAnimations().emplace_back(desc.Animation);
+                    for(size_t i = 0; i < desc.ChannelTargets.size(); i++)
+                    {
+                        animation.GetChannels()[i].Target = copies[desc.ChannelTargets[i]];
+                    }
+                    animation.SetAnchor(desc.Anchor >= 0 ? copies[desc.Anchor] : nullptr);
+                }
+            }
+
+            root->GetTransform()->RecalculateGlobalMatrix();
+        }
+    }
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+#include "../hsk_basics.hpp"
+#include "../hsk_glm.hpp"
+#include "hsk_animation.hpp"
+#include "hsk_scenegraph_declares.hpp"
+#include "hsk_skin.hpp"
+#include <vector>
+
+namespace hsk {
+
+    /// @brief A captured subtree of a scene (nodes, transforms, mesh instances and the animations targeting them), instantiable many times in one call
+    /// @remark Copies share meshes, materials, textures and instance transforms with the captured subtree. All nodes and components of an Instantiate() call
+    /// are constructed in a single NodeBlock, so a copy costs a handful of constructors instead of a model import.
+    /// Skinned and morphed mesh instances are copied with their own deformation resources, created by SkinningStage once it picks up the new components.
+    /// Every copy gets a skin of its own, bound to the copied joints, so copies are posed by their own animations.
+    class Prefab
+    {
+      public:
+        /// @brief Captures the subtree below root (including root). Replaces the previous capture.
+        void Capture(Node* root);
+        /// @brief Captures the subtrees below all roots (e.g. the root nodes of a loaded model). Replaces the previous capture.
+        void Capture(const std::vector<Node*>& roots);
+
+        /// @brief Creates count copies of the captured subtrees
+        /// @param parent Node the copies are attached to. nullptr attaches them as root nodes.
+        /// @param outroots Receives one node per copy. It parents the copied subtrees and carries an identity transform, set it to place the copy.
+        /// Changes to its transform are applied with Transform::RecalculateGlobalMatrix().
+        void Instantiate(Node* parent, uint32_t count, std::vector<Node*>& outroots);
+
+        HSK_PROPERTY_CGET(Scene)
+        /// @brief Number of nodes created per copy, including the copy's root node
+        inline size_t GetNodeCount() const { return mNodes.size() + 1; }
+        /// @brief Bytes of the NodeBlock allocated per copy
+        HSK_PROPERTY_CGET(CopySize)
+
+      protected:
+        struct NodeDesc
+        {
+            /// @brief Index of the parent in mNodes, -1 for captured roots
+            int32_t   Parent      = -1;
+            glm::vec3 Translation = {};
+            glm::quat Rotation    = {};
+            glm::vec3 Scale       = glm::vec3(1.f);
+            glm::mat4 LocalMatrix = glm::mat4(1.f);
+            bool      Static      = false;
+            /// @brief nullptr if the node has no mesh instance
+            hsk::Mesh*         Mesh         = nullptr;
+            std::vector<float> MorphWeights = {};
+            /// @brief Instance buffer range of an InstancedMeshInstance, InstanceCount is 0 for regular mesh instances
+            uint32_t FirstInstance = 0;
+            uint32_t InstanceCount = 0;
+            /// @brief Index in mSkins of the skin of a SkinnedMeshInstance, -1 otherwise
+            int32_t Skin = -1;
+            /// @brief True if the mesh instance is a MorphedMeshInstance (but not a SkinnedMeshInstance)
+            bool Morphed = false;
+        };
+        struct SkinDesc
+        {
+            /// @brief Copy of the captured skin. Joints and skeleton root inside the captured subtree are replaced per copy.
+            hsk::Skin Skin = {};
+            /// @brief Index in mNodes of every joint, -1 for joints outside the captured subtree (copies keep the original joint)
+            std::vector<int32_t> Joints = {};
+            /// @brief Index in mNodes of the skeleton root, -1 if it is not set or outside the captured subtree
+            int32_t SkeletonRoot = -1;
+        };
+        struct AnimationDesc
+        {
+            /// @brief Channel targets and anchor are not set
+            hsk::Animation Animation = {};
+            /// @brief Index in mNodes of the target of every channel
+            std::vector<int32_t> ChannelTargets = {};
+            /// @brief Index in mNodes of the anchor, -1 if the animation has none
+            int32_t Anchor = -1;
+        };
+
+        Scene* mScene = nullptr;
+        /// @brief Parents are always stored before their children
+        std::vector<NodeDesc>      mNodes      = {};
+        std::vector<AnimationDesc> mAnimations = {};
+        std::vector<SkinDesc>      mSkins      = {};
+        size_t                     mCopySize   = 0;
+
+        /// @param outskins Receives the skins of skinned mesh instances, indexed by NodeDesc::Skin
+        void CaptureNode(Node* node, int32_t parentIndex, std::vector<Node*>& outcaptured, std::vector<const hsk::Skin*>& outskins);
+        void CaptureAnimations(const std::vector<Node*>& captured);
+        /// @brief Resolves the joints of the skins referenced by captured skinned mesh instances
+        void CaptureSkins(const std::vector<Node*>& captured, const std::vector<const hsk::Skin*>& skins);
+    };
+}  // namespace hsk
\ No newline at end of file
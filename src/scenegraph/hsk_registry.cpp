@@ -27,6 +27,7 @@ namespace hsk {
 
     void Registry::RegisterToRoot(Component* component)
     {
+        mCallbackDispatcher->mComponentRevision++;
         Component::DrawCallback* drawable = dynamic_cast<Component::DrawCallback*>(component);
         if(drawable)
         {
@@ -50,6 +51,7 @@ namespace hsk {
     }
     void Registry::UnregisterFromRoot(Component* component)
     {
+        mCallbackDispatcher->mComponentRevision++;
         Component::DrawCallback* drawable = dynamic_cast<Component::DrawCallback*>(component);
         if(drawable)
         {
@@ -72,12 +74,24 @@ namespace hsk {
         }
     }
 
+    void Registry::DestroyComponent(Component* component)
+    {
+        if(component->mInNodeBlock)
+        {
+            component->~Component();
+        }
+        else
+        {
+            delete component;
+        }
+    }
+
     void Registry::Cleanup()
     {
         for(auto component : mComponents)
         {
             UnregisterFromRoot(component);
-            delete component;
+            DestroyComponent(component);
         }
         mComponents.resize(0);
     }
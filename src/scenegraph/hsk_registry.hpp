@@ -75,6 +75,9 @@ namespace hsk {
 
         void RegisterToRoot(Component* component);
         void UnregisterFromRoot(Component* component);
+
+        /// @brief Deletes a component, or only destroys it if its memory is owned by a NodeBlock
+        static void DestroyComponent(Component* component);
     };
 
     template <typename TComponent, typename... Args>
@@ -183,7 +186,7 @@ namespace hsk {
         Assert(mCallbackDispatcher, "Registry::RemoveDeleteComponent: No Root Registry defined!");
         Assert(Unregister(component), "Registry::RemoveDeleteComponent: Component not registered!");
 
-        delete component;
+        DestroyComponent(component);
 
         return false;
     }
@@ -1,5 +1,6 @@
 #include "hsk_scene.hpp"
 #include "globalcomponents/hsk_geometrystore.hpp"
+#include "globalcomponents/hsk_instancebuffer.hpp"
 #include "globalcomponents/hsk_materialbuffer.hpp"
 #include "globalcomponents/hsk_texturestore.hpp"
 #include "hsk_node.hpp"
@@ -13,6 +14,7 @@ namespace hsk {
     void Scene::InitDefaultGlobals()
     {
         MakeComponent<MaterialBuffer>(mContext);
+        MakeComponent<InstanceBuffer>(mContext);
         MakeComponent<GeometryStore>();
         MakeComponent<TextureStore>();
     }
@@ -45,6 +47,19 @@ namespace hsk {
         auto nodeManagedPtr = std::make_unique<Node>(this, parent);
         auto node           = nodeManagedPtr.get();
         mNodeBuffer.push_back(std::move(nodeManagedPtr));
+        LinkNode(node, parent);
+        return node;
+    }
+
+    Node* Scene::MakeNode(NodeBlock* block, Node* parent)
+    {
+        Node* node = block->MakeNode(this, parent);
+        LinkNode(node, parent);
+        return node;
+    }
+
+    void Scene::LinkNode(Node* node, Node* parent)
+    {
         if(!parent)
         {
             mRootNodes.push_back(node);
@@ -52,7 +67,12 @@ namespace hsk {
         else{
             parent->GetChildren().push_back(node);
         }
-        return node;
+    }
+
+    NodeBlock* Scene::MakeNodeBlock(size_t capacity)
+    {
+        mNodeBlocks.push_back(std::make_unique<NodeBlock>(capacity));
+        return mNodeBlocks.back().get();
     }
 
     void Scene::Cleanup(bool reinitialize)
@@ -60,6 +80,7 @@ namespace hsk {
         // Clear Nodes (automatically clears attached components via Node deconstructor, called by the deconstructing unique_ptr)
         mRootNodes.clear();
         mNodeBuffer.clear();
+        mNodeBlocks.clear();
 
         // Clear global components
         Registry::Cleanup();
@@ -2,6 +2,7 @@
 #include "../osi/hsk_osi_declares.hpp"
 #include "hsk_callbackdispatcher.hpp"
 #include "hsk_node.hpp"
+#include "hsk_nodeblock.hpp"
 #include "hsk_registry.hpp"
 #include "hsk_scenedrawing.hpp"
 #include "hsk_scenegraph_declares.hpp"
@@ -21,6 +22,11 @@ namespace hsk {
 
         /// @brief Generates a new node and attaches it to the parent if it is set, root otherwise
         Node* MakeNode(Node* parent = nullptr);
+        /// @brief Generates a new node in the memory of block and attaches it to the parent if it is set, root otherwise
+        Node* MakeNode(NodeBlock* block, Node* parent);
+        /// @brief Creates a block for constructing nodes and components in bulk. The block is owned by the scene.
+        /// @param capacity Size of the block in bytes
+        NodeBlock* MakeNodeBlock(size_t capacity);
 
         /// @brief Advance scene state by invoking all NodeComponent update callbacks, followed by GlobalComponent update callbacks
         void Update(const FrameUpdateInfo& updateInfo);
@@ -46,6 +52,8 @@ namespace hsk {
         /// @brief Buffer holding ownership of all nodes
         /// @remark Holds unique ptrs to be able to preserve pointers if the buffer is changed or moved. These pointers may be null-equivalent.
         std::vector<std::unique_ptr<Node>> mNodeBuffer;
+        /// @brief Blocks holding ownership of nodes created in bulk
+        std::vector<std::unique_ptr<NodeBlock>> mNodeBlocks;
 
         /// @brief All nodes directly attached to the root
         std::vector<Node*> mRootNodes;
@@ -53,6 +61,8 @@ namespace hsk {
         CallbackDispatcher mGlobalRootRegistry;
 
         void InitDefaultGlobals();
+        /// @brief Appends node to the children of parent if it is set, to the root nodes otherwise
+        void LinkNode(Node* node, Node* parent);
     };
 
     template <typename TComponent>
@@ -13,6 +13,8 @@ namespace hsk {
         glm::mat4 ModelWorldMatrix         = glm::mat4(1);
         glm::mat4 PreviousModelWorldMatrix = glm::mat4(1);
         int32_t   MeshInstanceIndex        = -1;
+        /// @brief Material of the primitive drawn. Only pushed for geometry in EVertexLayout::Compact, which does not store a per vertex material index.
+        int32_t MaterialIndex = -1;
 
         inline static VkShaderStageFlags  GetShaderStageFlags();
         inline static VkPushConstantRange GetPushConstantRange();
@@ -39,6 +41,8 @@ namespace hsk {
         inline SceneDrawInfo(const hsk::FrameRenderInfo& renderInfo, VkPipelineLayout pipelineLayout);
 
         inline void CmdPushConstant(int32_t meshInstanceIndex, const glm::mat4& worldMatrix, const glm::mat4& prevWorldMatrix);
+        /// @brief Updates only the material index of the push constant. Does nothing if it is unchanged.
+        inline void CmdPushMaterialIndex(int32_t materialIndex);
     };
 
     void SceneDrawInfo::CmdPushConstant(int32_t meshInstanceIndex, const glm::mat4& worldMatrix, const glm::mat4& prevWorldMatrix)
@@ -47,6 +51,17 @@ namespace hsk {
         vkCmdPushConstants(RenderInfo.GetCommandBuffer(), PipelineLayout, DrawPushConstant::GetShaderStageFlags(), 0, sizeof(DrawPushConstant), &PushConstantState);
     }
 
+    void SceneDrawInfo::CmdPushMaterialIndex(int32_t materialIndex)
+    {
+        if(PushConstantState.MaterialIndex == materialIndex)
+        {
+            return;
+        }
+        PushConstantState.MaterialIndex = materialIndex;
+        vkCmdPushConstants(RenderInfo.GetCommandBuffer(), PipelineLayout, DrawPushConstant::GetShaderStageFlags(), offsetof(DrawPushConstant, MaterialIndex), sizeof(int32_t),
+                           &PushConstantState.MaterialIndex);
+    }
+
     SceneDrawInfo::SceneDrawInfo(const hsk::FrameRenderInfo& renderInfo, VkPipelineLayout pipelineLayout)
 
         : RenderInfo(renderInfo), PipelineLayout(pipelineLayout), PushConstantState()
@@ -4,6 +4,8 @@ namespace hsk {
     class CallbackDispatcher;
     class Component;
     class Node;
+    class NodeBlock;
+    class Prefab;
     class Scene;
     class Transform;
     class MeshInstance;
@@ -11,6 +13,7 @@ namespace hsk {
     class Primitive;
     class GeometryStore;
     class MaterialBuffer;
+    class InstanceBuffer;
     class TextureStore;
     class GeometryBufferSet;
     class Animation;
@@ -18,4 +21,9 @@ namespace hsk {
     struct AnimationChannel;
     struct PlaybackConfig;
     class AnimationDirector;
+    class Skin;
+    class SkinnedMeshInstance;
+    class MorphTargetSet;
+    class MorphedMeshInstance;
+    class InstancedMeshInstance;
 }  // namespace hsk
\ No newline at end of file
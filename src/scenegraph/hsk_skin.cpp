@@ -0,0 +1,103 @@
+#include "hsk_skin.hpp"
+#include "components/hsk_transform.hpp"
+#include "hsk_node.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64)
+#define HSK_SKINNING_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace hsk {
+    void Skin::CalculateJointPalette(const glm::mat4& meshWorldMatrix, glm::mat4* outpalette) const
+    {
+        // https://www.khronos.org/registry/glTF/specs/2.0/glTF-2.0.html#joint-hierarchy
+        glm::mat4 inverseMeshWorld = glm::inverse(meshWorldMatrix);
+        for(size_t i = 0; i < mJoints.size(); i++)
+        {
+            const glm::mat4& jointWorld = mJoints[i] ? mJoints[i]->GetTransform()->GetGlobalMatrix() : glm::mat4(1.f);
+            const glm::mat4& inverseBind = i < mInverseBindMatrices.size() ? mInverseBindMatrices[i] : glm::mat4(1.f);
+            outpalette[i]                = inverseMeshWorld * jointWorld * inverseBind;
+        }
+    }
+
+#ifdef HSK_SKINNING_SSE
+    namespace {
+        struct SseMatrix
+        {
+            __m128 Columns[4];
+        };
+
+        inline SseMatrix BlendJointMatrices(const VertexSkinData& skin, const glm::mat4* palette)
+        {
+            SseMatrix result;
+            for(int32_t column = 0; column < 4; column++)
+            {
+                result.Columns[column] = _mm_setzero_ps();
+            }
+            for(int32_t influence = 0; influence < 4; influence++)
+            {
+                float weight = skin.Weights[influence];
+                if(weight == 0.f)
+                {
+                    continue;
+                }
+                __m128       weight4 = _mm_set1_ps(weight);
+                const float* joint   = glm::value_ptr(palette[skin.Joints[influence]]);
+                for(int32_t column = 0; column < 4; column++)
+                {
+                    result.Columns[column] = _mm_add_ps(result.Columns[column], _mm_mul_ps(weight4, _mm_loadu_ps(joint + column * 4)));
+                }
+            }
+            return result;
+        }
+
+        inline __m128 Transform(const SseMatrix& matrix, const glm::vec3& vec, float w)
+        {
+            __m128 result = _mm_mul_ps(matrix.Columns[0], _mm_set1_ps(vec.x));
+            result        = _mm_add_ps(result, _mm_mul_ps(matrix.Columns[1], _mm_set1_ps(vec.y)));
+            result        = _mm_add_ps(result, _mm_mul_ps(matrix.Columns[2], _mm_set1_ps(vec.z)));
+            if(w != 0.f)
+            {
+                result = _mm_add_ps(result, matrix.Columns[3]);
+            }
+            return result;
+        }
+
+        inline glm::vec3 StoreVec3(__m128 value)
+        {
+            alignas(16) float components[4];
+            _mm_store_ps(components, value);
+            return glm::vec3(components[0], components[1], components[2]);
+        }
+    }  // namespace
+#endif
+
+    void SkinVerticesCpu(const Vertex* source, const VertexSkinData* skinData, const glm::mat4* palette, size_t paletteSize, Vertex* out, size_t count)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            const Vertex&        vertex = source[i];
+            const VertexSkinData& skin   = skinData[i];
+            Vertex&              result = out[i];
+
+            // Malformed assets may reference joints the skin does not have. All four indices are checked, zero weights are still multiplied by the scalar path.
+            HSK_ASSERTFMT(glm::all(glm::lessThan(skin.Joints, glm::uvec4((uint32_t)paletteSize))), "Vertex {} references a joint outside of the palette of {} matrices!", i,
+                          paletteSize)
+
+#ifdef HSK_SKINNING_SSE
+            SseMatrix skinMatrix = BlendJointMatrices(skin, palette);
+            result.Pos           = StoreVec3(Transform(skinMatrix, vertex.Pos, 1.f));
+            result.Normal        = glm::normalize(StoreVec3(Transform(skinMatrix, vertex.Normal, 0.f)));
+            result.Tangent       = glm::normalize(StoreVec3(Transform(skinMatrix, vertex.Tangent, 0.f)));
+#else
+            glm::mat4 skinMatrix = skin.Weights.x * palette[skin.Joints.x] + skin.Weights.y * palette[skin.Joints.y] + skin.Weights.z * palette[skin.Joints.z]
+                                   + skin.Weights.w * palette[skin.Joints.w];
+            result.Pos     = glm::vec3(skinMatrix * glm::vec4(vertex.Pos, 1.f));
+            result.Normal  = glm::normalize(glm::vec3(skinMatrix * glm::vec4(vertex.Normal, 0.f)));
+            result.Tangent = glm::normalize(glm::vec3(skinMatrix * glm::vec4(vertex.Tangent, 0.f)));
+#endif
+            result.Uv            = vertex.Uv;
+            result.MaterialIndex = vertex.MaterialIndex;
+        }
+    }
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+#include "../hsk_basics.hpp"
+#include "../hsk_glm.hpp"
+#include "hsk_geo.hpp"
+#include "hsk_scenegraph_declares.hpp"
+
+namespace hsk {
+
+    /// @brief Describes a skeleton: the set of joint nodes and their inverse bind matrices
+    /// @remark Skins are shared resources (stored in GeometryStore). Per instance state (joint palette, skinned vertices) lives in SkinnedMeshInstance
+    class Skin
+    {
+      public:
+        inline Skin() {}
+
+        HSK_PROPERTY_ALL(Name)
+        HSK_PROPERTY_ALL(Joints)
+        HSK_PROPERTY_ALL(InverseBindMatrices)
+        HSK_PROPERTY_ALL(SkeletonRoot)
+
+        /// @brief Calculates the joint palette (one matrix per joint) transforming mesh space bind pose vertices into the skinned pose in mesh space
+        /// @param meshWorldMatrix The global matrix of the node the skinned mesh is attached to
+        /// @param outpalette Destination, expected to have room for GetJoints().size() matrices
+        void CalculateJointPalette(const glm::mat4& meshWorldMatrix, glm::mat4* outpalette) const;
+
+      protected:
+        std::string            mName                = {};
+        std::vector<Node*>     mJoints              = {};
+        std::vector<glm::mat4> mInverseBindMatrices = {};
+        Node*                  mSkeletonRoot        = nullptr;
+    };
+
+    /// @brief CPU reference implementation of linear blend skinning. Uses SSE where available, scalar code otherwise.
+    /// @remark Produces the same results as the skinning compute shader, used for validating the GPU path and for CPU side consumers (picking, bounds)
+    /// @param source Bind pose vertices
+    /// @param skinData Joint indices and weights, one entry per source vertex
+    /// @param palette Joint palette as calculated by Skin::CalculateJointPalette
+    /// @param paletteSize Number of matrices in palette. Throws if a vertex references a joint index outside of the palette.
+    /// @param out Destination for the skinned vertices
+    /// @param count Number of vertices to process
+    void SkinVerticesCpu(const Vertex* source, const VertexSkinData* skinData, const glm::mat4* palette, size_t paletteSize, Vertex* out, size_t count);
+}  // namespace hsk
\ No newline at end of file
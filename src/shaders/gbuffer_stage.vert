@@ -22,14 +22,19 @@ layout (location = 6) flat out int outMaterialIndex;	// Material Index
 #define BIND_CAMERA_UBO 2
 #include "camera.glsl"
 
+#define BIND_INSTANCE_BUFFER 3
+#include "instancebuffer.glsl"
+
 void main() 
 {
 	mat4 ProjMat = Camera.ProjectionMatrix;
 	mat4 ViewMat = Camera.ViewMatrix;
-	mat4 ModelMat = PushConstant.ModelWorldMatrix;
+	// Instance transforms are static, both frames use the same one
+	mat4 InstanceMat = GetInstanceMatrix(gl_InstanceIndex);
+	mat4 ModelMat = PushConstant.ModelWorldMatrix * InstanceMat;
 	mat4 ProjMatPrev = Camera.PreviousProjectionMatrix;
 	mat4 ViewMatPrev = Camera.PreviousViewMatrix;
-	mat4 ModelMatPrev = PushConstant.PreviousModelWorldMatrix;
+	mat4 ModelMatPrev = PushConstant.PreviousModelWorldMatrix * InstanceMat;
 
 	// Get transformations out of the way
 	outWorldPos = (ModelMat * vec4(inPos, 1.f)).xyz;
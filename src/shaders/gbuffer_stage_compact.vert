@@ -0,0 +1,52 @@
+#version 450
+#extension GL_GOOGLE_include_directive : enable
+#extension GL_KHR_vulkan_glsl: enable
+
+// Variant of gbuffer_stage.vert for geometry in hsk::EVertexLayout::Compact
+
+layout (location = 0) in vec3 inPos;			// Vertex position in model space
+layout (location = 1) in vec2 inNormal;			// Vertex normal (octahedral encoded, snorm)
+layout (location = 2) in vec2 inTangent;		// Vertex tangent (octahedral encoded, snorm)
+layout (location = 3) in vec2 inUV;				// UV coordinates (half float)
+
+layout (location = 0) out vec3 outWorldPos;				// Vertex position in world space
+layout (location = 1) out vec4 outDevicePos;			// Vertex position in normalized device space (current frame)
+layout (location = 2) out vec4 outOldDevicePos;			// Vertex position in normalized device space (previous frame)
+layout (location = 3) out vec3 outNormal; 				// Normal in world space
+layout (location = 4) out vec3 outTangent;				// Tangent in world space
+layout (location = 5) out vec2 outUV;					// UV coordinates
+layout (location = 6) flat out int outMaterialIndex;	// Material Index
+
+#define BIND_INSTANCE_PUSHC
+#include "gltf_pushc.glsl"
+
+#define BIND_CAMERA_UBO 2
+#include "camera.glsl"
+
+#define BIND_INSTANCE_BUFFER 3
+#include "instancebuffer.glsl"
+
+#include "vertexlayout.glsl"
+
+void main() 
+{
+	// Instance transforms are static, both frames use the same one
+	mat4 InstanceMat = GetInstanceMatrix(gl_InstanceIndex);
+	mat4 ModelMat = PushConstant.ModelWorldMatrix * InstanceMat;
+	mat4 ModelMatPrev = PushConstant.PreviousModelWorldMatrix * InstanceMat;
+
+	outWorldPos = (ModelMat * vec4(inPos, 1.f)).xyz;
+	outDevicePos = Camera.ProjectionViewMatrix * ModelMat * vec4(inPos, 1.f);
+	gl_Position = outDevicePos;
+	outOldDevicePos = Camera.PreviousProjectionViewMatrix * ModelMatPrev * vec4(inPos, 1.f);
+
+	outUV = inUV;
+
+	// Normal in world space
+	mat3 mNormal = transpose(inverse(mat3(1.0)));
+	outNormal = mNormal * DecodeOctahedral(inNormal);
+	outTangent = mNormal * DecodeOctahedral(inTangent);
+
+	// Material is constant per primitive
+	outMaterialIndex = PushConstant.MaterialIndex;
+}
\ No newline at end of file
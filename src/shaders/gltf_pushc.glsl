@@ -4,5 +4,6 @@ layout ( push_constant ) uniform PushConstantBlock
     mat4 ModelWorldMatrix;
     mat4 PreviousModelWorldMatrix;
     int MeshId;
+    int MaterialIndex;
 } PushConstant;
 #endif
\ No newline at end of file
@@ -0,0 +1,22 @@
+// Per instance transforms of instanced mesh draws (EXT_mesh_gpu_instancing), indexed with gl_InstanceIndex. Entry 0 is the identity.
+
+#ifdef BIND_INSTANCE_BUFFER
+#ifndef SET_INSTANCE_BUFFER
+#define SET_INSTANCE_BUFFER 0
+#endif // SET_INSTANCE_BUFFER
+
+// First three rows of the instance's affine transform
+struct InstanceTransform
+{
+    vec4 Rows[3];
+};
+
+layout(set = SET_INSTANCE_BUFFER, binding = BIND_INSTANCE_BUFFER ) buffer readonly InstanceBuffer { InstanceTransform Array[]; } Instances;
+
+mat4 GetInstanceMatrix(in int index)
+{
+    InstanceTransform instance = Instances.Array[index];
+    return transpose(mat4(instance.Rows[0], instance.Rows[1], instance.Rows[2], vec4(0.f, 0.f, 0.f, 1.f)));
+}
+
+#endif // BIND_INSTANCE_BUFFER
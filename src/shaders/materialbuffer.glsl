@@ -83,7 +83,9 @@ MaterialProbe ProbeMaterial(in MaterialBufferObject material, in vec2 uv)
     // Grab Normal Deviation
     if(material.NormalTextureIndex >= 0)
     {
-        result.Normal = SampleTexture(material.NormalTextureIndex, uv).xyz;
+        // z is reconstructed, so two channel (BC5) normal maps work as well
+        vec2 xy       = SampleTexture(material.NormalTextureIndex, uv).xy * 2.0 - 1.0;
+        result.Normal = vec3(xy, sqrt(max(1.0 - dot(xy, xy), 0.0))) * 0.5 + 0.5;
     }
     else
     {
@@ -0,0 +1,33 @@
+#ifndef VERTEXLAYOUT_GLSL
+#define VERTEXLAYOUT_GLSL
+
+// Decoding / encoding of the attributes of hsk::CompactVertex (see hsk_geo.hpp)
+
+// Octahedral mapped unit vector, stored as 2x 16 bit snorm
+vec3 DecodeOctahedral(vec2 encoded)
+{
+    vec3 vector = vec3(encoded.x, encoded.y, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-vector.z, 0.0);
+    vector.x += vector.x >= 0.0 ? -fold : fold;
+    vector.y += vector.y >= 0.0 ? -fold : fold;
+    return normalize(vector);
+}
+
+vec2 EncodeOctahedral(vec3 vector)
+{
+    float manhattanLength = abs(vector.x) + abs(vector.y) + abs(vector.z);
+    if(manhattanLength <= 0.0)
+    {
+        // Degenerate (zero length) vectors are encoded as +Z
+        return vec2(0.0);
+    }
+    vector /= manhattanLength;
+    vec2 encoded = vector.xy;
+    if(vector.z < 0.0)
+    {
+        encoded = (1.0 - abs(vector.yx)) * vec2(vector.x >= 0.0 ? 1.0 : -1.0, vector.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return encoded;
+}
+
+#endif  // VERTEXLAYOUT_GLSL
\ No newline at end of file
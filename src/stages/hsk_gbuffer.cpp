@@ -4,6 +4,7 @@
 #include "../utility/hsk_shadermodule.hpp"
 #include "../utility/hsk_shaderstagecreateinfos.hpp"
 #include "../scenegraph/globalcomponents/hsk_geometrystore.hpp"
+#include "../scenegraph/globalcomponents/hsk_instancebuffer.hpp"
 #include "../scenegraph/globalcomponents/hsk_materialbuffer.hpp"
 #include "../scenegraph/globalcomponents/hsk_texturestore.hpp"
 #include "../scenegraph/components/hsk_meshinstance.hpp"
@@ -212,8 +213,10 @@ namespace hsk {
         std::vector<Node*> nodes;
         mScene->FindNodesWithComponent<Camera>(nodes);
         mDescriptorSet.SetDescriptorInfoAt(2, nodes.front()->GetComponent<Camera>()->GetUboDescriptorInfos());
+        mDescriptorSet.SetDescriptorInfoAt(3, mScene->GetComponent<InstanceBuffer>()->MakeDescriptorInfo());
 
         VkDescriptorSetLayout descriptorSetLayout = mDescriptorSet.Create(mContext, "GBuffer_DescriptorSet");
+        mInstanceBufferRevisions.assign(mDescriptorSet.GetDescriptorSets().size(), mScene->GetComponent<InstanceBuffer>()->GetBufferRevision());
 
         std::vector<VkPushConstantRange> pushConstantRanges({{.stageFlags = VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT | VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT,
                                                               .offset     = 0,
@@ -229,6 +232,26 @@ namespace hsk {
         AssertVkResult(vkCreatePipelineLayout(mContext->Device, &pipelineLayoutCI, nullptr, &mPipelineLayout));
     }
 
+    void GBufferStage::UpdateInstanceBufferDescriptor(size_t setIndex)
+    {
+        InstanceBuffer* instanceBuffer = mScene->GetComponent<InstanceBuffer>();
+        if(mInstanceBufferRevisions[setIndex] == instanceBuffer->GetBufferRevision())
+        {
+            return;
+        }
+
+        // The set was last bound by a frame that has completed, so it can be written without waiting
+        VkDescriptorBufferInfo bufferInfo = instanceBuffer->GetDescriptorBufferInfo();
+        VkWriteDescriptorSet   write{.sType           = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                                     .dstSet          = mDescriptorSet.GetDescriptorSets()[setIndex],
+                                     .dstBinding      = 3,
+                                     .descriptorCount = 1,
+                                     .descriptorType  = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                     .pBufferInfo     = &bufferInfo};
+        vkUpdateDescriptorSets(mContext->Device, 1, &write, 0, nullptr);
+        mInstanceBufferRevisions[setIndex] = instanceBuffer->GetBufferRevision();
+    }
+
     void GBufferStage::RecordFrame(FrameRenderInfo& renderInfo)
     {
         VkRenderPassBeginInfo renderPassBeginInfo{};
@@ -252,9 +275,11 @@ namespace hsk {
         vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipeline);
 
         const auto& descriptorsets = mDescriptorSet.GetDescriptorSets();
+        size_t      setIndex       = renderInfo.GetFrameNumber() % 2;
+        UpdateInstanceBufferDescriptor(setIndex);
 
         // Instanced object
-        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout, 0, 1, &(descriptorsets[(renderInfo.GetFrameNumber()) % 2]), 0, nullptr);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipelineLayout, 0, 1, &(descriptorsets[setIndex]), 0, nullptr);
         mScene->Draw(renderInfo, mPipelineLayout);  // TODO: does pipeline has to be passed? Technically a scene could build pipelines themselves.
 
         vkCmdEndRenderPass(commandBuffer);
@@ -267,18 +292,24 @@ namespace hsk {
         AssertVkResult(vkCreatePipelineCache(mContext->Device, &pipelineCacheCreateInfo, nullptr, &mPipelineCache));
 
         // shader stages
-        auto                   vertShaderModule = ShaderModule(mContext, "../hsk_rt_rpf/src/shaders/gbuffer_stage.vert.spv");
+        bool                   compact          = mVertexLayout == EVertexLayout::Compact;
+        auto                   vertShaderModule = ShaderModule(mContext, compact ? "../hsk_rt_rpf/src/shaders/gbuffer_stage_compact.vert.spv" : "../hsk_rt_rpf/src/shaders/gbuffer_stage.vert.spv");
         auto                   fragShaderModule = ShaderModule(mContext, "../hsk_rt_rpf/src/shaders/gbuffer_stage.frag.spv");
         ShaderStageCreateInfos shaderStageCreateInfos;
         shaderStageCreateInfos.Add(VK_SHADER_STAGE_VERTEX_BIT, vertShaderModule).Add(VK_SHADER_STAGE_FRAGMENT_BIT, fragShaderModule);
 
         // vertex layout
         VertexInputStateBuilder vertexInputStateBuilder;
+        vertexInputStateBuilder.Layout = mVertexLayout;
         vertexInputStateBuilder.AddVertexComponentBinding(EVertexComponent::Position);
         vertexInputStateBuilder.AddVertexComponentBinding(EVertexComponent::Normal);
         vertexInputStateBuilder.AddVertexComponentBinding(EVertexComponent::Tangent);
         vertexInputStateBuilder.AddVertexComponentBinding(EVertexComponent::Uv);
-        vertexInputStateBuilder.AddVertexComponentBinding(EVertexComponent::MaterialIndex);
+        if(!compact)
+        {
+            // Compact layout sources the material index from the push constant
+            vertexInputStateBuilder.AddVertexComponentBinding(EVertexComponent::MaterialIndex);
+        }
         vertexInputStateBuilder.Build();
 
         // clang-format off
@@ -19,10 +19,16 @@ namespace hsk {
         inline static constexpr std::string_view MeshInstanceIndex  = "MeshId";
         inline static constexpr std::string_view MaterialIndex      = "MaterialId";
 
+        /// @brief Vertex layout of the scene geometry (see ModelConverter::Config::VertexLayout). Set before Init()
+        HSK_PROPERTY_ALL(VertexLayout)
+
       protected:
         Scene* mScene;
+        EVertexLayout mVertexLayout = EVertexLayout::Full;
         std::vector<VkClearValue> mClearValues;
         std::vector<std::unique_ptr<ManagedImage>> mGBufferImages;
+        /// @brief InstanceBuffer revision the instance binding of each descriptor set was written with
+        std::vector<uint64_t> mInstanceBufferRevisions;
 
         virtual void CreateFixedSizeComponents() override;
         virtual void DestroyFixedComponents() override;
@@ -33,6 +39,8 @@ namespace hsk {
         void PrepareAttachments();
         void PrepareRenderpass();
         void SetupDescriptors();
+        /// @brief Rewrites the instance binding of a descriptor set if the scene's InstanceBuffer has been recreated since (loads at runtime grow it)
+        void UpdateInstanceBufferDescriptor(size_t setIndex);
         void BuildCommandBuffer(){};
         void PreparePipeline();
     };
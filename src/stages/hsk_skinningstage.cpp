@@ -0,0 +1,130 @@
+#include "hsk_skinningstage.hpp"
+#include "../hsk_vkHelpers.hpp"
+#include "../scenegraph/components/hsk_morphedmeshinstance.hpp"
+#include "../scenegraph/components/hsk_skinnedmeshinstance.hpp"
+#include "../utility/hsk_shadermodule.hpp"
+
+namespace hsk {
+    void SkinningStage::Init(const VkContext* context, Scene* scene)
+    {
+        mContext = context;
+        mScene   = scene;
+        RefreshInstances();
+    }
+
+    void SkinningStage::RefreshInstances()
+    {
+        std::vector<Node*> nodes;
+        mScene->FindNodesWithComponent<MorphedMeshInstance>(nodes);
+
+        mMorphedInstances.clear();
+        mSkinnedInstances.clear();
+        mMorphedInstances.reserve(nodes.size());
+        mInstancesRevision = mScene->GetComponentRevision();
+        for(Node* node : nodes)
+        {
+            auto instance = node->GetComponent<MorphedMeshInstance>();
+            instance->InitDeviceResources(mContext);
+            mMorphedInstances.push_back(instance);
+            auto skinnedInstance = dynamic_cast<SkinnedMeshInstance*>(instance);
+            if(skinnedInstance)
+            {
+                mSkinnedInstances.push_back(skinnedInstance);
+            }
+        }
+
+        if(mSkinnedInstances.size() && !mPipeline)
+        {
+            // All instance descriptor set layouts are defined identically, so any of them is compatible with the pipeline layout
+            PreparePipeline(mSkinnedInstances.front()->GetDescriptorSet().GetDescriptorSetLayout());
+        }
+    }
+
+    void SkinningStage::PreparePipeline(VkDescriptorSetLayout descriptorSetLayout)
+    {
+        VkPushConstantRange pushConstantRange{.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .offset = 0, .size = sizeof(SkinningPushConstant)};
+
+        VkPipelineLayoutCreateInfo pipelineLayoutCI{};
+        pipelineLayoutCI.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutCI.pushConstantRangeCount = 1;
+        pipelineLayoutCI.pPushConstantRanges    = &pushConstantRange;
+        pipelineLayoutCI.setLayoutCount         = 1;
+        pipelineLayoutCI.pSetLayouts            = &descriptorSetLayout;
+        AssertVkResult(vkCreatePipelineLayout(mContext->Device, &pipelineLayoutCI, nullptr, &mPipelineLayout));
+
+        auto compShaderModule = ShaderModule(mContext, "../hsk_rt_rpf/src/shaders/skinning.comp.spv");
+
+        VkComputePipelineCreateInfo pipelineCI{};
+        pipelineCI.sType        = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineCI.stage.sType  = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineCI.stage.stage  = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineCI.stage.module = compShaderModule;
+        pipelineCI.stage.pName  = "main";
+        pipelineCI.layout       = mPipelineLayout;
+        AssertVkResult(vkCreateComputePipelines(mContext->Device, nullptr, 1, &pipelineCI, nullptr, &mPipeline));
+    }
+
+    void SkinningStage::RecordFrame(FrameRenderInfo& renderInfo)
+    {
+        // Models have been loaded or unloaded, the stored instance pointers may be stale
+        if(mScene->GetComponentRevision() != mInstancesRevision)
+        {
+            RefreshInstances();
+        }
+
+        // Host writes to the morphed vertex buffers are made visible by the queue submission
+        for(MorphedMeshInstance* instance : mMorphedInstances)
+        {
+            instance->UpdateMorph(renderInfo);
+        }
+
+        if(!mPipeline || !mSkinnedInstances.size())
+        {
+            return;
+        }
+
+        VkCommandBuffer commandBuffer = renderInfo.GetCommandBuffer();
+
+        // Previous frame's vertex fetch of the skinned vertices must finish before they are overwritten
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mPipeline);
+
+        bool dispatched = false;
+        for(SkinnedMeshInstance* instance : mSkinnedInstances)
+        {
+            dispatched |= instance->CmdSkin(renderInfo, mPipelineLayout);
+        }
+
+        if(dispatched)
+        {
+            VkMemoryBarrier barrier{};
+            barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        }
+    }
+
+    void SkinningStage::DestroyPipeline()
+    {
+        if(mPipeline)
+        {
+            vkDestroyPipeline(mContext->Device, mPipeline, nullptr);
+            mPipeline = nullptr;
+        }
+        if(mPipelineLayout)
+        {
+            vkDestroyPipelineLayout(mContext->Device, mPipelineLayout, nullptr);
+            mPipelineLayout = nullptr;
+        }
+    }
+
+    void SkinningStage::Destroy()
+    {
+        DestroyPipeline();
+        mMorphedInstances.clear();
+        mSkinnedInstances.clear();
+        RenderStage::Destroy();
+    }
+}  // namespace hsk
\ No newline at end of file
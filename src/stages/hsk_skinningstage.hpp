@@ -0,0 +1,41 @@
+#pragma once
+#include "../base/hsk_vkcontext.hpp"
+#include "../scenegraph/hsk_scene.hpp"
+#include "hsk_renderstage.hpp"
+
+namespace hsk {
+    /// @brief Pre-pass deforming all MorphedMeshInstance and SkinnedMeshInstance components of a scene. Morph targets are blended on the CPU, skinning is a compute pass.
+    /// @remark Record once per frame before any stage drawing the scene (e.g. GBufferStage). Every instance is deformed at most once per frame,
+    /// so multiple stages / passes drawing the scene do not multiply the deformation cost.
+    /// The instance list follows loads and unloads automatically: RecordFrame() collects the instances again whenever components of the scene have changed.
+    class SkinningStage : public RenderStage
+    {
+      public:
+        SkinningStage() = default;
+        inline virtual ~SkinningStage() { Destroy(); }
+
+        virtual void Init(const VkContext* context, Scene* scene);
+        virtual void RecordFrame(FrameRenderInfo& renderInfo) override;
+        virtual void Destroy() override;
+
+        /// @brief Collects morphed and skinned mesh instances from the scene again and creates their device resources
+        /// @remark Called by RecordFrame() if the scene's components have changed since the last call (see CallbackDispatcher::GetComponentRevision())
+        void RefreshInstances();
+
+        HSK_PROPERTY_CGET(MorphedInstances)
+        HSK_PROPERTY_CGET(SkinnedInstances)
+
+      protected:
+        Scene*                            mScene            = nullptr;
+        VkPipeline                        mPipeline         = nullptr;
+        VkPipelineLayout                  mPipelineLayout   = nullptr;
+        /// @brief All deformed instances (skinned instances are morphed instances too)
+        std::vector<MorphedMeshInstance*> mMorphedInstances = {};
+        std::vector<SkinnedMeshInstance*> mSkinnedInstances = {};
+        /// @brief Component revision of the scene the instance lists were collected at
+        uint64_t mInstancesRevision = 0;
+
+        void PreparePipeline(VkDescriptorSetLayout descriptorSetLayout);
+        void DestroyPipeline();
+    };
+}  // namespace hsk
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "../hsk_basics.hpp"
+#include <mutex>
 #include <unordered_set>
 #include <vulkan/vulkan.h>
 
@@ -10,6 +11,8 @@ namespace hsk {
     {
         /// @brief Every allocation registers with its name, so when clearing up, we can track if there are unfreed resources left.
         static inline std::unordered_set<DeviceResourceBase*> sAllocatedRessources{};
+        /// @brief Resources are created on import worker threads as well (see MultiModelLoad)
+        static inline std::mutex sAllocatedRessourcesMutex{};
 
       public:
         static const std::unordered_set<DeviceResourceBase*>* GetTotalAllocatedResources() { return &sAllocatedRessources; }
@@ -17,8 +20,16 @@ namespace hsk {
         virtual bool Exists() const     = 0;
         virtual void Cleanup()          = 0;
 
-        DeviceResourceBase() { sAllocatedRessources.insert(this); }
-        inline virtual ~DeviceResourceBase() { sAllocatedRessources.erase(this); }
+        DeviceResourceBase()
+        {
+            std::lock_guard<std::mutex> lock(sAllocatedRessourcesMutex);
+            sAllocatedRessources.insert(this);
+        }
+        inline virtual ~DeviceResourceBase()
+        {
+            std::lock_guard<std::mutex> lock(sAllocatedRessourcesMutex);
+            sAllocatedRessources.erase(this);
+        }
 
         std::string_view                   GetName() const { return mName; }
         inline virtual DeviceResourceBase& SetName(std::string_view name);
@@ -1,5 +1,6 @@
 #pragma once
 #include "../hsk_basics.hpp"
+#include <cstring>
 
 namespace hsk {
     template <typename T>
@@ -11,5 +12,40 @@ namespace hsk {
         hash ^= vhash + 0x9e3779b9 + (hash << 6) + (hash >> 2);
     }
 
+    /// @brief 64 bit hash of a memory range, for content keys (e.g. texture deduplication). Not suitable against adversarial input.
+    /// @remark Processes 8 bytes per step with the xxHash64 round and avalanche functions, fast enough for hashing large pixel buffers
+    inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0)
+    {
+        const uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+        const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+        const uint64_t PRIME3 = 0x165667B19E3779F9ull;
+        const uint64_t PRIME4 = 0x85EBCA77C2B2AE63ull;
+        const uint64_t PRIME5 = 0x27D4EB2F165667C5ull;
+
+        auto lRotl = [](uint64_t value, int32_t bits) { return (value << bits) | (value >> (64 - bits)); };
+
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+        uint64_t       hash  = seed + PRIME5 + (uint64_t)size;
+        size_t         i     = 0;
+        for(; i + 8 <= size; i += 8)
+        {
+            uint64_t word;
+            memcpy(&word, bytes + i, 8);
+            hash ^= lRotl(word * PRIME2, 31) * PRIME1;
+            hash = lRotl(hash, 27) * PRIME1 + PRIME4;
+        }
+        for(; i < size; i++)
+        {
+            hash ^= bytes[i] * PRIME5;
+            hash = lRotl(hash, 11) * PRIME1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= PRIME2;
+        hash ^= hash >> 29;
+        hash *= PRIME3;
+        hash ^= hash >> 32;
+        return hash;
+    }
 
 }  // namespace hsk
\ No newline at end of file
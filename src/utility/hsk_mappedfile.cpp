@@ -0,0 +1,135 @@
+#include "hsk_mappedfile.hpp"
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hsk {
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if(this != &other)
+        {
+            Close();
+            std::swap(mData, other.mData);
+            std::swap(mSize, other.mSize);
+            std::swap(mOpen, other.mOpen);
+#ifdef _WIN32
+            std::swap(mFile, other.mFile);
+            std::swap(mMapping, other.mMapping);
+#endif
+        }
+        return *this;
+    }
+
+#ifdef _WIN32
+    bool MappedFile::Open(const std::filesystem::path& path)
+    {
+        Close();
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if(file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+        LARGE_INTEGER size{};
+        if(!GetFileSizeEx(file, &size))
+        {
+            CloseHandle(file);
+            return false;
+        }
+        mFile = file;
+        mSize = (size_t)size.QuadPart;
+        mOpen = true;
+        if(!mSize)
+        {
+            // Empty files can't be mapped
+            return true;
+        }
+        mMapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        mData    = mMapping ? reinterpret_cast<const uint8_t*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+        if(!mData)
+        {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if(mData)
+        {
+            UnmapViewOfFile(mData);
+        }
+        if(mMapping)
+        {
+            CloseHandle(mMapping);
+        }
+        if(mFile)
+        {
+            CloseHandle(mFile);
+        }
+        mData    = nullptr;
+        mMapping = nullptr;
+        mFile    = nullptr;
+        mSize    = 0;
+        mOpen    = false;
+    }
+#else
+    bool MappedFile::Open(const std::filesystem::path& path)
+    {
+        Close();
+        int file = open(path.c_str(), O_RDONLY);
+        if(file < 0)
+        {
+            return false;
+        }
+        struct stat status{};
+        if(fstat(file, &status) != 0)
+        {
+            close(file);
+            return false;
+        }
+        mSize = (size_t)status.st_size;
+        mOpen = true;
+        if(mSize)
+        {
+            void* mapped = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, file, 0);
+            if(mapped == MAP_FAILED)
+            {
+                close(file);
+                Close();
+                return false;
+            }
+            mData = reinterpret_cast<const uint8_t*>(mapped);
+            // Contents are usually read front to back exactly once
+            madvise(mapped, mSize, MADV_SEQUENTIAL);
+        }
+        // The mapping keeps the file referenced
+        close(file);
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if(mData)
+        {
+            munmap(const_cast<uint8_t*>(mData), mSize);
+        }
+        mData = nullptr;
+        mSize = 0;
+        mOpen = false;
+    }
+#endif
+}  // namespace hsk
\ No newline at end of file
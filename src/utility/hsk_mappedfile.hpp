@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace hsk {
+
+    /// @brief Read only memory mapping of a file. The file contents are paged in on access, so reading is limited by I/O bandwidth instead of copies.
+    /// @remark Empty files can be opened, GetData() returns nullptr for them.
+    class MappedFile
+    {
+      public:
+        MappedFile() = default;
+        MappedFile(const MappedFile& other)            = delete;
+        MappedFile& operator=(const MappedFile& other) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+        inline ~MappedFile() { Close(); }
+
+        /// @brief Maps a file, closing the file mapped before
+        /// @return False if the file can not be opened or mapped
+        bool Open(const std::filesystem::path& path);
+        void Close();
+
+        inline bool           IsOpen() const { return mOpen; }
+        inline const uint8_t* GetData() const { return mData; }
+        inline size_t         GetSize() const { return mSize; }
+
+      protected:
+        const uint8_t* mData = nullptr;
+        size_t         mSize = 0;
+        bool           mOpen = false;
+#ifdef _WIN32
+        void* mFile    = nullptr;
+        void* mMapping = nullptr;
+#endif
+    };
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "hsk_threadpool.hpp"
+
+namespace hsk {
+    ThreadPool::ThreadPool(uint32_t threadCount)
+    {
+        if(!threadCount)
+        {
+            threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        mWorkers.reserve(threadCount);
+        for(uint32_t i = 0; i < threadCount; i++)
+        {
+            mWorkers.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+        mTaskAvailable.notify_all();
+        for(auto& worker : mWorkers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::Push(std::function<void()>&& task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTasks.push(std::move(task));
+        }
+        mTaskAvailable.notify_one();
+    }
+
+    void ThreadPool::WaitIdle()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mIdle.wait(lock, [this]() { return mTasks.empty() && mActiveTasks == 0; });
+    }
+
+    void ThreadPool::WorkerLoop()
+    {
+        while(true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mTaskAvailable.wait(lock, [this]() { return mStopping || !mTasks.empty(); });
+                if(mTasks.empty())
+                {
+                    // Only reached when stopping
+                    return;
+                }
+                task = std::move(mTasks.front());
+                mTasks.pop();
+                mActiveTasks++;
+            }
+
+            task();
+
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mActiveTasks--;
+                if(mTasks.empty() && mActiveTasks == 0)
+                {
+                    mIdle.notify_all();
+                }
+            }
+        }
+    }
+
+    ThreadPool& ThreadPool::Default()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+}  // namespace hsk
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace hsk {
+
+    /// @brief Fixed size pool of worker threads processing a FIFO queue of tasks
+    /// @remark Used by import code (image decoding, async model loading). Tasks must not throw into the pool, exceptions are forwarded through the returned futures.
+    class ThreadPool
+    {
+      public:
+        /// @param threadCount Number of worker threads. 0 selects std::thread::hardware_concurrency()
+        explicit ThreadPool(uint32_t threadCount = 0);
+        ThreadPool(const ThreadPool& other)            = delete;
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+        ~ThreadPool();
+
+        /// @brief Queues a task for execution on a worker thread
+        /// @return Future receiving the return value (or exception) of the task
+        template <typename TFunc>
+        auto Enqueue(TFunc&& func) -> std::future<std::invoke_result_t<TFunc>>;
+
+        /// @brief Calls func(index) for every index in [0, count), distributed over all workers. Blocks until all calls have finished.
+        /// @remark The calling thread participates. The first exception thrown by any call is rethrown after all calls have finished.
+        /// Must not be called from a task running on the same pool (helpers could starve behind the calling task).
+        template <typename TFunc>
+        void ParallelFor(size_t count, TFunc&& func);
+
+        /// @brief Blocks until the queue is empty and no task is executing
+        void WaitIdle();
+
+        inline uint32_t GetThreadCount() const { return static_cast<uint32_t>(mWorkers.size()); }
+
+        /// @brief Process wide pool sized to the hardware concurrency, created on first use
+        static ThreadPool& Default();
+
+      protected:
+        std::vector<std::thread>          mWorkers;
+        std::queue<std::function<void()>> mTasks;
+        std::mutex                        mMutex;
+        std::condition_variable           mTaskAvailable;
+        std::condition_variable           mIdle;
+        uint32_t                          mActiveTasks = 0;
+        bool                              mStopping    = false;
+
+        void Push(std::function<void()>&& task);
+        void WorkerLoop();
+    };
+
+    template <typename TFunc>
+    auto ThreadPool::Enqueue(TFunc&& func) -> std::future<std::invoke_result_t<TFunc>>
+    {
+        using TResult = std::invoke_result_t<TFunc>;
+        // std::function requires copyable callables, so the packaged task is shared
+        auto task   = std::make_shared<std::packaged_task<TResult()>>(std::forward<TFunc>(func));
+        auto future = task->get_future();
+        Push([task]() { (*task)(); });
+        return future;
+    }
+
+    template <typename TFunc>
+    void ThreadPool::ParallelFor(size_t count, TFunc&& func)
+    {
+        if(!count)
+        {
+            return;
+        }
+
+        std::atomic<size_t> nextIndex = 0;
+        std::exception_ptr  exception = nullptr;
+        std::mutex          exceptionMutex;
+
+        auto worker = [&]() {
+            for(size_t index = nextIndex++; index < count; index = nextIndex++)
+            {
+                try
+                {
+                    func(index);
+                }
+                catch(...)
+                {
+                    std::lock_guard<std::mutex> lock(exceptionMutex);
+                    if(!exception)
+                    {
+                        exception = std::current_exception();
+                    }
+                }
+            }
+        };
+
+        size_t                         helperCount = std::min<size_t>(mWorkers.size(), count - 1);
+        std::vector<std::future<void>> helpers;
+        helpers.reserve(helperCount);
+        for(size_t i = 0; i < helperCount; i++)
+        {
+            helpers.push_back(Enqueue(worker));
+        }
+        worker();
+        for(auto& helper : helpers)
+        {
+            helper.wait();
+        }
+
+        if(exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+}  // namespace hsk
\ No newline at end of file
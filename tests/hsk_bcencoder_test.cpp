@@ -0,0 +1,487 @@
+#include "hsk_test.hpp"
+#include "imageprocessing/hsk_bcencoder.hpp"
+#include "imageprocessing/hsk_ktx2.hpp"
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace hsk;
+
+namespace {
+    /// @brief Largest error of a channel quantized to 5 (red, blue) or 6 (green) bits, see To565()
+    const int BC1_RED_BLUE_TOLERANCE = 5;
+    const int BC1_GREEN_TOLERANCE    = 3;
+    /// @brief Half the distance of the 8 value BC4 palette entries spanning 0 to 255
+    const int BC4_GRADIENT_TOLERANCE = 19;
+    /// @brief The shared p-bit of a BC7 mode 6 endpoint can be off by one for some channels
+    const int BC7_ENDPOINT_TOLERANCE = 1;
+    /// @brief Half the largest distance of adjacent 4 bit BC7 weights (5 / 64) over 0 to 255, plus the endpoint tolerance
+    const int BC7_GRADIENT_TOLERANCE = 11;
+
+    using Block = uint8_t[64];
+
+    struct Color
+    {
+        uint8_t R, G, B, A;
+    };
+
+    const Color SOLID_COLORS[] = {{0, 0, 0, 255}, {255, 255, 255, 255}, {200, 17, 90, 255}, {13, 250, 128, 60}, {127, 128, 129, 1}};
+
+    void Fill(Block& block, Color color)
+    {
+        for(uint32_t p = 0; p < 16; p++)
+        {
+            memcpy(block + p * 4, &color, 4);
+        }
+    }
+
+    /// @brief Checkerboard of two colors, a in the first pixel
+    void FillTwoColors(Block& block, Color a, Color b)
+    {
+        for(uint32_t p = 0; p < 16; p++)
+        {
+            bool first = ((p % 4) + (p / 4)) % 2 == 0;
+            memcpy(block + p * 4, first ? &a : &b, 4);
+        }
+    }
+
+    /// @brief Reference decoders, written from the format specification independently of the encoder
+    namespace reference {
+        void Expand565(uint16_t color, int32_t (&out)[4])
+        {
+            int32_t r = (color >> 11) & 31;
+            int32_t g = (color >> 5) & 63;
+            int32_t b = color & 31;
+            out[0]    = (r * 255 + 15) / 31;
+            out[1]    = (g * 255 + 31) / 63;
+            out[2]    = (b * 255 + 15) / 31;
+            out[3]    = 255;
+        }
+
+        void DecodeBC1(const uint8_t* block, Block& out)
+        {
+            uint16_t color0  = (uint16_t)(block[0] | (block[1] << 8));
+            uint16_t color1  = (uint16_t)(block[2] | (block[3] << 8));
+            uint32_t indices = (uint32_t)block[4] | ((uint32_t)block[5] << 8) | ((uint32_t)block[6] << 16) | ((uint32_t)block[7] << 24);
+
+            int32_t palette[4][4];
+            Expand565(color0, palette[0]);
+            Expand565(color1, palette[1]);
+            for(uint32_t c = 0; c < 3; c++)
+            {
+                if(color0 > color1)
+                {
+                    palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+                    palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+                }
+                else
+                {
+                    palette[2][c] = (palette[0][c] + palette[1][c] + 1) / 2;
+                    palette[3][c] = 0;
+                }
+            }
+            palette[2][3] = 255;
+            palette[3][3] = color0 > color1 ? 255 : 0;
+
+            for(uint32_t p = 0; p < 16; p++)
+            {
+                uint32_t index = (indices >> (p * 2)) & 3;
+                for(uint32_t c = 0; c < 4; c++)
+                {
+                    out[p * 4 + c] = (uint8_t)palette[index][c];
+                }
+            }
+        }
+
+        void DecodeBC4(const uint8_t* block, uint32_t channel, Block& out)
+        {
+            int32_t palette[8];
+            palette[0] = block[0];
+            palette[1] = block[1];
+            if(palette[0] > palette[1])
+            {
+                for(int32_t i = 2; i < 8; i++)
+                {
+                    palette[i] = ((8 - i) * palette[0] + (i - 1) * palette[1] + 3) / 7;
+                }
+            }
+            else
+            {
+                for(int32_t i = 2; i < 6; i++)
+                {
+                    palette[i] = ((6 - i) * palette[0] + (i - 1) * palette[1] + 2) / 5;
+                }
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+
+            uint64_t indices = 0;
+            for(uint32_t i = 0; i < 6; i++)
+            {
+                indices |= (uint64_t)block[2 + i] << (i * 8);
+            }
+            for(uint32_t p = 0; p < 16; p++)
+            {
+                out[p * 4 + channel] = (uint8_t)palette[(indices >> (p * 3)) & 7];
+            }
+        }
+
+        void DecodeBC3(const uint8_t* block, Block& out)
+        {
+            DecodeBC1(block + 8, out);
+            DecodeBC4(block, 3, out);
+        }
+
+        void DecodeBC5(const uint8_t* block, Block& out)
+        {
+            std::fill(out, out + 64, (uint8_t)0);
+            DecodeBC4(block, 0, out);
+            DecodeBC4(block + 8, 1, out);
+        }
+
+        uint32_t ReadBits(const uint8_t* block, uint32_t& position, uint32_t count)
+        {
+            uint32_t value = 0;
+            for(uint32_t i = 0; i < count; i++, position++)
+            {
+                value |= (uint32_t)((block[position / 8] >> (position % 8)) & 1) << i;
+            }
+            return value;
+        }
+
+        /// @return False if the block is not a mode 6 block
+        bool DecodeBC7Mode6(const uint8_t* block, Block& out)
+        {
+            // The mode is the number of zero bits before the first set bit
+            uint32_t position = 0;
+            uint32_t mode     = 0;
+            while(mode < 8 && !ReadBits(block, position, 1))
+            {
+                mode++;
+            }
+            if(mode != 6)
+            {
+                return false;
+            }
+
+            int32_t endpoints[2][4];
+            for(uint32_t c = 0; c < 4; c++)
+            {
+                endpoints[0][c] = (int32_t)ReadBits(block, position, 7) << 1;
+                endpoints[1][c] = (int32_t)ReadBits(block, position, 7) << 1;
+            }
+            uint32_t p0 = ReadBits(block, position, 1);
+            uint32_t p1 = ReadBits(block, position, 1);
+            for(uint32_t c = 0; c < 4; c++)
+            {
+                endpoints[0][c] |= (int32_t)p0;
+                endpoints[1][c] |= (int32_t)p1;
+            }
+
+            const int32_t weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+            for(uint32_t p = 0; p < 16; p++)
+            {
+                // The anchor index omits its most significant bit
+                uint32_t index = ReadBits(block, position, p == 0 ? 3 : 4);
+                for(uint32_t c = 0; c < 4; c++)
+                {
+                    out[p * 4 + c] = (uint8_t)(((64 - weights[index]) * endpoints[0][c] + weights[index] * endpoints[1][c] + 32) >> 6);
+                }
+            }
+            return position == 128;
+        }
+    }  // namespace reference
+
+    int MaxError(const Block& a, const Block& b, uint32_t channel)
+    {
+        int result = 0;
+        for(uint32_t p = 0; p < 16; p++)
+        {
+            result = std::max(result, std::abs((int)a[p * 4 + channel] - (int)b[p * 4 + channel]));
+        }
+        return result;
+    }
+
+    bool IsBC1FourColorMode(const uint8_t* block)
+    {
+        uint16_t color0 = (uint16_t)(block[0] | (block[1] << 8));
+        uint16_t color1 = (uint16_t)(block[2] | (block[3] << 8));
+        return color0 > color1;
+    }
+
+    /// @brief Checks the BC1 color block against the source, which must be opaque for BC1 and may have any alpha for BC3
+    void CheckBC1(const Block& source, const uint8_t* encoded)
+    {
+        Block decoded;
+        reference::DecodeBC1(encoded, decoded);
+        HSK_CHECK(MaxError(source, decoded, 0) <= BC1_RED_BLUE_TOLERANCE)
+        HSK_CHECK(MaxError(source, decoded, 1) <= BC1_GREEN_TOLERANCE)
+        HSK_CHECK(MaxError(source, decoded, 2) <= BC1_RED_BLUE_TOLERANCE)
+        // Opaque, the 3 color mode's transparent black index is never used
+        bool opaque = true;
+        for(uint32_t p = 0; p < 16; p++)
+        {
+            opaque = opaque && decoded[p * 4 + 3] == 255;
+        }
+        HSK_CHECK(opaque)
+    }
+
+    void CheckBC7(const Block& source, const uint8_t* encoded, int tolerance)
+    {
+        // Mode 6: Bit 6 set, bits 0 to 5 clear
+        HSK_CHECK((encoded[0] & 0x7F) == 0x40)
+        Block decoded;
+        HSK_CHECK(reference::DecodeBC7Mode6(encoded, decoded))
+        for(uint32_t c = 0; c < 4; c++)
+        {
+            HSK_CHECK(MaxError(source, decoded, c) <= tolerance)
+        }
+    }
+
+    void TestSolidBlocks()
+    {
+        for(Color color : SOLID_COLORS)
+        {
+            Block source;
+            Fill(source, color);
+
+            Block opaque;
+            Fill(opaque, Color{color.R, color.G, color.B, 255});
+            uint8_t bc1[8];
+            BcEncoder::EncodeBC1(opaque, bc1);
+            CheckBC1(opaque, bc1);
+            // Both endpoints are the color, all indices select the first one
+            HSK_CHECK(memcmp(bc1, bc1 + 2, 2) == 0)
+            HSK_CHECK(bc1[4] == 0 && bc1[5] == 0 && bc1[6] == 0 && bc1[7] == 0)
+
+            for(uint32_t channel = 0; channel < 4; channel++)
+            {
+                uint8_t bc4[8];
+                BcEncoder::EncodeBC4(source, channel, bc4);
+                HSK_CHECK(bc4[0] == source[channel] && bc4[1] == source[channel])
+                Block decoded = {};
+                reference::DecodeBC4(bc4, channel, decoded);
+                HSK_CHECK(MaxError(source, decoded, channel) == 0)
+            }
+
+            uint8_t bc3[16];
+            BcEncoder::EncodeBC3(source, bc3);
+            Block decoded;
+            reference::DecodeBC3(bc3, decoded);
+            HSK_CHECK(MaxError(source, decoded, 3) == 0)
+            HSK_CHECK(MaxError(source, decoded, 0) <= BC1_RED_BLUE_TOLERANCE)
+            HSK_CHECK(MaxError(source, decoded, 1) <= BC1_GREEN_TOLERANCE)
+            HSK_CHECK(MaxError(source, decoded, 2) <= BC1_RED_BLUE_TOLERANCE)
+
+            uint8_t bc5[16];
+            BcEncoder::EncodeBC5(source, bc5);
+            reference::DecodeBC5(bc5, decoded);
+            HSK_CHECK(MaxError(source, decoded, 0) == 0 && MaxError(source, decoded, 1) == 0)
+
+            uint8_t bc7[16];
+            BcEncoder::EncodeBC7(source, bc7);
+            CheckBC7(source, bc7, BC7_ENDPOINT_TOLERANCE);
+        }
+    }
+
+    void TestTwoColorBlocks()
+    {
+        const Color pairs[][2] = {{{255, 0, 0, 255}, {0, 0, 255, 255}}, {{10, 20, 30, 40}, {240, 220, 200, 180}}, {{0, 0, 0, 0}, {255, 255, 255, 255}}, {{64, 200, 7, 255}, {66, 190, 9, 255}}};
+        for(const auto& pair : pairs)
+        {
+            // Both orders, so the encoders have to handle either endpoint in the first pixel
+            for(uint32_t order = 0; order < 2; order++)
+            {
+                Color a = pair[order];
+                Color b = pair[1 - order];
+
+                Block source;
+                FillTwoColors(source, a, b);
+                Block opaque;
+                FillTwoColors(opaque, Color{a.R, a.G, a.B, 255}, Color{b.R, b.G, b.B, 255});
+
+                uint8_t bc1[8];
+                BcEncoder::EncodeBC1(opaque, bc1);
+                CheckBC1(opaque, bc1);
+                HSK_CHECK(IsBC1FourColorMode(bc1))
+
+                for(uint32_t channel = 0; channel < 4; channel++)
+                {
+                    uint8_t bc4[8];
+                    BcEncoder::EncodeBC4(source, channel, bc4);
+                    uint8_t high = std::max(source[channel], source[4 + channel]);
+                    uint8_t low  = std::min(source[channel], source[4 + channel]);
+                    // 8 value mode with the extremes as endpoints
+                    HSK_CHECK(bc4[0] == high && bc4[1] == low)
+                    Block decoded = {};
+                    reference::DecodeBC4(bc4, channel, decoded);
+                    HSK_CHECK(MaxError(source, decoded, channel) == 0)
+                }
+
+                uint8_t bc3[16];
+                BcEncoder::EncodeBC3(source, bc3);
+                Block decoded;
+                reference::DecodeBC3(bc3, decoded);
+                HSK_CHECK(MaxError(source, decoded, 3) == 0)
+                HSK_CHECK(MaxError(source, decoded, 0) <= BC1_RED_BLUE_TOLERANCE)
+                HSK_CHECK(MaxError(source, decoded, 1) <= BC1_GREEN_TOLERANCE)
+                HSK_CHECK(MaxError(source, decoded, 2) <= BC1_RED_BLUE_TOLERANCE)
+
+                uint8_t bc7[16];
+                BcEncoder::EncodeBC7(source, bc7);
+                CheckBC7(source, bc7, BC7_ENDPOINT_TOLERANCE);
+            }
+        }
+    }
+
+    void TestAlphaGradientBlock()
+    {
+        Block source;
+        for(uint32_t p = 0; p < 16; p++)
+        {
+            Color color{90, 160, 220, (uint8_t)(p * 17)};
+            memcpy(source + p * 4, &color, 4);
+        }
+
+        // BC3 is BC4 alpha followed by BC1 color
+        uint8_t bc3[16];
+        BcEncoder::EncodeBC3(source, bc3);
+        uint8_t alpha[8];
+        BcEncoder::EncodeBC4(source, 3, alpha);
+        uint8_t color[8];
+        BcEncoder::EncodeBC1(source, color);
+        HSK_CHECK(memcmp(bc3, alpha, 8) == 0)
+        HSK_CHECK(memcmp(bc3 + 8, color, 8) == 0)
+        HSK_CHECK(bc3[0] == 255 && bc3[1] == 0)
+
+        Block decoded;
+        reference::DecodeBC3(bc3, decoded);
+        HSK_CHECK(MaxError(source, decoded, 3) <= BC4_GRADIENT_TOLERANCE)
+        HSK_CHECK(MaxError(source, decoded, 0) <= BC1_RED_BLUE_TOLERANCE)
+        HSK_CHECK(MaxError(source, decoded, 1) <= BC1_GREEN_TOLERANCE)
+        HSK_CHECK(MaxError(source, decoded, 2) <= BC1_RED_BLUE_TOLERANCE)
+
+        uint8_t bc7[16];
+        BcEncoder::EncodeBC7(source, bc7);
+        CheckBC7(source, bc7, BC7_GRADIENT_TOLERANCE);
+        // The color is constant, only the alpha channel may carry the gradient's error
+        reference::DecodeBC7Mode6(bc7, decoded);
+        HSK_CHECK(MaxError(source, decoded, 0) <= BC7_ENDPOINT_TOLERANCE)
+        HSK_CHECK(MaxError(source, decoded, 1) <= BC7_ENDPOINT_TOLERANCE)
+        HSK_CHECK(MaxError(source, decoded, 2) <= BC7_ENDPOINT_TOLERANCE)
+
+        // BC5 encodes red and green as two BC4 blocks. Red carries the gradient here.
+        Block redGradient;
+        for(uint32_t p = 0; p < 16; p++)
+        {
+            Color pixel{(uint8_t)(p * 17), (uint8_t)(p % 2 ? 30 : 200), 0, 255};
+            memcpy(redGradient + p * 4, &pixel, 4);
+        }
+        uint8_t bc5[16];
+        BcEncoder::EncodeBC5(redGradient, bc5);
+        uint8_t red[8];
+        uint8_t green[8];
+        BcEncoder::EncodeBC4(redGradient, 0, red);
+        BcEncoder::EncodeBC4(redGradient, 1, green);
+        HSK_CHECK(memcmp(bc5, red, 8) == 0)
+        HSK_CHECK(memcmp(bc5 + 8, green, 8) == 0)
+        reference::DecodeBC5(bc5, decoded);
+        HSK_CHECK(MaxError(redGradient, decoded, 0) <= BC4_GRADIENT_TOLERANCE)
+        HSK_CHECK(MaxError(redGradient, decoded, 1) == 0)
+    }
+
+    void TestEncodeImage()
+    {
+        // 6x5 pixels: 2x2 blocks, the right and bottom blocks repeat the border pixels
+        const uint32_t       width  = 6;
+        const uint32_t       height = 5;
+        std::vector<uint8_t> rgba(width * height * 4);
+        std::mt19937         rng(7);
+        for(uint8_t& value : rgba)
+        {
+            value = (uint8_t)rng();
+        }
+
+        const VkFormat formats[] = {VK_FORMAT_BC1_RGB_UNORM_BLOCK, VK_FORMAT_BC3_UNORM_BLOCK, VK_FORMAT_BC4_UNORM_BLOCK, VK_FORMAT_BC5_UNORM_BLOCK, VK_FORMAT_BC7_UNORM_BLOCK};
+        for(VkFormat format : formats)
+        {
+            HSK_CHECK(BcEncoder::SupportsFormat(format))
+
+            const uint8_t        guard     = 0xCD;
+            size_t               imageSize = GetFormatBlockInfo(format).GetImageSize(width, height);
+            size_t               blockSize = imageSize / 4;
+            std::vector<uint8_t> encoded(imageSize + 16, guard);
+            BcEncoder::EncodeImage(format, rgba.data(), width, height, encoded.data());
+            HSK_CHECK(std::all_of(encoded.begin() + imageSize, encoded.end(), [guard](uint8_t value) { return value == guard; }))
+
+            // The bottom right block covers pixels (4..5, 4), with x clamped to 5 and y clamped to 4
+            Block block;
+            for(uint32_t y = 0; y < 4; y++)
+            {
+                for(uint32_t x = 0; x < 4; x++)
+                {
+                    uint32_t sourceX = std::min(4 + x, width - 1);
+                    memcpy(block + (y * 4 + x) * 4, rgba.data() + ((size_t)4 * width + sourceX) * 4, 4);
+                }
+            }
+            uint8_t expected[16];
+            switch(format)
+            {
+                case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+                    BcEncoder::EncodeBC1(block, expected);
+                    break;
+                case VK_FORMAT_BC3_UNORM_BLOCK:
+                    BcEncoder::EncodeBC3(block, expected);
+                    break;
+                case VK_FORMAT_BC4_UNORM_BLOCK:
+                    BcEncoder::EncodeBC4(block, 0, expected);
+                    break;
+                case VK_FORMAT_BC5_UNORM_BLOCK:
+                    BcEncoder::EncodeBC5(block, expected);
+                    break;
+                default:
+                    BcEncoder::EncodeBC7(block, expected);
+                    break;
+            }
+            HSK_CHECK(memcmp(encoded.data() + 3 * blockSize, expected, blockSize) == 0)
+        }
+
+        HSK_CHECK(!BcEncoder::SupportsFormat(VK_FORMAT_R8G8B8A8_UNORM))
+        std::vector<uint8_t> out(width * height * 4);
+        HSK_CHECK_THROWS(BcEncoder::EncodeImage(VK_FORMAT_R8G8B8A8_UNORM, rgba.data(), width, height, out.data()))
+    }
+
+    void TestRandomBlocksStayWithinPaletteError()
+    {
+        // Random blocks have no exact encoding, but every decoded BC4 channel must stay within half the palette spacing of its endpoints
+        std::mt19937 rng(3);
+        for(uint32_t iteration = 0; iteration < 256; iteration++)
+        {
+            Block source;
+            for(uint8_t& value : source)
+            {
+                value = (uint8_t)rng();
+            }
+            uint8_t bc4[8];
+            BcEncoder::EncodeBC4(source, 2, bc4);
+            Block decoded = {};
+            reference::DecodeBC4(bc4, 2, decoded);
+            HSK_CHECK(MaxError(source, decoded, 2) <= (bc4[0] - bc4[1]) / 14 + 1)
+
+            uint8_t bc7[16];
+            BcEncoder::EncodeBC7(source, bc7);
+            HSK_CHECK(reference::DecodeBC7Mode6(bc7, decoded))
+        }
+    }
+}  // namespace
+
+int main()
+{
+    TestSolidBlocks();
+    TestTwoColorBlocks();
+    TestAlphaGradientBlock();
+    TestEncodeImage();
+    TestRandomBlocksStayWithinPaletteError();
+    return test::gFailureCount;
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "hsk_test.hpp"
+#include "meshprocessing/hsk_meshletbuilder.hpp"
+
+using namespace hsk;
+
+namespace {
+    /// @brief Grid of quads in the xy plane, facing +z
+    void MakeGrid(uint32_t quads, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices)
+    {
+        for(uint32_t y = 0; y <= quads; y++)
+        {
+            for(uint32_t x = 0; x <= quads; x++)
+            {
+                positions.push_back(glm::vec3((float)x, (float)y, 0.f));
+            }
+        }
+        for(uint32_t y = 0; y < quads; y++)
+        {
+            for(uint32_t x = 0; x < quads; x++)
+            {
+                uint32_t corner = y * (quads + 1) + x;
+                indices.insert(indices.end(), {corner, corner + 1, corner + quads + 1, corner + 1, corner + quads + 2, corner + quads + 1});
+            }
+        }
+    }
+
+    void CheckLimits(uint32_t maxVertices, uint32_t maxTriangles)
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t>  indices;
+        MakeGrid(20, positions, indices);
+
+        // Positions of a second primitive behind the first one in a shared vertex buffer
+        const uint32_t baseVertex = 7;
+        positions.insert(positions.begin(), baseVertex, glm::vec3(0.f));
+
+        MeshletBuffer buffer;
+        uint32_t      count = MeshletBuilder::Build(buffer, indices.data(), indices.size(), &positions[0].x, sizeof(glm::vec3), (uint32_t)(positions.size() - baseVertex),
+                                                    baseVertex, maxVertices, maxTriangles);
+        HSK_CHECK(count == buffer.Meshlets.size())
+        HSK_CHECK(count == buffer.Bounds.size())
+
+        // Every meshlet is within the limits, and together they reproduce the index list in order
+        size_t index = 0;
+        for(const Meshlet& meshlet : buffer.Meshlets)
+        {
+            HSK_CHECK(meshlet.VertexCount <= maxVertices)
+            HSK_CHECK(meshlet.TriangleCount >= 1 && meshlet.TriangleCount <= maxTriangles)
+            for(uint32_t corner = 0; corner < meshlet.TriangleCount * 3; corner++, index++)
+            {
+                uint8_t local = buffer.Triangles[meshlet.TriangleOffset + corner];
+                HSK_CHECK(local < meshlet.VertexCount)
+                HSK_CHECK(index < indices.size() && buffer.Vertices[meshlet.VertexOffset + local] == indices[index] + baseVertex)
+            }
+        }
+        HSK_CHECK(index == indices.size())
+    }
+
+    /// @brief Brute force reference: true if no triangle of the list is front facing for the camera
+    bool AllBackfacing(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices, const glm::vec3& cameraPosition)
+    {
+        for(size_t i = 0; i < indices.size(); i += 3)
+        {
+            const glm::vec3& p0 = positions[indices[i]];
+            glm::vec3        n  = glm::cross(positions[indices[i + 1]] - p0, positions[indices[i + 2]] - p0);
+            if(glm::dot(n, cameraPosition - p0) > 0.f)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief Builds a single meshlet and checks that the cone never culls it while any triangle is visible
+    MeshletBounds CheckCone(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices)
+    {
+        MeshletBuffer buffer;
+        HSK_CHECK(MeshletBuilder::Build(buffer, indices.data(), indices.size(), &positions[0].x, sizeof(glm::vec3), (uint32_t)positions.size()) == 1)
+        const MeshletBounds& bounds = buffer.Bounds[0];
+        HSK_CHECK(bounds.ConeCutoff < 1.f)
+
+        for(int32_t x = -6; x <= 6; x++)
+        {
+            for(int32_t y = -6; y <= 6; y++)
+            {
+                for(int32_t z = -6; z <= 6; z++)
+                {
+                    glm::vec3 camera = glm::vec3((float)x, (float)y, (float)z) * 0.5f;
+                    if(bounds.IsBackfacing(camera))
+                    {
+                        HSK_CHECK(AllBackfacing(positions, indices, camera))
+                    }
+                }
+            }
+        }
+        return bounds;
+    }
+
+    void TestConvexCone()
+    {
+        // Pyramid with its tip at +z, all faces pointing outwards
+        std::vector<glm::vec3> positions = {glm::vec3(-1.f, -1.f, 0.f), glm::vec3(1.f, -1.f, 0.f), glm::vec3(1.f, 1.f, 0.f), glm::vec3(-1.f, 1.f, 0.f), glm::vec3(0.f, 0.f, 1.f)};
+        std::vector<uint32_t>  indices   = {0, 1, 4, 1, 2, 4, 2, 3, 4, 3, 0, 4};
+        MeshletBounds          bounds    = CheckCone(positions, indices);
+
+        HSK_CHECK(!bounds.IsBackfacing(glm::vec3(0.f, 0.f, 10.f)))
+        HSK_CHECK(bounds.IsBackfacing(glm::vec3(0.f, 0.f, -10.f)))
+    }
+
+    void TestConcaveCone()
+    {
+        // V shaped valley along y, both faces pointing up into the valley
+        std::vector<glm::vec3> positions = {glm::vec3(-1.f, 0.f, 1.f), glm::vec3(-1.f, 1.f, 1.f), glm::vec3(0.f, 0.f, 0.f),
+                                            glm::vec3(0.f, 1.f, 0.f),  glm::vec3(1.f, 0.f, 1.f),  glm::vec3(1.f, 1.f, 1.f)};
+        std::vector<uint32_t>  indices   = {0, 2, 1, 1, 2, 3, 2, 4, 3, 3, 4, 5};
+        MeshletBounds          bounds    = CheckCone(positions, indices);
+
+        // Every triangle faces these cameras
+        HSK_CHECK(!bounds.IsBackfacing(glm::vec3(0.f, 0.5f, 3.f)))
+        HSK_CHECK(!bounds.IsBackfacing(glm::vec3(0.f, 0.5f, 0.5f)))
+        HSK_CHECK(bounds.IsBackfacing(glm::vec3(0.f, 0.5f, -10.f)))
+    }
+}  // namespace
+
+int main()
+{
+    CheckLimits(64, 124);
+    CheckLimits(3, 1);
+    CheckLimits(16, 8);
+    CheckLimits(256, 512);
+    TestConvexCone();
+    TestConcaveCone();
+    return test::gFailureCount;
+}
\ No newline at end of file
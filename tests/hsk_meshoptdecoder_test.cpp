@@ -0,0 +1,265 @@
+#include "hsk_test.hpp"
+#include "meshprocessing/hsk_meshoptdecoder.hpp"
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace hsk;
+
+namespace {
+    // Index, sequence and filter vectors are the ones meshoptimizer's own tests (demo/tests.cpp) decode. Vertex vectors are encoded following the
+    // EXT_meshopt_compression specification, the first one reproduces meshoptimizer's kVertexDataV0 for its kVertexBuffer.
+
+    struct PackedVertex
+    {
+        uint16_t px, py, pz;
+        uint8_t  nu, nv;
+        uint16_t tx, ty;
+    };
+    static_assert(sizeof(PackedVertex) == 12);
+
+    const PackedVertex VERTEX_BUFFER[] = {
+        {0, 0, 0, 0, 0, 0, 0},
+        {300, 0, 0, 0, 0, 500, 0},
+        {0, 300, 0, 0, 0, 0, 500},
+        {300, 300, 0, 0, 0, 500, 500},
+    };
+
+    // 2 bit groups with escapes, zero groups and the 32 byte tail holding the first vertex
+    const uint8_t VERTEX_DATA[] = {
+        0xa0, 0x01, 0x3f, 0x00, 0x00, 0x00, 0x58, 0x57, 0x58, 0x01, 0x26, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x00, 0x00, 0x00, 0x58, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x01, 0x3f, 0x00, 0x00, 0x00, 0x17, 0x18, 0x17, 0x01, 0x26, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x00, 0x00, 0x00, 0x17, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+
+    // 16 vertices of 4 bytes, one group mode per byte: 4 bit with an escape, 8 bit, zero and 2 bit with escapes
+    const uint8_t VERTEX_DATA_ALL_GROUP_MODES[] = {
+        0xa0, 0x02, 0x06, 0x66, 0x6f, 0x66, 0x66, 0x66, 0x66, 0x66, 0x2e, 0x03, 0x00, 0x4a, 0xde, 0x8d, 0x06, 0x9a, 0xd1, 0x3d, 0x56, 0xea, 0x81,
+        0x12, 0xa6, 0xc5, 0x31, 0x62, 0x00, 0x01, 0x21, 0xc0, 0x80, 0xc0, 0x04, 0x4a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0b, 0x00, 0x00,
+    };
+
+    const uint8_t VERTEX_BUFFER_ALL_GROUP_MODES[16][4] = {
+        {0, 11, 0, 0},   {3, 48, 0, 1},    {6, 159, 0, 1},   {9, 88, 0, 0},    {12, 91, 0, 2},   {35, 168, 0, 2},  {38, 63, 0, 2},   {41, 32, 0, 2},
+        {44, 75, 0, 3},  {47, 192, 0, 3},  {50, 127, 0, 3},  {53, 136, 0, 3},  {56, 219, 0, 40}, {59, 120, 0, 40}, {62, 95, 0, 40},  {65, 144, 0, 40},
+    };
+
+    const uint8_t INDEX_DATA_V0[] = {
+        0xe0, 0xf0, 0x10, 0xfe, 0xff, 0xf0, 0x0c, 0xff, 0x02, 0x02, 0x02, 0x00, 0x76, 0x87, 0x56, 0x67, 0x78, 0xa9, 0x86, 0x65, 0x89, 0x68, 0x98, 0x01, 0x69, 0x00, 0x00,
+    };
+
+    const uint32_t INDEX_BUFFER[] = {0, 1, 2, 2, 1, 3, 4, 6, 5, 7, 8, 9};
+
+    // Version 1 features: A free index (0x0f), the last free index plus (0x0e) and minus one (0x0d), and a restart (0xfe with codeaux 0)
+    const uint8_t INDEX_DATA_V1[] = {
+        0xe1, 0xf0, 0x10, 0x0f, 0x0e, 0x0d, 0xfe, 0x14, 0x00, 0x00, 0x76, 0x87, 0x56, 0x67, 0x78, 0xa9, 0x86, 0x65, 0x89, 0x68, 0x98, 0x01, 0x69, 0x00, 0x00,
+    };
+
+    const uint32_t INDEX_BUFFER_V1[] = {0, 1, 2, 2, 1, 3, 2, 3, 10, 2, 10, 11, 2, 11, 10, 0, 1, 2};
+
+    const uint8_t INDEX_SEQUENCE_DATA[] = {
+        0xd1, 0x00, 0x04, 0xcd, 0x01, 0x04, 0x07, 0x98, 0x1f, 0x00, 0x00, 0x00, 0x00,
+    };
+
+    const uint32_t INDEX_SEQUENCE[] = {0, 1, 51, 2, 49, 1000};
+
+    /// @brief Copy of data in an allocation of exactly size bytes, so address sanitizer builds catch any read past the end
+    std::vector<uint8_t> Exact(const uint8_t* data, size_t size) { return std::vector<uint8_t>(data, data + size); }
+
+    using DecodeFunc = bool (*)(uint8_t* out, size_t count, size_t byteStride, const uint8_t* data, size_t size);
+
+    /// @brief Every truncation of a valid stream must be rejected without reading past its end
+    void CheckTruncationsFail(DecodeFunc decode, const uint8_t* data, size_t size, size_t count, size_t byteStride)
+    {
+        std::vector<uint8_t> out(count * byteStride);
+        for(size_t truncated = 0; truncated < size; truncated++)
+        {
+            std::vector<uint8_t> input = Exact(data, truncated);
+            HSK_CHECK(!decode(out.data(), count, byteStride, input.data(), input.size()))
+        }
+    }
+
+    /// @brief Randomly corrupted streams may decode to anything, but must not read out of bounds (checked by sanitizer builds)
+    void CheckCorruptionsAreSafe(DecodeFunc decode, const uint8_t* data, size_t size, size_t count, size_t byteStride)
+    {
+        std::mt19937         rng(5);
+        std::vector<uint8_t> out(count * byteStride);
+        for(uint32_t iteration = 0; iteration < 1000; iteration++)
+        {
+            std::vector<uint8_t> input = Exact(data, size);
+            uint32_t             flips = 1 + rng() % 4;
+            for(uint32_t i = 0; i < flips; i++)
+            {
+                input[rng() % size] ^= (uint8_t)(1 << (rng() % 8));
+            }
+            decode(out.data(), count, byteStride, input.data(), input.size());
+        }
+    }
+
+    template <typename T>
+    std::vector<uint32_t> DecodeIndices(DecodeFunc decode, const uint8_t* data, size_t size, size_t count, bool& outsuccess)
+    {
+        std::vector<T>       decoded(count);
+        std::vector<uint8_t> input = Exact(data, size);
+        outsuccess                 = decode(reinterpret_cast<uint8_t*>(decoded.data()), count, sizeof(T), input.data(), input.size());
+        return std::vector<uint32_t>(decoded.begin(), decoded.end());
+    }
+
+    bool Equals(const std::vector<uint32_t>& decoded, const uint32_t* expected, size_t count)
+    {
+        return decoded.size() == count && memcmp(decoded.data(), expected, count * sizeof(uint32_t)) == 0;
+    }
+
+    void TestVertexCodec()
+    {
+        const size_t         count = sizeof(VERTEX_BUFFER) / sizeof(VERTEX_BUFFER[0]);
+        std::vector<uint8_t> input = Exact(VERTEX_DATA, sizeof(VERTEX_DATA));
+        PackedVertex         decoded[count];
+        HSK_CHECK(MeshoptDecoder::DecodeVertexBuffer(reinterpret_cast<uint8_t*>(decoded), count, sizeof(PackedVertex), input.data(), input.size()))
+        HSK_CHECK(memcmp(decoded, VERTEX_BUFFER, sizeof(VERTEX_BUFFER)) == 0)
+
+        input = Exact(VERTEX_DATA_ALL_GROUP_MODES, sizeof(VERTEX_DATA_ALL_GROUP_MODES));
+        uint8_t allModes[16][4];
+        HSK_CHECK(MeshoptDecoder::DecodeVertexBuffer(&allModes[0][0], 16, 4, input.data(), input.size()))
+        HSK_CHECK(memcmp(allModes, VERTEX_BUFFER_ALL_GROUP_MODES, sizeof(allModes)) == 0)
+
+        // Unsupported version and strides
+        input[0] = 0xa1;
+        HSK_CHECK(!MeshoptDecoder::DecodeVertexBuffer(&allModes[0][0], 16, 4, input.data(), input.size()))
+        input[0] = 0xa0;
+        HSK_CHECK(!MeshoptDecoder::DecodeVertexBuffer(&allModes[0][0], 16, 0, input.data(), input.size()))
+        HSK_CHECK(!MeshoptDecoder::DecodeVertexBuffer(&allModes[0][0], 32, 2, input.data(), input.size()))
+        HSK_CHECK(!MeshoptDecoder::DecodeVertexBuffer(&allModes[0][0], 0, 260, input.data(), input.size()))
+
+        CheckTruncationsFail(&MeshoptDecoder::DecodeVertexBuffer, VERTEX_DATA, sizeof(VERTEX_DATA), count, sizeof(PackedVertex));
+        CheckTruncationsFail(&MeshoptDecoder::DecodeVertexBuffer, VERTEX_DATA_ALL_GROUP_MODES, sizeof(VERTEX_DATA_ALL_GROUP_MODES), 16, 4);
+        CheckCorruptionsAreSafe(&MeshoptDecoder::DecodeVertexBuffer, VERTEX_DATA, sizeof(VERTEX_DATA), count, sizeof(PackedVertex));
+        CheckCorruptionsAreSafe(&MeshoptDecoder::DecodeVertexBuffer, VERTEX_DATA_ALL_GROUP_MODES, sizeof(VERTEX_DATA_ALL_GROUP_MODES), 16, 4);
+    }
+
+    void TestIndexCodec()
+    {
+        const size_t count = sizeof(INDEX_BUFFER) / sizeof(INDEX_BUFFER[0]);
+        bool         success = false;
+        HSK_CHECK(Equals(DecodeIndices<uint32_t>(&MeshoptDecoder::DecodeIndexBuffer, INDEX_DATA_V0, sizeof(INDEX_DATA_V0), count, success), INDEX_BUFFER, count))
+        HSK_CHECK(success)
+        HSK_CHECK(Equals(DecodeIndices<uint16_t>(&MeshoptDecoder::DecodeIndexBuffer, INDEX_DATA_V0, sizeof(INDEX_DATA_V0), count, success), INDEX_BUFFER, count))
+        HSK_CHECK(success)
+
+        const size_t countV1 = sizeof(INDEX_BUFFER_V1) / sizeof(INDEX_BUFFER_V1[0]);
+        HSK_CHECK(Equals(DecodeIndices<uint32_t>(&MeshoptDecoder::DecodeIndexBuffer, INDEX_DATA_V1, sizeof(INDEX_DATA_V1), countV1, success), INDEX_BUFFER_V1, countV1))
+        HSK_CHECK(success)
+        HSK_CHECK(Equals(DecodeIndices<uint16_t>(&MeshoptDecoder::DecodeIndexBuffer, INDEX_DATA_V1, sizeof(INDEX_DATA_V1), countV1, success), INDEX_BUFFER_V1, countV1))
+        HSK_CHECK(success)
+
+        // Version 0 reads codes 13 and 14 from the vertex FIFO instead
+        std::vector<uint8_t> asV0 = Exact(INDEX_DATA_V1, sizeof(INDEX_DATA_V1));
+        asV0[0]                   = 0xe0;
+        HSK_CHECK(!Equals(DecodeIndices<uint32_t>(&MeshoptDecoder::DecodeIndexBuffer, asV0.data(), asV0.size(), countV1, success), INDEX_BUFFER_V1, countV1))
+
+        // Unsupported version, index size and counts
+        std::vector<uint8_t> input = Exact(INDEX_DATA_V0, sizeof(INDEX_DATA_V0));
+        std::vector<uint8_t> out(countV1 * 4);
+        input[0]                   = 0xe2;
+        HSK_CHECK(!MeshoptDecoder::DecodeIndexBuffer(out.data(), count, 4, input.data(), input.size()))
+        input[0] = 0xe0;
+        HSK_CHECK(!MeshoptDecoder::DecodeIndexBuffer(out.data(), count, 1, input.data(), input.size()))
+        HSK_CHECK(!MeshoptDecoder::DecodeIndexBuffer(out.data(), count - 1, 4, input.data(), input.size()))
+
+        CheckTruncationsFail(&MeshoptDecoder::DecodeIndexBuffer, INDEX_DATA_V0, sizeof(INDEX_DATA_V0), count, 4);
+        CheckTruncationsFail(&MeshoptDecoder::DecodeIndexBuffer, INDEX_DATA_V1, sizeof(INDEX_DATA_V1), countV1, 4);
+        CheckCorruptionsAreSafe(&MeshoptDecoder::DecodeIndexBuffer, INDEX_DATA_V0, sizeof(INDEX_DATA_V0), count, 4);
+        CheckCorruptionsAreSafe(&MeshoptDecoder::DecodeIndexBuffer, INDEX_DATA_V1, sizeof(INDEX_DATA_V1), countV1, 2);
+    }
+
+    void TestSequenceCodec()
+    {
+        const size_t count   = sizeof(INDEX_SEQUENCE) / sizeof(INDEX_SEQUENCE[0]);
+        bool         success = false;
+        HSK_CHECK(Equals(DecodeIndices<uint32_t>(&MeshoptDecoder::DecodeIndexSequence, INDEX_SEQUENCE_DATA, sizeof(INDEX_SEQUENCE_DATA), count, success), INDEX_SEQUENCE, count))
+        HSK_CHECK(success)
+        HSK_CHECK(Equals(DecodeIndices<uint16_t>(&MeshoptDecoder::DecodeIndexSequence, INDEX_SEQUENCE_DATA, sizeof(INDEX_SEQUENCE_DATA), count, success), INDEX_SEQUENCE, count))
+        HSK_CHECK(success)
+
+        std::vector<uint8_t> input = Exact(INDEX_SEQUENCE_DATA, sizeof(INDEX_SEQUENCE_DATA));
+        std::vector<uint8_t> out((count + 1) * 4);
+        input[0]                   = 0xd2;
+        HSK_CHECK(!MeshoptDecoder::DecodeIndexSequence(out.data(), count, 4, input.data(), input.size()))
+        input[0] = 0xd1;
+        HSK_CHECK(!MeshoptDecoder::DecodeIndexSequence(out.data(), count + 1, 4, input.data(), input.size()))
+        HSK_CHECK(!MeshoptDecoder::DecodeIndexSequence(out.data(), count - 1, 4, input.data(), input.size()))
+
+        // A varint never ending in a byte below 128 must not run past the stream
+        const uint8_t unterminated[] = {0xd1, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+        input                        = Exact(unterminated, sizeof(unterminated));
+        HSK_CHECK(!MeshoptDecoder::DecodeIndexSequence(out.data(), 2, 4, input.data(), input.size()))
+
+        CheckTruncationsFail(&MeshoptDecoder::DecodeIndexSequence, INDEX_SEQUENCE_DATA, sizeof(INDEX_SEQUENCE_DATA), count, 4);
+        CheckCorruptionsAreSafe(&MeshoptDecoder::DecodeIndexSequence, INDEX_SEQUENCE_DATA, sizeof(INDEX_SEQUENCE_DATA), count, 4);
+    }
+
+    void TestOctahedralFilter()
+    {
+        int8_t       oct8[4 * 4]          = {0, 1, 127, 0, 0, -69, 127, 1, -1, 1, 127, 0, 14, -126, 127, 1};
+        const int8_t expectedOct8[4 * 4]  = {0, 1, 127, 0, 0, -97, 82, 1, -1, 1, 127, 0, 1, -126, -15, 1};
+        HSK_CHECK(MeshoptDecoder::ApplyFilter(MeshoptDecoder::EFilter::Octahedral, reinterpret_cast<uint8_t*>(oct8), 4, 4))
+        HSK_CHECK(memcmp(oct8, expectedOct8, sizeof(oct8)) == 0)
+
+        uint16_t       oct12[4 * 4]         = {0, 1, 2047, 0, 0, 1870, 2047, 1, 2017, 1, 2047, 0, 14, 1300, 2047, 1};
+        const uint16_t expectedOct12[4 * 4] = {0, 16, 32767, 0, 0, 32621, 3088, 1, 32764, 16, 471, 0, 307, 28541, 16093, 1};
+        HSK_CHECK(MeshoptDecoder::ApplyFilter(MeshoptDecoder::EFilter::Octahedral, reinterpret_cast<uint8_t*>(oct12), 4, 8))
+        HSK_CHECK(memcmp(oct12, expectedOct12, sizeof(oct12)) == 0)
+
+        HSK_CHECK(!MeshoptDecoder::ApplyFilter(MeshoptDecoder::EFilter::Octahedral, reinterpret_cast<uint8_t*>(oct12), 2, 16))
+    }
+
+    void TestQuaternionFilter()
+    {
+        uint16_t       quat[4 * 4]         = {0, 1, 0, 0x7fc, 0, 1870, 0, 0x7fd, 2017, 1, 0, 0x7fe, 14, 1300, 0, 0x7ff};
+        const uint16_t expectedQuat[4 * 4] = {32767, 0, 11, 0, 0, 25013, 0, 21166, 11, 0, 23504, 22830, 158, 14715, 0, 29277};
+        HSK_CHECK(MeshoptDecoder::ApplyFilter(MeshoptDecoder::EFilter::Quaternion, reinterpret_cast<uint8_t*>(quat), 4, 8))
+        HSK_CHECK(memcmp(quat, expectedQuat, sizeof(quat)) == 0)
+
+        HSK_CHECK(!MeshoptDecoder::ApplyFilter(MeshoptDecoder::EFilter::Quaternion, reinterpret_cast<uint8_t*>(quat), 8, 4))
+    }
+
+    void TestExponentialFilter()
+    {
+        uint32_t       exp[4]         = {0, 0xff000003, 0x02fffff7, 0xfe7fffff};
+        const uint32_t expectedExp[4] = {0, 0x3fc00000, 0xc2100000, 0x49fffffe};
+        HSK_CHECK(MeshoptDecoder::ApplyFilter(MeshoptDecoder::EFilter::Exponential, reinterpret_cast<uint8_t*>(exp), 2, 8))
+        HSK_CHECK(memcmp(exp, expectedExp, sizeof(exp)) == 0)
+
+        HSK_CHECK(!MeshoptDecoder::ApplyFilter(MeshoptDecoder::EFilter::Exponential, reinterpret_cast<uint8_t*>(exp), 2, 6))
+    }
+
+    void TestDecodeAppliesFilter()
+    {
+        // Attribute streams are filtered after decoding, index streams don't support filters
+        std::vector<uint8_t> input = Exact(VERTEX_DATA_ALL_GROUP_MODES, sizeof(VERTEX_DATA_ALL_GROUP_MODES));
+        uint8_t              decoded[16][4];
+        HSK_CHECK(MeshoptDecoder::Decode(MeshoptDecoder::EMode::Attributes, MeshoptDecoder::EFilter::Octahedral, &decoded[0][0], 16, 4, input.data(), input.size()))
+        uint8_t filtered[16][4];
+        memcpy(filtered, VERTEX_BUFFER_ALL_GROUP_MODES, sizeof(filtered));
+        MeshoptDecoder::ApplyFilter(MeshoptDecoder::EFilter::Octahedral, &filtered[0][0], 16, 4);
+        HSK_CHECK(memcmp(decoded, filtered, sizeof(decoded)) == 0)
+
+        input = Exact(INDEX_DATA_V0, sizeof(INDEX_DATA_V0));
+        std::vector<uint8_t> out(sizeof(INDEX_BUFFER));
+        HSK_CHECK(!MeshoptDecoder::Decode(MeshoptDecoder::EMode::Triangles, MeshoptDecoder::EFilter::Exponential, out.data(), 12, 4, input.data(), input.size()))
+        HSK_CHECK(MeshoptDecoder::Decode(MeshoptDecoder::EMode::Triangles, MeshoptDecoder::EFilter::None, out.data(), 12, 4, input.data(), input.size()))
+        HSK_CHECK(memcmp(out.data(), INDEX_BUFFER, sizeof(INDEX_BUFFER)) == 0)
+    }
+}  // namespace
+
+int main()
+{
+    TestVertexCodec();
+    TestIndexCodec();
+    TestSequenceCodec();
+    TestOctahedralFilter();
+    TestQuaternionFilter();
+    TestExponentialFilter();
+    TestDecodeAppliesFilter();
+    return test::gFailureCount;
+}
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include "hsk_test.hpp"
+#include "imageprocessing/hsk_pixelops.hpp"
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace hsk;
+
+namespace {
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+    // NEON kernels may fuse multiply-add sequences the scalar code does not (see PixelOps)
+    const int   ROUNDING_TOLERANCE = 1;
+    const float FLOAT_TOLERANCE    = 1e-6f;
+#else
+    const int   ROUNDING_TOLERANCE = 0;
+    const float FLOAT_TOLERANCE    = 0.f;
+#endif
+
+    const size_t PIXEL_COUNTS[] = {0, 1, 3, 5, 6, 7, 15, 16, 17, 33, 100, 1023};
+
+    template <typename T>
+    int MaxDifference(const std::vector<T>& a, const std::vector<T>& b)
+    {
+        int result = a.size() == b.size() ? 0 : 256;
+        for(size_t i = 0; i < std::min(a.size(), b.size()); i++)
+        {
+            result = std::max(result, std::abs((int)a[i] - (int)b[i]));
+        }
+        return result;
+    }
+
+    bool Matches(const std::vector<float>& a, const std::vector<float>& b)
+    {
+        if(a.size() != b.size())
+        {
+            return false;
+        }
+        for(size_t i = 0; i < a.size(); i++)
+        {
+            bool nan = a[i] != a[i] && b[i] != b[i];
+            if(!nan && memcmp(&a[i], &b[i], sizeof(float)) != 0 && !test::Near(a[i], b[i], FLOAT_TOLERANCE * std::max(std::abs(a[i]), 1.f)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void TestChannelKernelsMatchScalar()
+    {
+        std::mt19937 rng(1);
+        for(size_t n : PIXEL_COUNTS)
+        {
+            // One spare byte, the vectorized expansion must not read past the last pixel either way
+            std::vector<uint8_t> rgb(n * 3 + 1);
+            std::vector<uint8_t> src(n * 4);
+            for(uint8_t& v : rgb)
+            {
+                v = (uint8_t)rng();
+            }
+            for(uint8_t& v : src)
+            {
+                v = (uint8_t)rng();
+            }
+
+            std::vector<uint8_t> a(n * 4);
+            std::vector<uint8_t> b(n * 4);
+            PixelOps::ExpandRgbToRgba(rgb.data(), a.data(), n, 77);
+            PixelOps::Scalar::ExpandRgbToRgba(rgb.data(), b.data(), n, 77);
+            HSK_CHECK(a == b)
+
+            const uint8_t order[4] = {2, 0, 3, 1};
+            PixelOps::Swizzle(src.data(), a.data(), n, order);
+            PixelOps::Scalar::Swizzle(src.data(), b.data(), n, order);
+            HSK_CHECK(a == b)
+            std::vector<uint8_t> inPlace = src;
+            PixelOps::Swizzle(inPlace.data(), inPlace.data(), n, order);
+            HSK_CHECK(inPlace == b)
+
+            a = src;
+            b = src;
+            PixelOps::PremultiplyAlpha(a.data(), n);
+            PixelOps::Scalar::PremultiplyAlpha(b.data(), n);
+            HSK_CHECK(a == b)
+            a = src;
+            b = src;
+            PixelOps::PremultiplyAlphaSrgb(a.data(), n);
+            PixelOps::Scalar::PremultiplyAlphaSrgb(b.data(), n);
+            HSK_CHECK(MaxDifference(a, b) <= ROUNDING_TOLERANCE)
+
+            std::vector<uint16_t> wideA(n * 4);
+            std::vector<uint16_t> wideB(n * 4);
+            PixelOps::Unorm8ToUnorm16(src.data(), wideA.data(), n * 4);
+            PixelOps::Scalar::Unorm8ToUnorm16(src.data(), wideB.data(), n * 4);
+            HSK_CHECK(wideA == wideB)
+
+            std::vector<float> floatA(n * 4);
+            std::vector<float> floatB(n * 4);
+            PixelOps::Unorm8ToFloat(src.data(), floatA.data(), n * 4);
+            PixelOps::Scalar::Unorm8ToFloat(src.data(), floatB.data(), n * 4);
+            HSK_CHECK(Matches(floatA, floatB))
+            PixelOps::SrgbToLinearRgba(src.data(), floatA.data(), n);
+            PixelOps::Scalar::SrgbToLinearRgba(src.data(), floatB.data(), n);
+            HSK_CHECK(Matches(floatA, floatB))
+
+            // Out of range values exercise clamping
+            std::vector<float> linear(n * 4);
+            for(float& v : linear)
+            {
+                v = std::uniform_real_distribution<float>(-0.2f, 1.2f)(rng);
+            }
+            PixelOps::FloatToUnorm8(linear.data(), a.data(), n * 4);
+            PixelOps::Scalar::FloatToUnorm8(linear.data(), b.data(), n * 4);
+            HSK_CHECK(MaxDifference(a, b) <= ROUNDING_TOLERANCE)
+            PixelOps::LinearToSrgbRgba(linear.data(), a.data(), n);
+            PixelOps::Scalar::LinearToSrgbRgba(linear.data(), b.data(), n);
+            HSK_CHECK(MaxDifference(a, b) <= ROUNDING_TOLERANCE)
+            PixelOps::FloatToUnorm16(linear.data(), wideA.data(), n * 4);
+            PixelOps::Scalar::FloatToUnorm16(linear.data(), wideB.data(), n * 4);
+            HSK_CHECK(MaxDifference(wideA, wideB) <= ROUNDING_TOLERANCE)
+            PixelOps::Unorm16ToFloat(wideB.data(), floatA.data(), n * 4);
+            PixelOps::Scalar::Unorm16ToFloat(wideB.data(), floatB.data(), n * 4);
+            HSK_CHECK(Matches(floatA, floatB))
+
+            floatA = linear;
+            floatB = linear;
+            PixelOps::PremultiplyAlpha(floatA.data(), n);
+            PixelOps::Scalar::PremultiplyAlpha(floatB.data(), n);
+            HSK_CHECK(Matches(floatA, floatB))
+        }
+    }
+
+    void TestAllSixteenBitValuesMatchScalar()
+    {
+        const size_t          count = 65536;
+        std::vector<uint16_t> all(count);
+        for(size_t i = 0; i < count; i++)
+        {
+            all[i] = (uint16_t)i;
+        }
+
+        std::vector<uint8_t> narrowA(count);
+        std::vector<uint8_t> narrowB(count);
+        PixelOps::Unorm16ToUnorm8(all.data(), narrowA.data(), count);
+        PixelOps::Scalar::Unorm16ToUnorm8(all.data(), narrowB.data(), count);
+        HSK_CHECK(narrowA == narrowB)
+        bool rounded = true;
+        for(size_t i = 0; i < count; i++)
+        {
+            rounded = rounded && narrowB[i] == (uint8_t)std::lround(i / 257.0);
+        }
+        HSK_CHECK(rounded)
+
+        // Half to float is exact, and every half except NaN survives the round trip
+        std::vector<float> floatA(count);
+        std::vector<float> floatB(count);
+        PixelOps::HalfToFloat(all.data(), floatA.data(), count);
+        PixelOps::Scalar::HalfToFloat(all.data(), floatB.data(), count);
+        HSK_CHECK(Matches(floatA, floatB))
+        std::vector<uint16_t> halfA(count);
+        std::vector<uint16_t> halfB(count);
+        PixelOps::FloatToHalf(floatB.data(), halfA.data(), count);
+        PixelOps::Scalar::FloatToHalf(floatB.data(), halfB.data(), count);
+        bool roundTrip = true;
+        for(size_t i = 0; i < count; i++)
+        {
+            auto lIsNan = [](uint32_t half) { return (half & 0x7c00) == 0x7c00 && (half & 0x3ff); };
+            // NaN payloads are not preserved
+            bool matches = lIsNan((uint32_t)i) ? lIsNan(halfA[i]) && lIsNan(halfB[i]) : halfA[i] == i && halfB[i] == i;
+            roundTrip    = roundTrip && matches;
+        }
+        HSK_CHECK(roundTrip)
+    }
+
+    void TestFloatBitPatternsMatchScalar()
+    {
+        // Samples the whole float range (denormals, infinities, NaN) in blocks, then [0, 1] densely, where the sRGB table has its thresholds
+        const size_t          blockSize = 4096;
+        std::vector<float>    values(blockSize);
+        std::vector<uint8_t>  srgbA(blockSize);
+        std::vector<uint8_t>  srgbB(blockSize);
+        std::vector<uint16_t> halfA(blockSize);
+        std::vector<uint16_t> halfB(blockSize);
+        int                   srgbDifference = 0;
+        bool                  halfMatches    = true;
+        auto                  lCompare       = [&]() {
+            PixelOps::LinearToSrgb(values.data(), srgbA.data(), blockSize);
+            PixelOps::Scalar::LinearToSrgb(values.data(), srgbB.data(), blockSize);
+            srgbDifference = std::max(srgbDifference, MaxDifference(srgbA, srgbB));
+            PixelOps::FloatToHalf(values.data(), halfA.data(), blockSize);
+            PixelOps::Scalar::FloatToHalf(values.data(), halfB.data(), blockSize);
+            for(size_t i = 0; i < blockSize; i++)
+            {
+                halfMatches = halfMatches && (halfA[i] == halfB[i] || values[i] != values[i]);
+            }
+        };
+
+        for(uint64_t base = 0; base < (1ull << 32); base += blockSize * 1021)
+        {
+            for(size_t i = 0; i < blockSize; i++)
+            {
+                uint32_t bits = (uint32_t)(base + i * 7);
+                memcpy(&values[i], &bits, sizeof(float));
+            }
+            lCompare();
+        }
+        const uint32_t oneBits = 0x3f800000u;
+        for(uint64_t base = 0; base <= oneBits; base += blockSize * 61)
+        {
+            for(size_t i = 0; i < blockSize; i++)
+            {
+                uint32_t bits = (uint32_t)std::min<uint64_t>(base + i * 61, oneBits);
+                memcpy(&values[i], &bits, sizeof(float));
+            }
+            lCompare();
+        }
+        HSK_CHECK(srgbDifference <= ROUNDING_TOLERANCE)
+        HSK_CHECK(halfMatches)
+    }
+
+    void TestDownsampleMatchesScalar()
+    {
+        std::mt19937                               rng(2);
+        std::vector<std::pair<uint32_t, uint32_t>> sizes = {{1, 1}, {2, 2}, {3, 3}, {5, 1}, {1, 7}, {16, 16}, {17, 9}, {64, 33}, {255, 3}};
+        for(auto [width, height] : sizes)
+        {
+            std::vector<uint8_t> src((size_t)width * height * 4);
+            for(uint8_t& v : src)
+            {
+                v = (uint8_t)rng();
+            }
+            size_t               dstCount = (size_t)std::max(width / 2, 1u) * std::max(height / 2, 1u) * 4;
+            std::vector<uint8_t> a(dstCount);
+            std::vector<uint8_t> b(dstCount);
+            PixelOps::DownsampleBox(src.data(), width, height, a.data());
+            PixelOps::Scalar::DownsampleBox(src.data(), width, height, b.data());
+            HSK_CHECK(a == b)
+
+            std::vector<float> linear((size_t)width * height * 4);
+            PixelOps::Scalar::Unorm8ToFloat(src.data(), linear.data(), linear.size());
+            for(EMipFilter filter : {EMipFilter::Box, EMipFilter::Kaiser})
+            {
+                PixelOps::DownsampleSrgb(src.data(), width, height, filter, a.data());
+                PixelOps::Scalar::DownsampleSrgb(src.data(), width, height, filter, b.data());
+                HSK_CHECK(MaxDifference(a, b) <= ROUNDING_TOLERANCE)
+
+                std::vector<float> floatA(dstCount);
+                std::vector<float> floatB(dstCount);
+                PixelOps::Downsample(linear.data(), width, height, filter, floatA.data());
+                PixelOps::Scalar::Downsample(linear.data(), width, height, filter, floatB.data());
+                HSK_CHECK(Matches(floatA, floatB))
+
+                // Filter weights are normalized, constant images stay constant
+                std::vector<float> constant(linear.size(), 0.5f);
+                PixelOps::Downsample(constant.data(), width, height, filter, floatA.data());
+                HSK_CHECK(std::all_of(floatA.begin(), floatA.end(), [](float v) { return test::Near(v, 0.5f); }))
+            }
+        }
+    }
+}  // namespace
+
+int main()
+{
+    TestChannelKernelsMatchScalar();
+    TestAllSixteenBitValuesMatchScalar();
+    TestFloatBitPatternsMatchScalar();
+    TestDownsampleMatchesScalar();
+    return test::gFailureCount;
+}
\ No newline at end of file
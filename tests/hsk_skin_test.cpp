@@ -0,0 +1,64 @@
+#include "hsk_test.hpp"
+#include "scenegraph/hsk_skin.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace hsk;
+
+namespace {
+    bool NearVec3(const glm::vec3& a, const glm::vec3& b) { return test::Near(a.x, b.x) && test::Near(a.y, b.y) && test::Near(a.z, b.z); }
+
+    void TestBlendedPose()
+    {
+        // Joint 0 stays in bind pose, joint 1 is rotated 90 degrees around +Z and moved up by 2
+        glm::mat4 palette[2] = {glm::mat4(1.f), glm::translate(glm::mat4(1.f), glm::vec3(0.f, 2.f, 0.f)) * glm::rotate(glm::mat4(1.f), glm::radians(90.f), glm::vec3(0.f, 0.f, 1.f))};
+
+        Vertex source[3] = {
+            Vertex{.Pos = glm::vec3(1.f, 0.f, 0.f), .Normal = glm::vec3(1.f, 0.f, 0.f), .Tangent = glm::vec3(0.f, 0.f, 1.f), .Uv = glm::vec2(0.25f, 0.75f), .MaterialIndex = 3},
+            Vertex{.Pos = glm::vec3(1.f, 0.f, 0.f), .Normal = glm::vec3(1.f, 0.f, 0.f), .Tangent = glm::vec3(0.f, 1.f, 0.f), .Uv = glm::vec2(), .MaterialIndex = 3},
+            Vertex{.Pos = glm::vec3(1.f, 0.f, 0.f), .Normal = glm::vec3(1.f, 0.f, 0.f), .Tangent = glm::vec3(0.f, 1.f, 0.f), .Uv = glm::vec2(), .MaterialIndex = 3},
+        };
+        VertexSkinData skinData[3] = {
+            VertexSkinData{.Joints = glm::uvec4(0, 0, 0, 0), .Weights = glm::vec4(1.f, 0.f, 0.f, 0.f)},
+            VertexSkinData{.Joints = glm::uvec4(1, 0, 0, 0), .Weights = glm::vec4(1.f, 0.f, 0.f, 0.f)},
+            VertexSkinData{.Joints = glm::uvec4(0, 1, 0, 0), .Weights = glm::vec4(0.5f, 0.5f, 0.f, 0.f)},
+        };
+        Vertex out[3] = {};
+
+        SkinVerticesCpu(source, skinData, palette, 2, out, 3);
+
+        // Bind pose is kept, attributes not affected by skinning are copied
+        HSK_CHECK(NearVec3(out[0].Pos, glm::vec3(1.f, 0.f, 0.f)))
+        HSK_CHECK(NearVec3(out[0].Normal, glm::vec3(1.f, 0.f, 0.f)))
+        HSK_CHECK(NearVec3(out[0].Tangent, glm::vec3(0.f, 0.f, 1.f)))
+        HSK_CHECK(out[0].Uv == glm::vec2(0.25f, 0.75f))
+        HSK_CHECK(out[0].MaterialIndex == 3)
+
+        // Fully bound to joint 1: rotated, then translated. Directions are only rotated.
+        HSK_CHECK(NearVec3(out[1].Pos, glm::vec3(0.f, 3.f, 0.f)))
+        HSK_CHECK(NearVec3(out[1].Normal, glm::vec3(0.f, 1.f, 0.f)))
+        HSK_CHECK(NearVec3(out[1].Tangent, glm::vec3(-1.f, 0.f, 0.f)))
+
+        // Linear blend of both joints, directions are renormalized
+        HSK_CHECK(NearVec3(out[2].Pos, glm::vec3(0.5f, 1.5f, 0.f)))
+        HSK_CHECK(NearVec3(out[2].Normal, glm::normalize(glm::vec3(1.f, 1.f, 0.f))))
+        HSK_CHECK(NearVec3(out[2].Tangent, glm::normalize(glm::vec3(-1.f, 1.f, 0.f))))
+    }
+
+    void TestJointOutOfRange()
+    {
+        glm::mat4      palette[2] = {glm::mat4(1.f), glm::mat4(1.f)};
+        Vertex         source     = {};
+        VertexSkinData skinData   = {.Joints = glm::uvec4(0, 2, 0, 0), .Weights = glm::vec4(1.f, 0.f, 0.f, 0.f)};
+        Vertex         out        = {};
+
+        // Rejected even though the offending influence has zero weight
+        HSK_CHECK_THROWS(SkinVerticesCpu(&source, &skinData, palette, 2, &out, 1))
+    }
+}  // namespace
+
+int main()
+{
+    TestBlendedPose();
+    TestJointOutOfRange();
+    return test::gFailureCount;
+}
\ No newline at end of file
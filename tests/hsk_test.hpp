@@ -0,0 +1,37 @@
+#pragma once
+#include <cmath>
+#include <cstdio>
+
+namespace hsk::test {
+    /// @brief Number of failed checks. Test executables return it from main().
+    inline int gFailureCount = 0;
+
+    inline void Check(bool value, const char* expression, const char* file, int line)
+    {
+        if(!value)
+        {
+            std::printf("%s:%d: check failed: %s\n", file, line, expression);
+            gFailureCount++;
+        }
+    }
+
+    inline bool Near(float a, float b, float epsilon = 1e-5f) { return std::abs(a - b) <= epsilon; }
+}  // namespace hsk::test
+
+/// @brief Records a failure if the expression does not throw
+#define HSK_CHECK_THROWS(expr)                                                                                                                                                     \
+    {                                                                                                                                                                              \
+        bool thrown = false;                                                                                                                                                       \
+        try                                                                                                                                                                        \
+        {                                                                                                                                                                          \
+            expr;                                                                                                                                                                  \
+        }                                                                                                                                                                          \
+        catch(...)                                                                                                                                                                 \
+        {                                                                                                                                                                          \
+            thrown = true;                                                                                                                                                         \
+        }                                                                                                                                                                          \
+        hsk::test::Check(thrown, #expr " throws", __FILE__, __LINE__);                                                                                                            \
+    }
+
+/// @brief Records a failure (and continues) if val is false
+#define HSK_CHECK(val) hsk::test::Check((val), #val, __FILE__, __LINE__);
\ No newline at end of file
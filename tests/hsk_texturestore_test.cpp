@@ -0,0 +1,72 @@
+#include "hsk_test.hpp"
+#include "scenegraph/globalcomponents/hsk_texturestore.hpp"
+
+using namespace hsk;
+
+namespace {
+    // Samplers are only compared, never used
+    const VkSampler SAMPLER_A = (VkSampler)(uintptr_t)1;
+    const VkSampler SAMPLER_B = (VkSampler)(uintptr_t)2;
+
+    void TestSharedTexturesSurviveUntilLastRelease()
+    {
+        TextureStore store;
+
+        std::weak_ptr<ManagedImage> shared;
+        std::weak_ptr<ManagedImage> exclusive;
+
+        // Model A: one image only it uses, one image shared with model B (in two textures with different samplers)
+        std::vector<int32_t> modelA;
+        {
+            auto sharedImage    = std::make_shared<ManagedImage>();
+            auto exclusiveImage = std::make_shared<ManagedImage>();
+            shared              = sharedImage;
+            exclusive           = exclusiveImage;
+            modelA.push_back(store.AddTexture(sharedImage, SAMPLER_A, 100));
+            modelA.push_back(store.AddTexture(sharedImage, SAMPLER_B, 100));
+            modelA.push_back(store.AddTexture(exclusiveImage, SAMPLER_A, 200));
+        }
+        HSK_CHECK(modelA[0] != modelA[1] && modelA[1] != modelA[2])
+
+        // Model B deduplicates against model A
+        std::vector<int32_t> modelB;
+        {
+            std::shared_ptr<ManagedImage> image = store.FindImage(100);
+            HSK_CHECK(image && image == shared.lock())
+            modelB.push_back(store.AddTexture(image, SAMPLER_A, 100));
+        }
+        HSK_CHECK(modelB[0] == modelA[0])
+        HSK_CHECK(store.GetTextures()[modelA[0]].RefCount == 2)
+
+        // Unloading model A keeps the texture model B uses
+        store.ReleaseTextures(modelA);
+        HSK_CHECK(!shared.expired())
+        HSK_CHECK(exclusive.expired())
+        HSK_CHECK(store.GetTextures()[modelB[0]].Image == shared.lock())
+        HSK_CHECK(store.GetTextures()[modelB[0]].RefCount == 1)
+        HSK_CHECK(!store.GetTextures()[modelA[1]].Image && store.GetTextures()[modelA[1]].RefCount == 0)
+        HSK_CHECK(!store.GetTextures()[modelA[2]].Image && store.GetTextures()[modelA[2]].RefCount == 0)
+        HSK_CHECK(store.FindImage(100) == shared.lock())
+        HSK_CHECK(!store.FindImage(200))
+
+        // Released slots are reused, indices of remaining textures don't change
+        int32_t reused = store.AddTexture(std::make_shared<ManagedImage>(), SAMPLER_A, 300);
+        HSK_CHECK(reused == modelA[1] || reused == modelA[2])
+        HSK_CHECK(store.GetTextures().size() == 3)
+
+        // Unloading model B releases the last reference
+        store.ReleaseTextures(modelB);
+        HSK_CHECK(shared.expired())
+        HSK_CHECK(!store.FindImage(100))
+        HSK_CHECK(store.FindImage(300) != nullptr)
+
+        // Releasing more often than added is an error
+        HSK_CHECK_THROWS(store.ReleaseTexture(modelB[0]))
+    }
+}  // namespace
+
+int main()
+{
+    TestSharedTexturesSurviveUntilLastRelease();
+    return test::gFailureCount;
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#include "hsk_test.hpp"
+#include "scenegraph/hsk_geo.hpp"
+
+using namespace hsk;
+
+namespace {
+    void TestOctahedralRoundTrip()
+    {
+        const glm::vec3 directions[] = {glm::vec3(1.f, 0.f, 0.f),  glm::vec3(-1.f, 0.f, 0.f), glm::vec3(0.f, 1.f, 0.f),
+                                        glm::vec3(0.f, -1.f, 0.f), glm::vec3(0.f, 0.f, 1.f),  glm::vec3(0.f, 0.f, -1.f),
+                                        glm::normalize(glm::vec3(1.f, 2.f, 3.f)), glm::normalize(glm::vec3(-3.f, 1.f, -2.f)), glm::normalize(glm::vec3(0.5f, -0.5f, -0.1f))};
+        for(const glm::vec3& direction : directions)
+        {
+            HSK_CHECK(glm::length(DecodeOctahedral(EncodeOctahedral(direction)) - direction) < 1e-4f)
+        }
+    }
+
+    void TestOctahedralZeroLength()
+    {
+        // Degenerate normals must not write NaN into packed vertices
+        glm::vec3 decoded = DecodeOctahedral(EncodeOctahedral(glm::vec3(0.f)));
+        HSK_CHECK(decoded == glm::vec3(0.f, 0.f, 1.f))
+
+        CompactVertex packed = PackVertex(Vertex{.Pos = glm::vec3(1.f, 2.f, 3.f), .Normal = glm::vec3(0.f), .Tangent = glm::vec3(0.f)});
+        HSK_CHECK(packed.Normal == EncodeOctahedral(glm::vec3(0.f, 0.f, 1.f)))
+        HSK_CHECK(packed.Tangent == EncodeOctahedral(glm::vec3(0.f, 0.f, 1.f)))
+    }
+}  // namespace
+
+int main()
+{
+    TestOctahedralRoundTrip();
+    TestOctahedralZeroLength();
+    return test::gFailureCount;
+}
\ No newline at end of file